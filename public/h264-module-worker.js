@@ -36,7 +36,7 @@ async function initDecoder() {
 
 // Handle messages
 self.onmessage = function(e) {
-  const { type, data } = e.data;
+  const { type, data, offset, size } = e.data;
 
   if (type === 'init') {
     initDecoder();
@@ -51,7 +51,8 @@ self.onmessage = function(e) {
   switch (type) {
     case 'decode':
       try {
-        const h264Data = new Uint8Array(data);
+        // Frames from the IPC channel carry a header; offset/size select the H.264 payload
+        const h264Data = new Uint8Array(data, offset || 0, size);
         decoder.decode(h264Data);
       } catch (error) {
         self.postMessage({ type: 'error', error: 'Decode error: ' + error.message });
@@ -2,12 +2,36 @@
 // This provides a C interface on top of AASDK's C++ API
 
 #include "aasdk_c.h"
-
+#include "audio_focus.h"
+#include "audio_mixer.h"
+#include "usb_event_loop.h"
+#include "frame_pool.h"
+#include "frame_ring.h"
+#include "video_queue.h"
+#include "h264_decoder.h"
+#include "h264_parser.h"
+#include "input_batcher.h"
+#include "jitter_buffer.h"
+#include "lag_controller.h"
+#include "media_ack.h"
+#include "mic_capture.h"
+#include "session_capture.h"
+#include "session_replay.h"
+#include "video_probe.h"
+#include "wav_source.h"
+#include "yuv_convert.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
 
 // AASDK includes
 #include <f1x/aasdk/IO/IOContextWrapper.hpp>
@@ -30,7 +54,10 @@
 #include <f1x/aasdk/Channel/AV/MediaAudioServiceChannel.hpp>
 #include <f1x/aasdk/Channel/AV/SpeechAudioServiceChannel.hpp>
 #include <f1x/aasdk/Channel/AV/SystemAudioServiceChannel.hpp>
+#include <f1x/aasdk/Channel/AV/AVInputServiceChannel.hpp>
 #include <f1x/aasdk/USB/AOAPDevice.hpp>
+#include <aasdk_proto/AVChannelMessageIdsEnum.pb.h>
+#include <aasdk_proto/ControlMessageIdsEnum.pb.h>
 #include <libusb-1.0/libusb.h>
 #include <boost/asio.hpp>
 #include <iostream>
@@ -45,7 +72,7 @@ class VideoEventHandler : public channel::av::IVideoServiceChannelEventHandler {
 public:
     VideoEventHandler(VideoFrameCallback cb, void* ud, AASDKContext* ctx)
         : callback_(cb), user_data_(ud), ctx_(ctx),
-          video_width_(1280), video_height_(720) {}
+          video_width_(1280), video_height_(720), sequence_(0) {}
 
     void onChannelOpenRequest(const proto::messages::ChannelOpenRequest& request) override;
     void onAVChannelSetupRequest(const proto::messages::AVChannelSetupRequest& request) override;
@@ -54,43 +81,48 @@ public:
     void onAVChannelStopIndication(const proto::messages::AVChannelStopIndication& indication) override;
 
     void onAVMediaWithTimestampIndication(messenger::Timestamp::ValueType timestamp, const common::DataConstBuffer& buffer) override {
-        // Don't log every frame - too verbose
-        if (callback_ && buffer.cdata && buffer.size > 0) {
-            uint32_t buffer_size = static_cast<uint32_t>(buffer.size);
-            callback_(buffer.cdata, video_width_, video_height_, buffer_size, user_data_);
-        }
+        onVideoPayload(timestamp, AASDK_MEDIA_INFO_HAS_TIMESTAMP, buffer);
     }
 
     void onAVMediaIndication(const common::DataConstBuffer& buffer) override {
-        // Don't log every frame - too verbose
-        if (callback_ && buffer.cdata && buffer.size > 0) {
-            uint32_t buffer_size = static_cast<uint32_t>(buffer.size);
-            callback_(buffer.cdata, video_width_, video_height_, buffer_size, user_data_);
-        }
+        onVideoPayload(0, 0, buffer);
     }
 
     void onVideoFocusRequest(const proto::messages::VideoFocusRequest& request) override;
     void onChannelError(const error::Error& e) override;
 
+    // Re-deliver the cached SPS/PPS to every consumer. Runs on the video strand.
+    void prime();
+
 private:
+    void onVideoPayload(messenger::Timestamp::ValueType timestamp, uint32_t infoFlags, const common::DataConstBuffer& buffer);
+    // Hand a frame reference to the decoder and the ref callback or queue
+    void deliver(AASDKFrame* frame);
+    // Drop the queued backlog up to the next IDR
+    void resync();
+    // Cycle video focus so the phone restarts its encoder with an IDR
+    void requestKeyframe();
+    bool hasConsumers() const;
+
     VideoFrameCallback callback_;
     void* user_data_;
     AASDKContext* ctx_;
     uint32_t video_width_;
     uint32_t video_height_;
+    uint64_t sequence_;
 };
 
 class AudioEventHandler : public channel::av::IAudioServiceChannelEventHandler {
 public:
     AudioEventHandler(AudioDataCallback cb, void* ud, AASDKContext* ctx, channel::av::AudioServiceChannel::Pointer* channel_ptr)
-        : callback_(cb), user_data_(ud), ctx_(ctx), channel_ptr_(channel_ptr),
-          sample_rate_(48000), channels_(2), bit_depth_(16) {}
+        : callback_(cb), user_data_(ud), ctx_(ctx), channel_ptr_(channel_ptr), format_(), sequence_(0) {}
 
     void onChannelOpenRequest(const proto::messages::ChannelOpenRequest& request) override;
     void onAVChannelSetupRequest(const proto::messages::AVChannelSetupRequest& request) override;
 
     void onAVChannelStartIndication(const proto::messages::AVChannelStartIndication& indication) override {
-        std::cerr << "Audio stream started" << std::endl;
+        std::cerr << "Audio stream started, session: " << indication.session() << std::endl;
+        startAckSession(indication.session());
 
         // Continue receiving on audio channel
         if (ctx_ && channel_ptr_ && *channel_ptr_) {
@@ -98,31 +130,14 @@ public:
         }
     }
 
-    void onAVChannelStopIndication(const proto::messages::AVChannelStopIndication& indication) override {
-        std::cerr << "Audio stream stopped" << std::endl;
-
-        // Continue receiving on audio channel
-        if (ctx_ && channel_ptr_ && *channel_ptr_) {
-            // Audio event handlers are shared pointers managed by context
-        }
-    }
+    void onAVChannelStopIndication(const proto::messages::AVChannelStopIndication& indication) override;
 
     void onAVMediaWithTimestampIndication(messenger::Timestamp::ValueType timestamp, const common::DataConstBuffer& buffer) override {
-        if (callback_ && buffer.cdata) {
-            // Use configured audio parameters
-            const int16_t* samples = reinterpret_cast<const int16_t*>(buffer.cdata);
-            uint32_t sample_count = buffer.size / (bit_depth_ / 8);
-            callback_(samples, sample_count, channels_, sample_rate_, user_data_);
-        }
+        onAudioPayload(timestamp, AASDK_MEDIA_INFO_HAS_TIMESTAMP, buffer);
     }
 
     void onAVMediaIndication(const common::DataConstBuffer& buffer) override {
-        if (callback_ && buffer.cdata) {
-            // Use configured audio parameters
-            const int16_t* samples = reinterpret_cast<const int16_t*>(buffer.cdata);
-            uint32_t sample_count = buffer.size / (bit_depth_ / 8);
-            callback_(samples, sample_count, channels_, sample_rate_, user_data_);
-        }
+        onAudioPayload(0, 0, buffer);
     }
 
     void onChannelError(const error::Error& e) override {
@@ -131,13 +146,63 @@ public:
     }
 
 private:
+    void onAudioPayload(messenger::Timestamp::ValueType timestamp, uint32_t infoFlags, const common::DataConstBuffer& buffer);
+    void startAckSession(int32_t session);
+
     AudioDataCallback callback_;
     void* user_data_;
     AASDKContext* ctx_;
     channel::av::AudioServiceChannel::Pointer* channel_ptr_;
-    uint32_t sample_rate_;
-    uint32_t channels_;
-    uint32_t bit_depth_;
+    AASDKAudioFormat format_;   // Set from the advertised configuration on setup
+    uint64_t sequence_;
+};
+
+// AV_INPUT channel: answers the phone's microphone requests and, while it listens, pumps
+// captured audio out of the MicCapture on a timer and as acks come back
+class MicEventHandler : public channel::av::IAVInputServiceChannelEventHandler,
+                        public std::enable_shared_from_this<MicEventHandler> {
+public:
+    MicEventHandler(AASDKContext* ctx, boost::asio::io_service::strand& strand);
+
+    void onChannelOpenRequest(const proto::messages::ChannelOpenRequest& request) override;
+    void onAVChannelSetupRequest(const proto::messages::AVChannelSetupRequest& request) override;
+    void onAVInputOpenRequest(const proto::messages::AVInputOpenRequest& request) override;
+    void onAVMediaAckIndication(const proto::messages::AVMediaAckIndication& indication) override;
+    void onChannelError(const error::Error& e) override;
+
+private:
+    // Send what is ready and check again in a quarter payload while the phone listens
+    void pump();
+    void receive();
+
+    AASDKContext* ctx_;
+    boost::asio::io_service::strand& strand_;
+    boost::asio::deadline_timer pumpTimer_;
+};
+
+// Input channel: sends the InputBatcher's touch and key indications to the phone, one
+// in flight at a time, so moves queued behind a slow write are merged into one
+class InputEventHandler : public channel::input::IInputServiceChannelEventHandler,
+                          public std::enable_shared_from_this<InputEventHandler> {
+public:
+    InputEventHandler(AASDKContext* ctx, boost::asio::io_service::strand& strand);
+
+    void onChannelOpenRequest(const proto::messages::ChannelOpenRequest& request) override;
+    void onBindingRequest(const proto::messages::BindingRequest& request) override;
+    void onChannelError(const error::Error& e) override;
+
+    // Any thread: send what the batcher has queued
+    void flush();
+
+private:
+    // Send the next indication unless one is in flight; runs on the strand
+    void sendNext();
+    void receive();
+
+    AASDKContext* ctx_;
+    boost::asio::io_service::strand& strand_;
+    bool open_;
+    bool inFlight_;
 };
 
 // Control channel event handler (uses forward declaration, methods implemented after AASDKContext is defined)
@@ -159,23 +224,281 @@ private:
     AASDKContext* ctx_;
 };
 
+// Tracks the device connection state machine and the time spent in each state.
+// Written from the connector and control strands, read from the C API.
+class ConnectionStateTracker {
+public:
+    ConnectionStateTracker()
+        : state_(AASDK_CONN_IDLE), enteredAt_(std::chrono::steady_clock::now()), openAttempts_(0) {
+        for (auto& us : accumulatedUs_) {
+            us = 0;
+        }
+    }
+
+    void enter(AASDKConnectionState state) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        accumulatedUs_[state_] += std::chrono::duration_cast<std::chrono::microseconds>(now - enteredAt_).count();
+        state_ = state;
+        enteredAt_ = now;
+    }
+
+    AASDKConnectionState state() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_;
+    }
+
+    void countOpenAttempt() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++openAttempts_;
+    }
+
+    void snapshot(AASDKConnectionStateInfo* info) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        info->state = state_;
+        info->open_attempts = openAttempts_;
+        for (int i = 0; i < AASDK_CONN_STATE_COUNT; ++i) {
+            info->state_time_us[i] = accumulatedUs_[i];
+        }
+        // Include the time spent so far in the current state
+        info->state_time_us[state_] += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - enteredAt_).count();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    AASDKConnectionState state_;
+    std::chrono::steady_clock::time_point enteredAt_;
+    uint32_t openAttempts_;
+    uint64_t accumulatedUs_[AASDK_CONN_STATE_COUNT];
+};
+
+// Monotonic timestamps for each connection milestone, reset when a new phone is found.
+// Milestones are recorded once per connection (first writer wins) with lock-free atomics
+// so the media hot path only pays a relaxed load after the first payload.
+class ConnectTimeline {
+public:
+    ConnectTimeline() {
+        reset();
+    }
+
+    static uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void reset() {
+        usbDiscovered_ = 0;
+        aoapSwitched_ = 0;
+        transportUp_ = 0;
+        versionResponse_ = 0;
+        handshakeRounds_ = 0;
+        for (auto& ns : handshakeRoundNs_) {
+            ns = 0;
+        }
+        authComplete_ = 0;
+        serviceDiscovery_ = 0;
+        for (uint32_t i = 0; i < AASDK_TIMELINE_MAX_CHANNELS; ++i) {
+            channelOpen_[i] = 0;
+            avSetup_[i] = 0;
+        }
+        firstVideo_ = 0;
+        firstAudio_ = 0;
+    }
+
+    void markUsbDiscovered() { markOnce(usbDiscovered_); }
+    void markAoapSwitched() { markOnce(aoapSwitched_); }
+    void markTransportUp() { markOnce(transportUp_); }
+    void markVersionResponse() { markOnce(versionResponse_); }
+    void markAuthComplete() { markOnce(authComplete_); }
+    void markServiceDiscovery() { markOnce(serviceDiscovery_); }
+    void markFirstVideo() { markOnce(firstVideo_); }
+    void markFirstAudio() { markOnce(firstAudio_); }
+
+    void markHandshakeRound() {
+        uint32_t round = handshakeRounds_.fetch_add(1, std::memory_order_relaxed);
+        if (round < AASDK_TIMELINE_MAX_HANDSHAKE_ROUNDS) {
+            handshakeRoundNs_[round].store(nowNs(), std::memory_order_relaxed);
+        }
+    }
+
+    void markChannelOpen(messenger::ChannelId channelId) {
+        markChannel(channelOpen_, channelId);
+    }
+
+    void markAVSetup(messenger::ChannelId channelId) {
+        markChannel(avSetup_, channelId);
+    }
+
+    bool started() const {
+        return usbDiscovered_.load(std::memory_order_relaxed) != 0;
+    }
+
+    void snapshot(AASDKConnectTimeline* timeline) const {
+        timeline->usb_discovered_ns = usbDiscovered_.load(std::memory_order_relaxed);
+        timeline->aoap_switched_ns = aoapSwitched_.load(std::memory_order_relaxed);
+        timeline->transport_up_ns = transportUp_.load(std::memory_order_relaxed);
+        timeline->version_response_ns = versionResponse_.load(std::memory_order_relaxed);
+        timeline->handshake_round_count = std::min<uint32_t>(
+            handshakeRounds_.load(std::memory_order_relaxed), AASDK_TIMELINE_MAX_HANDSHAKE_ROUNDS);
+        for (uint32_t i = 0; i < AASDK_TIMELINE_MAX_HANDSHAKE_ROUNDS; ++i) {
+            timeline->handshake_round_ns[i] = handshakeRoundNs_[i].load(std::memory_order_relaxed);
+        }
+        timeline->auth_complete_ns = authComplete_.load(std::memory_order_relaxed);
+        timeline->service_discovery_ns = serviceDiscovery_.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < AASDK_TIMELINE_MAX_CHANNELS; ++i) {
+            timeline->channel_open_ns[i] = channelOpen_[i].load(std::memory_order_relaxed);
+            timeline->av_setup_ns[i] = avSetup_[i].load(std::memory_order_relaxed);
+        }
+        timeline->first_video_ns = firstVideo_.load(std::memory_order_relaxed);
+        timeline->first_audio_ns = firstAudio_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static void markOnce(std::atomic<uint64_t>& milestone) {
+        if (milestone.load(std::memory_order_relaxed) != 0) {
+            return;
+        }
+        uint64_t expected = 0;
+        milestone.compare_exchange_strong(expected, nowNs(), std::memory_order_relaxed);
+    }
+
+    static void markChannel(std::atomic<uint64_t>* milestones, messenger::ChannelId channelId) {
+        auto index = static_cast<uint32_t>(channelId);
+        if (index < AASDK_TIMELINE_MAX_CHANNELS) {
+            markOnce(milestones[index]);
+        }
+    }
+
+    std::atomic<uint64_t> usbDiscovered_;
+    std::atomic<uint64_t> aoapSwitched_;
+    std::atomic<uint64_t> transportUp_;
+    std::atomic<uint64_t> versionResponse_;
+    std::atomic<uint32_t> handshakeRounds_;
+    std::atomic<uint64_t> handshakeRoundNs_[AASDK_TIMELINE_MAX_HANDSHAKE_ROUNDS];
+    std::atomic<uint64_t> authComplete_;
+    std::atomic<uint64_t> serviceDiscovery_;
+    std::atomic<uint64_t> channelOpen_[AASDK_TIMELINE_MAX_CHANNELS];
+    std::atomic<uint64_t> avSetup_[AASDK_TIMELINE_MAX_CHANNELS];
+    std::atomic<uint64_t> firstVideo_;
+    std::atomic<uint64_t> firstAudio_;
+};
+
+// Video configurations advertised at service discovery, in the order the phone indexes
+// them, and the one it picked in AVChannelSetupRequest::config_index.
+// Written from the control and video strands, read from the C API.
+class VideoConfigTable {
+public:
+    struct Mode {
+        uint32_t width;         // Encoded picture size
+        uint32_t height;
+        uint32_t fps;
+        uint32_t marginWidth;   // Letterboxing inside the picture
+        uint32_t marginHeight;
+        uint32_t dpi;
+    };
+
+    VideoConfigTable() : selected_(-1) {}
+
+    // Replace the table with what is being advertised to a new phone
+    void advertise(const google::protobuf::RepeatedPtrField<proto::data::VideoConfig>& configs) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        modes_.clear();
+        for (const auto& config : configs) {
+            modes_.push_back(modeOf(config));
+        }
+        selected_ = -1;
+    }
+
+    // Size and rate a video config stands for
+    static Mode modeOf(const proto::data::VideoConfig& config) {
+        Mode mode = {0, 0, 0, config.margin_width(), config.margin_height(), config.dpi()};
+        switch (config.video_resolution()) {
+        case proto::enums::VideoResolution::_480p: mode.width = 800; mode.height = 480; break;
+        case proto::enums::VideoResolution::_720p: mode.width = 1280; mode.height = 720; break;
+        case proto::enums::VideoResolution::_1080p: mode.width = 1920; mode.height = 1080; break;
+        default: break;
+        }
+        switch (config.video_fps()) {
+        case proto::enums::VideoFPS::_30: mode.fps = 30; break;
+        case proto::enums::VideoFPS::_60: mode.fps = 60; break;
+        default: break;
+        }
+        return mode;
+    }
+
+    // Pick the mode for config_index; false if it was never advertised
+    bool select(uint32_t index, Mode& mode) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index >= modes_.size()) {
+            return false;
+        }
+        selected_ = static_cast<int>(index);
+        mode = modes_[index];
+        return true;
+    }
+
+    // The negotiated mode; false until the phone has sent its setup request
+    bool selected(Mode& mode) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (selected_ < 0) {
+            return false;
+        }
+        mode = modes_[selected_];
+        return true;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Mode> modes_;
+    int selected_;
+};
+
+class DeviceConnector;
+
 // Main AASDK context
 struct AASDKContext {
     boost::asio::io_service ioService;
     std::unique_ptr<boost::asio::io_service::work> work;
-    std::thread ioThread;
+    std::vector<std::thread> ioThreads;
+    std::atomic<uint64_t> ioThreadHandlers[AASDK_MAX_IO_THREADS];
     
     libusb_context* usbContext;
+    std::unique_ptr<USBEventLoop> usbEventLoop;  // Dispatches libusb events from the io_service reactor
     std::unique_ptr<usb::USBWrapper> usbWrapper;
     std::unique_ptr<usb::AccessoryModeQueryFactory> queryFactory;
     std::unique_ptr<usb::AccessoryModeQueryChainFactory> queryChainFactory;
     usb::IUSBHub::Pointer usbHub;  // Must be shared_ptr because USBHub uses shared_from_this()
     usb::IAccessoryModeQueryChain::Pointer activeQueryChain;  // For enumerating already-connected devices
+    std::shared_ptr<DeviceConnector> connector;  // Non-blocking discovery/connection state machine
+    ConnectionStateTracker connectionState;
+    ConnectTimeline timeline;  // Per-connection milestone timestamps
+    FramePool framePool;       // Recycled video payload buffers
+    std::unique_ptr<VideoFrameQueue> videoQueue;  // Bounded hand-off to aasdk_video_queue_pop()
+    std::shared_ptr<H264Decoder> decoder;         // Optional native decode stage; std::atomic_load/store only
+    std::shared_ptr<FrameRing> frameRing;         // Decoded pictures shared with a renderer
+    std::shared_ptr<VideoLagController> videoLag; // Resyncs the stream when consumers fall behind
+    std::shared_ptr<SessionCapture> capture;      // Protocol capture for connections started while set
+    std::shared_ptr<SessionReplay> replay;        // Capture being played back in place of a phone
+    H264ParameterCache videoParameters;           // Latest SPS/PPS, primes late consumers
+    VideoConfigTable videoConfigs;                // Advertised video modes and the negotiated one
+    VideoCapabilityProbe videoProbe;              // Which modes the native decode path sustains
+    std::shared_ptr<MediaAckWindow> ackWindows[AASDK_AV_CHANNEL_COUNT];  // Per-connection, by AASDKAVChannel; atomic_load/atomic_store only
+    std::unique_ptr<AudioJitterBuffer> audioBuffers[AASDK_AV_CHANNEL_COUNT];  // aasdk_audio_read() buffers, by AASDKAVChannel
+    std::shared_ptr<AudioMixer> mixer;                                   // Optional reader of every audio ring; set once
+    std::atomic<AudioMixer*> mixerOutput;                                // mixer for aasdk_audio_mix(), which takes no lock
+    AudioFocus audioFocus;                                               // Granted to the phone, decides what plays
+    std::shared_ptr<MicCapture> mic;                                     // Optional capture behind AV_INPUT; set once
+    std::atomic<MicCapture*> micInput;                                   // mic for the AV_INPUT strand and aasdk_mic_write()
+    std::unique_ptr<WavSource> micWav;                                   // File played into mic instead of a device
+    std::shared_ptr<InputBatcher> input;                                 // Touches and keys on their way to the phone
+    uint32_t videoAckWindow;
+    uint32_t audioAckWindow;
     
     usb::IAOAPDevice::Pointer aoapDevice;
     transport::USBTransport::Pointer transport;
     messenger::ICryptor::Pointer cryptor;
-    messenger::Messenger::Pointer messenger;
+    messenger::IMessenger::Pointer messenger;        // Wrapped in a CapturingMessenger while capturing
     messenger::MessageInStream::Pointer messageInStream;
     messenger::MessageOutStream::Pointer messageOutStream;
     
@@ -184,6 +507,7 @@ struct AASDKContext {
     channel::av::AudioServiceChannel::Pointer speechAudioChannel;
     channel::av::AudioServiceChannel::Pointer systemAudioChannel;
     channel::input::InputServiceChannel::Pointer inputChannel;
+    channel::av::AVInputServiceChannel::Pointer avInputChannel;
     channel::control::ControlServiceChannel::Pointer controlChannel;
 
     // Strands for channel thread safety - must be kept alive
@@ -193,52 +517,553 @@ struct AASDKContext {
     std::unique_ptr<boost::asio::io_service::strand> speechAudioStrand;
     std::unique_ptr<boost::asio::io_service::strand> systemAudioStrand;
     std::unique_ptr<boost::asio::io_service::strand> inputStrand;
+    std::unique_ptr<boost::asio::io_service::strand> avInputStrand;
 
     std::shared_ptr<VideoEventHandler> videoEventHandler;
     std::shared_ptr<AudioEventHandler> audioEventHandler;
     std::shared_ptr<AudioEventHandler> speechAudioEventHandler;
     std::shared_ptr<AudioEventHandler> systemAudioEventHandler;
     std::shared_ptr<ControlEventHandler> controlEventHandler;
+    std::shared_ptr<MicEventHandler> micEventHandler;
+    std::shared_ptr<InputEventHandler> inputEventHandler;
     
     VideoFrameCallback videoCallback;
+    // Frame reference callback and its user data, swapped as one; std::atomic_load/store only
+    struct VideoRefSink {
+        VideoFrameRefCallback callback;
+        void* userData;
+    };
+    std::shared_ptr<const VideoRefSink> videoRef;
+    DecodedFrameCallback decodedCallback;
+    void* decodedUserData;
+    VideoFrameCallbackV2 videoCallbackV2;
+    AudioDataCallbackV2 audioCallbackV2;
+    void* mediaUserDataV2;
     AudioDataCallback audioCallback;
     ConnectionStatusCallback connectionCallback;
     void* userData;
+    MicStateCallback micStateCallback;
+    void* micUserData;
+    AudioFocusCallback audioFocusCallback;
+    void* audioFocusUserData;
     
-    std::atomic<bool> connected;
+    std::atomic<bool> connected;    // A phone or replay session was set up; written under mutex with replay
     std::atomic<bool> running;
     std::mutex mutex;
     
-    AASDKContext() : connected(false), running(false) {}
+    // Enough idle buffers to cover a GOP's worth of frames in flight at 60fps
+    static constexpr size_t FRAME_POOL_IDLE = 32;
+    // Advertised touch screen; aasdk_send_touch() coordinates are in its pixels
+    static constexpr uint32_t TOUCH_WIDTH = 1280;
+    static constexpr uint32_t TOUCH_HEIGHT = 720;
+
+    AASDKContext()
+        : usbContext(nullptr), framePool(FRAME_POOL_IDLE), mixerOutput(nullptr), micInput(nullptr),
+          videoAckWindow(AASDK_DEFAULT_VIDEO_ACK_WINDOW), audioAckWindow(AASDK_DEFAULT_AUDIO_ACK_WINDOW),
+          decodedCallback(nullptr), decodedUserData(nullptr),
+          videoCallbackV2(nullptr), audioCallbackV2(nullptr), mediaUserDataV2(nullptr),
+          micStateCallback(nullptr), micUserData(nullptr), audioFocusCallback(nullptr), audioFocusUserData(nullptr),
+          connected(false), running(false) {
+        for (auto& count : ioThreadHandlers) {
+            count = 0;
+        }
+    }
     
     ~AASDKContext() {
         stop();
+        joinIoThreads();
     }
-    
-    void stop() {
-        if (running) {
-            running = false;
-            work.reset();
-            if (ioThread.joinable()) {
-                ioThread.join();
+
+    // Start the io_service worker pool, optionally pinning each worker to a CPU
+    void startIoThreads(const AASDKInitOptions& options) {
+        uint32_t threadCount = std::max<uint32_t>(1, std::min<uint32_t>(options.io_threads, AASDK_MAX_IO_THREADS));
+
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            ioThreads.emplace_back([this, i]() {
+                try {
+                    // Blocks in the reactor until a handler or USB event is ready
+                    while (ioService.run_one() != 0) {
+                        ioThreadHandlers[i].fetch_add(1, std::memory_order_relaxed);
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "IO service thread " << i << " error: " << e.what() << std::endl;
+                }
+            });
+
+            int32_t cpu = options.io_thread_cpus[i];
+            if (cpu >= CPU_SETSIZE) {
+                // CPU_SET would write past the cpu_set_t
+                std::cerr << "Warning: Not pinning io thread " << i << ": CPU " << cpu
+                          << " is beyond CPU_SETSIZE (" << CPU_SETSIZE << ")" << std::endl;
+            } else if (cpu >= 0) {
+                cpu_set_t cpuset;
+                CPU_ZERO(&cpuset);
+                CPU_SET(cpu, &cpuset);
+                int ret = pthread_setaffinity_np(ioThreads.back().native_handle(), sizeof(cpuset), &cpuset);
+                if (ret != 0) {
+                    std::cerr << "Warning: Failed to pin io thread " << i << " to CPU " << cpu << std::endl;
+                }
+            }
+        }
+
+        std::cerr << "Started " << threadCount << " io thread(s)" << std::endl;
+    }
+
+    // Join every worker except the calling one (stop() can run from a handler,
+    // e.g. onShutdownRequest); that one is joined later from the destructor
+    void joinIoThreads() {
+        for (auto& thread : ioThreads) {
+            if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) {
+                thread.join();
             }
-            if (usbHub) {
-                usbHub->cancel();
+        }
+    }
+    
+    // AASDKAVChannel of an audio/video channel, -1 for any other channel
+    static int avChannel(messenger::ChannelId id) {
+        switch (id) {
+        case messenger::ChannelId::VIDEO: return AASDK_AV_CHANNEL_VIDEO;
+        case messenger::ChannelId::MEDIA_AUDIO: return AASDK_AV_CHANNEL_MEDIA_AUDIO;
+        case messenger::ChannelId::SPEECH_AUDIO: return AASDK_AV_CHANNEL_SPEECH_AUDIO;
+        case messenger::ChannelId::SYSTEM_AUDIO: return AASDK_AV_CHANNEL_SYSTEM_AUDIO;
+        default: return -1;
+        }
+    }
+
+    // PCM format advertised for each audio stream in service discovery, by AASDKAVChannel.
+    // Each stream offers a single configuration, so it is also the negotiated one.
+    static const AASDKAudioFormat& audioFormat(int channel) {
+        static const AASDKAudioFormat formats[AASDK_AV_CHANNEL_COUNT] = {
+            {0, 0, 0},          // Video
+            {48000, 2, 16},     // Media
+            {16000, 1, 16},     // Speech (guidance, assistant)
+            {16000, 1, 16},     // System (notification sounds)
+        };
+        return formats[channel >= 0 && channel < AASDK_AV_CHANNEL_COUNT ? channel : 0];
+    }
+
+    // PCM format advertised for the AV_INPUT channel (microphone)
+    static const AASDKAudioFormat& micFormat() {
+        static const AASDKAudioFormat format = {16000, 1, 16};
+        return format;
+    }
+
+    // Flow control window of an audio/video channel, nullptr before service discovery.
+    // Service discovery and stop() replace the windows while strands and aasdk_get_stats()
+    // read them, so they are only ever loaded and stored atomically.
+    std::shared_ptr<MediaAckWindow> ackWindow(messenger::ChannelId id) const {
+        return ackWindowAt(avChannel(id));
+    }
+
+    std::shared_ptr<MediaAckWindow> ackWindowAt(int index) const {
+        return index < 0 ? nullptr : std::atomic_load(&ackWindows[index]);
+    }
+
+    // Stop acknowledging for the previous connection; frames may still be in flight
+    void detachAckWindows() {
+        for (int i = 0; i < AASDK_AV_CHANNEL_COUNT; ++i) {
+            if (auto window = ackWindowAt(i)) {
+                window->detach();
             }
-            if (activeQueryChain) {
-                activeQueryChain->cancel();
+        }
+    }
+
+    void setAckWindow(int index, std::shared_ptr<MediaAckWindow> window) {
+        std::atomic_store(&ackWindows[index], std::move(window));
+    }
+
+    // Post a prime() of the video consumers onto the video strand; caller holds mutex
+    bool primeVideoConsumers() {
+        if (!videoStrand || !videoEventHandler || !videoParameters.hasConfig()) {
+            return false;
+        }
+        auto handler = videoEventHandler;
+        videoStrand->post([handler]() { handler->prime(); });
+        return true;
+    }
+
+    // Replace the native decoder with one feeding the installed callback and frame ring,
+    // or just stop it when neither is set; caller holds mutex. The video strand loads the
+    // decoder without the mutex and keeps its reference for a whole delivery, so the old
+    // one is unpublished before it is stopped and is freed by whichever side lets go last.
+    bool restartDecoder() {
+        auto previous = std::atomic_load(&decoder);
+        if (previous) {
+            std::atomic_store(&decoder, std::shared_ptr<H264Decoder>());
+            previous->stop();
+        }
+        if (!decodedCallback && !frameRing) {
+            return true;
+        }
+
+        auto next = std::make_shared<H264Decoder>(decodedCallback, decodedUserData);
+        next->setRing(frameRing);
+        next->setLagController(videoLag);
+        if (!next->start()) {
+            return false;
+        }
+        std::atomic_store(&decoder, std::move(next));
+        primeVideoConsumers();
+        return true;
+    }
+
+    // The phone opened or closed the microphone: restart the WAV stand-in and tell the app
+    void micStateChanged(bool open) {
+        std::cerr << "Microphone " << (open ? "opened" : "closed") << " by the phone" << std::endl;
+        if (open && micWav) {
+            micWav->rewind();
+        }
+        if (micStateCallback) {
+            micStateCallback(open, micUserData);
+        }
+    }
+
+    // Capture behind AV_INPUT, nullptr without aasdk_enable_mic(); valid until aasdk_deinit()
+    MicCapture* micCapture() const {
+        return micInput.load(std::memory_order_acquire);
+    }
+
+    // Close the microphone of a connection that is gone
+    void closeMic() {
+        MicCapture* capture = micCapture();
+        if (capture && capture->close()) {
+            micStateChanged(false);
+        }
+    }
+
+    // Strand of an audio stream's channel; nullptr before service discovery
+    boost::asio::io_service::strand* audioStrand(int stream) {
+        switch (stream) {
+        case AASDK_AV_CHANNEL_MEDIA_AUDIO: return mediaAudioStrand.get();
+        case AASDK_AV_CHANNEL_SPEECH_AUDIO: return speechAudioStrand.get();
+        case AASDK_AV_CHANNEL_SYSTEM_AUDIO: return systemAudioStrand.get();
+        default: return nullptr;
+        }
+    }
+
+    // Act on a new audio focus outcome: duck media, let streams that were paused play out
+    // what they have buffered, and tell the app. Runs on the control strand.
+    void audioFocusChanged(const AASDKAudioFocusInfo& focus, const bool* wasActive) {
+        std::shared_ptr<AudioMixer> currentMixer;
+        AudioFocusCallback callback;
+        void* callbackData;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            currentMixer = mixer;
+            callback = audioFocusCallback;
+            callbackData = audioFocusUserData;
+        }
+        if (currentMixer) {
+            currentMixer->setDucked(focus.media_ducked);
+        }
+
+        static const char* const names[AASDK_AV_CHANNEL_COUNT] = {"video", "media", "speech", "system"};
+        std::cerr << "Audio focus " << AudioFocus::stateName(static_cast<AASDKAudioFocusState>(focus.state)) << ":";
+        for (int i = AASDK_AV_CHANNEL_MEDIA_AUDIO; i < AASDK_AV_CHANNEL_COUNT; ++i) {
+            std::cerr << " " << names[i] << (focus.stream_active[i] ? " plays" : " paused");
+            AudioJitterBuffer* buffer = audioBuffers[i].get();
+            auto* strand = audioStrand(i);
+            if (wasActive[i] && !focus.stream_active[i] && buffer && strand) {
+                // Only the stream's strand writes its buffer
+                strand->post([buffer]() { buffer->endOfStream(); });
             }
-            if (transport) {
-                transport->stop();
+        }
+        std::cerr << (focus.media_ducked ? ", media ducked" : "") << std::endl;
+
+        if (callback) {
+            callback(&focus, callbackData);
+        }
+    }
+
+    // A new connection starts with no focus requested, every stream playing
+    void resetAudioFocus() {
+        audioFocus.reset();
+        AASDKAudioFocusInfo focus = {};
+        audioFocus.info(&focus);
+        audioFocusChanged(focus, focus.stream_active);
+    }
+
+    // Any thread, after queueing input: wake the input strand unless a drain is already
+    // pending, so a burst of touches costs one post
+    void kickInput() {
+        if (!input->requestDrain()) {
+            return;
+        }
+        ioService.post([this]() {
+            std::shared_ptr<InputEventHandler> handler;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                handler = inputEventHandler;
             }
-            if (messenger) {
-                messenger->stop();
+            if (handler) {
+                handler->flush();
             }
+        });
+    }
+
+    // Defined after DeviceConnector
+    void stop();
+};
+
+// Flow control window that acknowledges consumed messages on an audio/video channel.
+// Consumers finish on their own threads, so the ack is written from the io_service.
+template <typename ServiceChannel>
+std::shared_ptr<MediaAckWindow> makeAckWindow(AASDKContext* ctx, std::shared_ptr<ServiceChannel> service, uint32_t size) {
+    if (!service) {
+        return nullptr;
+    }
+    return std::make_shared<MediaAckWindow>(size,
+        [ctx, service](std::shared_ptr<MediaAckWindow> window, int32_t session, uint64_t receivedNs) {
+            ctx->ioService.post([ctx, service, window, session, receivedNs]() {
+                proto::messages::AVMediaAckIndication indication;
+                indication.set_session(session);
+                indication.set_value(1);
+
+                auto promise = channel::SendPromise::defer(ctx->ioService);
+                promise->then([window, receivedNs]() { window->acked(receivedNs); },
+                              [window](const error::Error&) { window->ackFailed(); });
+                service->sendAVMediaAckIndication(indication, std::move(promise));
+            });
+        });
+}
+
+// Messenger decorator that hands every message it passes to a SessionCapture. Inbound
+// messages are decrypted by the time the messenger resolves them; outbound ones are
+// recorded before the out stream encrypts them.
+class CapturingMessenger : public messenger::IMessenger {
+public:
+    CapturingMessenger(boost::asio::io_service& ioService, messenger::IMessenger::Pointer inner,
+                       std::shared_ptr<SessionCapture> capture)
+        : ioService_(ioService), inner_(std::move(inner)), capture_(std::move(capture)) {}
+
+    void enqueueReceive(messenger::ChannelId channelId, messenger::ReceivePromise::Pointer promise) override {
+        auto capture = capture_;
+        auto tap = messenger::ReceivePromise::defer(ioService_);
+        tap->then([capture, promise](messenger::Message::Pointer message) {
+                      record(*capture, capture::Direction::INBOUND, message);
+                      promise->resolve(std::move(message));
+                  },
+                  [promise](const error::Error& e) { promise->reject(e); });
+        inner_->enqueueReceive(channelId, std::move(tap));
+    }
+
+    void enqueueSend(messenger::Message::Pointer message, messenger::SendPromise::Pointer promise) override {
+        record(*capture_, capture::Direction::OUTBOUND, message);
+        inner_->enqueueSend(std::move(message), std::move(promise));
+    }
+
+    void stop() override {
+        inner_->stop();
+    }
+
+private:
+    static void record(SessionCapture& capture, capture::Direction direction, const messenger::Message::Pointer& message) {
+        uint8_t flags = 0;
+        if (message->getEncryptionType() == messenger::EncryptionType::ENCRYPTED) {
+            flags |= capture::FLAG_ENCRYPTED;
+        }
+        if (message->getType() == messenger::MessageType::CONTROL) {
+            flags |= capture::FLAG_CONTROL;
+        }
+
+        // Timestamped media carries the phone's timestamp right after the message id
+        const auto& payload = message->getPayload();
+        size_t timestampOffset = 0;
+        bool media = AASDKContext::avChannel(message->getChannelId()) >= 0 ||
+                     message->getChannelId() == messenger::ChannelId::AV_INPUT;
+        if (media && payload.size() >= messenger::MessageId::getSizeOf() &&
+            messenger::MessageId(payload).getId() == proto::ids::AVChannelMessage::AV_MEDIA_WITH_TIMESTAMP_INDICATION) {
+            timestampOffset = messenger::MessageId::getSizeOf();
         }
+
+        // Share the message rather than copy it; the writer thread copies into the file
+        std::shared_ptr<const SessionCapture::Payload> shared(message, &payload);
+        capture.record(direction, static_cast<uint8_t>(message->getChannelId()), flags, std::move(shared), timestampOffset);
+    }
+
+    boost::asio::io_service& ioService_;
+    messenger::IMessenger::Pointer inner_;
+    std::shared_ptr<SessionCapture> capture_;
+};
+
+// Messenger that plays a SessionReplay instead of talking to a phone: receives are answered
+// with recorded messages, sends are resolved right away and dropped
+class ReplayMessenger : public messenger::IMessenger {
+public:
+    explicit ReplayMessenger(std::shared_ptr<SessionReplay> replay) : replay_(std::move(replay)) {}
+
+    void enqueueReceive(messenger::ChannelId channelId, messenger::ReceivePromise::Pointer promise) override {
+        replay_->receive(static_cast<uint8_t>(channelId), [channelId, promise](const SessionReplay::Message& recorded) {
+            auto message = std::make_shared<messenger::Message>(channelId,
+                recorded.flags & capture::FLAG_ENCRYPTED ? messenger::EncryptionType::ENCRYPTED : messenger::EncryptionType::PLAIN,
+                recorded.flags & capture::FLAG_CONTROL ? messenger::MessageType::CONTROL : messenger::MessageType::SPECIFIC);
+            message->insertPayload(common::DataConstBuffer(recorded.payload, recorded.size));
+            promise->resolve(std::move(message));
+        });
+    }
+
+    void enqueueSend(messenger::Message::Pointer /*message*/, messenger::SendPromise::Pointer promise) override {
+        replay_->sent();
+        promise->resolve();
+    }
+
+    void stop() override {
+        replay_->stop();
     }
+
+private:
+    std::shared_ptr<SessionReplay> replay_;
 };
 
 // Implement VideoEventHandler methods (after AASDKContext is defined)
+void VideoEventHandler::onVideoPayload(messenger::Timestamp::ValueType timestamp, uint32_t infoFlags,
+                                       const common::DataConstBuffer& buffer) {
+    // Don't log every frame - too verbose
+    ctx_->timeline.markFirstVideo();
+
+    // Every payload is acknowledged once consumed; a frame when its last reference goes.
+    // The ack token is the receive time, so the clock is read once per payload.
+    auto ackWindow = ctx_->ackWindow(messenger::ChannelId::VIDEO);
+    uint64_t receivedNs = ackWindow ? ackWindow->received() : ConnectTimeline::nowNs();
+    if (!buffer.cdata || buffer.size == 0) {
+        if (ackWindow) {
+            ackWindow->consumed(receivedNs);
+        }
+        return;
+    }
+    ++sequence_;
+
+    // Tag the payload and pick up the real picture size whenever the phone sends an SPS
+    uint32_t nalFlags = ctx_->videoParameters.update(buffer.cdata, buffer.size);
+    if (nalFlags & AASDK_NAL_FLAG_SPS) {
+        H264Parser::SpsInfo info;
+        if (ctx_->videoParameters.info(info) && (info.width != video_width_ || info.height != video_height_)) {
+            std::cerr << "Video stream is " << info.width << "x" << info.height
+                      << " (profile " << static_cast<int>(info.profile)
+                      << ", level " << static_cast<int>(info.level) << ")" << std::endl;
+            video_width_ = info.width;
+            video_height_ = info.height;
+        }
+    }
+
+    // Flush the backlog once consumers fall behind, and force an IDR if the phone sends none
+    switch (ctx_->videoLag->onPayload(nalFlags, receivedNs)) {
+    case VideoLagController::Action::FLUSH:
+        std::cerr << "Video consumer lagging, dropping frames until the next IDR" << std::endl;
+        resync();
+        break;
+    case VideoLagController::Action::REQUEST_KEYFRAME:
+        requestKeyframe();
+        break;
+    case VideoLagController::Action::NONE:
+        break;
+    }
+
+    uint32_t buffer_size = static_cast<uint32_t>(buffer.size);
+    if (ctx_->videoCallbackV2) {
+        AASDKMediaInfo info = {};
+        info.channel = AASDK_AV_CHANNEL_VIDEO;
+        info.flags = infoFlags;
+        info.timestamp = timestamp;
+        info.receive_ns = receivedNs;
+        info.sequence = sequence_;
+        ctx_->videoCallbackV2(buffer.cdata, buffer_size, video_width_, video_height_, &info, ctx_->mediaUserDataV2);
+    } else if (callback_) {
+        callback_(buffer.cdata, video_width_, video_height_, buffer_size, user_data_);
+    }
+
+    AASDKFrame* frame = hasConsumers() ? ctx_->framePool.acquire(buffer.size) : nullptr;
+    if (!frame) {
+        if (ackWindow) {
+            ackWindow->consumed(receivedNs);
+        }
+        return;
+    }
+
+    // The message buffer dies with this handler, so copy once into a recycled
+    // frame and hand the consumer a reference instead of a pointer to copy again
+    std::memcpy(const_cast<uint8_t*>(frame->data), buffer.cdata, buffer.size);
+    frame->width = video_width_;
+    frame->height = video_height_;
+    frame->nal_flags = nalFlags;
+    frame->timestamp = timestamp;
+    frame->sequence = sequence_;
+    frame->receive_ns = receivedNs;
+    if (ackWindow) {
+        FramePool::notifyOnRelease(frame, ackWindow, receivedNs);
+    }
+    deliver(frame);
+}
+
+void VideoEventHandler::prime() {
+    if (!hasConsumers()) {
+        return;
+    }
+    AASDKFrame* frame = ctx_->videoParameters.configFrame(ctx_->framePool);
+    if (frame) {
+        deliver(frame);
+    }
+}
+
+bool VideoEventHandler::hasConsumers() const {
+    return std::atomic_load(&ctx_->videoRef) || (ctx_->videoQueue && ctx_->videoQueue->enabled()) ||
+           std::atomic_load(&ctx_->decoder);
+}
+
+void VideoEventHandler::deliver(AASDKFrame* frame) {
+    // The C API swaps these under the context mutex; hold what is current for this frame
+    auto decoder = std::atomic_load(&ctx_->decoder);
+    auto videoRef = std::atomic_load(&ctx_->videoRef);
+
+    auto kind = VideoFrameQueue::kindOf(frame->nal_flags);
+    if (decoder) {
+        // The decoder shares the payload; its reference is released once libavcodec is done
+        FramePool::retain(frame);
+        decoder->submit(frame, kind);
+    }
+
+    if (videoRef) {
+        videoRef->callback(frame, videoRef->userData);
+    } else if (ctx_->videoQueue && ctx_->videoQueue->enabled()) {
+        ctx_->videoQueue->push(frame, kind);
+    } else {
+        FramePool::release(frame);
+    }
+}
+
+void VideoEventHandler::resync() {
+    if (ctx_->videoQueue) {
+        ctx_->videoQueue->resync();
+    }
+    auto decoder = std::atomic_load(&ctx_->decoder);
+    if (decoder) {
+        decoder->resync();
+    }
+}
+
+void VideoEventHandler::requestKeyframe() {
+    if (!ctx_->videoChannel) {
+        return;
+    }
+    std::cerr << "No IDR since the resync, cycling video focus to request one" << std::endl;
+
+    // Losing and regaining focus makes the phone restart its encoder
+    const proto::enums::VideoFocusMode::Enum modes[] = {
+        proto::enums::VideoFocusMode::UNFOCUSED, proto::enums::VideoFocusMode::FOCUSED
+    };
+    for (auto mode : modes) {
+        proto::messages::VideoFocusIndication indication;
+        indication.set_focus_mode(mode);
+        indication.set_unrequested(true);
+
+        auto promise = channel::SendPromise::defer(ctx_->ioService);
+        promise->then([]() {}, [](const error::Error& e) {
+            std::cerr << "Failed to send video focus indication: " << e.what() << std::endl;
+        });
+        ctx_->videoChannel->sendVideoFocusIndication(indication, std::move(promise));
+    }
+}
+
 void VideoEventHandler::onChannelOpenRequest(const proto::messages::ChannelOpenRequest& request) {
     std::cerr << "Video channel open request, priority: " << request.priority() << std::endl;
 
@@ -246,6 +1071,7 @@ void VideoEventHandler::onChannelOpenRequest(const proto::messages::ChannelOpenR
         std::cerr << "Error: videoChannel not available" << std::endl;
         return;
     }
+    ctx_->timeline.markChannelOpen(messenger::ChannelId::VIDEO);
 
     // Send channel open response
     proto::messages::ChannelOpenResponse response;
@@ -273,19 +1099,34 @@ void VideoEventHandler::onAVChannelSetupRequest(const proto::messages::AVChannel
         std::cerr << "Error: videoChannel not available" << std::endl;
         return;
     }
+    ctx_->timeline.markAVSetup(messenger::ChannelId::VIDEO);
+
+    // Size frames and pool buffers for the mode the phone picked; the SPS confirms it later
+    VideoConfigTable::Mode mode;
+    if (ctx_->videoConfigs.select(request.config_index(), mode) && mode.width != 0) {
+        video_width_ = mode.width;
+        video_height_ = mode.height;
+        std::cerr << "Video mode: " << mode.width << "x" << mode.height << "@" << mode.fps
+                  << " margins " << mode.marginWidth << "x" << mode.marginHeight
+                  << " dpi " << mode.dpi << std::endl;
+
+        // About one bit per pixel per 60th of a second covers keyframes at projection bitrates
+        uint32_t fps = mode.fps != 0 ? mode.fps : 60;
+        ctx_->framePool.setCapacityHint(static_cast<size_t>(mode.width) * mode.height / 8 * 60 / fps);
+    } else {
+        std::cerr << "Video config " << request.config_index() << " was not advertised, keeping "
+                  << video_width_ << "x" << video_height_ << std::endl;
+    }
 
-    // TODO: Parse the actual video configuration based on config_index
-    // For now, assume standard 1280x720 H264 video
-    video_width_ = 1280;
-    video_height_ = 720;
-
     // Send setup response accepting the configuration
+    auto ackWindow = ctx_->ackWindow(messenger::ChannelId::VIDEO);
     proto::messages::AVChannelSetupResponse response;
     response.set_media_status(proto::enums::AVChannelSetupStatus::OK);
-    response.set_max_unacked(1);  // Allow 1 unacknowledged frame
+    response.set_max_unacked(ackWindow ? ackWindow->window() : 1);
     response.add_configs(request.config_index());  // Accept the requested config
 
-    std::cerr << "Accepting video config " << request.config_index() << std::endl;
+    std::cerr << "Accepting video config " << request.config_index()
+              << " (max unacked " << response.max_unacked() << ")" << std::endl;
 
     auto promise = channel::SendPromise::defer(ctx_->ioService);
     promise->then([]() {
@@ -302,8 +1143,12 @@ void VideoEventHandler::onAVChannelSetupRequest(const proto::messages::AVChannel
     }
 }
 
-void VideoEventHandler::onAVChannelStartIndication(const proto::messages::AVChannelStartIndication& /*indication*/) {
-    std::cerr << "Video stream started" << std::endl;
+void VideoEventHandler::onAVChannelStartIndication(const proto::messages::AVChannelStartIndication& indication) {
+    std::cerr << "Video stream started, session: " << indication.session() << std::endl;
+    if (auto ackWindow = ctx_->ackWindow(messenger::ChannelId::VIDEO)) {
+        ackWindow->start(indication.session());
+    }
+    ctx_->videoLag->reset();
     // Video frames will now start arriving in onAVMediaIndication/onAVMediaWithTimestampIndication
 
     // Continue receiving on video channel
@@ -363,6 +1208,62 @@ void VideoEventHandler::onChannelError(const error::Error& e) {
 }
 
 // Implement AudioEventHandler methods (after AASDKContext is defined)
+void AudioEventHandler::onAudioPayload(messenger::Timestamp::ValueType timestamp, uint32_t infoFlags,
+                                       const common::DataConstBuffer& buffer) {
+    ctx_->timeline.markFirstAudio();
+    int channel = channel_ptr_ && *channel_ptr_ ? AASDKContext::avChannel((*channel_ptr_)->getId()) : -1;
+    auto ackWindow = ctx_->ackWindowAt(channel);
+    uint64_t receivedNs = ackWindow ? ackWindow->received() : ConnectTimeline::nowNs();
+    ++sequence_;
+
+    if (buffer.cdata && format_.channels > 0 && channel >= 0 && !ctx_->audioFocus.active(channel)) {
+        // Paused for lack of audio focus: acked, but neither buffered nor delivered
+        ctx_->audioFocus.countDropped(channel, buffer.size / (format_.bit_depth / 8) / format_.channels);
+    } else if (buffer.cdata && format_.channels > 0) {
+        const int16_t* samples = reinterpret_cast<const int16_t*>(buffer.cdata);
+        uint32_t sample_count = buffer.size / (format_.bit_depth / 8);
+        AASDKMediaInfo info = {};
+        info.channel = channel;
+        info.flags = infoFlags;
+        info.timestamp = timestamp;
+        info.receive_ns = receivedNs;
+        info.sequence = sequence_;
+        if (channel >= 0 && ctx_->audioBuffers[channel]) {
+            ctx_->audioBuffers[channel]->write(samples, sample_count / format_.channels, info);
+        }
+        if (ctx_->audioCallbackV2) {
+            ctx_->audioCallbackV2(samples, sample_count, format_.channels, format_.sample_rate, &info,
+                                  ctx_->mediaUserDataV2);
+        } else if (callback_) {
+            callback_(samples, sample_count, format_.channels, format_.sample_rate, user_data_);
+        }
+    }
+
+    // The ring or callback hands the samples to the audio device, so the packet is consumed
+    if (ackWindow) {
+        ackWindow->consumed(receivedNs);
+    }
+}
+
+void AudioEventHandler::onAVChannelStopIndication(const proto::messages::AVChannelStopIndication& /*indication*/) {
+    std::cerr << "Audio stream stopped" << std::endl;
+
+    // Let the reader play out what is buffered without waiting for more
+    int channel = ctx_ && channel_ptr_ && *channel_ptr_ ? AASDKContext::avChannel((*channel_ptr_)->getId()) : -1;
+    if (channel >= 0 && ctx_->audioBuffers[channel]) {
+        ctx_->audioBuffers[channel]->endOfStream();
+    }
+}
+
+void AudioEventHandler::startAckSession(int32_t session) {
+    if (!channel_ptr_ || !*channel_ptr_) {
+        return;
+    }
+    if (auto ackWindow = ctx_->ackWindow((*channel_ptr_)->getId())) {
+        ackWindow->start(session);
+    }
+}
+
 void AudioEventHandler::onChannelOpenRequest(const proto::messages::ChannelOpenRequest& request) {
     std::cerr << "Audio channel open request, priority: " << request.priority() << std::endl;
 
@@ -370,6 +1271,7 @@ void AudioEventHandler::onChannelOpenRequest(const proto::messages::ChannelOpenR
         std::cerr << "Error: audio channel not available" << std::endl;
         return;
     }
+    ctx_->timeline.markChannelOpen((*channel_ptr_)->getId());
 
     // Send channel open response
     proto::messages::ChannelOpenResponse response;
@@ -395,20 +1297,20 @@ void AudioEventHandler::onAVChannelSetupRequest(const proto::messages::AVChannel
         std::cerr << "Error: audio channel not available" << std::endl;
         return;
     }
+    ctx_->timeline.markAVSetup((*channel_ptr_)->getId());
 
-    // TODO: Parse the actual audio configuration based on config_index
-    // For now, assume standard 48kHz 16-bit stereo PCM
-    sample_rate_ = 48000;
-    channels_ = 2;
-    bit_depth_ = 16;
+    // Only one configuration is advertised per stream, so config_index is always 0
+    format_ = AASDKContext::audioFormat(AASDKContext::avChannel((*channel_ptr_)->getId()));
 
     // Send setup response accepting the configuration
+    auto ackWindow = ctx_->ackWindow((*channel_ptr_)->getId());
     proto::messages::AVChannelSetupResponse response;
     response.set_media_status(proto::enums::AVChannelSetupStatus::OK);
-    response.set_max_unacked(1);  // Allow 1 unacknowledged frame
+    response.set_max_unacked(ackWindow ? ackWindow->window() : 1);
     response.add_configs(request.config_index());  // Accept the requested config
 
-    std::cerr << "Accepting audio config " << request.config_index() << std::endl;
+    std::cerr << "Accepting audio config " << request.config_index()
+              << " (max unacked " << response.max_unacked() << ")" << std::endl;
 
     auto promise = channel::SendPromise::defer(ctx_->ioService);
     promise->then([]() {
@@ -423,10 +1325,262 @@ void AudioEventHandler::onAVChannelSetupRequest(const proto::messages::AVChannel
     // The channel will automatically continue receiving after each message
 }
 
+MicEventHandler::MicEventHandler(AASDKContext* ctx, boost::asio::io_service::strand& strand)
+    : ctx_(ctx), strand_(strand), pumpTimer_(ctx->ioService) {}
+
+void MicEventHandler::receive() {
+    if (ctx_->avInputChannel) {
+        ctx_->avInputChannel->receive(shared_from_this());
+    }
+}
+
+void MicEventHandler::onChannelOpenRequest(const proto::messages::ChannelOpenRequest& request) {
+    std::cerr << "Microphone channel open request, priority: " << request.priority() << std::endl;
+    ctx_->timeline.markChannelOpen(messenger::ChannelId::AV_INPUT);
+
+    proto::messages::ChannelOpenResponse response;
+    response.set_status(proto::enums::Status::OK);
+
+    auto promise = channel::SendPromise::defer(ctx_->ioService);
+    promise->then([]() {}, [](const error::Error& e) {
+        std::cerr << "Failed to send microphone channel open response: " << e.what() << std::endl;
+    });
+    ctx_->avInputChannel->sendChannelOpenResponse(response, std::move(promise));
+    receive();
+}
+
+void MicEventHandler::onAVChannelSetupRequest(const proto::messages::AVChannelSetupRequest& request) {
+    std::cerr << "Microphone setup request received, config_index: " << request.config_index() << std::endl;
+    ctx_->timeline.markAVSetup(messenger::ChannelId::AV_INPUT);
+
+    // The only advertised configuration is 16 kHz mono, which is what MicCapture frames
+    proto::messages::AVChannelSetupResponse response;
+    response.set_media_status(proto::enums::AVChannelSetupStatus::OK);
+    response.set_max_unacked(1);
+    response.add_configs(request.config_index());
+
+    auto promise = channel::SendPromise::defer(ctx_->ioService);
+    promise->then([]() {}, [](const error::Error& e) {
+        std::cerr << "Failed to send microphone setup response: " << e.what() << std::endl;
+    });
+    ctx_->avInputChannel->sendAVChannelSetupResponse(response, std::move(promise));
+    receive();
+}
+
+void MicEventHandler::onAVInputOpenRequest(const proto::messages::AVInputOpenRequest& request) {
+    std::cerr << "Microphone " << (request.open() ? "open" : "close") << " request, max unacked "
+              << request.max_unacked() << std::endl;
+
+    MicCapture* mic = ctx_->micCapture();
+    if (mic) {
+        if (request.open()) {
+            mic->open(static_cast<uint32_t>(std::max<int32_t>(request.max_unacked(), 0)));
+            ctx_->micStateChanged(true);
+            pump();
+        } else {
+            boost::system::error_code ec;
+            pumpTimer_.cancel(ec);
+            ctx_->closeMic();
+        }
+    }
+
+    // Answered even without a capture source, or the phone waits on it forever
+    proto::messages::AVInputOpenResponse response;
+    response.set_session(0);
+    response.set_value(0);
+
+    auto promise = channel::SendPromise::defer(ctx_->ioService);
+    promise->then([]() {}, [](const error::Error& e) {
+        std::cerr << "Failed to send microphone open response: " << e.what() << std::endl;
+    });
+    ctx_->avInputChannel->sendAVInputOpenResponse(response, std::move(promise));
+    receive();
+}
+
+void MicEventHandler::onAVMediaAckIndication(const proto::messages::AVMediaAckIndication& indication) {
+    MicCapture* mic = ctx_->micCapture();
+    if (mic) {
+        // An ack frees its window slot, so whatever waited on it goes out right away
+        mic->acked(static_cast<uint32_t>(std::max<int32_t>(indication.value(), 1)));
+        mic->pump();
+    }
+    receive();
+}
+
+void MicEventHandler::onChannelError(const error::Error& e) {
+    std::cerr << "Microphone channel error: " << e.what()
+              << " (code: " << (int)e.getCode() << ", native: " << e.getNativeCode() << ")" << std::endl;
+}
+
+void MicEventHandler::pump() {
+    MicCapture* mic = ctx_->micCapture();
+    if (!mic || !mic->isOpen()) {
+        return;
+    }
+    mic->pump();
+
+    auto self = shared_from_this();
+    pumpTimer_.expires_from_now(boost::posix_time::milliseconds(std::max<uint32_t>(mic->periodMs() / 4, 1)));
+    pumpTimer_.async_wait(strand_.wrap([self](const boost::system::error_code& ec) {
+        if (!ec) {
+            self->pump();
+        }
+    }));
+}
+
+InputEventHandler::InputEventHandler(AASDKContext* ctx, boost::asio::io_service::strand& strand)
+    : ctx_(ctx), strand_(strand), open_(false), inFlight_(false) {}
+
+void InputEventHandler::receive() {
+    if (ctx_->inputChannel) {
+        ctx_->inputChannel->receive(shared_from_this());
+    }
+}
+
+void InputEventHandler::onChannelOpenRequest(const proto::messages::ChannelOpenRequest& request) {
+    std::cerr << "Input channel open request, priority: " << request.priority() << std::endl;
+    ctx_->timeline.markChannelOpen(messenger::ChannelId::INPUT);
+
+    proto::messages::ChannelOpenResponse response;
+    response.set_status(proto::enums::Status::OK);
+
+    auto promise = channel::SendPromise::defer(ctx_->ioService);
+    promise->then([]() {}, [](const error::Error& e) {
+        std::cerr << "Failed to send input channel open response: " << e.what() << std::endl;
+    });
+    ctx_->inputChannel->sendChannelOpenResponse(response, std::move(promise));
+
+    // Whatever was touched before the phone listened is stale
+    ctx_->input->reset();
+    open_ = true;
+    receive();
+}
+
+void InputEventHandler::onBindingRequest(const proto::messages::BindingRequest& request) {
+    std::cerr << "Input binding request for " << request.scan_codes_size() << " key codes" << std::endl;
+
+    proto::messages::BindingResponse response;
+    response.set_status(proto::enums::Status::OK);
+
+    auto promise = channel::SendPromise::defer(ctx_->ioService);
+    promise->then([]() {}, [](const error::Error& e) {
+        std::cerr << "Failed to send input binding response: " << e.what() << std::endl;
+    });
+    ctx_->inputChannel->sendBindingResponse(response, std::move(promise));
+    receive();
+}
+
+void InputEventHandler::onChannelError(const error::Error& e) {
+    std::cerr << "Input channel error: " << e.what()
+              << " (code: " << (int)e.getCode() << ", native: " << e.getNativeCode() << ")" << std::endl;
+}
+
+void InputEventHandler::flush() {
+    auto self = shared_from_this();
+    strand_.dispatch([self]() { self->sendNext(); });
+}
+
+void InputEventHandler::sendNext() {
+    InputBatcher::Batch batch;
+    if (inFlight_ || !open_ || !ctx_->inputChannel || !ctx_->input->next(&batch)) {
+        return;
+    }
+
+    proto::messages::InputEventIndication indication;
+    indication.set_timestamp(batch.timeNs / 1000);
+    if (batch.button) {
+        auto* event = indication.mutable_button_event()->add_button_events();
+        event->set_scan_code(batch.code);
+        event->set_is_pressed(batch.pressed);
+        event->set_meta(0);
+        event->set_long_press(false);
+    } else {
+        auto* touch = indication.mutable_touch_event();
+        for (uint32_t i = 0; i < batch.pointerCount; ++i) {
+            auto* location = touch->add_touch_location();
+            location->set_x(batch.pointers[i].x);
+            location->set_y(batch.pointers[i].y);
+            location->set_pointer_id(batch.pointers[i].id);
+        }
+        touch->set_touch_action(static_cast<proto::enums::TouchAction::Enum>(batch.action));
+        touch->set_action_index(batch.actionIndex);
+    }
+
+    // The next indication is built once this one is written, from whatever queued meanwhile
+    inFlight_ = true;
+    auto self = shared_from_this();
+    auto promise = channel::SendPromise::defer(strand_);
+    promise->then([self, batch]() {
+        self->ctx_->input->sent(batch);
+        self->inFlight_ = false;
+        self->sendNext();
+    }, [self](const error::Error& e) {
+        std::cerr << "Failed to send input event: " << e.what() << std::endl;
+        self->inFlight_ = false;
+        self->sendNext();
+    });
+    ctx_->inputChannel->sendInputEventIndication(indication, std::move(promise));
+}
+
+// Bring up the control channel on messenger and send the version request that starts
+// the handshake; shared by phone connections and replays
+static void startSession(AASDKContext* ctx, messenger::IMessenger::Pointer messenger) {
+    std::shared_ptr<SessionCapture> capture;
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        capture = ctx->capture;
+    }
+    ctx->messenger = capture ? std::make_shared<CapturingMessenger>(ctx->ioService, std::move(messenger), capture)
+                             : std::move(messenger);
+
+    ctx->timeline.markTransportUp();
+
+    // Create control strand and store it to keep it alive
+    ctx->controlStrand = std::make_unique<boost::asio::io_service::strand>(ctx->ioService);
+
+    // Create control channel using the stored strand
+    ctx->controlChannel = std::make_shared<channel::control::ControlServiceChannel>(
+        *ctx->controlStrand, ctx->messenger
+    );
+    
+    // Create control event handler and store it in context to keep it alive
+    ctx->controlEventHandler = std::make_shared<ControlEventHandler>(ctx);
+    
+    // Start receiving on control channel
+    ctx->controlChannel->receive(ctx->controlEventHandler);
+    
+    // Send version request to start handshake
+    auto versionPromise = messenger::SendPromise::defer(ctx->ioService);
+    versionPromise->then([]() {
+        std::cerr << "Version request sent" << std::endl;
+    }, [](const error::Error& e) {
+        std::cerr << "Version request failed: " << e.what() << std::endl;
+    });
+    ctx->controlChannel->sendVersionRequest(std::move(versionPromise));
+    ctx->connectionState.enter(AASDK_CONN_HANDSHAKE);
+}
+
 // Helper function to set up device connection
-static void setupDeviceConnection(AASDKContext* ctx, usb::DeviceHandle deviceHandle) {
+// Returns false if the transport could not be created; the caller decides whether to retry
+static bool setupDeviceConnection(AASDKContext* ctx, usb::DeviceHandle deviceHandle) {
+    // Claim the session under the lock aasdk_start_replay() claims it with, so a phone and
+    // a replay never build their channels over each other
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        if (ctx->replay) {
+            std::cerr << "Replay active, ignoring device" << std::endl;
+            return false;
+        }
+        ctx->connected = true;
+    }
+
     try {
         std::cerr << "Setting up device connection..." << std::endl;
+        ctx->connectionState.enter(AASDK_CONN_TRANSPORT);
+
+        // Devices that enumerate straight into AOAP mode never pass through the query chain
+        ctx->timeline.markUsbDiscovered();
+        ctx->timeline.markAoapSwitched();
 
         // Detach kernel driver if active (fixes LIBUSB_ERROR_BUSY)
         // Check interface 0 (AOAP uses interface 0)
@@ -449,7 +1603,10 @@ static void setupDeviceConnection(AASDKContext* ctx, usb::DeviceHandle deviceHan
         ctx->aoapDevice = usb::AOAPDevice::create(*ctx->usbWrapper, ctx->ioService, deviceHandle);
         if (!ctx->aoapDevice) {
             std::cerr << "Failed to create AOAPDevice" << std::endl;
-            return;
+            ctx->connectionState.enter(AASDK_CONN_FAILED);
+            std::lock_guard<std::mutex> lock(ctx->mutex);
+            ctx->connected = false;
+            return false;
         }
         
         // Create USB transport
@@ -471,32 +1628,9 @@ static void setupDeviceConnection(AASDKContext* ctx, usb::DeviceHandle deviceHan
         );
         
         // Create messenger
-        ctx->messenger = std::make_shared<messenger::Messenger>(
+        startSession(ctx, std::make_shared<messenger::Messenger>(
             ctx->ioService, ctx->messageInStream, ctx->messageOutStream
-        );
-
-        // Create control strand and store it to keep it alive
-        ctx->controlStrand = std::make_unique<boost::asio::io_service::strand>(ctx->ioService);
-
-        // Create control channel using the stored strand
-        ctx->controlChannel = std::make_shared<channel::control::ControlServiceChannel>(
-            *ctx->controlStrand, ctx->messenger
-        );
-        
-        // Create control event handler and store it in context to keep it alive
-        ctx->controlEventHandler = std::make_shared<ControlEventHandler>(ctx);
-        
-        // Start receiving on control channel
-        ctx->controlChannel->receive(ctx->controlEventHandler);
-        
-        // Send version request to start handshake
-        auto versionPromise = messenger::SendPromise::defer(ctx->ioService);
-        versionPromise->then([]() {
-            std::cerr << "Version request sent" << std::endl;
-        }, [](const error::Error& e) {
-            std::cerr << "Version request failed: " << e.what() << std::endl;
-        });
-        ctx->controlChannel->sendVersionRequest(std::move(versionPromise));
+        ));
         
         std::cerr << "Device connection setup complete, starting handshake..." << std::endl;
         
@@ -504,19 +1638,409 @@ static void setupDeviceConnection(AASDKContext* ctx, usb::DeviceHandle deviceHan
         if (ctx->connectionCallback) {
             ctx->connectionCallback(true, ctx->userData);
         }
-        ctx->connected = true;
+        return true;
         
     } catch (const std::exception& e) {
         std::cerr << "Failed to set up device connection: " << e.what() << std::endl;
+        ctx->connectionState.enter(AASDK_CONN_FAILED);
+        {
+            std::lock_guard<std::mutex> lock(ctx->mutex);
+            ctx->connected = false;
+        }
         if (ctx->connectionCallback) {
             ctx->connectionCallback(false, ctx->userData);
         }
+        return false;
+    }
+}
+
+// Device discovery and connection state machine:
+// ENUMERATE -> OPEN -> [AOAP_QUERY] -> TRANSPORT -> HANDSHAKE -> CONNECTED
+// Every step runs on the connector strand and every delay is a deadline_timer wait,
+// so bringing up a phone never blocks the io threads.
+class DeviceConnector : public std::enable_shared_from_this<DeviceConnector> {
+public:
+    explicit DeviceConnector(AASDKContext* ctx)
+        : ctx_(ctx), strand_(ctx->ioService), retryTimer_(ctx->ioService), queryTimer_(ctx->ioService),
+          candidateIndex_(0), attempt_(0), reenumerated_(false), switchPending_(false), replaying_(false),
+          cancelled_(false) {}
+
+    void start() {
+        auto self = shared_from_this();
+        strand_.dispatch([self]() {
+            // Note: In WSL2, USB hotplug events may not work properly
+            // So we rely primarily on enumeration of already-connected devices
+            std::cerr << "Starting USBHub to listen for hotplug events (may not work in WSL2)..." << std::endl;
+            self->startHotplug();
+
+            // Let devices stabilize after USB initialization before enumerating
+            self->enter(AASDK_CONN_ENUMERATE);
+            self->waitThen(SETTLE_DELAY_MS, [self]() { self->enumerate(); });
+        });
+    }
+
+    // Run a replay's session setup on this strand, after any phone setup already under
+    // way, and stop looking for phones: hotplugged devices and pending retries are ignored
+    void startReplay(std::function<void()> setup) {
+        auto self = shared_from_this();
+        strand_.post([self, setup]() {
+            self->replaying_ = true;
+            boost::system::error_code ec;
+            self->retryTimer_.cancel(ec);
+            setup();
+        });
+    }
+
+    // Called from AASDKContext::stop() once the io threads are down
+    void cancel() {
+        cancelled_ = true;
+        boost::system::error_code ec;
+        retryTimer_.cancel(ec);
+        queryTimer_.cancel(ec);
+    }
+
+private:
+    struct Candidate {
+        libusb_device* device;
+        uint16_t productId;
+        bool isAOAP;
+    };
+
+    static constexpr int SETTLE_DELAY_MS = 100;
+    static constexpr int OPEN_RETRY_DELAY_MS = 300;
+    static constexpr int CONNECT_RETRY_DELAY_MS = 500;
+    static constexpr int REENUMERATE_DELAY_MS = 1500;
+    static constexpr int MAX_ATTEMPTS = 3;
+    static constexpr int AOAP_QUERY_TIMEOUT_S = 30;
+
+    void enter(AASDKConnectionState state) {
+        ctx_->connectionState.enter(state);
+    }
+
+    // A phone showed up: start a fresh timeline unless this is the same phone coming
+    // back in AOAP mode after the query chain switched it
+    void beginTimeline() {
+        if (!switchPending_ || !ctx_->timeline.started()) {
+            ctx_->timeline.reset();
+            ctx_->timeline.markUsbDiscovered();
+        }
+        switchPending_ = false;
+    }
+
+    void waitThen(int delayMs, std::function<void()> next) {
+        retryTimer_.expires_from_now(boost::posix_time::milliseconds(delayMs));
+        retryTimer_.async_wait(strand_.wrap([this, next](const boost::system::error_code& ec) {
+            if (!ec && !cancelled_ && !replaying_) {
+                next();
+            }
+        }));
+    }
+
+    void startHotplug() {
+        auto self = shared_from_this();
+        auto promise = usb::IUSBHub::Promise::defer(strand_);
+        promise->then([self](usb::DeviceHandle deviceHandle) {
+            std::cerr << "USB device discovered via hotplug, setting up connection..." << std::endl;
+            self->onHotplugDevice(deviceHandle);
+        }, [self](const error::Error& error) {
+            std::cerr << "USB discovery failed: " << error.what() << std::endl;
+            if (self->ctx_->connectionCallback) {
+                self->ctx_->connectionCallback(false, self->ctx_->userData);
+            }
+        });
+
+        ctx_->usbHub->start(std::move(promise));
+        std::cerr << "USBHub started, waiting for new devices..." << std::endl;
+    }
+
+    void onHotplugDevice(usb::DeviceHandle deviceHandle) {
+        if (cancelled_) {
+            return;
+        }
+
+        auto state = ctx_->connectionState.state();
+        if (replaying_) {
+            std::cerr << "Replay active, ignoring hotplug device" << std::endl;
+        } else if (state == AASDK_CONN_TRANSPORT || state == AASDK_CONN_HANDSHAKE) {
+            std::cerr << "Connection already in progress, ignoring hotplug device" << std::endl;
+        } else {
+            // A hotplugged AOAP device supersedes any pending enumeration retry
+            beginTimeline();
+            boost::system::error_code ec;
+            retryTimer_.cancel(ec);
+            candidates_.clear();
+            deviceList_.reset();
+            setupDeviceConnection(ctx_, deviceHandle);
+        }
+
+        // Keep listening so a replugged phone is picked up again
+        startHotplug();
+    }
+
+    void enumerate() {
+        enter(AASDK_CONN_ENUMERATE);
+        std::cerr << "Enumerating already-connected devices (primary method for WSL2)..." << std::endl;
+
+        candidates_.clear();
+        candidateIndex_ = 0;
+        deviceList_.reset();
+
+        auto listResult = ctx_->usbWrapper->getDeviceList(deviceList_);
+        if (listResult < 0 || !deviceList_ || deviceList_->empty()) {
+            std::cerr << "No USB devices found or enumeration failed." << std::endl;
+            enter(AASDK_CONN_IDLE);
+            return;
+        }
+
+        std::cerr << "Found " << deviceList_->size() << " USB device(s), checking for Android Auto capable devices..." << std::endl;
+
+        for (auto deviceIter = deviceList_->begin(); deviceIter != deviceList_->end(); ++deviceIter) {
+            libusb_device_descriptor deviceDescriptor;
+            auto descResult = ctx_->usbWrapper->getDeviceDescriptor(*deviceIter, deviceDescriptor);
+            if (descResult != 0) {
+                std::cerr << "Failed to get device descriptor: " << descResult << std::endl;
+                continue;
+            }
+
+            // Skip USB hubs (Linux Foundation vendor ID 0x1d6b)
+            if (deviceDescriptor.idVendor == 0x1d6b) {
+                std::cerr << "Skipping USB hub: VID=0x" << std::hex << deviceDescriptor.idVendor
+                          << " PID=0x" << deviceDescriptor.idProduct << std::dec << std::endl;
+                continue;
+            }
+
+            // Check if device is already in AOAP mode (Google vendor ID + AOAP product ID)
+            bool isAOAP = (deviceDescriptor.idVendor == 0x18D1) &&
+                          (deviceDescriptor.idProduct == 0x2D00 || deviceDescriptor.idProduct == 0x2D01);
+
+            std::cerr << "Device: VID=0x" << std::hex << deviceDescriptor.idVendor
+                      << " PID=0x" << deviceDescriptor.idProduct << std::dec
+                      << (isAOAP ? " (AOAP mode)" : "") << std::endl;
+
+            if (deviceDescriptor.idVendor == 0x18D1) {
+                candidates_.push_back(Candidate{*deviceIter, deviceDescriptor.idProduct, isAOAP});
+            } else {
+                std::cerr << "Skipping non-Google device (VID=0x" << std::hex << deviceDescriptor.idVendor << std::dec << ")" << std::endl;
+            }
+        }
+
+        tryNextCandidate();
+    }
+
+    void tryNextCandidate() {
+        if (candidateIndex_ >= candidates_.size()) {
+            candidates_.clear();
+            deviceList_.reset();
+            if (ctx_->connectionState.state() != AASDK_CONN_FAILED) {
+                std::cerr << "No connectable device found, waiting for hotplug..." << std::endl;
+                enter(AASDK_CONN_IDLE);
+            }
+            return;
+        }
+
+        attempt_ = 0;
+        openCandidate();
+    }
+
+    void openCandidate() {
+        enter(AASDK_CONN_OPEN);
+        ctx_->connectionState.countOpenAttempt();
+
+        const Candidate candidate = candidates_[candidateIndex_];
+        if (attempt_ == 0) {
+            beginTimeline();
+        }
+
+        usb::DeviceHandle deviceHandle;
+        auto openResult = ctx_->usbWrapper->open(candidate.device, deviceHandle);
+
+        if (openResult != 0 || deviceHandle == nullptr) {
+            if (candidate.isAOAP) {
+                std::cerr << "Failed to open AOAP device: " << openResult << std::endl;
+                retryOrNext(OPEN_RETRY_DELAY_MS);
+            } else {
+                std::cerr << "Failed to open Google device (error " << openResult << "), trying next..." << std::endl;
+                ++candidateIndex_;
+                tryNextCandidate();
+            }
+            return;
+        }
+
+        if (!candidate.isAOAP) {
+            // Google device (likely Android phone) but not in AOAP mode yet
+            queryAccessoryMode(candidate, std::move(deviceHandle));
+            return;
+        }
+
+        if (attempt_ > 0) {
+            std::cerr << "Connection attempt " << (attempt_ + 1) << " of " << MAX_ATTEMPTS << "..." << std::endl;
+        } else {
+            std::cerr << "Device already in AOAP mode, setting up connection..." << std::endl;
+        }
+
+        if (setupDeviceConnection(ctx_, deviceHandle)) {
+            std::cerr << "Successfully connected to AOAP device!" << std::endl;
+            candidates_.clear();
+            deviceList_.reset();
+        } else {
+            // Device handle is consumed on error, need to reopen
+            deviceHandle.reset();
+            retryOrNext(CONNECT_RETRY_DELAY_MS);
+        }
+    }
+
+    void retryOrNext(int delayMs) {
+        if (++attempt_ < MAX_ATTEMPTS) {
+            std::cerr << "Retrying in " << delayMs << "ms..." << std::endl;
+            auto self = shared_from_this();
+            waitThen(delayMs, [self]() { self->openCandidate(); });
+        } else {
+            std::cerr << "All connection attempts failed, will rely on hotplug..." << std::endl;
+            enter(AASDK_CONN_FAILED);
+            ++candidateIndex_;
+            tryNextCandidate();
+        }
+    }
+
+    void queryAccessoryMode(const Candidate& candidate, usb::DeviceHandle deviceHandle) {
+        enter(AASDK_CONN_AOAP_QUERY);
+        std::cerr << "Opened Google device (VID=0x18d1 PID=0x" << std::hex << candidate.productId << std::dec << ")" << std::endl;
+        std::cerr << "Creating query chain to switch device to AOAP mode..." << std::endl;
+
+        // Only the first Google device is switched; the rest of the list is no longer needed
+        candidates_.clear();
+        deviceList_.reset();
+
+        ctx_->activeQueryChain = ctx_->queryChainFactory->create();
+        auto queryPromise = usb::IAccessoryModeQueryChain::Promise::defer(strand_);
+        auto self = shared_from_this();
+
+        // If the query chain takes too long, cancel it
+        queryTimer_.expires_from_now(boost::posix_time::seconds(AOAP_QUERY_TIMEOUT_S));
+        queryTimer_.async_wait(strand_.wrap([self](const boost::system::error_code& ec) {
+            if (!ec && self->ctx_->activeQueryChain) {
+                std::cerr << "========================================" << std::endl;
+                std::cerr << "Query chain timeout (" << AOAP_QUERY_TIMEOUT_S << "s) - canceling..." << std::endl;
+                std::cerr << "========================================" << std::endl;
+                std::cerr << "Possible issues:" << std::endl;
+                std::cerr << "1. Android phone may need to accept 'Allow USB accessory?' prompt" << std::endl;
+                std::cerr << "2. USB debugging must be enabled in Developer options" << std::endl;
+                std::cerr << "3. In WSL2, USB control transfers may not work properly" << std::endl;
+                std::cerr << "4. Try unplugging and replugging your phone" << std::endl;
+                std::cerr << "5. Check if Android Auto app is installed and set up" << std::endl;
+                std::cerr << "========================================" << std::endl;
+                self->ctx_->activeQueryChain->cancel();
+                self->ctx_->activeQueryChain.reset();
+                self->enter(AASDK_CONN_FAILED);
+            }
+        }));
+
+        std::cerr << "Query chain steps:" << std::endl;
+        std::cerr << "  1. PROTOCOL_VERSION" << std::endl;
+        std::cerr << "  2. SEND_MANUFACTURER (\"Android\")" << std::endl;
+        std::cerr << "  3. SEND_MODEL (\"Android Auto\")" << std::endl;
+        std::cerr << "  4. SEND_DESCRIPTION (\"Android Auto\")" << std::endl;
+        std::cerr << "  5. SEND_VERSION (\"2.0.1\")" << std::endl;
+        std::cerr << "  6. SEND_URI (\"https://f1xstudio.com\")" << std::endl;
+        std::cerr << "  7. SEND_SERIAL (\"HU-AAAAAA001\")" << std::endl;
+        std::cerr << "  8. START (switch to AOAP mode)" << std::endl;
+        std::cerr << "Watch your phone for 'Allow USB accessory?' prompt!" << std::endl;
+
+        queryPromise->then([self](usb::DeviceHandle) {
+            boost::system::error_code ec;
+            self->queryTimer_.cancel(ec);
+            std::cerr << "========================================" << std::endl;
+            std::cerr << "Device successfully switched to AOAP mode!" << std::endl;
+            std::cerr << "Waiting for it to re-enumerate as an accessory..." << std::endl;
+            std::cerr << "========================================" << std::endl;
+            self->ctx_->activeQueryChain.reset();
+            self->ctx_->timeline.markAoapSwitched();
+            self->switchPending_ = true;
+            self->enter(AASDK_CONN_IDLE);
+
+            // The phone drops off the bus and comes back with the AOAP product ID, so the
+            // handle from the query chain is stale. Hotplug normally catches the new device;
+            // re-enumerate once as a fallback for hosts without hotplug (WSL2).
+            if (!self->reenumerated_) {
+                self->reenumerated_ = true;
+                self->waitThen(REENUMERATE_DELAY_MS, [self]() {
+                    if (self->ctx_->connectionState.state() == AASDK_CONN_IDLE) {
+                        self->enumerate();
+                    }
+                });
+            }
+        }, [self](const error::Error& e) {
+            boost::system::error_code ec;
+            self->queryTimer_.cancel(ec);
+            std::cerr << "========================================" << std::endl;
+            std::cerr << "Query chain failed: " << e.what() << std::endl;
+            std::cerr << "Error code: " << (int)e.getCode() << std::endl;
+            std::cerr << "========================================" << std::endl;
+            self->ctx_->activeQueryChain.reset();
+            // USBHub is already running in background
+            self->enter(AASDK_CONN_FAILED);
+        });
+
+        ctx_->activeQueryChain->start(std::move(deviceHandle), std::move(queryPromise));
+    }
+
+    AASDKContext* ctx_;
+    boost::asio::io_service::strand strand_;
+    boost::asio::deadline_timer retryTimer_;
+    boost::asio::deadline_timer queryTimer_;
+    usb::DeviceListHandle deviceList_;  // Keeps candidate libusb_device pointers referenced
+    std::vector<Candidate> candidates_;
+    size_t candidateIndex_;
+    int attempt_;
+    bool reenumerated_;
+    bool switchPending_;  // Query chain switched a phone, its AOAP re-enumeration continues the timeline
+    bool replaying_;      // A replay owns the session; phones are ignored
+    std::atomic<bool> cancelled_;
+};
+
+void AASDKContext::stop() {
+    if (running) {
+        running = false;
+        work.reset();
+        // Pending libusb descriptor waits keep run() busy, so stop the reactor explicitly
+        ioService.stop();
+        joinIoThreads();
+        detachAckWindows();
+        closeMic();
+        if (videoQueue) {
+            videoQueue->close();
+        }
+        auto currentDecoder = std::atomic_load(&decoder);
+        if (currentDecoder) {
+            currentDecoder->stop();
+        }
+        if (usbEventLoop) {
+            usbEventLoop->stop();
+        }
+        if (connector) {
+            connector->cancel();
+        }
+        if (usbHub) {
+            usbHub->cancel();
+        }
+        if (activeQueryChain) {
+            activeQueryChain->cancel();
+        }
+        if (transport) {
+            transport->stop();
+        }
+        if (messenger) {
+            messenger->stop();
+        }
     }
 }
 
 // Implement ControlEventHandler methods (after AASDKContext is defined)
 void ControlEventHandler::onVersionResponse(uint16_t majorCode, uint16_t minorCode, proto::enums::VersionResponseStatus::Enum status) {
     std::cerr << "Version response: " << majorCode << "." << minorCode << " status: " << (int)status << std::endl;
+    if (ctx_) {
+        ctx_->timeline.markVersionResponse();
+    }
 
     if (!ctx_ || !ctx_->controlChannel || !ctx_->cryptor) {
         std::cerr << "ERROR: Cannot initiate handshake - required components missing" << std::endl;
@@ -566,6 +2090,8 @@ void ControlEventHandler::onHandshake(const common::DataConstBuffer& payload) {
         return;
     }
 
+    ctx_->timeline.markHandshakeRound();
+
     try {
         // Write the phone's handshake data to the cryptor
         ctx_->cryptor->writeHandshakeBuffer(payload);
@@ -601,6 +2127,7 @@ void ControlEventHandler::onHandshake(const common::DataConstBuffer& payload) {
             });
 
             ctx_->controlChannel->sendAuthComplete(authCompleteIndication, std::move(authPromise));
+            ctx_->timeline.markAuthComplete();
         }
 
         // Always re-register to receive the next message
@@ -620,6 +2147,7 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
         std::cerr << "Context is null in onServiceDiscoveryRequest" << std::endl;
         return;
     }
+    ctx_->timeline.markServiceDiscovery();
 
     // Create service discovery response
     proto::messages::ServiceDiscoveryResponse response;
@@ -647,9 +2175,10 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
     avInputChannelData->set_stream_type(proto::enums::AVStreamType::AUDIO);
     avInputChannelData->set_available_while_in_call(true);
     auto* avInputConfig = avInputChannelData->mutable_audio_config();
-    avInputConfig->set_sample_rate(16000);
-    avInputConfig->set_bit_depth(16);
-    avInputConfig->set_channel_count(1);
+    const AASDKAudioFormat& micFormat = AASDKContext::micFormat();
+    avInputConfig->set_sample_rate(micFormat.sample_rate);
+    avInputConfig->set_bit_depth(micFormat.bit_depth);
+    avInputConfig->set_channel_count(micFormat.channels);
 
     // 2. Add media audio service with configuration
     auto* mediaAudioService = response.add_channels();
@@ -659,9 +2188,10 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
     mediaAudioChannelData->set_audio_type(proto::enums::AudioType::MEDIA);
     mediaAudioChannelData->set_available_while_in_call(false);
     auto* mediaAudioConfig = mediaAudioChannelData->add_audio_configs();
-    mediaAudioConfig->set_sample_rate(48000);
-    mediaAudioConfig->set_bit_depth(16);
-    mediaAudioConfig->set_channel_count(2);
+    const AASDKAudioFormat& mediaAudioFormat = AASDKContext::audioFormat(AASDK_AV_CHANNEL_MEDIA_AUDIO);
+    mediaAudioConfig->set_sample_rate(mediaAudioFormat.sample_rate);
+    mediaAudioConfig->set_bit_depth(mediaAudioFormat.bit_depth);
+    mediaAudioConfig->set_channel_count(mediaAudioFormat.channels);
 
     // 3. Add speech audio service with configuration
     auto* speechAudioService = response.add_channels();
@@ -671,9 +2201,10 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
     speechAudioChannelData->set_audio_type(proto::enums::AudioType::SPEECH);
     speechAudioChannelData->set_available_while_in_call(true);
     auto* speechAudioConfig = speechAudioChannelData->add_audio_configs();
-    speechAudioConfig->set_sample_rate(16000);
-    speechAudioConfig->set_bit_depth(16);
-    speechAudioConfig->set_channel_count(1);
+    const AASDKAudioFormat& speechAudioFormat = AASDKContext::audioFormat(AASDK_AV_CHANNEL_SPEECH_AUDIO);
+    speechAudioConfig->set_sample_rate(speechAudioFormat.sample_rate);
+    speechAudioConfig->set_bit_depth(speechAudioFormat.bit_depth);
+    speechAudioConfig->set_channel_count(speechAudioFormat.channels);
 
     // 4. Add system audio service with configuration
     auto* systemAudioService = response.add_channels();
@@ -683,9 +2214,10 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
     systemAudioChannelData->set_audio_type(proto::enums::AudioType::SYSTEM);
     systemAudioChannelData->set_available_while_in_call(true);
     auto* systemAudioConfig = systemAudioChannelData->add_audio_configs();
-    systemAudioConfig->set_sample_rate(16000);
-    systemAudioConfig->set_bit_depth(16);
-    systemAudioConfig->set_channel_count(1);
+    const AASDKAudioFormat& systemAudioFormat = AASDKContext::audioFormat(AASDK_AV_CHANNEL_SYSTEM_AUDIO);
+    systemAudioConfig->set_sample_rate(systemAudioFormat.sample_rate);
+    systemAudioConfig->set_bit_depth(systemAudioFormat.bit_depth);
+    systemAudioConfig->set_channel_count(systemAudioFormat.channels);
 
     // 5. Add sensor service (GPS, etc.)
     auto* sensorService = response.add_channels();
@@ -700,26 +2232,64 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
     videoChannelData->set_available_while_in_call(true);  // Match OpenAuto
 
     // Add supported video configurations (provide multiple options for phone to choose)
-    // Primary: 480p at 60fps (matches OpenAuto defaults)
-    auto* videoConfig480p60 = videoChannelData->add_video_configs();
-    videoConfig480p60->set_video_resolution(proto::enums::VideoResolution::_480p);
-    videoConfig480p60->set_video_fps(proto::enums::VideoFPS::_60);
-    videoConfig480p60->set_margin_width(0);
-    videoConfig480p60->set_margin_height(0);
-    videoConfig480p60->set_dpi(140);  // Match OpenAuto
-    videoConfig480p60->set_additional_depth(0);
-
-    // Alternative: 720p at 60fps
-    auto* videoConfig720p60 = videoChannelData->add_video_configs();
-    videoConfig720p60->set_video_resolution(proto::enums::VideoResolution::_720p);
-    videoConfig720p60->set_video_fps(proto::enums::VideoFPS::_60);
-    videoConfig720p60->set_margin_width(0);
-    videoConfig720p60->set_margin_height(0);
-    videoConfig720p60->set_dpi(140);
-    videoConfig720p60->set_additional_depth(0);
+    // Primary: 480p at 60fps (matches OpenAuto defaults), alternative: 720p at 60fps.
+    // When the wrapper decodes, only modes the probe says this board sustains are offered,
+    // stepping a resolution down to 30fps before dropping it. The probe runs from init and
+    // is never waited for here: this handler holds an io thread, so a first-boot benchmark
+    // still in progress gets only the cheapest mode for this connection.
+    bool decoding = static_cast<bool>(std::atomic_load(&ctx_->decoder));
+    VideoCapabilityProbe::Status probe = decoding ? ctx_->videoProbe.status() : VideoCapabilityProbe::Status::FAILED;
+    bool probed = probe == VideoCapabilityProbe::Status::READY;
+    if (decoding && probe == VideoCapabilityProbe::Status::FAILED) {
+        std::cerr << "Video probe unavailable, advertising every video mode" << std::endl;
+    } else if (probe == VideoCapabilityProbe::Status::PENDING) {
+        std::cerr << "Video probe still running, advertising 480p30 only" << std::endl;
+    }
+    const proto::enums::VideoResolution::Enum resolutions[] = {
+        proto::enums::VideoResolution::_480p,
+        proto::enums::VideoResolution::_720p
+    };
+    const proto::enums::VideoFPS::Enum rates[] = {
+        proto::enums::VideoFPS::_60,
+        proto::enums::VideoFPS::_30
+    };
+    proto::data::VideoConfig candidate;
+    candidate.set_margin_width(0);
+    candidate.set_margin_height(0);
+    candidate.set_dpi(140);  // Match OpenAuto
+    candidate.set_additional_depth(0);
+    for (auto resolution : resolutions) {
+        if (probe == VideoCapabilityProbe::Status::PENDING) {
+            break;
+        }
+        for (auto rate : rates) {
+            candidate.set_video_resolution(resolution);
+            candidate.set_video_fps(rate);
+            VideoConfigTable::Mode mode = VideoConfigTable::modeOf(candidate);
+            if (!probed || ctx_->videoProbe.sustains(mode.width, mode.height, mode.fps)) {
+                *videoChannelData->add_video_configs() = candidate;
+                break;
+            }
+            std::cerr << "Not advertising " << mode.width << "x" << mode.height << "@" << mode.fps
+                      << ": " << ctx_->videoProbe.frameCostUs(mode.width, mode.height)
+                      << " us per frame" << std::endl;
+        }
+    }
+    if (videoChannelData->video_configs_size() == 0) {
+        // The phone needs at least one mode; offer the cheapest and let frames drop
+        if (probe != VideoCapabilityProbe::Status::PENDING) {
+            std::cerr << "No video mode runs in real time here, advertising 480p30 anyway" << std::endl;
+        }
+        candidate.set_video_resolution(proto::enums::VideoResolution::_480p);
+        candidate.set_video_fps(proto::enums::VideoFPS::_30);
+        *videoChannelData->add_video_configs() = candidate;
+    }
 
     // Store primary config for logging
-    auto* videoConfig = videoConfig480p60;
+    const auto* videoConfig = &videoChannelData->video_configs(0);
+
+    // The phone answers with an index into this list
+    ctx_->videoConfigs.advertise(videoChannelData->video_configs());
 
     // 7. Add Bluetooth service (MANDATORY - for phone pairing)
     auto* bluetoothService = response.add_channels();
@@ -733,7 +2303,7 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
     inputService->set_channel_id(static_cast<uint32_t>(messenger::ChannelId::INPUT));
     auto* inputChannelData = inputService->mutable_input_channel();
     // Add supported button keycodes (common Android Auto buttons)
-    inputChannelData->add_supported_keycodes(1); // KEYCODE_BACK
+    inputChannelData->add_supported_keycodes(4); // KEYCODE_BACK
     inputChannelData->add_supported_keycodes(3); // KEYCODE_HOME
     inputChannelData->add_supported_keycodes(24); // KEYCODE_VOLUME_UP
     inputChannelData->add_supported_keycodes(25); // KEYCODE_VOLUME_DOWN
@@ -742,10 +2312,10 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
     inputChannelData->add_supported_keycodes(88); // KEYCODE_MEDIA_PREVIOUS
     inputChannelData->add_supported_keycodes(126); // KEYCODE_MEDIA_PLAY
     inputChannelData->add_supported_keycodes(127); // KEYCODE_MEDIA_PAUSE
-    // Add touchscreen configuration: 1280x720 display
+    // Add touchscreen configuration, in the coordinates aasdk_send_touch() takes
     auto* touchConfig = inputChannelData->mutable_touch_screen_config();
-    touchConfig->set_width(1280);
-    touchConfig->set_height(720);
+    touchConfig->set_width(AASDKContext::TOUCH_WIDTH);
+    touchConfig->set_height(AASDKContext::TOUCH_HEIGHT);
 
     std::cerr << "Sending service discovery response with " << response.channels_size() << " services (with full config data)" << std::endl;
     std::cerr << "Video config: resolution=" << videoConfig->video_resolution()
@@ -765,6 +2335,7 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
     });
 
     ctx_->controlChannel->sendServiceDiscoveryResponse(response, std::move(promise));
+    ctx_->connectionState.enter(AASDK_CONN_CONNECTED);
 
     // Now set up the service channels
     std::cerr << "Setting up service channels..." << std::endl;
@@ -775,12 +2346,16 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
         *ctx_->videoStrand, ctx_->messenger
     );
 
-    // Create video event handler
+    // Create video event handler; a new phone sends its own SPS/PPS
+    ctx_->videoParameters.reset();
     ctx_->videoEventHandler = std::make_shared<VideoEventHandler>(ctx_->videoCallback, ctx_->userData, ctx_);
     ctx_->videoChannel->receive(ctx_->videoEventHandler);
 
     std::cerr << "Video channel setup complete" << std::endl;
 
+    // A new phone starts without audio focus; whatever the last one held is gone
+    ctx_->resetAudioFocus();
+
     // Create media audio strand and channel
     ctx_->mediaAudioStrand = std::make_unique<boost::asio::io_service::strand>(ctx_->ioService);
     ctx_->mediaAudioChannel = std::make_shared<channel::av::MediaAudioServiceChannel>(
@@ -823,7 +2398,37 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
 
     std::cerr << "System audio channel setup complete" << std::endl;
 
-    // TODO: Set up input channel for touch/button events
+    // Create the microphone strand and channel; a microphone the last phone left open is closed
+    ctx_->closeMic();
+    ctx_->avInputStrand = std::make_unique<boost::asio::io_service::strand>(ctx_->ioService);
+    ctx_->avInputChannel = std::make_shared<channel::av::AVInputServiceChannel>(
+        *ctx_->avInputStrand, ctx_->messenger
+    );
+    ctx_->micEventHandler = std::make_shared<MicEventHandler>(ctx_, *ctx_->avInputStrand);
+    ctx_->avInputChannel->receive(ctx_->micEventHandler);
+
+    std::cerr << "Microphone channel setup complete" << (ctx_->micCapture() ? "" : " (no capture source)") << std::endl;
+
+    // Flow control windows for this connection's audio/video channels
+    ctx_->detachAckWindows();
+    ctx_->setAckWindow(AASDK_AV_CHANNEL_VIDEO, makeAckWindow(ctx_, ctx_->videoChannel, ctx_->videoAckWindow));
+    ctx_->setAckWindow(AASDK_AV_CHANNEL_MEDIA_AUDIO, makeAckWindow(ctx_, ctx_->mediaAudioChannel, ctx_->audioAckWindow));
+    ctx_->setAckWindow(AASDK_AV_CHANNEL_SPEECH_AUDIO, makeAckWindow(ctx_, ctx_->speechAudioChannel, ctx_->audioAckWindow));
+    ctx_->setAckWindow(AASDK_AV_CHANNEL_SYSTEM_AUDIO, makeAckWindow(ctx_, ctx_->systemAudioChannel, ctx_->audioAckWindow));
+
+    // Create the input strand and channel; touches queued from now on wait for it to open
+    ctx_->inputStrand = std::make_unique<boost::asio::io_service::strand>(ctx_->ioService);
+    ctx_->inputChannel = std::make_shared<channel::input::InputServiceChannel>(
+        *ctx_->inputStrand, ctx_->messenger
+    );
+    auto inputHandler = std::make_shared<InputEventHandler>(ctx_, *ctx_->inputStrand);
+    {
+        std::lock_guard<std::mutex> lock(ctx_->mutex);
+        ctx_->inputEventHandler = inputHandler;
+    }
+    ctx_->inputChannel->receive(inputHandler);
+
+    std::cerr << "Input channel setup complete" << std::endl;
 
     std::cerr << "Service channels ready, waiting for channel open requests..." << std::endl;
 
@@ -841,6 +2446,8 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
     std::cerr << "  - Media audio channel: " << (ctx_->mediaAudioChannel ? "registered" : "NULL") << std::endl;
     std::cerr << "  - Speech audio channel: " << (ctx_->speechAudioChannel ? "registered" : "NULL") << std::endl;
     std::cerr << "  - System audio channel: " << (ctx_->systemAudioChannel ? "registered" : "NULL") << std::endl;
+    std::cerr << "  - Microphone channel: " << (ctx_->avInputChannel ? "registered" : "NULL") << std::endl;
+    std::cerr << "  - Input channel: " << (ctx_->inputChannel ? "registered" : "NULL") << std::endl;
     std::cerr << "  - Control channel: " << (ctx_->controlChannel ? "registered" : "NULL") << std::endl;
 
     // Set up a timer to log if we don't receive any channel open requests
@@ -858,23 +2465,39 @@ void ControlEventHandler::onServiceDiscoveryRequest(const proto::messages::Servi
 }
 
 void ControlEventHandler::onAudioFocusRequest(const proto::messages::AudioFocusRequest& request) {
-    std::cerr << "Audio focus request received" << std::endl;
-
     if (!ctx_) {
         std::cerr << "Context is null in onAudioFocusRequest" << std::endl;
         return;
     }
 
-    // Grant audio focus
-    proto::messages::AudioFocusResponse response;
-    response.set_audio_focus_state(proto::enums::AudioFocusState::GAIN);
+    AudioFocus::Request type = AudioFocus::Request::NONE;
+    switch (request.audio_focus_type()) {
+    case proto::enums::AudioFocusType::GAIN: type = AudioFocus::Request::GAIN; break;
+    case proto::enums::AudioFocusType::GAIN_TRANSIENT: type = AudioFocus::Request::GAIN_TRANSIENT; break;
+    case proto::enums::AudioFocusType::GAIN_NAVI: type = AudioFocus::Request::GAIN_NAVI; break;
+    case proto::enums::AudioFocusType::RELEASE: type = AudioFocus::Request::RELEASE; break;
+    default: break;
+    }
 
-    std::cerr << "Granting audio focus" << std::endl;
+    bool wasActive[AASDK_AV_CHANNEL_COUNT];
+    for (int i = 0; i < AASDK_AV_CHANNEL_COUNT; ++i) {
+        wasActive[i] = ctx_->audioFocus.active(i);
+    }
+    AASDKAudioFocusInfo focus = {};
+    bool changed = false;
+    AASDKAudioFocusState state = ctx_->audioFocus.request(type, &focus, &changed);
+    std::cerr << "Audio focus request " << request.audio_focus_type() << ", granting "
+              << AudioFocus::stateName(state) << std::endl;
+    if (changed) {
+        ctx_->audioFocusChanged(focus, wasActive);
+    }
 
-    auto promise = messenger::SendPromise::defer(ctx_->ioService);
-    promise->then([]() {
-        std::cerr << "Audio focus response sent" << std::endl;
-    }, [](const error::Error& e) {
+    // AASDKAudioFocusState shares AudioFocusState's values
+    proto::messages::AudioFocusResponse response;
+    response.set_audio_focus_state(static_cast<proto::enums::AudioFocusState::Enum>(state));
+
+    auto promise = messenger::SendPromise::defer(ctx_->ioService);
+    promise->then([]() {}, [](const error::Error& e) {
         std::cerr << "Failed to send audio focus response: " << e.what() << std::endl;
     });
 
@@ -936,13 +2559,56 @@ void ControlEventHandler::onChannelError(const error::Error& e) {
 // C callback wrappers
 extern "C" {
 
+void aasdk_default_init_options(AASDKInitOptions* options) {
+    if (!options) return;
+
+    options->io_threads = 1;
+    for (auto& cpu : options->io_thread_cpus) {
+        cpu = -1;
+    }
+    options->video_queue_depth = AASDK_DEFAULT_VIDEO_QUEUE_DEPTH;
+    options->video_ack_window = AASDK_DEFAULT_VIDEO_ACK_WINDOW;
+    options->audio_ack_window = AASDK_DEFAULT_AUDIO_ACK_WINDOW;
+    options->video_lag_threshold_ms = AASDK_DEFAULT_VIDEO_LAG_THRESHOLD_MS;
+    options->audio_ring_ms = 0;
+}
+
 AASDKHandle aasdk_init(VideoFrameCallback video_cb, AudioDataCallback audio_cb, ConnectionStatusCallback conn_cb, void* user_data) {
+    return aasdk_init_with_options(video_cb, audio_cb, conn_cb, user_data, nullptr);
+}
+
+AASDKHandle aasdk_init_with_options(VideoFrameCallback video_cb, AudioDataCallback audio_cb, ConnectionStatusCallback conn_cb, void* user_data, const AASDKInitOptions* options) {
+    AASDKInitOptions resolvedOptions;
+    aasdk_default_init_options(&resolvedOptions);
+    if (options) {
+        resolvedOptions = *options;
+    }
+
     try {
         auto* ctx = new AASDKContext();
         ctx->videoCallback = video_cb;
         ctx->audioCallback = audio_cb;
         ctx->connectionCallback = conn_cb;
         ctx->userData = user_data;
+        ctx->videoQueue = std::make_unique<VideoFrameQueue>(
+            std::min<uint32_t>(resolvedOptions.video_queue_depth, AASDK_MAX_VIDEO_QUEUE_DEPTH));
+        ctx->videoLag = std::make_shared<VideoLagController>(resolvedOptions.video_lag_threshold_ms);
+        ctx->videoQueue->setLagController(ctx->videoLag);
+        ctx->input = std::make_shared<InputBatcher>(AASDKContext::TOUCH_WIDTH, AASDKContext::TOUCH_HEIGHT);
+        // Measure (or recall) what this board can decode long before a phone asks
+        if (H264Decoder::available()) {
+            ctx->videoProbe.start();
+        }
+        ctx->videoAckWindow = std::max<uint32_t>(1, std::min<uint32_t>(resolvedOptions.video_ack_window, AASDK_MAX_ACK_WINDOW));
+        ctx->audioAckWindow = std::max<uint32_t>(1, std::min<uint32_t>(resolvedOptions.audio_ack_window, AASDK_MAX_ACK_WINDOW));
+        uint32_t audioRingMs = std::min<uint32_t>(resolvedOptions.audio_ring_ms, AASDK_MAX_AUDIO_RING_MS);
+        AASDKJitterConfig jitterConfig;
+        aasdk_default_jitter_config(&jitterConfig);
+        for (int i = AASDK_AV_CHANNEL_MEDIA_AUDIO; audioRingMs > 0 && i < AASDK_AV_CHANNEL_COUNT; ++i) {
+            const AASDKAudioFormat& format = AASDKContext::audioFormat(i);
+            ctx->audioBuffers[i] = std::make_unique<AudioJitterBuffer>(format.sample_rate / 1000 * audioRingMs, format,
+                                                                       jitterConfig);
+        }
         
         // Initialize libusb
         libusb_context* usbContext = nullptr;
@@ -971,27 +2637,19 @@ AASDKHandle aasdk_init(VideoFrameCallback video_cb, AudioDataCallback audio_cb,
         ctx->usbHub = std::make_shared<usb::USBHub>(
             *ctx->usbWrapper, ctx->ioService, *ctx->queryChainFactory
         );
+
+        // Create the device connection state machine
+        ctx->connector = std::make_shared<DeviceConnector>(ctx);
         
-        // Start IO service thread
+        // Register libusb's file descriptors with the io_service reactor so USB
+        // completions wake the io thread instead of being polled for
+        ctx->usbEventLoop = std::make_unique<USBEventLoop>(ctx->ioService, usbContext);
+        ctx->usbEventLoop->start();
+
+        // Start IO service threads
         ctx->work = std::make_unique<boost::asio::io_service::work>(ctx->ioService);
         ctx->running = true;
-        ctx->ioThread = std::thread([ctx]() {
-            try {
-                while (ctx->running) {
-                    // Run io_service with timeout to allow libusb event handling
-                    ctx->ioService.poll();  // Process ready handlers without blocking
-
-                    // Handle libusb events with short timeout
-                    struct timeval tv = {0, 100000}; // 100ms timeout
-                    libusb_handle_events_timeout_completed(ctx->usbContext, &tv, nullptr);
-
-                    // Small sleep to prevent busy waiting
-                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "IO service thread error: " << e.what() << std::endl;
-            }
-        });
+        ctx->startIoThreads(resolvedOptions);
         
         std::cerr << "AASDK initialized successfully" << std::endl;
         return static_cast<AASDKHandle>(ctx);
@@ -1001,6 +2659,486 @@ AASDKHandle aasdk_init(VideoFrameCallback video_cb, AudioDataCallback audio_cb,
     }
 }
 
+void aasdk_set_media_callbacks_v2(AASDKHandle handle, VideoFrameCallbackV2 video_cb, AudioDataCallbackV2 audio_cb, void* user_data) {
+    if (!handle) return;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+    ctx->videoCallbackV2 = video_cb;
+    ctx->audioCallbackV2 = audio_cb;
+    ctx->mediaUserDataV2 = user_data;
+}
+
+void aasdk_set_video_frame_ref_callback(AASDKHandle handle, VideoFrameRefCallback callback, void* user_data) {
+    if (!handle) return;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+    std::shared_ptr<const AASDKContext::VideoRefSink> sink;
+    if (callback) {
+        sink = std::make_shared<const AASDKContext::VideoRefSink>(AASDKContext::VideoRefSink{callback, user_data});
+    }
+    std::atomic_store(&ctx->videoRef, sink);
+    if (callback) {
+        ctx->primeVideoConsumers();
+    }
+}
+
+AASDKFrame* aasdk_video_queue_pop(AASDKHandle handle, uint32_t timeout_ms) {
+    if (!handle) return nullptr;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    if (!ctx->videoQueue) return nullptr;
+    return ctx->videoQueue->pop(timeout_ms);
+}
+
+bool aasdk_set_decoded_frame_callback(AASDKHandle handle, DecodedFrameCallback callback, void* user_data) {
+    if (!handle) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+
+    ctx->decodedCallback = callback;
+    ctx->decodedUserData = user_data;
+    return ctx->restartDecoder();
+}
+
+bool aasdk_enable_frame_ring(AASDKHandle handle, uint32_t slot_count, uint32_t max_width, uint32_t max_height) {
+    if (!handle) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    if (!H264Decoder::available()) {
+        std::cerr << "Frame ring needs native decoding: wrapper built without libavcodec" << std::endl;
+        return false;
+    }
+    if (slot_count == 0) {
+        slot_count = AASDK_DEFAULT_FRAME_RING_SLOTS;
+    }
+    if (max_width == 0 || max_height == 0) {
+        max_width = 1280;
+        max_height = 720;
+    }
+
+    auto ring = FrameRing::create(slot_count, max_width, max_height);
+    if (!ring) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+    ctx->frameRing = ring;
+    if (!ctx->restartDecoder()) {
+        ctx->frameRing.reset();
+        return false;
+    }
+    return true;
+}
+
+bool aasdk_get_frame_ring(AASDKHandle handle, AASDKFrameRingInfo* info) {
+    if (!handle || !info) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+    if (!ctx->frameRing) {
+        return false;
+    }
+    ctx->frameRing->info(info);
+    return true;
+}
+
+void aasdk_disable_frame_ring(AASDKHandle handle) {
+    if (!handle) return;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+    if (!ctx->frameRing) {
+        return;
+    }
+    // The decoder holds its own reference; stopping it closes the descriptors
+    ctx->frameRing.reset();
+    ctx->restartDecoder();
+}
+
+bool aasdk_start_capture(AASDKHandle handle, const char* path, uint64_t capacity_bytes) {
+    if (!handle || !path) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    auto capture = SessionCapture::open(path, capacity_bytes);
+    if (!capture) {
+        return false;
+    }
+
+    std::shared_ptr<SessionCapture> previous;
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        previous = std::move(ctx->capture);
+        ctx->capture = capture;
+    }
+    // Closes the previous file even though a live connection still references it
+    if (previous) {
+        previous->stop();
+    }
+    return true;
+}
+
+void aasdk_stop_capture(AASDKHandle handle) {
+    if (!handle) return;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::shared_ptr<SessionCapture> capture;
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        capture = std::move(ctx->capture);
+    }
+    if (capture) {
+        capture->stop();
+    }
+}
+
+bool aasdk_start_replay(AASDKHandle handle, const char* path, double speed) {
+    if (!handle || !path || speed < 0) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::shared_ptr<SessionReplay> replay = SessionReplay::open(path);
+    if (!replay) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        if (!ctx->running || !ctx->connector) {
+            std::cerr << "AASDK context is not running" << std::endl;
+            return false;
+        }
+        if (ctx->replay || ctx->connected) {
+            std::cerr << "Replay: a session is already active" << std::endl;
+            return false;
+        }
+        // A phone setting up from now on finds the replay and backs off
+        ctx->replay = replay;
+        ctx->connected = true;
+    }
+
+    std::cerr << "Replaying " << path << " at " << (speed > 0 ? std::to_string(speed) + "x" : std::string("full speed"))
+              << std::endl;
+
+    // Phone sessions are set up on the connector strand, so the replay's is too
+    ctx->connector->startReplay([ctx, replay, speed]() {
+        ctx->timeline.reset();
+        startSession(ctx, std::make_shared<ReplayMessenger>(replay));
+
+        // The phone's half of the version and TLS exchange only makes sense to the cryptor that
+        // negotiated it; the replay starts at service discovery, which the channel is armed for
+        replay->start(speed, [](const capture::CaptureRecord& record) {
+            return record.channel != static_cast<uint8_t>(messenger::ChannelId::CONTROL) ||
+                   (record.messageId != proto::ids::ControlMessage::VERSION_RESPONSE &&
+                    record.messageId != proto::ids::ControlMessage::SSL_HANDSHAKE);
+        });
+
+        if (ctx->connectionCallback) {
+            ctx->connectionCallback(true, ctx->userData);
+        }
+    });
+    return true;
+}
+
+bool aasdk_get_replay_stats(AASDKHandle handle, AASDKReplayStats* stats) {
+    if (!handle || !stats) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::shared_ptr<SessionReplay> replay;
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        replay = ctx->replay;
+    }
+    if (!replay) {
+        return false;
+    }
+
+    *stats = AASDKReplayStats();
+    replay->snapshot(stats);
+    replay->handlerLatency(static_cast<uint8_t>(messenger::ChannelId::CONTROL), &stats->control);
+    const messenger::ChannelId avChannels[] = {
+        messenger::ChannelId::VIDEO, messenger::ChannelId::MEDIA_AUDIO,
+        messenger::ChannelId::SPEECH_AUDIO, messenger::ChannelId::SYSTEM_AUDIO
+    };
+    for (auto id : avChannels) {
+        replay->handlerLatency(static_cast<uint8_t>(id), &stats->handler[AASDKContext::avChannel(id)]);
+    }
+    return true;
+}
+
+bool aasdk_get_audio_format(AASDKHandle handle, AASDKAVChannel stream, AASDKAudioFormat* format) {
+    if (!handle || !format || stream < AASDK_AV_CHANNEL_MEDIA_AUDIO || stream >= AASDK_AV_CHANNEL_COUNT) {
+        return false;
+    }
+    *format = AASDKContext::audioFormat(stream);
+    return true;
+}
+
+uint32_t aasdk_audio_read(AASDKHandle handle, AASDKAVChannel stream, int16_t* samples, uint32_t frames,
+                          AASDKAudioReadInfo* info) {
+    if (info) {
+        *info = AASDKAudioReadInfo();
+    }
+    if (!handle || !samples || stream < 0 || stream >= AASDK_AV_CHANNEL_COUNT) return 0;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    AudioJitterBuffer* buffer = ctx->audioBuffers[stream].get();
+    return buffer ? buffer->read(samples, frames, info) : 0;
+}
+
+void aasdk_default_jitter_config(AASDKJitterConfig* config) {
+    if (!config) return;
+
+    config->min_ms = 20;
+    config->max_ms = 200;
+}
+
+bool aasdk_set_jitter_config(AASDKHandle handle, AASDKAVChannel stream, const AASDKJitterConfig* config) {
+    if (!handle || !config || stream < 0 || stream >= AASDK_AV_CHANNEL_COUNT) return false;
+
+    AudioJitterBuffer* buffer = static_cast<AASDKContext*>(handle)->audioBuffers[stream].get();
+    if (!buffer) return false;
+    buffer->configure(*config);
+    return true;
+}
+
+void aasdk_default_mixer_config(AASDKMixerConfig* config) {
+    if (!config) return;
+
+    config->sample_rate = 48000;
+    config->channels = 2;
+    config->period_frames = 480;
+    config->duck_gain = 0.2f;
+    config->duck_attack_ms = 50;
+    config->duck_release_ms = 300;
+}
+
+bool aasdk_enable_mixer(AASDKHandle handle, const AASDKMixerConfig* config) {
+    if (!handle) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    AASDKMixerConfig resolved;
+    aasdk_default_mixer_config(&resolved);
+    if (config) {
+        resolved = *config;
+    }
+    if (resolved.sample_rate == 0 || resolved.channels < 1 || resolved.channels > 2 ||
+        resolved.period_frames == 0 || resolved.period_frames > AASDK_MAX_MIXER_PERIOD_FRAMES ||
+        !(resolved.duck_gain >= 0.0f && resolved.duck_gain <= 1.0f)) {
+        std::cerr << "Invalid mixer configuration" << std::endl;
+        return false;
+    }
+
+    AudioJitterBuffer* buffers[AASDK_AV_CHANNEL_COUNT];
+    for (int i = 0; i < AASDK_AV_CHANNEL_COUNT; ++i) {
+        buffers[i] = ctx->audioBuffers[i].get();
+    }
+    if (!buffers[AASDK_AV_CHANNEL_MEDIA_AUDIO]) {
+        std::cerr << "Mixer needs audio rings (AASDKInitOptions::audio_ring_ms)" << std::endl;
+        return false;
+    }
+
+    auto mixer = std::make_shared<AudioMixer>(resolved, buffers);
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+    // The device callback mixes without a lock, so a mixer is never replaced once enabled
+    if (ctx->mixer) {
+        std::cerr << "Audio mixer already enabled" << std::endl;
+        return false;
+    }
+    std::cerr << "Audio mixer: " << resolved.sample_rate << " Hz x" << resolved.channels << ", "
+              << resolved.period_frames << " frame periods, " << AudioMixer::isaName(mixer->isa()) << std::endl;
+    ctx->mixer = std::move(mixer);
+    ctx->mixerOutput.store(ctx->mixer.get(), std::memory_order_release);
+    return true;
+}
+
+uint32_t aasdk_audio_mix(AASDKHandle handle, int16_t* samples, uint32_t frames) {
+    if (!handle || !samples) return 0;
+
+    // Set once by aasdk_enable_mixer() and kept until aasdk_deinit()
+    AudioMixer* mixer = static_cast<AASDKContext*>(handle)->mixerOutput.load(std::memory_order_acquire);
+    if (!mixer) return 0;
+    mixer->mix(samples, frames);
+    return frames;
+}
+
+void aasdk_set_stream_gain(AASDKHandle handle, AASDKAVChannel stream, float gain) {
+    if (!handle) return;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::shared_ptr<AudioMixer> mixer;
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        mixer = ctx->mixer;
+    }
+    if (mixer) {
+        mixer->setGain(stream, gain);
+    }
+}
+
+void aasdk_set_audio_focus_callback(AASDKHandle handle, AudioFocusCallback callback, void* user_data) {
+    if (!handle) return;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+    ctx->audioFocusCallback = callback;
+    ctx->audioFocusUserData = user_data;
+}
+
+void aasdk_default_mic_config(AASDKMicConfig* config) {
+    if (!config) return;
+
+    config->period_ms = 20;
+    config->ring_ms = 200;
+    config->max_latency_ms = 100;
+}
+
+bool aasdk_enable_mic(AASDKHandle handle, const AASDKMicConfig* config, MicStateCallback state_callback,
+                      void* user_data) {
+    if (!handle) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    AASDKMicConfig resolved;
+    aasdk_default_mic_config(&resolved);
+    if (config) {
+        resolved = *config;
+    }
+    if (resolved.period_ms == 0 || resolved.max_latency_ms < resolved.period_ms ||
+        resolved.ring_ms < resolved.max_latency_ms || resolved.ring_ms > AASDK_MAX_AUDIO_RING_MS) {
+        std::cerr << "Invalid microphone configuration" << std::endl;
+        return false;
+    }
+
+    // Payloads go out on the AV_INPUT strand, which is the only caller of pump()
+    auto mic = std::make_shared<MicCapture>(AASDKContext::micFormat(), resolved,
+        [ctx](uint64_t timestampUs, const int16_t* samples, uint32_t frames) {
+            auto service = ctx->avInputChannel;
+            if (!service) {
+                return false;
+            }
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(samples);
+            common::Data data(bytes, bytes + frames * sizeof(int16_t));
+
+            auto promise = channel::SendPromise::defer(ctx->ioService);
+            promise->then([]() {}, [](const error::Error& e) {
+                std::cerr << "Failed to send microphone audio: " << e.what() << std::endl;
+            });
+            service->sendAVMediaWithTimestampIndication(timestampUs, data, std::move(promise));
+            return true;
+        });
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+    // The capture callback and the AV_INPUT strand use the mic without a lock, so it is
+    // never replaced once enabled
+    if (ctx->mic) {
+        std::cerr << "Microphone already enabled" << std::endl;
+        return false;
+    }
+    std::cerr << "Microphone: " << resolved.period_ms << " ms payloads, at most " << resolved.max_latency_ms
+              << " ms behind" << std::endl;
+    ctx->mic = std::move(mic);
+    ctx->micStateCallback = state_callback;
+    ctx->micUserData = user_data;
+    ctx->micInput.store(ctx->mic.get(), std::memory_order_release);
+    return true;
+}
+
+uint32_t aasdk_mic_write(AASDKHandle handle, const int16_t* samples, uint32_t frames, uint64_t capture_ns) {
+    if (!handle || !samples) return 0;
+
+    // Set once by aasdk_enable_mic() and kept until aasdk_deinit()
+    MicCapture* mic = static_cast<AASDKContext*>(handle)->micCapture();
+    return mic ? mic->write(samples, frames, capture_ns) : 0;
+}
+
+bool aasdk_mic_play_wav(AASDKHandle handle, const char* path, bool loop) {
+    if (!handle) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+    ctx->micWav.reset();
+    if (!path) {
+        return true;
+    }
+    if (!ctx->mic) {
+        std::cerr << "WAV microphone needs aasdk_enable_mic()" << std::endl;
+        return false;
+    }
+
+    auto source = WavSource::open(path, AASDKContext::micFormat().sample_rate);
+    if (!source) {
+        return false;
+    }
+    // Chunks the size of a typical capture period, 10 ms
+    std::shared_ptr<MicCapture> mic = ctx->mic;
+    source->start([mic](const int16_t* samples, uint32_t frames, uint64_t captureNs) {
+        mic->write(samples, frames, captureNs);
+    }, source->sampleRate() / 100, loop);
+    std::cerr << "Microphone plays " << path << " (" << source->samples().size() * 1000 / source->sampleRate()
+              << " ms" << (loop ? ", looped" : "") << ")" << std::endl;
+    ctx->micWav = std::move(source);
+    return true;
+}
+
+bool aasdk_get_video_config(AASDKHandle handle, AASDKVideoConfig* config) {
+    if (!handle || !config) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    VideoConfigTable::Mode mode;
+    H264Parser::SpsInfo info;
+    bool negotiated = ctx->videoConfigs.selected(mode);
+    bool parsed = ctx->videoParameters.info(info);
+    if (!negotiated && !parsed) {
+        return false;
+    }
+
+    *config = AASDKVideoConfig();
+    if (negotiated) {
+        config->width = mode.width;
+        config->height = mode.height;
+        config->fps = mode.fps;
+        config->margin_width = mode.marginWidth;
+        config->margin_height = mode.marginHeight;
+        config->dpi = mode.dpi;
+    }
+    // The SPS describes what is actually being sent
+    if (parsed) {
+        config->width = info.width;
+        config->height = info.height;
+        config->profile_idc = info.profile;
+        config->level_idc = info.level;
+    }
+    return true;
+}
+
+bool aasdk_video_prime(AASDKHandle handle) {
+    if (!handle) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    std::lock_guard<std::mutex> lock(ctx->mutex);
+    return ctx->primeVideoConsumers();
+}
+
+bool aasdk_convert_frame(const AASDKDecodedFrame* frame, uint8_t* dst, uint32_t dst_stride,
+                         uint32_t dst_width, uint32_t dst_height, int32_t dst_format) {
+    if (!frame) return false;
+
+    // Scaling scratch is per thread so decoder threads never share it
+    thread_local YuvConverter converter;
+    return converter.convert(*frame, dst, dst_stride, dst_width, dst_height,
+                             static_cast<AASDKRgbFormat>(dst_format));
+}
+
+void aasdk_frame_acquire(AASDKFrame* frame) {
+    if (!frame) return;
+    FramePool::retain(frame);
+}
+
+void aasdk_frame_release(AASDKFrame* frame) {
+    if (!frame) return;
+    FramePool::release(frame);
+}
+
 bool aasdk_start(AASDKHandle handle) {
     if (!handle) {
         std::cerr << "Invalid AASDK handle" << std::endl;
@@ -1017,224 +3155,14 @@ bool aasdk_start(AASDKHandle handle) {
             return false;
         }
         
-        if (!ctx->usbHub) {
+        if (!ctx->usbHub || !ctx->connector) {
             std::cerr << "USBHub is not initialized" << std::endl;
             return false;
         }
         
-        // Dispatch the start operation to the io_service thread to ensure proper context
-        // This ensures all AASDK operations happen on the correct thread
-        boost::asio::post(ctx->ioService, [ctx]() {
-            try {
-                // Helper function to start USBHub for hotplug events
-                auto startUSBHub = [ctx]() {
-                    auto promise = usb::IUSBHub::Promise::defer(ctx->ioService);
-                    promise->then([ctx](usb::DeviceHandle deviceHandle) {
-                        std::cerr << "USB device discovered via hotplug, setting up connection..." << std::endl;
-                        setupDeviceConnection(ctx, deviceHandle);
-                    }, [ctx](const error::Error& error) {
-                        std::cerr << "USB discovery failed: " << error.what() << std::endl;
-                        if (ctx->connectionCallback) {
-                            ctx->connectionCallback(false, ctx->userData);
-                        }
-                    });
-                    
-                    ctx->usbHub->start(std::move(promise));
-                    std::cerr << "USBHub started, waiting for new devices..." << std::endl;
-                };
-                
-                // Note: In WSL2, USB hotplug events may not work properly
-                // So we rely primarily on enumeration of already-connected devices
-                // Start USBHub in background for hotplug (may not work in WSL2)
-                std::cerr << "Starting USBHub to listen for hotplug events (may not work in WSL2)..." << std::endl;
-                startUSBHub();
-                
-                // Enumerate already-connected devices - this is the primary method for WSL2
-                std::cerr << "Enumerating already-connected devices (primary method for WSL2)..." << std::endl;
-
-                // Add small delay to let devices stabilize after USB initialization
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-                usb::DeviceListHandle deviceListHandle;
-                auto listResult = ctx->usbWrapper->getDeviceList(deviceListHandle);
-                
-                if (listResult >= 0 && !deviceListHandle->empty()) {
-                    std::cerr << "Found " << deviceListHandle->size() << " USB device(s), checking for Android Auto capable devices..." << std::endl;
-                    
-                    // Try each device
-                    for (auto deviceIter = deviceListHandle->begin(); deviceIter != deviceListHandle->end(); ++deviceIter) {
-                        // First check device descriptor to see if it's already in AOAP mode
-                        libusb_device_descriptor deviceDescriptor;
-                        auto descResult = ctx->usbWrapper->getDeviceDescriptor(*deviceIter, deviceDescriptor);
-                        
-                        if (descResult == 0) {
-                            // Skip USB hubs (Linux Foundation vendor ID 0x1d6b)
-                            if (deviceDescriptor.idVendor == 0x1d6b) {
-                                std::cerr << "Skipping USB hub: VID=0x" << std::hex << deviceDescriptor.idVendor 
-                                         << " PID=0x" << deviceDescriptor.idProduct << std::dec << std::endl;
-                                continue;
-                            }
-                            
-                            // Check if device is already in AOAP mode (Google vendor ID + AOAP product ID)
-                            bool isAOAP = (deviceDescriptor.idVendor == 0x18D1) && 
-                                         (deviceDescriptor.idProduct == 0x2D00 || deviceDescriptor.idProduct == 0x2D01);
-                            
-                            std::cerr << "Device: VID=0x" << std::hex << deviceDescriptor.idVendor 
-                                     << " PID=0x" << deviceDescriptor.idProduct << std::dec
-                                     << (isAOAP ? " (AOAP mode)" : "") << std::endl;
-                            
-                            if (isAOAP) {
-                                // Device is already in AOAP mode, try to open it directly with retry logic
-                                // Retry logic for initial connection (handles timing issues)
-                                const int MAX_RETRIES = 3;
-                                bool connected = false;
-
-                                for (int retry = 0; retry < MAX_RETRIES; retry++) {
-                                    usb::DeviceHandle deviceHandle;
-                                    auto openResult = ctx->usbWrapper->open(*deviceIter, deviceHandle);
-
-                                    if (openResult != 0 || deviceHandle == nullptr) {
-                                        std::cerr << "Failed to open AOAP device: " << openResult << std::endl;
-                                        if (retry < MAX_RETRIES - 1) {
-                                            std::cerr << "Retrying open in 300ms..." << std::endl;
-                                            std::this_thread::sleep_for(std::chrono::milliseconds(300));
-                                            continue;
-                                        }
-                                        break;
-                                    }
-
-                                    try {
-                                        if (retry > 0) {
-                                            std::cerr << "Connection attempt " << (retry + 1) << " of " << MAX_RETRIES << "..." << std::endl;
-                                        } else {
-                                            std::cerr << "Device already in AOAP mode, setting up connection..." << std::endl;
-                                        }
-
-                                        setupDeviceConnection(ctx, deviceHandle);
-                                        connected = true;
-                                        std::cerr << "Successfully connected to AOAP device!" << std::endl;
-                                        break; // Success
-                                    } catch (const error::Error& e) {
-                                        std::cerr << "Connection attempt " << (retry + 1) << " failed: " << e.what()
-                                                 << " (code: " << (int)e.getCode() << ", native: " << e.getNativeCode() << ")" << std::endl;
-
-                                        // Device handle is consumed on error, need to reopen
-                                        deviceHandle.reset();
-
-                                        if (retry < MAX_RETRIES - 1) {
-                                            std::cerr << "Retrying in 500ms..." << std::endl;
-                                            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-                                        }
-                                    } catch (const std::exception& e) {
-                                        std::cerr << "Connection attempt " << (retry + 1) << " failed: " << e.what() << std::endl;
-
-                                        // Device handle is consumed on error, need to reopen
-                                        deviceHandle.reset();
-
-                                        if (retry < MAX_RETRIES - 1) {
-                                            std::cerr << "Retrying in 500ms..." << std::endl;
-                                            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-                                        }
-                                    }
-                                }
-
-                                if (connected) {
-                                    break; // Found and connected
-                                } else {
-                                    std::cerr << "All connection attempts failed, will rely on hotplug..." << std::endl;
-                                }
-                            } else if (deviceDescriptor.idVendor == 0x18D1) {
-                                // Google device (likely Android phone) but not in AOAP mode yet
-                                // Try to open and query it to switch to AOAP mode
-                                usb::DeviceHandle deviceHandle;
-                                auto openResult = ctx->usbWrapper->open(*deviceIter, deviceHandle);
-                                
-                                if (openResult == 0 && deviceHandle != nullptr) {
-                                    std::cerr << "Opened Google device (VID=0x18d1 PID=0x" << std::hex << deviceDescriptor.idProduct << std::dec << ")" << std::endl;
-                                    std::cerr << "Creating query chain to switch device to AOAP mode..." << std::endl;
-                                    
-                                    // Create query chain to switch device to AOAP mode
-                                    ctx->activeQueryChain = ctx->queryChainFactory->create();
-                                    auto queryPromise = usb::IAccessoryModeQueryChain::Promise::defer(ctx->ioService);
-                                    
-                                    // Add a timeout mechanism - if query chain takes too long, cancel it
-                                    auto queryTimeout = std::make_shared<boost::asio::deadline_timer>(ctx->ioService);
-                                    queryTimeout->expires_from_now(boost::posix_time::seconds(30));
-                                    queryTimeout->async_wait([ctx, queryTimeout](const boost::system::error_code& ec) {
-                                        if (!ec && ctx->activeQueryChain) {
-                                            std::cerr << "========================================" << std::endl;
-                                            std::cerr << "Query chain timeout (30s) - canceling..." << std::endl;
-                                            std::cerr << "========================================" << std::endl;
-                                            std::cerr << "Possible issues:" << std::endl;
-                                            std::cerr << "1. Android phone may need to accept 'Allow USB accessory?' prompt" << std::endl;
-                                            std::cerr << "2. USB debugging must be enabled in Developer options" << std::endl;
-                                            std::cerr << "3. In WSL2, USB control transfers may not work properly" << std::endl;
-                                            std::cerr << "4. Try unplugging and replugging your phone" << std::endl;
-                                            std::cerr << "5. Check if Android Auto app is installed and set up" << std::endl;
-                                            std::cerr << "========================================" << std::endl;
-                                            ctx->activeQueryChain->cancel();
-                                            ctx->activeQueryChain.reset();
-                                        }
-                                    });
-                                    
-                                    std::cerr << "Query chain steps:" << std::endl;
-                                    std::cerr << "  1. PROTOCOL_VERSION" << std::endl;
-                                    std::cerr << "  2. SEND_MANUFACTURER (\"Android\")" << std::endl;
-                                    std::cerr << "  3. SEND_MODEL (\"Android Auto\")" << std::endl;
-                                    std::cerr << "  4. SEND_DESCRIPTION (\"Android Auto\")" << std::endl;
-                                    std::cerr << "  5. SEND_VERSION (\"2.0.1\")" << std::endl;
-                                    std::cerr << "  6. SEND_URI (\"https://f1xstudio.com\")" << std::endl;
-                                    std::cerr << "  7. SEND_SERIAL (\"HU-AAAAAA001\")" << std::endl;
-                                    std::cerr << "  8. START (switch to AOAP mode)" << std::endl;
-                                    std::cerr << "Watch your phone for 'Allow USB accessory?' prompt!" << std::endl;
-                                    
-                                    queryPromise->then([ctx, queryTimeout](usb::DeviceHandle handle) {
-                                        queryTimeout->cancel(); // Cancel timeout on success
-                                        std::cerr << "========================================" << std::endl;
-                                        std::cerr << "Device successfully switched to AOAP mode!" << std::endl;
-                                        std::cerr << "Setting up connection..." << std::endl;
-                                        std::cerr << "========================================" << std::endl;
-                                        ctx->activeQueryChain.reset();
-                                        setupDeviceConnection(ctx, handle);
-                                    }, [ctx, queryTimeout](const error::Error& e) {
-                                        queryTimeout->cancel(); // Cancel timeout on error
-                                        std::cerr << "========================================" << std::endl;
-                                        std::cerr << "Query chain failed: " << e.what() << std::endl;
-                                        std::cerr << "Error code: " << (int)e.getCode() << std::endl;
-                                        std::cerr << "========================================" << std::endl;
-                                        ctx->activeQueryChain.reset();
-                                        // USBHub is already running in background
-                                    });
-                                    
-                                    ctx->activeQueryChain->start(std::move(deviceHandle), std::move(queryPromise));
-                                    // Don't break - let it run in background, USBHub is already started
-                                    break; // Only try first Google device
-                                } else {
-                                    std::cerr << "Failed to open Google device (error " << openResult << "), trying next..." << std::endl;
-                                }
-                            } else {
-                                std::cerr << "Skipping non-Google device (VID=0x" << std::hex << deviceDescriptor.idVendor << std::dec << ")" << std::endl;
-                            }
-                        } else {
-                            std::cerr << "Failed to get device descriptor: " << descResult << std::endl;
-                        }
-                    }
-                } else {
-                    std::cerr << "No USB devices found or enumeration failed." << std::endl;
-                }
-                
-            } catch (const std::bad_weak_ptr& e) {
-                std::cerr << "AASDK start failed: bad_weak_ptr - " << e.what() << std::endl;
-                if (ctx->connectionCallback) {
-                    ctx->connectionCallback(false, ctx->userData);
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "AASDK start failed: " << e.what() << std::endl;
-                if (ctx->connectionCallback) {
-                    ctx->connectionCallback(false, ctx->userData);
-                }
-            }
-        });
+        // The connector runs discovery on its own strand; retries and settle delays are
+        // timer waits, so nothing here blocks an io thread
+        ctx->connector->start();
         
         std::cerr << "AASDK started, waiting for device..." << std::endl;
         return true;
@@ -1259,7 +3187,12 @@ void aasdk_deinit(AASDKHandle handle) {
     if (!handle) return;
     
     AASDKContext* ctx = static_cast<AASDKContext*>(handle);
-    
+
+    // The event loop holds libusb notifiers, drop it before the libusb context goes away
+    ctx->stop();
+    ctx->usbEventLoop.reset();
+    aasdk_stop_capture(handle);
+
     // Cleanup libusb
     if (ctx->usbContext) {
         libusb_exit(ctx->usbContext);
@@ -1269,23 +3202,116 @@ void aasdk_deinit(AASDKHandle handle) {
     delete ctx;
 }
 
+bool aasdk_get_connection_state(AASDKHandle handle, AASDKConnectionStateInfo* info) {
+    if (!handle || !info) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    ctx->connectionState.snapshot(info);
+    return true;
+}
+
+bool aasdk_get_connect_timeline(AASDKHandle handle, AASDKConnectTimeline* timeline) {
+    if (!handle || !timeline) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+    ctx->timeline.snapshot(timeline);
+    return true;
+}
+
+bool aasdk_get_stats(AASDKHandle handle, AASDKStats* stats) {
+    if (!handle || !stats) return false;
+
+    AASDKContext* ctx = static_cast<AASDKContext*>(handle);
+
+    *stats = AASDKStats();
+    stats->io_thread_count = static_cast<uint32_t>(ctx->ioThreads.size());
+    for (uint32_t i = 0; i < stats->io_thread_count; ++i) {
+        stats->io_thread_handlers[i] = ctx->ioThreadHandlers[i].load(std::memory_order_relaxed);
+    }
+    stats->frame_pool_outstanding = ctx->framePool.outstanding();
+    stats->frame_pool_allocated = ctx->framePool.allocated();
+    auto decoder = std::atomic_load(&ctx->decoder);
+    if (decoder) {
+        stats->decoded_frames = decoder->decodedFrames();
+        stats->decode_errors = decoder->decodeErrors();
+        stats->decode_frames_dropped = decoder->droppedFrames();
+        stats->decode_time_us_avg = decoder->averageDecodeUs();
+    }
+    std::shared_ptr<FrameRing> ring;
+    std::shared_ptr<SessionCapture> capture;
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        ring = ctx->frameRing;
+        capture = ctx->capture;
+    }
+    if (ring) {
+        stats->frame_ring_published = ring->published();
+        stats->frame_ring_dropped = ring->dropped();
+    }
+    if (capture) {
+        stats->capture_records = capture->records();
+        stats->capture_bytes = capture->bytes();
+        stats->capture_dropped = capture->dropped();
+    }
+    if (ctx->videoQueue) {
+        stats->video_queue_depth = ctx->videoQueue->depth();
+        stats->video_queue_size = ctx->videoQueue->size();
+        stats->video_queue_high_water = ctx->videoQueue->highWater();
+        stats->video_frames_dropped = ctx->videoQueue->dropped();
+    }
+    ctx->videoLag->snapshot(stats);
+    for (int i = 0; i < AASDK_AV_CHANNEL_COUNT; ++i) {
+        auto window = ctx->ackWindowAt(i);
+        if (window) {
+            window->snapshot(&stats->media_ack[i]);
+        }
+        if (ctx->audioBuffers[i]) {
+            ctx->audioBuffers[i]->stats(&stats->audio_ring[i]);
+        }
+    }
+    std::shared_ptr<AudioMixer> mixer;
+    std::shared_ptr<MicCapture> mic;
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        mixer = ctx->mixer;
+        mic = ctx->mic;
+    }
+    if (mixer) {
+        stats->mixer_periods = mixer->periods();
+        stats->mixer_ducked = mixer->ducked();
+    }
+    if (mic) {
+        mic->stats(&stats->mic);
+    }
+    ctx->audioFocus.info(&stats->audio_focus);
+    ctx->input->stats(&stats->input);
+    return true;
+}
+
 void aasdk_send_touch_event(AASDKHandle handle, int32_t x, int32_t y, int32_t action) {
-    if (!handle) return;
-    
+    aasdk_send_touch(handle, 0, x, y, action, 0);
+}
+
+bool aasdk_send_touch(AASDKHandle handle, uint32_t pointer_id, int32_t x, int32_t y, int32_t action,
+                      uint64_t time_ns) {
+    if (!handle) return false;
+
     AASDKContext* ctx = static_cast<AASDKContext*>(handle);
-    
-    // TODO: Implement touch event sending via InputServiceChannel
-    // This requires creating input channel messages
-    std::cerr << "Touch event: x=" << x << ", y=" << y << ", action=" << action << std::endl;
+    if (!ctx->input->pushTouch(pointer_id, x, y, action, time_ns)) {
+        return false;
+    }
+    ctx->kickInput();
+    return true;
 }
 
 void aasdk_send_button_event(AASDKHandle handle, int32_t button_code, bool pressed) {
     if (!handle) return;
-    
+
     AASDKContext* ctx = static_cast<AASDKContext*>(handle);
-    
-    // TODO: Implement button event sending via InputServiceChannel
-    std::cerr << "Button event: code=" << button_code << ", pressed=" << pressed << std::endl;
+    if (button_code < 0 || !ctx->input->pushButton(static_cast<uint32_t>(button_code), pressed, 0)) {
+        return;
+    }
+    ctx->kickInput();
 }
 
 } // extern "C"
@@ -21,10 +21,596 @@ typedef void (*VideoFrameCallback)(const uint8_t* data, uint32_t width, uint32_t
 typedef void (*AudioDataCallback)(const int16_t* samples, uint32_t sample_count, uint32_t channels, uint32_t sample_rate, void* user_data);
 typedef void (*ConnectionStatusCallback)(bool connected, void* user_data);
 
+// H.264 NAL units found in a video payload (AASDKFrame::nal_flags)
+#define AASDK_NAL_FLAG_SPS      0x01
+#define AASDK_NAL_FLAG_PPS      0x02
+#define AASDK_NAL_FLAG_IDR      0x04    // IDR slice: decoding can start here
+#define AASDK_NAL_FLAG_NON_IDR  0x08    // Slice that references earlier pictures
+
+// Pooled, reference-counted video payload. The wrapper owns the buffer; consumers
+// hold it with aasdk_frame_acquire()/aasdk_frame_release() instead of copying it.
+typedef struct {
+    const uint8_t* data;    // H.264 payload
+    uint32_t size;          // Payload length in bytes
+    uint32_t width;         // From the stream's SPS once one has been seen
+    uint32_t height;
+    uint32_t nal_flags;     // AASDK_NAL_FLAG_*
+    uint64_t timestamp;     // Phone media timestamp (microseconds), 0 if the message had none
+    uint64_t sequence;      // Per-connection frame counter, starts at 1; 0 for priming frames
+    uint64_t receive_ns;    // CLOCK_MONOTONIC time the payload came off the transport, 0 for priming frames
+} AASDKFrame;
+
+// Receives one reference to frame; the callee must call aasdk_frame_release() when done
+typedef void (*VideoFrameRefCallback)(AASDKFrame* frame, void* user_data);
+
+// Decoded picture layouts
+typedef enum {
+    AASDK_PIXEL_FORMAT_I420 = 0,    // Y, U, V planes
+    AASDK_PIXEL_FORMAT_NV12 = 1     // Y plane, interleaved UV plane
+} AASDKPixelFormat;
+
+// Decoded video picture. Planes are only valid for the duration of the callback.
+typedef struct {
+    int32_t format;             // AASDKPixelFormat
+    uint32_t width;
+    uint32_t height;
+    const uint8_t* planes[3];   // Unused planes are NULL
+    uint32_t strides[3];        // Bytes per row of each plane
+    uint64_t timestamp;         // Phone media timestamp of the source payload
+    uint64_t sequence;          // Sequence number of the source AASDKFrame
+    uint64_t receive_ns;        // Receive time of the source AASDKFrame (CLOCK_MONOTONIC)
+} AASDKDecodedFrame;
+
+// Called on the decoder thread for every decoded picture
+typedef void (*DecodedFrameCallback)(const AASDKDecodedFrame* frame, void* user_data);
+
+// Set in AASDKMediaInfo::flags when the phone sent a media timestamp with the payload
+#define AASDK_MEDIA_INFO_HAS_TIMESTAMP 0x01
+
+// Timing of one audio/video payload, for A/V sync, pacing and latency measurement
+typedef struct {
+    int32_t channel;        // AASDKAVChannel the payload arrived on
+    uint32_t flags;         // AASDK_MEDIA_INFO_*
+    uint64_t timestamp;     // Phone media timestamp (microseconds, phone clock), 0 if none
+    uint64_t receive_ns;    // Host CLOCK_MONOTONIC time the payload came off the transport
+    uint64_t sequence;      // Per-channel payload counter, starts at 1 on every connection
+} AASDKMediaInfo;
+
+// Version 2 media callbacks: the version 1 arguments plus the payload's AASDKMediaInfo,
+// which is only valid for the duration of the call
+typedef void (*VideoFrameCallbackV2)(const uint8_t* data, uint32_t size, uint32_t width, uint32_t height,
+                                     const AASDKMediaInfo* info, void* user_data);
+typedef void (*AudioDataCallbackV2)(const int16_t* samples, uint32_t sample_count, uint32_t channels,
+                                    uint32_t sample_rate, const AASDKMediaInfo* info, void* user_data);
+
+// 32-bit output layouts for aasdk_convert_frame(), in memory byte order
+typedef enum {
+    AASDK_RGB_FORMAT_RGBA = 0,
+    AASDK_RGB_FORMAT_BGRA = 1
+} AASDKRgbFormat;
+
+// Video configuration negotiated with the phone, refined by the latest SPS on the video channel
+typedef struct {
+    uint32_t width;         // Picture size after cropping (negotiated size until an SPS arrives)
+    uint32_t height;
+    uint32_t profile_idc;   // 0 until an SPS arrives
+    uint32_t level_idc;
+    uint32_t fps;           // Negotiated frame rate
+    uint32_t margin_width;  // Letterboxing inside the picture, excluded from the phone UI
+    uint32_t margin_height;
+    uint32_t dpi;
+} AASDKVideoConfig;
+
+// Shared-memory frame ring
+// The native decoder copies each picture into a slot of a memfd-backed ring and writes
+// 1 to an eventfd doorbell. A renderer in this process, or in another one that received
+// both descriptors over a unix socket, mmaps the memfd and reads pictures in place.
+// Layout: AASDKFrameRingHeader at offset 0, followed by slot_count AASDKFrameRingSlot
+// descriptors; plane offsets are relative to the start of the mapping.
+//
+// Slot states are 32-bit words changed only with atomic compare-and-swap:
+//   writer: FREE or READY -> WRITING -> READY (slot sequence = header published)
+//   reader: READY -> READING, render, READING -> FREE
+// A reader takes the READY slot with the highest sequence. The writer never touches a
+// READING slot and overwrites the oldest unread picture when it laps the reader; if every
+// slot is being read the picture is dropped.
+#define AASDK_FRAME_RING_MAGIC 0x47524641u     // "AFRG"
+#define AASDK_FRAME_RING_VERSION 1
+#define AASDK_FRAME_RING_MIN_SLOTS 2
+#define AASDK_FRAME_RING_MAX_SLOTS 16
+#define AASDK_DEFAULT_FRAME_RING_SLOTS 3
+
+typedef enum {
+    AASDK_RING_SLOT_FREE = 0,
+    AASDK_RING_SLOT_WRITING = 1,
+    AASDK_RING_SLOT_READY = 2,
+    AASDK_RING_SLOT_READING = 3
+} AASDKRingSlotState;
+
+typedef struct {
+    uint32_t state;             // AASDKRingSlotState
+    int32_t format;             // AASDKPixelFormat
+    uint32_t width;
+    uint32_t height;
+    uint32_t offsets[3];        // Plane offsets from the start of the mapping, 0 = unused
+    uint32_t strides[3];
+    uint64_t sequence;          // Ring publish number, increases with every picture
+    uint64_t frame_sequence;    // AASDKDecodedFrame::sequence
+    uint64_t timestamp;         // Phone media timestamp
+} AASDKFrameRingSlot;
+
+typedef struct {
+    uint32_t magic;             // AASDK_FRAME_RING_MAGIC
+    uint32_t version;           // AASDK_FRAME_RING_VERSION
+    uint32_t slot_count;
+    uint32_t slot_size;         // Pixel bytes per slot
+    uint32_t max_width;         // Largest picture a slot holds
+    uint32_t max_height;
+    uint64_t published;         // Sequence of the newest READY picture, updated atomically
+    uint64_t dropped;           // Pictures dropped: every slot being read, or larger than a slot
+} AASDKFrameRingHeader;
+
+// Descriptors of an enabled frame ring. Both stay owned by the wrapper: dup() them to
+// keep them past aasdk_deinit() or aasdk_disable_frame_ring().
+typedef struct {
+    int32_t memfd;              // Sealed against resizing, map with PROT_READ | PROT_WRITE
+    int32_t doorbell_fd;        // Non-blocking eventfd, readable once a picture is published
+    uint64_t size;              // Bytes to map
+    uint32_t slot_count;
+    uint32_t max_width;
+    uint32_t max_height;
+} AASDKFrameRingInfo;
+
+// Upper bound on io_service worker threads
+#define AASDK_MAX_IO_THREADS 8
+
+// Video queue depth bounds (frames)
+#define AASDK_DEFAULT_VIDEO_QUEUE_DEPTH 4
+#define AASDK_MAX_VIDEO_QUEUE_DEPTH 64
+
+// Frames consumed more than this long after they arrived trigger a resync
+#define AASDK_DEFAULT_VIDEO_LAG_THRESHOLD_MS 200
+
+// Video lag histogram: bucket i counts frames consumed less than 2^i ms after they
+// arrived (bucket 0: under 1 ms), the last bucket everything slower
+#define AASDK_LAG_HISTOGRAM_BUCKETS 12
+
+// Media acknowledgement windows (unacknowledged messages the phone may have in flight)
+#define AASDK_DEFAULT_VIDEO_ACK_WINDOW 2
+#define AASDK_DEFAULT_AUDIO_ACK_WINDOW 4
+#define AASDK_MAX_ACK_WINDOW 32
+
+// Audio/video channels with media flow control, indexes AASDKStats::media_ack
+typedef enum {
+    AASDK_AV_CHANNEL_VIDEO = 0,
+    AASDK_AV_CHANNEL_MEDIA_AUDIO = 1,
+    AASDK_AV_CHANNEL_SPEECH_AUDIO = 2,
+    AASDK_AV_CHANNEL_SYSTEM_AUDIO = 3
+} AASDKAVChannel;
+
+#define AASDK_AV_CHANNEL_COUNT 4
+
+// Flow control counters for one audio/video channel
+typedef struct {
+    uint32_t window;                // max_unacked granted to the phone
+    uint32_t in_flight;             // Received, ack not yet written
+    uint32_t in_flight_max;
+    uint64_t received;              // Media messages received
+    uint64_t acked;                 // Acks written to the transport
+    uint64_t ack_errors;            // Acks the transport failed to send
+    uint32_t ack_delay_us_avg;      // Receipt to ack written: consumer time plus send queueing
+    uint32_t ack_delay_us_max;
+} AASDKMediaAckStats;
+
+// Upper bound on AASDKInitOptions::audio_ring_ms
+#define AASDK_MAX_AUDIO_RING_MS 2000
+
+// PCM format of an audio stream, fixed by the configuration advertised to the phone
+typedef struct {
+    uint32_t sample_rate;
+    uint32_t channels;
+    uint32_t bit_depth;
+} AASDKAudioFormat;
+
+// First frame returned by aasdk_audio_read()
+typedef struct {
+    uint32_t flags;         // AASDK_MEDIA_INFO_HAS_TIMESTAMP if timestamp is valid
+    uint32_t available;     // Frames still buffered after the read
+    uint64_t timestamp;     // Phone media timestamp of the frame (microseconds, phone clock)
+    uint64_t receive_ns;    // Receive time of the payload that carried it (CLOCK_MONOTONIC)
+} AASDKAudioReadInfo;
+
+// Per-stream PCM ring and jitter buffer counters
+typedef struct {
+    uint32_t capacity_frames;
+    uint32_t buffered_frames;       // Waiting for the reader right now
+    uint64_t written_frames;
+    uint64_t overrun_frames;        // Frames dropped because the ring was full
+    uint64_t underruns;             // Reads that ran dry while playing (audible gaps); draining a
+                                    // stream the phone stopped is not one
+    uint32_t target_frames;         // Depth playout is held back to after a start or underrun
+    uint32_t jitter_us;             // Spread of payload arrival times against the phone's media clock
+    uint32_t latency_us;            // Buffered audio ahead of the reader: the added output latency
+    uint64_t trimmed_frames;        // Frames skipped to bring a standing backlog back to target
+} AASDKAudioRingStats;
+
+// Jitter buffer of one audio stream. The target depth follows the measured arrival
+// jitter (plus a quarter) between these bounds; raise min_ms for robustness or lower it
+// for latency. max_ms 0 turns the buffer off: the reader gets whatever has arrived.
+typedef struct {
+    uint32_t min_ms;
+    uint32_t max_ms;    // Also held to half the ring (AASDKInitOptions::audio_ring_ms)
+} AASDKJitterConfig;
+
+// Upper bound on AASDKMixerConfig::period_frames
+#define AASDK_MAX_MIXER_PERIOD_FRAMES 8192
+
+// Native mixer output - fill with aasdk_default_mixer_config() before changing fields
+typedef struct {
+    uint32_t sample_rate;       // DAC rate
+    uint32_t channels;          // 1 or 2
+    uint32_t period_frames;     // Frames rendered at a time, the DAC period (1..AASDK_MAX_MIXER_PERIOD_FRAMES)
+    float duck_gain;            // Media gain while ducked (0..1)
+    uint32_t duck_attack_ms;    // Ramp into the duck
+    uint32_t duck_release_ms;   // Ramp back to full volume
+} AASDKMixerConfig;
+
+// Microphone capture for the AV_INPUT channel (16 kHz mono) - fill with
+// aasdk_default_mic_config() before changing fields
+typedef struct {
+    uint32_t period_ms;         // Audio per payload sent to the phone
+    uint32_t ring_ms;           // Captured audio buffered while the phone has not acked
+    uint32_t max_latency_ms;    // Older audio is dropped once this much is waiting to be sent
+} AASDKMicConfig;
+
+// Told when the phone opens (voice command starts) or closes the microphone; called on
+// an io thread, so hand the change to the capture device's own thread
+typedef void (*MicStateCallback)(bool open, void* user_data);
+
+// Microphone capture counters
+typedef struct {
+    bool open;                  // The phone is listening right now
+    uint32_t max_unacked;       // Payloads the phone allows in flight, 0 = no limit
+    uint64_t opens;             // AVInputOpenRequests that opened the microphone
+    uint64_t captured_frames;   // Frames accepted while open
+    uint64_t dropped_frames;    // Captured frames never sent: ring full or older than max_latency_ms
+    uint64_t payloads_sent;
+    uint64_t payloads_acked;
+    uint64_t window_stalls;     // Times a whole payload was ready but the phone's window was full
+    uint32_t latency_us_avg;    // Capture of a payload's first frame to handing it to the transport
+    uint32_t latency_us_max;
+} AASDKMicStats;
+
+// Audio focus granted to the phone (values match aasdk's AudioFocusState)
+typedef enum {
+    AASDK_AUDIO_FOCUS_NONE = 0,                             // Nothing requested yet; every stream plays
+    AASDK_AUDIO_FOCUS_GAIN = 1,                             // Long-lived focus, media
+    AASDK_AUDIO_FOCUS_GAIN_TRANSIENT = 2,                   // Assistant, calls and other short audio
+    AASDK_AUDIO_FOCUS_LOSS = 3,                             // Released with nothing held underneath; system sounds only
+    AASDK_AUDIO_FOCUS_GAIN_TRANSIENT_GUIDANCE_ONLY = 7      // Navigation prompts
+} AASDKAudioFocusState;
+
+// Audio focus arbitration: what the phone holds and which streams play because of it
+typedef struct {
+    int32_t state;                                      // AASDKAudioFocusState granted last
+    bool gain_held;                                     // GAIN held under the transient focus, if any
+    bool media_ducked;                                  // Media plays ducked under a transient
+    bool stream_active[AASDK_AV_CHANNEL_COUNT];         // Indexed by AASDKAVChannel; false for video
+    uint64_t requests;                                  // AudioFocusRequests this connection
+    uint64_t transitions;                               // Requests that changed the grant or what plays
+    uint64_t dropped_frames[AASDK_AV_CHANNEL_COUNT];    // Frames received for a paused stream
+} AASDKAudioFocusInfo;
+
+// Told whenever a focus request changes the granted state or what plays, and when a
+// connection starts over from AASDK_AUDIO_FOCUS_NONE; called on an io thread
+typedef void (*AudioFocusCallback)(const AASDKAudioFocusInfo* focus, void* user_data);
+
+// Touch actions (values match aasdk's TouchAction)
+typedef enum {
+    AASDK_TOUCH_DOWN = 0,
+    AASDK_TOUCH_UP = 1,
+    AASDK_TOUCH_MOVE = 2
+} AASDKTouchAction;
+
+// Pointers down at once; further touches are dropped until one goes up
+#define AASDK_MAX_TOUCH_POINTERS 10
+
+// Input channel counters
+typedef struct {
+    uint64_t touch_events;      // Touch points queued by the app
+    uint64_t button_events;     // Key presses and releases queued by the app
+    uint64_t dropped_events;    // Queue full, unknown pointer or action, too many pointers, or queued without a connection
+    uint64_t coalesced_moves;   // Moves merged into an indication with a later position
+    uint64_t indications_sent;  // InputEventIndications the transport took
+    uint32_t latency_us_avg;    // Queueing of an indication's oldest event to the transport taking it
+    uint32_t latency_us_max;
+} AASDKInputStats;
+
+// Initialization options - fill with aasdk_default_init_options() before changing fields
+typedef struct {
+    uint32_t io_threads;                            // io_service worker threads (1..AASDK_MAX_IO_THREADS)
+    int32_t io_thread_cpus[AASDK_MAX_IO_THREADS];   // CPU to pin each worker to, -1 = no affinity (>= CPU_SETSIZE is ignored)
+    uint32_t video_queue_depth;                     // Frames buffered for aasdk_video_queue_pop(), 0 = no queue
+    uint32_t video_ack_window;                      // Video frames in flight before the phone waits for an ack
+    uint32_t audio_ack_window;                      // Same for each audio channel (1..AASDK_MAX_ACK_WINDOW)
+    uint32_t video_lag_threshold_ms;                // Receive-to-consume lag that triggers a resync, 0 = never
+    uint32_t audio_ring_ms;                         // PCM buffered per audio stream for aasdk_audio_read(), 0 = no rings
+} AASDKInitOptions;
+
+// Runtime statistics snapshot
+typedef struct {
+    uint32_t io_thread_count;
+    uint64_t io_thread_handlers[AASDK_MAX_IO_THREADS];  // Handlers executed by each worker
+    uint32_t frame_pool_outstanding;                    // Video frames currently held
+    uint32_t frame_pool_allocated;                      // Video buffers ever allocated
+    uint32_t video_queue_depth;                         // Configured queue depth
+    uint32_t video_queue_size;                          // Frames waiting right now
+    uint32_t video_queue_high_water;                    // Most frames ever waiting at once
+    uint64_t video_frames_dropped;                      // Frames discarded because the consumer fell behind
+    uint64_t decoded_frames;                            // Pictures produced by the native decoder
+    uint64_t decode_errors;                             // Packets libavcodec rejected
+    uint64_t decode_frames_dropped;                     // Payloads dropped because decode fell behind
+    uint32_t decode_time_us_avg;                        // Mean decode time per picture
+    uint64_t frame_ring_published;                      // Pictures written to the shared frame ring
+    uint64_t frame_ring_dropped;                        // Pictures the frame ring had no slot for
+    uint64_t capture_records;                           // Messages written by the active session capture
+    uint64_t capture_bytes;                             // Record bytes written, headers included
+    uint64_t capture_dropped;                           // Messages the capture could not keep up with or fit
+    uint64_t video_lag_histogram[AASDK_LAG_HISTOGRAM_BUCKETS];  // Receive-to-consume lag of queued/decoded frames
+    uint32_t video_lag_ms_max;
+    uint64_t video_resyncs;                             // Backlogs flushed up to the next IDR
+    uint64_t video_keyframe_requests;                   // Video focus cycles forcing an IDR after a resync
+    AASDKMediaAckStats media_ack[AASDK_AV_CHANNEL_COUNT];   // Indexed by AASDKAVChannel
+    AASDKAudioRingStats audio_ring[AASDK_AV_CHANNEL_COUNT]; // Same; zero for video and without rings
+    uint64_t mixer_periods;                             // Periods rendered by the native mixer
+    bool mixer_ducked;                                  // Media is ducked right now
+    AASDKMicStats mic;                                  // Zero unless aasdk_enable_mic() was called
+    AASDKAudioFocusInfo audio_focus;                    // Focus of the current connection
+    AASDKInputStats input;                              // Touch and key input sent to the phone
+} AASDKStats;
+
+// Device connection state machine
+typedef enum {
+    AASDK_CONN_IDLE = 0,        // Waiting for a device (hotplug armed)
+    AASDK_CONN_ENUMERATE,       // Scanning already-connected devices
+    AASDK_CONN_OPEN,            // Opening a candidate device
+    AASDK_CONN_AOAP_QUERY,      // Switching the device to accessory mode
+    AASDK_CONN_TRANSPORT,       // Creating USB transport, cryptor and messenger
+    AASDK_CONN_HANDSHAKE,       // Version exchange and SSL handshake
+    AASDK_CONN_CONNECTED,       // Service discovery answered
+    AASDK_CONN_FAILED,          // Last attempt failed, waiting for hotplug
+    AASDK_CONN_STATE_COUNT
+} AASDKConnectionState;
+
+// Connection state snapshot
+typedef struct {
+    int32_t state;                                      // Current AASDKConnectionState
+    uint32_t open_attempts;                             // Device open/connect attempts so far
+    uint64_t state_time_us[AASDK_CONN_STATE_COUNT];     // Cumulative time spent in each state
+} AASDKConnectionStateInfo;
+
+#define AASDK_TIMELINE_MAX_HANDSHAKE_ROUNDS 8
+#define AASDK_TIMELINE_MAX_CHANNELS 16
+
+// Connection milestones for the current (or last) phone connection
+// Timestamps are CLOCK_MONOTONIC nanoseconds, 0 = milestone not reached yet
+typedef struct {
+    uint64_t usb_discovered_ns;
+    uint64_t aoap_switched_ns;
+    uint64_t transport_up_ns;
+    uint64_t version_response_ns;
+    uint32_t handshake_round_count;
+    uint64_t handshake_round_ns[AASDK_TIMELINE_MAX_HANDSHAKE_ROUNDS];   // Phone handshake payload received
+    uint64_t auth_complete_ns;
+    uint64_t service_discovery_ns;
+    uint64_t channel_open_ns[AASDK_TIMELINE_MAX_CHANNELS];  // Indexed by Android Auto channel id
+    uint64_t av_setup_ns[AASDK_TIMELINE_MAX_CHANNELS];      // Indexed by Android Auto channel id
+    uint64_t first_video_ns;
+    uint64_t first_audio_ns;
+} AASDKConnectTimeline;
+
+// Latency distribution of one replay stage
+typedef struct {
+    uint64_t count;
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} AASDKLatencyStats;
+
+// Progress of a session replay (see aasdk_start_replay)
+typedef struct {
+    bool running;                   // Still releasing messages or waiting for handlers
+    uint64_t released;              // Inbound messages handed to the service channels
+    uint64_t skipped;               // Version and SSL handshake messages, never replayed
+    uint64_t unclaimed;             // Released to channels the wrapper never received on
+    uint64_t stalls;                // Handlers that never asked for their next message
+    uint64_t sent;                  // Outbound messages the wrapper sent (discarded)
+    uint64_t recorded_us;           // Recorded time span of the messages released so far
+    uint64_t elapsed_us;            // Replay time from the first release to the last handled message
+    AASDKLatencyStats control;      // Release to the channel's next receive: strand, parse and handler
+    AASDKLatencyStats handler[AASDK_AV_CHANNEL_COUNT];  // Same per AASDKAVChannel
+    AASDKLatencyStats schedule_slip;    // Timed replays: release later than the scaled recorded time
+} AASDKReplayStats;
+
+// Fill options with defaults (single io thread, no affinity, 4-frame video queue,
+// 2-frame video and 4-packet audio ack windows, 200 ms video lag threshold)
+void aasdk_default_init_options(AASDKInitOptions* options);
+
 // Initialize AASDK with callbacks
 // Returns handle on success, NULL on failure
 AASDKHandle aasdk_init(VideoFrameCallback video_cb, AudioDataCallback audio_cb, ConnectionStatusCallback conn_cb, void* user_data);
 
+// Initialize AASDK with callbacks and options (NULL options = defaults)
+// Each service channel keeps its own strand, so with several io threads audio,
+// video and control handlers run in parallel but never concurrently with themselves
+AASDKHandle aasdk_init_with_options(VideoFrameCallback video_cb, AudioDataCallback audio_cb, ConnectionStatusCallback conn_cb, void* user_data, const AASDKInitOptions* options);
+
+// Copy the connection state and per-state timings into info
+// Returns false if handle or info is NULL
+bool aasdk_get_connection_state(AASDKHandle handle, AASDKConnectionStateInfo* info);
+
+// Copy the connection milestone timeline into timeline
+// Returns false if handle or timeline is NULL
+bool aasdk_get_connect_timeline(AASDKHandle handle, AASDKConnectTimeline* timeline);
+
+// Copy current runtime statistics into stats
+// Returns false if handle or stats is NULL
+bool aasdk_get_stats(AASDKHandle handle, AASDKStats* stats);
+
+// Install version 2 media callbacks, which replace the VideoFrameCallback and
+// AudioDataCallback given to aasdk_init() for every payload. Either may be NULL to keep
+// the version 1 callback for that media type. Call before aasdk_start().
+void aasdk_set_media_callbacks_v2(AASDKHandle handle, VideoFrameCallbackV2 video_cb, AudioDataCallbackV2 audio_cb, void* user_data);
+
+// Deliver video as pooled AASDKFrame references instead of through VideoFrameCallback.
+// Call before aasdk_start(); NULL restores the plain callback.
+void aasdk_set_video_frame_ref_callback(AASDKHandle handle, VideoFrameRefCallback callback, void* user_data);
+
+// Wait up to timeout_ms (0 = don't wait) for the next queued video frame.
+// Returns a reference the caller must release, or NULL on timeout or after aasdk_stop().
+// Frames are only queued while no VideoFrameRefCallback is installed. When the consumer
+// falls behind, whole GOPs are dropped: everything up to the next IDR is discarded.
+AASDKFrame* aasdk_video_queue_pop(AASDKHandle handle, uint32_t timeout_ms);
+
+// Decode video natively with libavcodec on a dedicated thread and deliver YUV pictures.
+// Independent of the video queue and ref callback, which keep receiving H.264.
+// Call before aasdk_start(); NULL stops the decoder unless a frame ring is enabled.
+// Returns false if the wrapper was built without libavcodec or the decoder could not be opened.
+bool aasdk_set_decoded_frame_callback(AASDKHandle handle, DecodedFrameCallback callback, void* user_data);
+
+// PCM format of an audio stream (AASDK_AV_CHANNEL_*_AUDIO). The same format is passed
+// to the audio callbacks and returned by aasdk_audio_read().
+// Returns false for the video channel or a NULL argument.
+bool aasdk_get_audio_format(AASDKHandle handle, AASDKAVChannel stream, AASDKAudioFormat* format);
+
+// Copy up to frames interleaved frames of stream into samples, without blocking, locking
+// or allocating, so it can run on an audio device callback. One reader per stream.
+// Returns the frames copied; the caller pads the rest. Returns 0 while the stream's
+// jitter buffer fills to its target depth, after a start or an underrun. Requires
+// audio_ring_ms in AASDKInitOptions, otherwise always returns 0. info (optional)
+// describes the first frame.
+uint32_t aasdk_audio_read(AASDKHandle handle, AASDKAVChannel stream, int16_t* samples, uint32_t frames,
+                          AASDKAudioReadInfo* info);
+
+// Fill config with the defaults: 20 ms to 200 ms
+void aasdk_default_jitter_config(AASDKJitterConfig* config);
+
+// Bound the jitter buffer of an audio stream (AASDK_AV_CHANNEL_*_AUDIO); any time.
+// Returns false without audio rings or for the video channel.
+bool aasdk_set_jitter_config(AASDKHandle handle, AASDKAVChannel stream, const AASDKJitterConfig* config);
+
+// Fill config with the defaults: 48 kHz stereo in 10 ms periods, media ducked to 0.2
+// over 50 ms and restored over 300 ms
+void aasdk_default_mixer_config(AASDKMixerConfig* config);
+
+// Mix the audio streams natively into one output for the DAC, ducking media while the
+// phone holds transient or navigation audio focus on top of its media focus. The mixer
+// becomes the reader of every audio ring, so aasdk_audio_read() must not be used with
+// it. Requires audio_ring_ms in AASDKInitOptions; call once, before aasdk_start(). NULL
+// config = defaults. Returns false without audio rings, for a config out of range or
+// if a mixer is already enabled: one is never replaced under a running device callback.
+bool aasdk_enable_mixer(AASDKHandle handle, const AASDKMixerConfig* config);
+
+// Fill frames interleaved frames of mixed output, in the mixer's format, without
+// blocking, locking or allocating; for the audio device callback. Silence where no
+// stream has audio. Returns frames, or 0 if the mixer is not enabled.
+uint32_t aasdk_audio_mix(AASDKHandle handle, int16_t* samples, uint32_t frames);
+
+// Volume of one audio stream in the mix, 0..2 (default 1), ramped in over a period
+void aasdk_set_stream_gain(AASDKHandle handle, AASDKAVChannel stream, float gain);
+
+// Report audio focus transitions (see AudioFocusCallback); any time, NULL removes it.
+// Whatever the callback, a stream the phone holds no focus for is paused: its payloads
+// are acked and dropped rather than buffered or passed to the audio callbacks. System
+// audio is never paused, as the phone plays it without requesting focus.
+void aasdk_set_audio_focus_callback(AASDKHandle handle, AudioFocusCallback callback, void* user_data);
+
+// Fill config with the defaults: 20 ms payloads, a 200 ms ring, at most 100 ms waiting
+void aasdk_default_mic_config(AASDKMicConfig* config);
+
+// Serve the AV_INPUT channel from captured audio so voice commands work. Without this
+// the phone's requests are still answered, but no audio is sent. state_callback (optional)
+// is told when the phone opens and closes the microphone so the app can run the capture
+// device only while it listens. Call once, before aasdk_start(); NULL config = defaults.
+// Returns false for a config out of range or if the microphone is already enabled.
+bool aasdk_enable_mic(AASDKHandle handle, const AASDKMicConfig* config, MicStateCallback state_callback,
+                      void* user_data);
+
+// Append frames of captured 16 kHz mono PCM; for the capture device callback, never
+// blocks, locks or allocates. capture_ns is the CLOCK_MONOTONIC time of the first frame,
+// 0 = it ends now. Returns the frames accepted: 0 while the phone has the microphone
+// closed, fewer than frames if the ring is full.
+uint32_t aasdk_mic_write(AASDKHandle handle, const int16_t* samples, uint32_t frames, uint64_t capture_ns);
+
+// Feed a 16 kHz 16-bit PCM WAV file (mono, or stereo downmixed) into the microphone in
+// real time, in place of a capture device, restarting it whenever the phone opens the
+// microphone; loop repeats it while open. NULL path stops it. Requires aasdk_enable_mic().
+// Returns false if the file cannot be read or has another format.
+bool aasdk_mic_play_wav(AASDKHandle handle, const char* path, bool loop);
+
+// Video configuration of the current connection. Returns false until the phone has
+// picked a video mode or sent an SPS.
+bool aasdk_get_video_config(AASDKHandle handle, AASDKVideoConfig* config);
+
+// Re-send the cached SPS/PPS to the video consumers (ref callback or queue, and the
+// native decoder) so a consumer that restarted its decoder can resume at the next
+// frame instead of waiting for an IDR. Consumers installed through
+// aasdk_set_video_frame_ref_callback() or aasdk_set_decoded_frame_callback() are
+// primed automatically. Returns false if no configuration is cached.
+bool aasdk_video_prime(AASDKHandle handle);
+
+// Convert a decoded picture to RGBA/BGRA (BT.601 limited range) using the fastest
+// SIMD kernels for this CPU. If dst_width x dst_height differs from the picture it is
+// scaled bilinearly in the same pass. dst must hold dst_stride * dst_height bytes.
+// Meant to be called from a DecodedFrameCallback; thread-safe.
+bool aasdk_convert_frame(const AASDKDecodedFrame* frame, uint8_t* dst, uint32_t dst_stride,
+                         uint32_t dst_width, uint32_t dst_height, int32_t dst_format);
+
+// Also publish natively decoded pictures into a shared-memory ring (see
+// AASDKFrameRingHeader) that a renderer maps instead of copying them out of the callback.
+// slot_count 0 = AASDK_DEFAULT_FRAME_RING_SLOTS; max_width x max_height 0 = 1280x720,
+// the largest mode the wrapper advertises. Starts the native decoder if no
+// DecodedFrameCallback is installed. Call before aasdk_start(); returns false if the
+// wrapper was built without libavcodec or the ring could not be created.
+bool aasdk_enable_frame_ring(AASDKHandle handle, uint32_t slot_count, uint32_t max_width, uint32_t max_height);
+
+// Descriptors for mapping the ring; returns false if no ring is enabled
+bool aasdk_get_frame_ring(AASDKHandle handle, AASDKFrameRingInfo* info);
+
+// Stop publishing into the ring and close its descriptors. Existing mappings stay valid.
+void aasdk_disable_frame_ring(AASDKHandle handle);
+
+// Record every message of the connections started from now on, decrypted, with channel,
+// message id and timestamps, to path (created or truncated; format in session_capture.h).
+// The file is preallocated to capacity_bytes (0 = 256 MiB); messages beyond it are counted
+// as capture_dropped. Replaces a capture already running. Returns false if path cannot be
+// created or mapped.
+bool aasdk_start_capture(AASDKHandle handle, const char* path, uint64_t capacity_bytes);
+
+// Finish the capture and trim the file to the records written. Also done by aasdk_deinit().
+void aasdk_stop_capture(AASDKHandle handle);
+
+// Replay a capture instead of connecting a phone: call instead of aasdk_start(). The
+// recorded inbound messages go through the same service channels and handlers as a live
+// session, from service discovery on (the version and SSL handshake exchange is skipped),
+// and everything the wrapper sends is discarded. speed 1.0 replays in real time, N.0 N
+// times faster and 0 as fast as the handlers keep up, one message at a time. The session
+// is set up on an io thread after this returns, and phones are ignored from then on.
+// Returns false if the capture cannot be read, the handle is not running or a phone
+// session is already set up.
+bool aasdk_start_replay(AASDKHandle handle, const char* path, double speed);
+
+// Replay progress and per-stage latencies; returns false if no replay was started
+bool aasdk_get_replay_stats(AASDKHandle handle, AASDKReplayStats* stats);
+
+// Take an additional reference to frame
+void aasdk_frame_acquire(AASDKFrame* frame);
+
+// Drop a reference; the buffer returns to the pool when the last one is released.
+// Safe to call after aasdk_deinit().
+void aasdk_frame_release(AASDKFrame* frame);
+
 // Start Android Auto service (will auto-discover USB devices)
 // Returns true on success, false on failure
 bool aasdk_start(AASDKHandle handle);
@@ -35,10 +621,20 @@ void aasdk_stop(AASDKHandle handle);
 // Cleanup AASDK and free all resources
 void aasdk_deinit(AASDKHandle handle);
 
-// Send touch event to Android Auto
+// Send touch event to Android Auto: aasdk_send_touch() for pointer 0, stamped now
 void aasdk_send_touch_event(AASDKHandle handle, int32_t x, int32_t y, int32_t action);
 
-// Send button event to Android Auto
+// Queue one point of a (multi-)touch gesture for the phone; any thread, never blocks or
+// locks. x and y are in the advertised touch screen's pixels, action an AASDKTouchAction,
+// and pointer_id tells the fingers apart for as long as they are down. time_ns is the
+// CLOCK_MONOTONIC time of the touch, 0 = now. Moves queued while an indication is in
+// flight are merged into the next one; downs and ups are always sent. Returns false if
+// the event was dropped (queue full or unknown action).
+bool aasdk_send_touch(AASDKHandle handle, uint32_t pointer_id, int32_t x, int32_t y, int32_t action,
+                      uint64_t time_ns);
+
+// Send button event to Android Auto; button_code is an Android key code (aasdk's
+// ButtonCode). Queued with the touches, in order; any thread.
 void aasdk_send_button_event(AASDKHandle handle, int32_t button_code, bool pressed);
 
 #ifdef __cplusplus
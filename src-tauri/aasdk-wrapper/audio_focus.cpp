@@ -0,0 +1,142 @@
+// Audio focus arbitration
+// See audio_focus.h
+
+#include "audio_focus.h"
+
+namespace {
+
+const uint32_t ALL_AUDIO = 1u << AASDK_AV_CHANNEL_MEDIA_AUDIO | 1u << AASDK_AV_CHANNEL_SPEECH_AUDIO |
+                           1u << AASDK_AV_CHANNEL_SYSTEM_AUDIO;
+
+} // namespace
+
+const char* AudioFocus::stateName(AASDKAudioFocusState state) {
+    switch (state) {
+    case AASDK_AUDIO_FOCUS_NONE: return "none";
+    case AASDK_AUDIO_FOCUS_GAIN: return "gain";
+    case AASDK_AUDIO_FOCUS_GAIN_TRANSIENT: return "gain transient";
+    case AASDK_AUDIO_FOCUS_LOSS: return "loss";
+    case AASDK_AUDIO_FOCUS_GAIN_TRANSIENT_GUIDANCE_ONLY: return "gain transient, guidance only";
+    }
+    return "unknown";
+}
+
+AudioFocus::AudioFocus()
+    : state_(AASDK_AUDIO_FOCUS_NONE), gain_(false), transient_(Transient::NONE), requests_(0), transitions_(0),
+      active_(ALL_AUDIO), ducked_(false) {
+    for (auto& dropped : dropped_) {
+        dropped = 0;
+    }
+}
+
+AASDKAudioFocusState AudioFocus::request(Request type, AASDKAudioFocusInfo* info, bool* changed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++requests_;
+    AASDKAudioFocusState previous = state_;
+
+    switch (type) {
+    case Request::GAIN:
+        gain_ = true;
+        transient_ = Transient::NONE;
+        state_ = AASDK_AUDIO_FOCUS_GAIN;
+        break;
+    case Request::GAIN_TRANSIENT:
+        transient_ = Transient::GAIN_TRANSIENT;
+        state_ = AASDK_AUDIO_FOCUS_GAIN_TRANSIENT;
+        break;
+    case Request::GAIN_NAVI:
+        transient_ = Transient::GAIN_NAVI;
+        state_ = AASDK_AUDIO_FOCUS_GAIN_TRANSIENT_GUIDANCE_ONLY;
+        break;
+    case Request::RELEASE:
+        // The end of a prompt or call over media: back to GAIN, not LOSS
+        if (gain_ && transient_ != Transient::NONE) {
+            transient_ = Transient::NONE;
+            state_ = AASDK_AUDIO_FOCUS_GAIN;
+            break;
+        }
+        gain_ = false;
+        transient_ = Transient::NONE;
+        state_ = AASDK_AUDIO_FOCUS_LOSS;
+        break;
+    case Request::NONE:
+        // Nothing asked for: answer with what is already granted
+        break;
+    }
+
+    uint32_t active = activeMask();
+    bool ducked = gain_ && transient_ != Transient::NONE;
+    bool transition = state_ != previous || active != active_.load(std::memory_order_relaxed) ||
+                      ducked != ducked_.load(std::memory_order_relaxed);
+    if (transition) {
+        ++transitions_;
+    }
+    active_.store(active, std::memory_order_relaxed);
+    ducked_.store(ducked, std::memory_order_relaxed);
+
+    if (changed) {
+        *changed = transition;
+    }
+    if (info) {
+        infoLocked(info);
+    }
+    return state_;
+}
+
+void AudioFocus::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_ = AASDK_AUDIO_FOCUS_NONE;
+    gain_ = false;
+    transient_ = Transient::NONE;
+    requests_ = 0;
+    transitions_ = 0;
+    active_.store(ALL_AUDIO, std::memory_order_relaxed);
+    ducked_.store(false, std::memory_order_relaxed);
+    for (auto& dropped : dropped_) {
+        dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool AudioFocus::active(int stream) const {
+    return stream >= 0 && stream < AASDK_AV_CHANNEL_COUNT &&
+           (active_.load(std::memory_order_relaxed) & 1u << stream) != 0;
+}
+
+void AudioFocus::countDropped(int stream, uint32_t frames) {
+    if (stream >= 0 && stream < AASDK_AV_CHANNEL_COUNT) {
+        dropped_[stream].fetch_add(frames, std::memory_order_relaxed);
+    }
+}
+
+void AudioFocus::info(AASDKAudioFocusInfo* info) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    infoLocked(info);
+}
+
+uint32_t AudioFocus::activeMask() const {
+    if (state_ == AASDK_AUDIO_FOCUS_NONE) {
+        return ALL_AUDIO;
+    }
+    // Click and notification sounds come without a focus request, even after a RELEASE
+    uint32_t mask = 1u << AASDK_AV_CHANNEL_SYSTEM_AUDIO;
+    if (gain_ || transient_ != Transient::NONE) {
+        mask |= 1u << AASDK_AV_CHANNEL_SPEECH_AUDIO;
+    }
+    if (gain_ || transient_ == Transient::GAIN_TRANSIENT) {
+        mask |= 1u << AASDK_AV_CHANNEL_MEDIA_AUDIO;
+    }
+    return mask;
+}
+
+void AudioFocus::infoLocked(AASDKAudioFocusInfo* info) const {
+    uint32_t active = active_.load(std::memory_order_relaxed);
+    info->state = state_;
+    info->gain_held = gain_;
+    info->media_ducked = ducked_.load(std::memory_order_relaxed);
+    info->requests = requests_;
+    info->transitions = transitions_;
+    for (int i = 0; i < AASDK_AV_CHANNEL_COUNT; ++i) {
+        info->stream_active[i] = (active & 1u << i) != 0;
+        info->dropped_frames[i] = dropped_[i].load(std::memory_order_relaxed);
+    }
+}
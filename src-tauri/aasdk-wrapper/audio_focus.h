@@ -0,0 +1,81 @@
+// Audio focus arbitration
+// The phone asks for audio focus before it plays and the head unit answers with the
+// focus it grants. Requests stack the way Android's focus does: GAIN is the phone's
+// long-lived focus (media), and GAIN_TRANSIENT (assistant, calls) or GAIN_NAVI
+// (navigation prompts) is held on top of it until the phone asks for GAIN again or
+// RELEASEs. A RELEASE pops the transient when one sits on GAIN (a prompt ending), so
+// media resumes under GAIN; otherwise it gives up everything and is answered LOSS.
+// They are granted as GAIN, GAIN_TRANSIENT, GAIN_TRANSIENT_GUIDANCE_ONLY and LOSS.
+// What plays follows from what is held:
+//   - media while GAIN or GAIN_TRANSIENT is held, ducked when a transient is over GAIN
+//   - speech while any focus is held
+//   - system sounds always: the phone plays UI clicks without requesting focus
+// Before the first request every stream plays, as a phone may stream before it asks.
+// A stream that does not play is paused: the audio handlers drop its payloads.
+
+#ifndef AUDIO_FOCUS_H
+#define AUDIO_FOCUS_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "aasdk_c.h"
+
+class AudioFocus {
+public:
+    // AudioFocusType of a request
+    enum class Request {
+        NONE,
+        GAIN,
+        GAIN_TRANSIENT,
+        GAIN_NAVI,
+        RELEASE
+    };
+
+    static const char* stateName(AASDKAudioFocusState state);
+
+    AudioFocus();
+
+    AudioFocus(const AudioFocus&) = delete;
+    AudioFocus& operator=(const AudioFocus&) = delete;
+
+    // Control strand. Apply a request and return the state to grant; info (optional)
+    // receives the outcome, changed (optional) whether the granted state or what plays
+    // changed.
+    AASDKAudioFocusState request(Request type, AASDKAudioFocusInfo* info, bool* changed);
+
+    // A new connection: nothing held, every stream plays
+    void reset();
+
+    // Any thread, lock-free
+    bool active(int stream) const;
+    bool ducked() const { return ducked_.load(std::memory_order_relaxed); }
+    void countDropped(int stream, uint32_t frames);
+
+    void info(AASDKAudioFocusInfo* info) const;
+
+private:
+    enum class Transient {
+        NONE,
+        GAIN_TRANSIENT,
+        GAIN_NAVI
+    };
+
+    // Streams that play in the current state, as a bit per AASDKAVChannel; caller holds mutex_
+    uint32_t activeMask() const;
+    void infoLocked(AASDKAudioFocusInfo* info) const;
+
+    mutable std::mutex mutex_;
+    AASDKAudioFocusState state_;
+    bool gain_;                     // GAIN held
+    Transient transient_;           // Held on top of gain_
+    uint64_t requests_;
+    uint64_t transitions_;
+
+    std::atomic<uint32_t> active_;  // activeMask() as of the last change
+    std::atomic<bool> ducked_;
+    std::atomic<uint64_t> dropped_[AASDK_AV_CHANNEL_COUNT];
+};
+
+#endif // AUDIO_FOCUS_H
@@ -0,0 +1,393 @@
+// Native audio mixer
+// See audio_mixer.h
+
+#include "audio_mixer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define AUDIO_MIXER_NEON 1
+#endif
+
+constexpr int32_t AudioMixer::UNITY_Q14;
+
+namespace {
+
+// Largest stream gain; 2.0 in Q14 is one past int16, so it is held just below
+constexpr float MAX_GAIN = 2.0f;
+constexpr int32_t MAX_GAIN_Q14 = 32767;
+
+Resampler::Isa resamplerIsa(AudioMixer::Isa isa) {
+    switch (isa) {
+    case AudioMixer::Isa::SSE2: return Resampler::Isa::SSE2;
+    case AudioMixer::Isa::NEON: return Resampler::Isa::NEON;
+    default: return Resampler::Isa::SCALAR;
+    }
+}
+
+int16_t toQ14(float gain) {
+    long q = std::lround(gain * AudioMixer::UNITY_Q14);
+    return static_cast<int16_t>(std::min<long>(std::max<long>(q, 0), MAX_GAIN_Q14));
+}
+
+float moveToward(float from, float to, float maxStep) {
+    if (std::fabs(to - from) <= maxStep) {
+        return to;
+    }
+    return to > from ? from + maxStep : from - maxStep;
+}
+
+void accumulateScalar(int32_t* acc, const int16_t* in, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        acc[i] += in[i];
+    }
+}
+
+void accumulateGainScalar(int32_t* acc, const int16_t* in, const int16_t* gain, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        acc[i] += (static_cast<int32_t>(in[i]) * gain[i]) >> 14;
+    }
+}
+
+void saturateScalar(int16_t* out, const int32_t* acc, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        out[i] = static_cast<int16_t>(std::min<int32_t>(std::max<int32_t>(acc[i], INT16_MIN), INT16_MAX));
+    }
+}
+
+#if defined(__SSE2__)
+
+void accumulateSse2(int32_t* acc, const int16_t* in, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign-extend by pairing each sample with itself and shifting the copy out
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        __m128i* a = reinterpret_cast<__m128i*>(acc + i);
+        _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), lo));
+        _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), hi));
+    }
+    accumulateScalar(acc + i, in + i, count - i);
+}
+
+void accumulateGainSse2(int32_t* acc, const int16_t* in, const int16_t* gain, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gain + i));
+        // Full 32-bit products from the low and high halves
+        __m128i productLo = _mm_mullo_epi16(x, g);
+        __m128i productHi = _mm_mulhi_epi16(x, g);
+        __m128i p0 = _mm_srai_epi32(_mm_unpacklo_epi16(productLo, productHi), 14);
+        __m128i p1 = _mm_srai_epi32(_mm_unpackhi_epi16(productLo, productHi), 14);
+        __m128i* a = reinterpret_cast<__m128i*>(acc + i);
+        _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), p0));
+        _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), p1));
+    }
+    accumulateGainScalar(acc + i, in + i, gain + i, count - i);
+}
+
+void saturateSse2(int16_t* out, const int32_t* acc, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a0, a1));
+    }
+    saturateScalar(out + i, acc + i, count - i);
+}
+
+#endif // __SSE2__
+
+#if defined(AUDIO_MIXER_NEON)
+
+void accumulateNeon(int32_t* acc, const int16_t* in, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t x = vld1q_s16(in + i);
+        vst1q_s32(acc + i, vaddw_s16(vld1q_s32(acc + i), vget_low_s16(x)));
+        vst1q_s32(acc + i + 4, vaddw_s16(vld1q_s32(acc + i + 4), vget_high_s16(x)));
+    }
+    accumulateScalar(acc + i, in + i, count - i);
+}
+
+void accumulateGainNeon(int32_t* acc, const int16_t* in, const int16_t* gain, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t x = vld1q_s16(in + i);
+        int16x8_t g = vld1q_s16(gain + i);
+        int32x4_t p0 = vshrq_n_s32(vmull_s16(vget_low_s16(x), vget_low_s16(g)), 14);
+        int32x4_t p1 = vshrq_n_s32(vmull_s16(vget_high_s16(x), vget_high_s16(g)), 14);
+        vst1q_s32(acc + i, vaddq_s32(vld1q_s32(acc + i), p0));
+        vst1q_s32(acc + i + 4, vaddq_s32(vld1q_s32(acc + i + 4), p1));
+    }
+    accumulateGainScalar(acc + i, in + i, gain + i, count - i);
+}
+
+void saturateNeon(int16_t* out, const int32_t* acc, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(vld1q_s32(acc + i)), vqmovn_s32(vld1q_s32(acc + i + 4))));
+    }
+    saturateScalar(out + i, acc + i, count - i);
+}
+
+#endif // AUDIO_MIXER_NEON
+
+} // namespace
+
+AudioMixer::Isa AudioMixer::detectIsa() {
+#if defined(AUDIO_MIXER_NEON)
+    return Isa::NEON;
+#elif defined(__SSE2__)
+    return Isa::SSE2;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+const char* AudioMixer::isaName(Isa isa) {
+    switch (isa) {
+    case Isa::SCALAR: return "scalar";
+    case Isa::SSE2: return "sse2";
+    case Isa::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+AudioMixer::AudioMixer(const AASDKMixerConfig& config, AudioJitterBuffer* const buffers[AASDK_AV_CHANNEL_COUNT], Isa isa)
+    : config_(config), isa_(Isa::SCALAR), accumulate_(&accumulateScalar), accumulateGain_(&accumulateGainScalar),
+      saturate_(&saturateScalar), periodOffset_(config.period_frames), ducked_(false), periods_(0) {
+    const uint32_t samples = config_.period_frames * config_.channels;
+    accumulator_.resize(samples);
+    gainRamp_.resize(samples);
+    period_.resize(samples);
+
+    // Periods a full-scale gain change is spread over
+    auto rampStep = [this](uint32_t ms) {
+        float periods = static_cast<float>(ms) * config_.sample_rate / 1000.0f / config_.period_frames;
+        return periods > 1.0f ? 1.0f / periods : MAX_GAIN;
+    };
+    duckStep_ = rampStep(config_.duck_attack_ms);
+    releaseStep_ = rampStep(config_.duck_release_ms);
+
+    for (int i = AASDK_AV_CHANNEL_MEDIA_AUDIO; i < AASDK_AV_CHANNEL_COUNT; ++i) {
+        if (!buffers[i]) {
+            continue;
+        }
+        std::unique_ptr<Stream> stream(new Stream());
+        stream->buffer = buffers[i];
+        stream->format = buffers[i]->format();
+        stream->phase = 0;
+        stream->weightScale = static_cast<uint32_t>((static_cast<uint64_t>(1) << 31) / config_.sample_rate);
+        stream->buffered = 0;
+        uint32_t maxInput = static_cast<uint32_t>((config_.sample_rate - 1 + static_cast<uint64_t>(config_.period_frames) *
+                                                   stream->format.sample_rate) / config_.sample_rate) + 2;
+        if (stream->format.sample_rate != config_.sample_rate) {
+            stream->resampler = Resampler::create(stream->format.sample_rate, config_.sample_rate,
+                                                  stream->format.channels, config_.channels, config_.period_frames,
+                                                  resamplerIsa(isa));
+        }
+        if (stream->resampler) {
+            maxInput = std::max(maxInput, stream->resampler->maxInput());
+        }
+        stream->input.resize(static_cast<size_t>(maxInput) * stream->format.channels);
+        stream->output.resize(samples);
+        stream->flushing = false;
+        stream->gain = 1.0f;
+        stream->userGain.store(1.0f);
+        streams_[i] = std::move(stream);
+    }
+
+    switch (isa) {
+#if defined(__SSE2__)
+    case Isa::SSE2:
+        isa_ = isa;
+        accumulate_ = &accumulateSse2;
+        accumulateGain_ = &accumulateGainSse2;
+        saturate_ = &saturateSse2;
+        break;
+#endif
+#if defined(AUDIO_MIXER_NEON)
+    case Isa::NEON:
+        isa_ = isa;
+        accumulate_ = &accumulateNeon;
+        accumulateGain_ = &accumulateGainNeon;
+        saturate_ = &saturateNeon;
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+void AudioMixer::mix(int16_t* out, uint32_t frames) {
+    const uint32_t channels = config_.channels;
+    while (frames > 0) {
+        if (periodOffset_ == config_.period_frames) {
+            renderPeriod();
+            periodOffset_ = 0;
+        }
+        uint32_t count = std::min(frames, config_.period_frames - periodOffset_);
+        std::memcpy(out, &period_[static_cast<size_t>(periodOffset_) * channels],
+                    static_cast<size_t>(count) * channels * sizeof(int16_t));
+        out += static_cast<size_t>(count) * channels;
+        frames -= count;
+        periodOffset_ += count;
+    }
+}
+
+void AudioMixer::renderPeriod() {
+    const uint32_t frames = config_.period_frames;
+    const uint32_t channels = config_.channels;
+    const uint32_t samples = frames * channels;
+    std::fill(accumulator_.begin(), accumulator_.end(), 0);
+
+    for (int i = AASDK_AV_CHANNEL_MEDIA_AUDIO; i < AASDK_AV_CHANNEL_COUNT; ++i) {
+        if (!streams_[i]) {
+            continue;
+        }
+        Stream& stream = *streams_[i];
+        float target = targetGain(i);
+        float step = i == AASDK_AV_CHANNEL_MEDIA_AUDIO ? (target < stream.gain ? duckStep_ : releaseStep_) : MAX_GAIN;
+        float start = stream.gain;
+        stream.gain = moveToward(start, target, step);
+        if (!pull(stream)) {
+            continue;
+        }
+
+        int16_t from = toQ14(start);
+        int16_t to = toQ14(stream.gain);
+        if (from == to && to == UNITY_Q14) {
+            accumulate_(accumulator_.data(), stream.output.data(), samples);
+        } else if (from != to || to != 0) {
+            // Linear ramp across the period, reaching the new gain on its last frame
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                int16_t gain = static_cast<int16_t>(from + (to - from) * static_cast<int32_t>(frame + 1) /
+                                                              static_cast<int32_t>(frames));
+                for (uint32_t c = 0; c < channels; ++c) {
+                    gainRamp_[frame * channels + c] = gain;
+                }
+            }
+            accumulateGain_(accumulator_.data(), stream.output.data(), gainRamp_.data(), samples);
+        }
+    }
+
+    saturate_(period_.data(), accumulator_.data(), samples);
+    periods_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool AudioMixer::pull(Stream& stream) {
+    const uint32_t frames = config_.period_frames;
+    const uint32_t inChannels = stream.format.channels;
+    const uint32_t outChannels = config_.channels;
+
+    if (stream.resampler) {
+        uint32_t needed = stream.resampler->inputFor(frames);
+        uint32_t got = stream.buffer->read(stream.input.data(), needed, nullptr);
+        if (got == 0 && !stream.flushing) {
+            return false;
+        }
+        std::fill(stream.input.begin() + static_cast<size_t>(got) * inChannels,
+                  stream.input.begin() + static_cast<size_t>(needed) * inChannels, 0);
+        stream.resampler->process(stream.input.data(), stream.output.data(), frames);
+
+        // A period of silence plays out the filter's tail; after that the stream is idle
+        // and starts clean when audio comes back
+        stream.flushing = got > 0;
+        if (!stream.flushing) {
+            stream.resampler->reset();
+        }
+        return true;
+    }
+
+    // Input frames this period touches: the last output frame interpolates between
+    // `last` and last + 1, and the next period starts at `consumed`
+    const uint32_t inRate = stream.format.sample_rate;
+    const uint32_t outRate = config_.sample_rate;
+    uint64_t lastPos = stream.phase + static_cast<uint64_t>(frames - 1) * inRate;
+    uint64_t endPos = stream.phase + static_cast<uint64_t>(frames) * inRate;
+    uint32_t consumed = static_cast<uint32_t>(endPos / outRate);
+    uint32_t needed = std::max(static_cast<uint32_t>(lastPos / outRate) + 2, consumed);
+
+    uint32_t got = 0;
+    if (stream.buffered < needed) {
+        got = stream.buffer->read(&stream.input[static_cast<size_t>(stream.buffered) * inChannels],
+                                needed - stream.buffered, nullptr);
+        // Whatever the buffer could not supply plays as silence
+        std::fill(stream.input.begin() + static_cast<size_t>(stream.buffered + got) * inChannels,
+                  stream.input.begin() + static_cast<size_t>(needed) * inChannels, 0);
+    }
+    if (got == 0 && stream.buffered <= 1) {
+        // Idle: nothing but the carried frame. Start clean when audio comes back.
+        stream.buffered = 0;
+        stream.phase = 0;
+        return false;
+    }
+    stream.buffered = std::max(stream.buffered, needed);
+
+    const int16_t* in = stream.input.data();
+    int16_t* out = stream.output.data();
+    auto sample = [in, inChannels, outChannels](uint32_t frame, uint32_t channel) -> int32_t {
+        const int16_t* f = in + static_cast<size_t>(frame) * inChannels;
+        if (inChannels == outChannels) {
+            return f[channel];
+        }
+        return inChannels == 1 ? f[0] : (f[0] + f[1]) >> 1;
+    };
+
+    if (inRate == outRate && inChannels == outChannels) {
+        std::memcpy(out, in, static_cast<size_t>(frames) * outChannels * sizeof(int16_t));
+    } else {
+        // Linear interpolation between neighbouring input frames, 15-bit weights
+        uint32_t index = 0;
+        uint32_t remainder = stream.phase;
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            int32_t weight = static_cast<int32_t>((static_cast<uint64_t>(remainder) * stream.weightScale) >> 16);
+            for (uint32_t c = 0; c < outChannels; ++c) {
+                int32_t a = sample(index, c);
+                int32_t b = sample(index + 1, c);
+                out[frame * outChannels + c] = static_cast<int16_t>(a + (((b - a) * weight) >> 15));
+            }
+            remainder += inRate;
+            while (remainder >= outRate) {
+                remainder -= outRate;
+                ++index;
+            }
+        }
+    }
+
+    // Keep the frames the next period still needs
+    stream.phase = static_cast<uint32_t>(endPos % outRate);
+    stream.buffered -= consumed;
+    std::memmove(stream.input.data(), stream.input.data() + static_cast<size_t>(consumed) * inChannels,
+                 static_cast<size_t>(stream.buffered) * inChannels * sizeof(int16_t));
+    return true;
+}
+
+float AudioMixer::targetGain(int index) const {
+    float gain = streams_[index]->userGain.load(std::memory_order_relaxed);
+    if (index == AASDK_AV_CHANNEL_MEDIA_AUDIO && ducked_.load(std::memory_order_relaxed)) {
+        gain *= config_.duck_gain;
+    }
+    return gain;
+}
+
+void AudioMixer::setGain(int stream, float gain) {
+    if (stream < 0 || stream >= AASDK_AV_CHANNEL_COUNT || !streams_[stream]) {
+        return;
+    }
+    streams_[stream]->userGain.store(std::min(std::max(gain, 0.0f), MAX_GAIN), std::memory_order_relaxed);
+}
+
+void AudioMixer::setDucked(bool ducked) {
+    ducked_.store(ducked, std::memory_order_relaxed);
+}
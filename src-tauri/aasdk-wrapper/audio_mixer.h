@@ -0,0 +1,106 @@
+// Native audio mixer
+// Mixes the media, speech and system streams into one interleaved int16 stream for the
+// DAC, one period at a time. Each period every stream is pulled from its jitter buffer and
+// converted to the output format (by the polyphase resampler where it has a filter for
+// the rate pair, by linear interpolation otherwise), then scaled by its gain and summed
+// into a 32-bit accumulator that is saturated back to int16 once, so a loud prompt over
+// loud music clips instead of wrapping. Gains move in ramps spread across the period,
+// never in steps; media is ducked while a transient focus is held over the media focus.
+// The gain and sum kernels have SSE2 and NEON versions that are bit-identical to the
+// scalar ones.
+
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "aasdk_c.h"
+#include "jitter_buffer.h"
+#include "resampler.h"
+
+class AudioMixer {
+public:
+    enum class Isa {
+        SCALAR,
+        SSE2,
+        NEON
+    };
+
+    // Best kernel set supported by this build and CPU
+    static Isa detectIsa();
+    static const char* isaName(Isa isa);
+
+    // Unity gain in the Q14 fixed point the kernels use
+    static constexpr int32_t UNITY_Q14 = 1 << 14;
+
+    // Mixes buffers[AASDK_AV_CHANNEL_*_AUDIO]; a NULL buffer is left out.
+    // Falls back to the scalar kernels if isa is not available.
+    AudioMixer(const AASDKMixerConfig& config, AudioJitterBuffer* const buffers[AASDK_AV_CHANNEL_COUNT], Isa isa = detectIsa());
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    Isa isa() const { return isa_; }
+    const AASDKMixerConfig& config() const { return config_; }
+
+    // Audio thread. Fill frames interleaved output frames, rendering periods as needed.
+    // Never blocks or allocates; silence where no stream has audio.
+    void mix(int16_t* out, uint32_t frames);
+
+    // Any thread. Volume of one stream (0..2, 1 = unity), ramped in over a period.
+    void setGain(int stream, float gain);
+
+    // Any thread. Duck media under guidance and other transient audio.
+    void setDucked(bool ducked);
+    bool ducked() const { return ducked_.load(std::memory_order_relaxed); }
+
+    uint64_t periods() const { return periods_.load(std::memory_order_relaxed); }
+
+private:
+    // acc += in, acc += (in * gain) >> 14 and out = saturate(acc), over count samples
+    typedef void (*AccumulateKernel)(int32_t* acc, const int16_t* in, uint32_t count);
+    typedef void (*AccumulateGainKernel)(int32_t* acc, const int16_t* in, const int16_t* gain, uint32_t count);
+    typedef void (*SaturateKernel)(int16_t* out, const int32_t* acc, uint32_t count);
+
+    struct Stream {
+        AudioJitterBuffer* buffer;
+        AASDKAudioFormat format;
+        uint32_t phase;             // Position of the next output frame past input[0], in
+                                    // 1/sample_rate of an input frame (exact, no drift)
+        uint32_t weightScale;       // phase to a 15-bit interpolation weight, 16.16
+        uint32_t buffered;          // Input frames held in input
+        std::vector<int16_t> input;     // Ring frames in the stream's own format
+        std::vector<int16_t> output;    // One period converted to the mixer format
+        std::unique_ptr<Resampler> resampler;   // Replaces the interpolation when set
+        bool flushing;              // Resampler history still holds audio
+        float gain;                 // Applied at the end of the last period
+        std::atomic<float> userGain;
+    };
+
+    void renderPeriod();
+    // Pull one period of stream from its buffer into stream.output; false if it had nothing
+    bool pull(Stream& stream);
+    float targetGain(int index) const;
+
+    AASDKMixerConfig config_;
+    Isa isa_;
+    AccumulateKernel accumulate_;
+    AccumulateGainKernel accumulateGain_;
+    SaturateKernel saturate_;
+
+    std::unique_ptr<Stream> streams_[AASDK_AV_CHANNEL_COUNT];
+    std::vector<int32_t> accumulator_;
+    std::vector<int16_t> gainRamp_;
+    std::vector<int16_t> period_;
+    uint32_t periodOffset_;         // Frames of period_ already handed out
+    float duckStep_;                // Largest gain change per period while ducking
+    float releaseStep_;             // Same when the duck releases
+
+    std::atomic<bool> ducked_;
+    std::atomic<uint64_t> periods_;
+};
+
+#endif // AUDIO_MIXER_H
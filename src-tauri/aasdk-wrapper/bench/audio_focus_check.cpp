@@ -0,0 +1,173 @@
+// Audio focus state machine check
+//
+// Feeds AudioFocus the request sequences a phone sends (music, navigation prompts over
+// it, assistant and calls, releases, a new connection) and checks after every request
+// the state granted, which streams play, whether media is ducked and whether the request
+// counted as a transition. Prints one line per sequence, and the first mismatch of a
+// failing one.
+//
+// Usage: audio_focus_check
+
+#include <cstdio>
+#include <vector>
+
+#include "audio_focus.h"
+
+namespace {
+
+using Request = AudioFocus::Request;
+
+// Streams that play, by AASDKAVChannel
+const uint32_t MEDIA = 1u << AASDK_AV_CHANNEL_MEDIA_AUDIO;
+const uint32_t SPEECH = 1u << AASDK_AV_CHANNEL_SPEECH_AUDIO;
+const uint32_t SYSTEM = 1u << AASDK_AV_CHANNEL_SYSTEM_AUDIO;
+const uint32_t ALL = MEDIA | SPEECH | SYSTEM;
+
+// RESET stands for a new connection rather than a phone request
+const Request RESET = static_cast<Request>(-1);
+
+struct Step {
+    Request request;
+    AASDKAudioFocusState state;
+    uint32_t playing;
+    bool ducked;
+    bool changed;
+};
+
+struct Sequence {
+    const char* name;
+    std::vector<Step> steps;
+};
+
+const char* requestName(Request request) {
+    switch (request) {
+    case Request::NONE: return "NONE";
+    case Request::GAIN: return "GAIN";
+    case Request::GAIN_TRANSIENT: return "GAIN_TRANSIENT";
+    case Request::GAIN_NAVI: return "GAIN_NAVI";
+    case Request::RELEASE: return "RELEASE";
+    }
+    return "RESET";
+}
+
+uint32_t playingMask(const AASDKAudioFocusInfo& info) {
+    uint32_t mask = 0;
+    for (int i = 0; i < AASDK_AV_CHANNEL_COUNT; ++i) {
+        if (info.stream_active[i]) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+bool run(const Sequence& sequence) {
+    AudioFocus focus;
+    for (size_t i = 0; i < sequence.steps.size(); ++i) {
+        const Step& step = sequence.steps[i];
+        AASDKAudioFocusInfo info = {};
+        bool changed = false;
+        if (step.request == RESET) {
+            focus.reset();
+            focus.info(&info);
+            changed = step.changed;
+        } else {
+            focus.request(step.request, &info, &changed);
+        }
+
+        uint32_t playing = playingMask(info);
+        bool ducked = info.media_ducked;
+        bool streamsAgree = true;
+        for (int stream = 0; stream < AASDK_AV_CHANNEL_COUNT; ++stream) {
+            streamsAgree = streamsAgree && focus.active(stream) == ((playing & 1u << stream) != 0);
+        }
+        if (info.state != step.state || playing != step.playing || ducked != step.ducked ||
+            focus.ducked() != ducked || changed != step.changed || !streamsAgree) {
+            std::printf("  FAIL  %s\n", sequence.name);
+            std::printf("        step %zu %s: got %s, playing 0x%x, ducked %d, changed %d;"
+                        " want %s, playing 0x%x, ducked %d, changed %d\n",
+                        i + 1, requestName(step.request),
+                        AudioFocus::stateName(static_cast<AASDKAudioFocusState>(info.state)), playing, ducked,
+                        changed, AudioFocus::stateName(step.state), step.playing, step.ducked, step.changed);
+            return false;
+        }
+    }
+    std::printf("  ok    %s\n", sequence.name);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    const AASDKAudioFocusState NONE = AASDK_AUDIO_FOCUS_NONE;
+    const AASDKAudioFocusState GAIN = AASDK_AUDIO_FOCUS_GAIN;
+    const AASDKAudioFocusState TRANSIENT = AASDK_AUDIO_FOCUS_GAIN_TRANSIENT;
+    const AASDKAudioFocusState GUIDANCE = AASDK_AUDIO_FOCUS_GAIN_TRANSIENT_GUIDANCE_ONLY;
+    const AASDKAudioFocusState LOSS = AASDK_AUDIO_FOCUS_LOSS;
+
+    const std::vector<Sequence> sequences = {
+        {"nothing asked yet: every stream plays", {
+            {Request::NONE, NONE, ALL, false, false},
+        }},
+        {"music: GAIN, repeated GAIN is no transition", {
+            {Request::GAIN, GAIN, ALL, false, true},
+            {Request::GAIN, GAIN, ALL, false, false},
+        }},
+        {"prompt over music: GAIN, NAVI, RELEASE back to GAIN", {
+            {Request::GAIN, GAIN, ALL, false, true},
+            {Request::GAIN_NAVI, GUIDANCE, ALL, true, true},
+            {Request::RELEASE, GAIN, ALL, false, true},
+        }},
+        {"prompt over music, then music released: LOSS keeps system sounds", {
+            {Request::GAIN, GAIN, ALL, false, true},
+            {Request::GAIN_NAVI, GUIDANCE, ALL, true, true},
+            {Request::RELEASE, GAIN, ALL, false, true},
+            {Request::RELEASE, LOSS, SYSTEM, false, true},
+        }},
+        {"assistant over music: GAIN, TRANSIENT, GAIN ends it", {
+            {Request::GAIN, GAIN, ALL, false, true},
+            {Request::GAIN_TRANSIENT, TRANSIENT, ALL, true, true},
+            {Request::GAIN, GAIN, ALL, false, true},
+        }},
+        {"call replaces a prompt: GAIN, NAVI, TRANSIENT, RELEASE", {
+            {Request::GAIN, GAIN, ALL, false, true},
+            {Request::GAIN_NAVI, GUIDANCE, ALL, true, true},
+            {Request::GAIN_TRANSIENT, TRANSIENT, ALL, true, true},
+            {Request::RELEASE, GAIN, ALL, false, true},
+        }},
+        {"transient alone: TRANSIENT plays media unducked, RELEASE to LOSS", {
+            {Request::GAIN_TRANSIENT, TRANSIENT, ALL, false, true},
+            {Request::RELEASE, LOSS, SYSTEM, false, true},
+        }},
+        {"prompt alone: NAVI pauses media, RELEASE to LOSS", {
+            {Request::GAIN_NAVI, GUIDANCE, SPEECH | SYSTEM, false, true},
+            {Request::RELEASE, LOSS, SYSTEM, false, true},
+            {Request::RELEASE, LOSS, SYSTEM, false, false},
+        }},
+        {"music released, prompt after it", {
+            {Request::GAIN, GAIN, ALL, false, true},
+            {Request::RELEASE, LOSS, SYSTEM, false, true},
+            {Request::GAIN_NAVI, GUIDANCE, SPEECH | SYSTEM, false, true},
+            {Request::RELEASE, LOSS, SYSTEM, false, true},
+        }},
+        {"NONE answers with what is granted", {
+            {Request::GAIN, GAIN, ALL, false, true},
+            {Request::GAIN_NAVI, GUIDANCE, ALL, true, true},
+            {Request::NONE, GUIDANCE, ALL, true, false},
+        }},
+        {"new connection: reset from a held transient, then GAIN", {
+            {Request::GAIN, GAIN, ALL, false, true},
+            {Request::GAIN_TRANSIENT, TRANSIENT, ALL, true, true},
+            {RESET, NONE, ALL, false, false},
+            {Request::RELEASE, LOSS, SYSTEM, false, true},
+            {RESET, NONE, ALL, false, false},
+            {Request::GAIN, GAIN, ALL, false, true},
+        }},
+    };
+
+    std::printf("Audio focus: %zu request sequences\n\n", sequences.size());
+    bool passed = true;
+    for (const Sequence& sequence : sequences) {
+        passed = run(sequence) && passed;
+    }
+    return passed ? 0 : 1;
+}
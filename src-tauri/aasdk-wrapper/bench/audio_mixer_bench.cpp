@@ -0,0 +1,170 @@
+// Native audio mixer benchmark
+//
+// Feeds the three Android Auto audio streams (48 kHz stereo media, 16 kHz mono speech
+// and system) through their jitter buffers, turned off so the mix does not depend on
+// timing, into a 48 kHz stereo mixer, with loud enough input to saturate, speech and
+// navigation prompts ducking the media, and volume changes mid-stream. Every kernel set this CPU supports is checked bit-exact against the scalar
+// one over the whole run, then timed per 10 ms period, the DAC's budget for one period.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "audio_mixer.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const uint32_t RATE = 48000;
+const uint32_t PERIOD = 480;        // 10 ms
+
+struct Source {
+    AASDKAVChannel stream;
+    AASDKAudioFormat format;
+    std::vector<int16_t> samples;   // One 10 ms payload, written whole every period
+};
+
+// Loud noise over a tone, so sums regularly leave the int16 range
+void makeSource(Source& source, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> noise(-6000, 6000);
+    uint32_t frames = source.format.sample_rate / 100;
+    source.samples.resize(static_cast<size_t>(frames) * source.format.channels);
+    for (uint32_t i = 0; i < frames; ++i) {
+        double tone = 24000.0 * std::sin(6.283185307 * 440.0 * i / source.format.sample_rate);
+        for (uint32_t c = 0; c < source.format.channels; ++c) {
+            int value = static_cast<int>(tone) + noise(rng);
+            source.samples[i * source.format.channels + c] = static_cast<int16_t>(std::max(-32768, std::min(32767, value)));
+        }
+    }
+}
+
+struct Run {
+    std::vector<int16_t> output;
+    double mixSeconds;
+    uint32_t periods;
+};
+
+// Mix periods periods, feeding each buffer one period of its stream first, and time the mixing
+Run mixSession(AudioMixer::Isa isa, std::vector<Source>& sources, uint32_t periods, bool keep) {
+    const AASDKJitterConfig off = {0, 0};
+    std::unique_ptr<AudioJitterBuffer> owned[AASDK_AV_CHANNEL_COUNT];
+    AudioJitterBuffer* buffers[AASDK_AV_CHANNEL_COUNT] = {};
+    for (auto& source : sources) {
+        owned[source.stream].reset(new AudioJitterBuffer(source.format.sample_rate / 10, source.format, off));
+        buffers[source.stream] = owned[source.stream].get();
+    }
+
+    AASDKMixerConfig config;
+    config.sample_rate = RATE;
+    config.channels = 2;
+    config.period_frames = PERIOD;
+    config.duck_gain = 0.2f;
+    config.duck_attack_ms = 50;
+    config.duck_release_ms = 300;
+    AudioMixer mixer(config, buffers, isa);
+
+    Run run;
+    run.mixSeconds = 0.0;
+    run.periods = periods;
+    if (keep) {
+        run.output.resize(static_cast<size_t>(periods) * PERIOD * 2);
+    }
+    std::vector<int16_t> out(PERIOD * 2);
+    AASDKMediaInfo info = {};
+
+    for (uint32_t period = 0; period < periods; ++period) {
+        // A prompt every second and a half, lasting half a second; system sounds in bursts
+        bool prompt = period % 150 < 50;
+        mixer.setDucked(prompt);
+        if (period % 200 == 100) {
+            mixer.setGain(AASDK_AV_CHANNEL_MEDIA_AUDIO, period % 400 == 100 ? 1.6f : 0.7f);
+        }
+        for (auto& source : sources) {
+            bool active = source.stream == AASDK_AV_CHANNEL_MEDIA_AUDIO ||
+                          (source.stream == AASDK_AV_CHANNEL_SPEECH_AUDIO && prompt) ||
+                          (source.stream == AASDK_AV_CHANNEL_SYSTEM_AUDIO && period % 70 < 8);
+            if (active) {
+                buffers[source.stream]->write(source.samples.data(),
+                                              static_cast<uint32_t>(source.samples.size() / source.format.channels), info);
+            }
+        }
+
+        auto start = Clock::now();
+        mixer.mix(out.data(), PERIOD);
+        run.mixSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+        if (keep) {
+            std::copy(out.begin(), out.end(), run.output.begin() + static_cast<size_t>(period) * PERIOD * 2);
+        }
+    }
+    return run;
+}
+
+size_t countMismatches(const std::vector<int16_t>& a, const std::vector<int16_t>& b) {
+    size_t mismatches = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        mismatches += a[i] != b[i];
+    }
+    return mismatches;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t periods = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 6000;
+
+    std::vector<Source> sources(3);
+    sources[0].stream = AASDK_AV_CHANNEL_MEDIA_AUDIO;
+    sources[0].format = {48000, 2, 16};
+    sources[1].stream = AASDK_AV_CHANNEL_SPEECH_AUDIO;
+    sources[1].format = {16000, 1, 16};
+    sources[2].stream = AASDK_AV_CHANNEL_SYSTEM_AUDIO;
+    sources[2].format = {16000, 1, 16};
+    for (size_t i = 0; i < sources.size(); ++i) {
+        makeSource(sources[i], static_cast<uint32_t>(i + 1));
+    }
+
+    const AudioMixer::Isa candidates[] = {AudioMixer::Isa::SCALAR, AudioMixer::Isa::SSE2, AudioMixer::Isa::NEON};
+    AudioJitterBuffer* none[AASDK_AV_CHANNEL_COUNT] = {};
+    AASDKMixerConfig probe = {RATE, 2, PERIOD, 0.2f, 50, 300};
+    std::vector<AudioMixer::Isa> isas;
+    for (auto isa : candidates) {
+        AudioMixer mixer(probe, none, isa);
+        if (mixer.isa() == isa) {
+            isas.push_back(isa);
+        }
+    }
+    std::printf("Detected kernels: %s\n", AudioMixer::isaName(AudioMixer::detectIsa()));
+    std::printf("Media 48 kHz x2 + speech/system 16 kHz x1 -> 48 kHz x2, %u periods of %u frames\n\n",
+                periods, PERIOD);
+
+    Run reference = mixSession(AudioMixer::Isa::SCALAR, sources, periods, true);
+    size_t clipped = 0;
+    for (int16_t sample : reference.output) {
+        clipped += sample == 32767 || sample == -32768;
+    }
+    std::printf("Saturated samples in the mix: %zu of %zu\n\n", clipped, reference.output.size());
+
+    bool exact = true;
+    const double budgetUs = 1e6 * PERIOD / RATE;
+    for (auto isa : isas) {
+        Run run = mixSession(isa, sources, periods, true);
+        size_t mismatches = countMismatches(run.output, reference.output);
+        exact = exact && mismatches == 0;
+
+        // Time a second pass without keeping the output
+        Run timed = mixSession(isa, sources, periods, false);
+        double usPerPeriod = timed.mixSeconds * 1e6 / timed.periods;
+        std::printf("  %-8s %7.2f us/period  %6.3f%% of the %.0f us budget  %s\n", AudioMixer::isaName(isa),
+                    usPerPeriod, 100.0 * usPerPeriod / budgetUs, budgetUs,
+                    mismatches == 0 ? "bit-exact" : "MISMATCH");
+    }
+
+    return exact ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+#!/bin/bash
+# Build the standalone wrapper benchmarks
+# Usage: ./build_bench.sh [output_dir]
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+WRAPPER_DIR="$(dirname "$SCRIPT_DIR")"
+OUT_DIR="${1:-${SCRIPT_DIR}/build}"
+
+CXX="${CXX:-g++}"
+CXXFLAGS="${CXXFLAGS:--std=c++14 -O2 -Wall}"
+
+mkdir -p "$OUT_DIR"
+
+# The dispatch benchmark drives the real USBEventLoop, so it needs libusb
+if pkg-config --exists libusb-1.0; then
+    echo "Building dispatch_latency_bench..."
+    $CXX $CXXFLAGS -I"$WRAPPER_DIR" $(pkg-config --cflags libusb-1.0) "$SCRIPT_DIR/dispatch_latency_bench.cpp" \
+        "$WRAPPER_DIR/usb_event_loop.cpp" -o "$OUT_DIR/dispatch_latency_bench" \
+        $(pkg-config --libs libusb-1.0) -lboost_system -lpthread
+else
+    echo "Skipping dispatch_latency_bench: libusb-1.0 not found"
+fi
+
+echo "Building yuv_convert_bench..."
+$CXX $CXXFLAGS -I"$WRAPPER_DIR" "$SCRIPT_DIR/yuv_convert_bench.cpp" "$WRAPPER_DIR/yuv_convert.cpp" \
+    -o "$OUT_DIR/yuv_convert_bench"
+
+echo "Building frame_ring_bench..."
+$CXX $CXXFLAGS -I"$WRAPPER_DIR" "$SCRIPT_DIR/frame_ring_bench.cpp" "$WRAPPER_DIR/frame_ring.cpp" \
+    -o "$OUT_DIR/frame_ring_bench" -lpthread
+
+echo "Building capture_bench..."
+$CXX $CXXFLAGS -I"$WRAPPER_DIR" "$SCRIPT_DIR/capture_bench.cpp" "$WRAPPER_DIR/session_capture.cpp" \
+    -o "$OUT_DIR/capture_bench" -lpthread
+
+echo "Building resampler_bench..."
+$CXX $CXXFLAGS -I"$WRAPPER_DIR" "$SCRIPT_DIR/resampler_bench.cpp" "$WRAPPER_DIR/resampler.cpp" \
+    -o "$OUT_DIR/resampler_bench"
+
+echo "Building audio_mixer_bench..."
+$CXX $CXXFLAGS -I"$WRAPPER_DIR" "$SCRIPT_DIR/audio_mixer_bench.cpp" "$WRAPPER_DIR/audio_mixer.cpp" \
+    "$WRAPPER_DIR/jitter_buffer.cpp" "$WRAPPER_DIR/pcm_ring.cpp" "$WRAPPER_DIR/resampler.cpp" \
+    -o "$OUT_DIR/audio_mixer_bench"
+
+echo "Building mic_capture_bench..."
+$CXX $CXXFLAGS -I"$WRAPPER_DIR" "$SCRIPT_DIR/mic_capture_bench.cpp" "$WRAPPER_DIR/mic_capture.cpp" \
+    "$WRAPPER_DIR/pcm_ring.cpp" "$WRAPPER_DIR/wav_source.cpp" -o "$OUT_DIR/mic_capture_bench" -lpthread
+
+echo "Building input_batcher_bench..."
+$CXX $CXXFLAGS -I"$WRAPPER_DIR" "$SCRIPT_DIR/input_batcher_bench.cpp" "$WRAPPER_DIR/input_batcher.cpp" \
+    -o "$OUT_DIR/input_batcher_bench" -lpthread
+
+echo "Building audio_focus_check..."
+$CXX $CXXFLAGS -I"$WRAPPER_DIR" "$SCRIPT_DIR/audio_focus_check.cpp" "$WRAPPER_DIR/audio_focus.cpp" \
+    -o "$OUT_DIR/audio_focus_check"
+
+# The replay benchmark runs the whole wrapper, so it needs the aasdk build (./build_aasdk.sh)
+AASDK_BUILD_DIR="$WRAPPER_DIR/build"
+if [ -f "$AASDK_BUILD_DIR/lib/libaasdk.so" ]; then
+    echo "Building replay_bench..."
+    LIBAV_FLAGS=""
+    LIBAV_LIBS=""
+    if pkg-config --exists libavcodec libavutil; then
+        LIBAV_FLAGS="-DAASDK_WITH_LIBAV $(pkg-config --cflags libavcodec libavutil)"
+        LIBAV_LIBS="$(pkg-config --libs libavcodec libavutil)"
+    fi
+    WRAPPER_SOURCES="$WRAPPER_DIR/aasdk_c.cpp"
+    for module in usb_event_loop frame_pool video_queue h264_decoder yuv_convert h264_parser media_ack \
+                  video_probe frame_ring lag_controller session_capture session_replay pcm_ring jitter_buffer \
+                  resampler audio_mixer mic_capture wav_source audio_focus input_batcher; do
+        WRAPPER_SOURCES="$WRAPPER_SOURCES $WRAPPER_DIR/$module.cpp"
+    done
+    $CXX $CXXFLAGS $LIBAV_FLAGS -I"$WRAPPER_DIR" -I"$WRAPPER_DIR/aasdk/include" -I"$AASDK_BUILD_DIR" \
+        $(pkg-config --cflags libusb-1.0) "$SCRIPT_DIR/replay_bench.cpp" $WRAPPER_SOURCES \
+        -o "$OUT_DIR/replay_bench" -L"$AASDK_BUILD_DIR/lib" -Wl,-rpath,"$AASDK_BUILD_DIR/lib" \
+        -laasdk -laasdk_proto -lprotobuf -lusb-1.0 -lboost_system -lssl -lcrypto $LIBAV_LIBS -lpthread
+else
+    echo "Skipping replay_bench: aasdk not built in $AASDK_BUILD_DIR"
+fi
+
+echo "Benchmarks built in $OUT_DIR"
@@ -0,0 +1,152 @@
+// Session capture overhead benchmark
+//
+// Replays the message mix of a 720p60 session (60 video frames of ~24 KB, 100 media audio
+// packets of 10 ms and an ack for each, per second) through SessionCapture in real time
+// and compares process CPU time with the same traffic uncaptured.
+//
+// Measures:
+//   - record():  producer-side cost per message, as paid by the io threads (payload size
+//                doesn't matter: only a reference is queued)
+//   - overhead:  extra CPU over the paced run, in percent of one core (writer thread included)
+//
+// Usage: capture_bench [seconds] [capture file]
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "session_capture.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr int TICK_HZ = 100;
+constexpr int VIDEO_FPS = 60;
+constexpr size_t VIDEO_BYTES = 24 * 1024;
+constexpr size_t AUDIO_BYTES = 1920;  // 10 ms of 48 kHz stereo s16
+
+typedef std::shared_ptr<const SessionCapture::Payload> Message;
+
+Message makeMessage(uint16_t messageId, size_t size) {
+    auto payload = std::make_shared<SessionCapture::Payload>(size);
+    for (size_t i = 0; i < size; ++i) {
+        (*payload)[i] = static_cast<uint8_t>(i * 131);
+    }
+    (*payload)[0] = static_cast<uint8_t>(messageId >> 8);
+    (*payload)[1] = static_cast<uint8_t>(messageId);
+    return payload;
+}
+
+double cpuSeconds() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+struct Traffic {
+    Message video = makeMessage(0x0000, VIDEO_BYTES + 8);
+    Message audio = makeMessage(0x0000, AUDIO_BYTES + 8);
+    Message ack = makeMessage(0x8004, 6);
+};
+
+// Touch every payload the way a consumer would so both runs do the same real work
+uint64_t consume(const Message& message) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < message->size(); i += 64) {
+        sum += (*message)[i];
+    }
+    return sum;
+}
+
+uint64_t runPaced(const Traffic& traffic, SessionCapture* capture, int seconds, uint64_t* messages) {
+    uint64_t sum = 0;
+    auto next = Clock::now();
+    int videoCredit = 0;
+    for (int tick = 0; tick < seconds * TICK_HZ; ++tick) {
+        std::vector<std::pair<const Message*, uint8_t>> batch = {{&traffic.audio, 4}, {&traffic.ack, 4}};
+        videoCredit += VIDEO_FPS;
+        if (videoCredit >= TICK_HZ) {
+            videoCredit -= TICK_HZ;
+            batch.push_back({&traffic.video, 3});
+            batch.push_back({&traffic.ack, 3});
+        }
+        for (const auto& entry : batch) {
+            const Message& message = *entry.first;
+            auto direction = message == traffic.ack ? capture::Direction::OUTBOUND : capture::Direction::INBOUND;
+            if (capture) {
+                capture->record(direction, entry.second, capture::FLAG_ENCRYPTED, message, message == traffic.ack ? 0 : 2);
+            }
+            sum += consume(message);
+            ++*messages;
+        }
+        next += std::chrono::microseconds(1000000 / TICK_HZ);
+        std::this_thread::sleep_until(next);
+    }
+    return sum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 5;
+    const char* path = argc > 2 ? argv[2] : "/tmp/aasdk_capture_bench.cap";
+    Traffic traffic;
+
+    std::printf("Session capture, %d s of 720p60 traffic\n", seconds);
+
+    // Producer cost: what an io thread pays per message, writer draining concurrently
+    {
+        auto capture = SessionCapture::open(path, 0);
+        if (!capture) {
+            return 1;
+        }
+        const int burst = 256;
+        double best = 1e9;
+        for (int round = 0; round < 100; ++round) {
+            auto start = Clock::now();
+            for (int i = 0; i < burst; ++i) {
+                capture->record(capture::Direction::INBOUND, 4, 0, traffic.audio, 2);
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / burst;
+            best = std::min(best, ns);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        capture->stop();
+        std::printf("  record()          %8.1f ns per message (best burst of %d)\n", best, burst);
+    }
+
+    uint64_t sum = 0;
+    uint64_t plainMessages = 0;
+    double cpu = cpuSeconds();
+    auto wall = Clock::now();
+    sum += runPaced(traffic, nullptr, seconds, &plainMessages);
+    double plainCpu = cpuSeconds() - cpu;
+    double plainWall = std::chrono::duration<double>(Clock::now() - wall).count();
+
+    uint64_t capturedMessages = 0;
+    auto capture = SessionCapture::open(path, 0);
+    if (!capture) {
+        return 1;
+    }
+    cpu = cpuSeconds();
+    wall = Clock::now();
+    sum += runPaced(traffic, capture.get(), seconds, &capturedMessages);
+    capture->stop();
+    double capturedCpu = cpuSeconds() - cpu;
+    double capturedWall = std::chrono::duration<double>(Clock::now() - wall).count();
+
+    std::printf("  uncaptured        %8.2f %% of a core  (%llu messages)\n", 100.0 * plainCpu / plainWall,
+                static_cast<unsigned long long>(plainMessages));
+    std::printf("  captured          %8.2f %% of a core  (%llu records, %.1f MB, %llu dropped)\n",
+                100.0 * capturedCpu / capturedWall, static_cast<unsigned long long>(capture->records()),
+                capture->bytes() / 1e6, static_cast<unsigned long long>(capture->dropped()));
+    std::printf("  overhead          %8.2f %% of a core\n", 100.0 * (capturedCpu / capturedWall - plainCpu / plainWall));
+    return sum == 0 ? 1 : 0;
+}
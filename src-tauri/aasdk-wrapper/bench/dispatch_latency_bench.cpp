@@ -0,0 +1,205 @@
+// Handler dispatch latency benchmark for the io thread
+//
+// Compares the old polling loop (ioService.poll() + 100 ms libusb wait + 10 ms sleep)
+// with the reactor loop (USBEventLoop registering libusb's pollfds as asio descriptors +
+// ioService.run()), both on a real libusb context. No phone is needed: USB activity is
+// libusb_interrupt_event_handler(), which signals the same internal event fd a completed
+// transfer does, and counts as handled once libusb has drained that fd again.
+//
+// Measures:
+//   - post latency: boost::asio::post() from another thread -> handler running (60 Hz, like video),
+//                   once with USB quiet and once with USB traffic
+//   - usb latency:  libusb event signalled -> libusb_handle_events() consuming it
+//   - idle wakeups: io thread loop iterations (or handlers run) per second with nothing to do
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+
+#include <boost/asio.hpp>
+#include <libusb-1.0/libusb.h>
+
+#include "usb_event_loop.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Samples {
+    std::mutex mutex;
+    std::vector<double> values;
+
+    void add(Clock::time_point start) {
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(mutex);
+        values.push_back(us);
+    }
+
+    void print(const char* label) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (values.empty()) {
+            std::printf("  %-16s no samples\n", label);
+            return;
+        }
+        std::sort(values.begin(), values.end());
+        auto pct = [this](double p) { return values[static_cast<size_t>(p * (values.size() - 1))]; };
+        std::printf("  %-16s n=%-4zu p50=%9.1f us  p99=%9.1f us  max=%9.1f us\n",
+                    label, values.size(), pct(0.50), pct(0.99), values.back());
+    }
+};
+
+struct Harness {
+    boost::asio::io_service ioService;
+    libusb_context* usbContext = nullptr;
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> wakeups{0};
+    std::atomic<Clock::rep> usbSignalTime{0};   // 0 = nothing outstanding
+    Samples postQuiet;
+    Samples postBusy;
+    Samples usb;
+
+    Harness() {
+        int ret = libusb_init(&usbContext);
+        if (ret != 0) {
+            std::fprintf(stderr, "libusb_init failed: %s\n", libusb_error_name(ret));
+            std::exit(1);
+        }
+    }
+
+    ~Harness() {
+        libusb_exit(usbContext);
+    }
+
+    // Raise libusb's event fd as a completed transfer would; one outstanding at a time
+    void signalUsb() {
+        if (usbSignalTime.load() != 0) {
+            return;
+        }
+        usbSignalTime = Clock::now().time_since_epoch().count();
+        libusb_interrupt_event_handler(usbContext);
+    }
+
+    // io thread, after each loop iteration or handler: record the signal once libusb
+    // has handled it, i.e. none of its fds is readable any more
+    void checkUsb() {
+        Clock::rep signalled = usbSignalTime.load();
+        if (signalled == 0) {
+            return;
+        }
+        const libusb_pollfd** pollfds = libusb_get_pollfds(usbContext);
+        if (!pollfds) {
+            return;
+        }
+        std::vector<pollfd> fds;
+        for (const libusb_pollfd** it = pollfds; *it != nullptr; ++it) {
+            fds.push_back({(*it)->fd, POLLIN, 0});
+        }
+        libusb_free_pollfds(pollfds);
+        if (::poll(fds.data(), fds.size(), 0) == 0) {
+            usb.add(Clock::time_point(Clock::duration(signalled)));
+            usbSignalTime = 0;
+        }
+    }
+};
+
+static void runPollingLoop(Harness& h) {
+    boost::asio::io_service::work work(h.ioService);
+    while (h.running) {
+        ++h.wakeups;
+        h.ioService.poll();
+
+        struct timeval tv = {0, 100000};
+        libusb_handle_events_timeout_completed(h.usbContext, &tv, nullptr);
+        h.checkUsb();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+static void runReactorLoop(Harness& h) {
+    USBEventLoop eventLoop(h.ioService, h.usbContext);
+    eventLoop.start();
+
+    boost::asio::io_service::work work(h.ioService);
+    std::thread stopper([&h]() {
+        while (h.running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        h.ioService.stop();
+    });
+    // The worker loop of AASDKContext::startIoThreads
+    while (h.ioService.run_one() != 0) {
+        ++h.wakeups;
+        h.checkUsb();
+    }
+    stopper.join();
+    eventLoop.stop();
+}
+
+static void runScenario(const char* name, bool reactor, int seconds) {
+    Harness h;
+    std::thread ioThread([&h, reactor]() {
+        if (reactor) {
+            runReactorLoop(h);
+        } else {
+            runPollingLoop(h);
+        }
+    });
+
+    // Idle phase: nothing posted, no USB activity
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    uint64_t idleStart = h.wakeups.load();
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    uint64_t idleWakeups = h.wakeups.load() - idleStart;
+
+    // Load phase: a 60 Hz posted handler, first with USB quiet, then with a USB event
+    // every 7 ms
+    auto load = [&h](int durationMs, Samples& postSamples, bool withUsb) {
+        auto end = Clock::now() + std::chrono::milliseconds(durationMs);
+        auto nextPost = Clock::now();
+        auto nextUsb = Clock::now();
+        while (Clock::now() < end) {
+            auto now = Clock::now();
+            if (now >= nextPost) {
+                auto postedAt = Clock::now();
+                Samples* samples = &postSamples;
+                boost::asio::post(h.ioService, [&h, samples, postedAt]() {
+                    if (!h.running.load()) {
+                        return;
+                    }
+                    samples->add(postedAt);
+                });
+                nextPost += std::chrono::microseconds(16667);
+            }
+            if (withUsb && now >= nextUsb) {
+                h.signalUsb();
+                nextUsb += std::chrono::milliseconds(7);
+            }
+            std::this_thread::sleep_until(withUsb ? std::min(nextPost, nextUsb) : nextPost);
+        }
+    };
+    load(seconds * 500, h.postQuiet, false);
+    load(seconds * 500, h.postBusy, true);
+
+    h.running = false;
+    ioThread.join();
+
+    std::printf("%s\n", name);
+    std::printf("  %-16s %llu/s\n", "idle wakeups", static_cast<unsigned long long>(idleWakeups));
+    h.postQuiet.print("post (usb idle)");
+    h.postBusy.print("post (usb busy)");
+    h.usb.print("usb latency");
+}
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    runScenario("polling loop (poll + 100 ms libusb wait + 10 ms sleep)", false, seconds);
+    runScenario("reactor loop (USBEventLoop + run)", true, seconds);
+    return 0;
+}
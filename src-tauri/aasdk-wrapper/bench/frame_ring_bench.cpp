@@ -0,0 +1,211 @@
+// Frame ring benchmark
+//
+// Runs both ends of the shared frame ring the way the decoder and a renderer do: a writer
+// thread publishes 720p I420 pictures through FrameRing, and a reader thread maps the same
+// memfd through FrameRingReader (a second mapping, as another process would), waits on
+// the doorbell, acquires the newest picture, holds it for a simulated render time and
+// releases it. Runs an unthrottled writer against an instant and a 2 ms render, and a
+// 60 fps writer against a 25 ms render that laps the reader.
+//
+// Every picture is filled with a byte derived from its frame sequence. While the reader
+// holds a slot it checks that the slot stays READING and that every plane still holds its
+// picture's byte when it is released, i.e. the writer never claimed a slot being read.
+// It also checks that acquired pictures only move forward and that the writer never had
+// to drop a picture, which with one reader holding one slot it never should.
+//
+// Usage: frame_ring_bench [seconds per run]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "frame_ring.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const uint32_t WIDTH = 1280;
+const uint32_t HEIGHT = 720;
+const uint32_t SLOTS = AASDK_DEFAULT_FRAME_RING_SLOTS;
+
+uint8_t fillByte(uint64_t frameSequence, uint32_t plane) {
+    return static_cast<uint8_t>(frameSequence * 7 + plane * 85 + 1);
+}
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count());
+}
+
+struct Result {
+    uint64_t published;
+    uint64_t dropped;
+    uint64_t read;
+    uint64_t skipped;           // Published pictures the reader never saw (overwritten unread)
+    uint64_t stateViolations;   // Held slot seen in a state other than READING
+    uint64_t torn;              // Held slot's pixels changed under the reader
+    uint64_t outOfOrder;        // Acquired sequence not above the previous one
+    std::vector<uint32_t> latencyUs;
+};
+
+// Every row of plane still holds its picture's byte
+bool planeIntact(const FrameRingReader& reader, const AASDKFrameRingSlot* slot, uint32_t plane) {
+    const uint8_t* pixels = reader.plane(slot, plane);
+    if (!pixels) {
+        return false;
+    }
+    uint32_t rowBytes = plane == 0 ? slot->width : (slot->width + 1) / 2;
+    uint32_t rows = plane == 0 ? slot->height : (slot->height + 1) / 2;
+    uint8_t expected = fillByte(slot->frame_sequence, plane);
+    for (uint32_t row = 0; row < rows; ++row) {
+        const uint8_t* line = pixels + static_cast<size_t>(row) * slot->strides[plane];
+        for (uint32_t x = 0; x < rowBytes; ++x) {
+            if (line[x] != expected) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool run(uint32_t writeIntervalUs, uint32_t renderUs, int seconds, Result* result) {
+    std::shared_ptr<FrameRing> ring = FrameRing::create(SLOTS, WIDTH, HEIGHT);
+    if (!ring) {
+        return false;
+    }
+    AASDKFrameRingInfo info;
+    ring->info(&info);
+    std::unique_ptr<FrameRingReader> reader = FrameRingReader::open(info.memfd, info.doorbell_fd, info.size);
+    if (!reader) {
+        return false;
+    }
+
+    *result = Result();
+    std::atomic<bool> writing(true);
+    std::atomic<bool> reading(true);
+
+    std::thread writer([&]() {
+        uint32_t chromaWidth = (WIDTH + 1) / 2;
+        uint32_t chromaHeight = (HEIGHT + 1) / 2;
+        std::vector<uint8_t> planes[3] = {
+            std::vector<uint8_t>(static_cast<size_t>(WIDTH) * HEIGHT),
+            std::vector<uint8_t>(static_cast<size_t>(chromaWidth) * chromaHeight),
+            std::vector<uint8_t>(static_cast<size_t>(chromaWidth) * chromaHeight),
+        };
+        AASDKDecodedFrame picture = {};
+        picture.format = AASDK_PIXEL_FORMAT_I420;
+        picture.width = WIDTH;
+        picture.height = HEIGHT;
+        picture.strides[0] = WIDTH;
+        picture.strides[1] = picture.strides[2] = chromaWidth;
+
+        Clock::time_point tick = Clock::now();
+        for (uint64_t sequence = 1; writing.load(); ++sequence) {
+            for (uint32_t plane = 0; plane < 3; ++plane) {
+                std::memset(planes[plane].data(), fillByte(sequence, plane), planes[plane].size());
+                picture.planes[plane] = planes[plane].data();
+            }
+            picture.sequence = sequence;
+            picture.timestamp = nowNs();
+            ring->publish(picture);
+            if (writeIntervalUs > 0) {
+                tick += std::chrono::microseconds(writeIntervalUs);
+                std::this_thread::sleep_until(tick);
+            }
+        }
+    });
+
+    std::thread renderer([&]() {
+        uint64_t lastSequence = 0;
+        while (reading.load()) {
+            reader->wait(10);
+            const AASDKFrameRingSlot* slot = reader->acquire();
+            if (!slot) {
+                continue;
+            }
+            uint64_t acquiredNs = nowNs();
+            result->latencyUs.push_back(static_cast<uint32_t>((acquiredNs - slot->timestamp) / 1000));
+            if (slot->sequence <= lastSequence) {
+                ++result->outOfOrder;
+            } else {
+                result->skipped += slot->sequence - lastSequence - 1;
+                lastSequence = slot->sequence;
+            }
+            ++result->read;
+
+            if (renderUs > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(renderUs));
+            }
+            if (__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) != AASDK_RING_SLOT_READING) {
+                ++result->stateViolations;
+            }
+            if (!planeIntact(*reader, slot, 0) || !planeIntact(*reader, slot, 1) || !planeIntact(*reader, slot, 2)) {
+                ++result->torn;
+            }
+            reader->release(slot);
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    writing.store(false);
+    writer.join();
+    reading.store(false);
+    renderer.join();
+
+    result->published = ring->published();
+    result->dropped = ring->dropped();
+    return true;
+}
+
+uint32_t percentile(std::vector<uint32_t> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 3;
+    struct Scenario {
+        const char* writer;
+        uint32_t writeIntervalUs;
+        uint32_t renderUs;
+    };
+    const Scenario scenarios[] = {
+        {"unthrottled", 0, 0},
+        {"unthrottled", 0, 2000},
+        {"60 fps", 16667, 25000},
+    };
+
+    std::printf("Frame ring: %u slots of %ux%u I420, %d s per run\n\n", SLOTS, WIDTH, HEIGHT, seconds);
+    std::printf("  %-12s %8s %10s %8s %10s %8s %8s %8s %10s\n", "writer", "render", "published", "read", "skipped",
+                "dropped", "p50 us", "p99 us", "violations");
+    bool intact = true;
+    for (const Scenario& scenario : scenarios) {
+        Result result;
+        if (!run(scenario.writeIntervalUs, scenario.renderUs, seconds, &result)) {
+            std::printf("  %-12s frame ring unavailable\n", scenario.writer);
+            return 1;
+        }
+        uint64_t violations = result.stateViolations + result.torn + result.outOfOrder + result.dropped;
+        std::printf("  %-12s %5.1f ms %10llu %8llu %10llu %8llu %8u %8u %10llu%s\n", scenario.writer,
+                    scenario.renderUs / 1000.0, static_cast<unsigned long long>(result.published),
+                    static_cast<unsigned long long>(result.read), static_cast<unsigned long long>(result.skipped),
+                    static_cast<unsigned long long>(result.dropped), percentile(result.latencyUs, 0.5),
+                    percentile(result.latencyUs, 0.99), static_cast<unsigned long long>(violations),
+                    violations ? "  MISMATCH" : "");
+        intact = intact && violations == 0;
+    }
+    return intact ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+// Input batching benchmark
+//
+// Drives an InputBatcher the way a touch panel and the app's key handling do: two
+// producer threads each drag one finger in strokes (down, a move every millisecond, up),
+// overlapping into two-finger gestures, and a third presses or releases a key every
+// 100 ms. A sender thread stands in for the input strand: it is woken through
+// requestDrain(), takes one indication at a time and holds the send slot for a simulated
+// write time, as the transport does. Runs an instant transport, a 1 ms write and a slow
+// 4 ms write (a drag's moves then take one slot, but every down and up still takes its
+// own, so past about 8 ms this gesture rate outruns the transport), and reports
+// indications sent, events merged per indication and the queue-to-send latency.
+// Every run checks that each finger's downs and ups and each key's presses and releases
+// arrive in order and at the positions they were queued with.
+//
+// Usage: input_batcher_bench [seconds per run]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "input_batcher.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const uint32_t WIDTH = 1280;
+const uint32_t HEIGHT = 720;
+const uint32_t MOVES_PER_STROKE = 60;
+const uint32_t KEY_CODE = 4;
+
+// A down, up, press or release as queued, or as it came out of an indication
+struct Edge {
+    bool down;
+    uint32_t x;
+    uint32_t y;
+
+    bool operator==(const Edge& other) const {
+        return down == other.down && x == other.x && y == other.y;
+    }
+};
+
+struct Result {
+    std::vector<uint32_t> latencyUs;
+    uint64_t moveIndications;
+    AASDKInputStats stats;
+    bool intact;
+};
+
+Result run(uint32_t writeUs, int seconds) {
+    InputBatcher batcher(WIDTH, HEIGHT);
+    Result result = {};
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool kicked = false;
+    std::atomic<bool> producing(true);
+
+    auto kick = [&]() {
+        if (batcher.requestDrain()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            kicked = true;
+            wake.notify_one();
+        }
+    };
+
+    // What each producer queued and the sender saw, by pointer id (keys use KEY_CODE)
+    std::map<uint32_t, std::vector<Edge>> queued;
+    std::map<uint32_t, std::vector<Edge>> sent;
+    std::vector<Edge> queuedKeys;
+    std::vector<Edge> sentKeys;
+    queued[0];
+    queued[1];
+
+    auto finger = [&](uint32_t id) {
+        std::vector<Edge>& edges = queued[id];
+        Clock::time_point tick = Clock::now() + std::chrono::milliseconds(id * 23);
+        uint32_t stroke = 0;
+        while (producing.load()) {
+            uint32_t x = (stroke * 97 + id * 400) % WIDTH;
+            uint32_t y = (stroke * 53 + id * 200) % HEIGHT;
+            std::this_thread::sleep_until(tick);
+            if (batcher.pushTouch(id, x, y, AASDK_TOUCH_DOWN, 0)) {
+                edges.push_back({true, x, y});
+            }
+            kick();
+            for (uint32_t i = 0; i < MOVES_PER_STROKE; ++i) {
+                tick += std::chrono::milliseconds(1);
+                std::this_thread::sleep_until(tick);
+                x = (x + 7) % WIDTH;
+                y = (y + 3) % HEIGHT;
+                batcher.pushTouch(id, x, y, AASDK_TOUCH_MOVE, 0);
+                kick();
+            }
+            if (batcher.pushTouch(id, x, y, AASDK_TOUCH_UP, 0)) {
+                edges.push_back({false, x, y});
+            }
+            kick();
+            tick += std::chrono::milliseconds(5 + id * 7);
+            ++stroke;
+        }
+    };
+
+    auto keys = [&]() {
+        bool pressed = false;
+        while (producing.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            pressed = !pressed;
+            if (batcher.pushButton(KEY_CODE, pressed, 0)) {
+                queuedKeys.push_back({pressed, 0, 0});
+            }
+            kick();
+        }
+        if (pressed && batcher.pushButton(KEY_CODE, false, 0)) {
+            queuedKeys.push_back({false, 0, 0});
+            kick();
+        }
+    };
+
+    // The input strand: one indication in flight, the next built once it is written
+    std::atomic<bool> sending(true);
+    std::thread sender([&]() {
+        InputBatcher::Batch batch;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait_for(lock, std::chrono::milliseconds(5), [&]() { return kicked; });
+                kicked = false;
+            }
+            bool producersDone = !sending.load();
+            bool any = false;
+            while (batcher.next(&batch)) {
+                any = true;
+                if (writeUs > 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(writeUs));
+                }
+                batcher.sent(batch);
+                uint64_t now = InputBatcher::nowNs();
+                result.latencyUs.push_back(static_cast<uint32_t>((now - batch.queuedNs) / 1000));
+
+                if (batch.button) {
+                    sentKeys.push_back({batch.pressed, 0, 0});
+                    continue;
+                }
+                const InputBatcher::Pointer& pointer = batch.pointers[batch.actionIndex];
+                switch (batch.action) {
+                case AASDK_TOUCH_DOWN:
+                case InputBatcher::ACTION_POINTER_DOWN:
+                    sent[pointer.id].push_back({true, pointer.x, pointer.y});
+                    break;
+                case AASDK_TOUCH_UP:
+                case InputBatcher::ACTION_POINTER_UP:
+                    sent[pointer.id].push_back({false, pointer.x, pointer.y});
+                    break;
+                default:
+                    ++result.moveIndications;
+                    break;
+                }
+            }
+            if (producersDone && !any) {
+                return;
+            }
+        }
+    });
+
+    std::thread first(finger, 0);
+    std::thread second(finger, 1);
+    std::thread presser(keys);
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    producing.store(false);
+    first.join();
+    second.join();
+    presser.join();
+    sending.store(false);
+    sender.join();
+
+    batcher.stats(&result.stats);
+    result.intact = sent[0] == queued[0] && sent[1] == queued[1] && sentKeys == queuedKeys;
+    return result;
+}
+
+uint32_t percentile(std::vector<uint32_t> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 3;
+    const uint32_t writes[] = {0, 1000, 4000};
+
+    std::printf("Input: two fingers moving at 1 kHz and a key every 100 ms, %d s per run\n\n", seconds);
+    std::printf("  %-10s %8s %8s %9s %9s %9s %9s %9s %8s\n", "write", "events", "sent", "moves", "per msg",
+                "p50 ms", "p99 ms", "max ms", "dropped");
+    bool intact = true;
+    for (uint32_t writeUs : writes) {
+        Result result = run(writeUs, seconds);
+        uint64_t events = result.stats.touch_events + result.stats.button_events;
+        std::printf("  %6.1f ms %8llu %8llu %9llu %9.2f %9.2f %9.2f %9.2f %8llu%s\n", writeUs / 1000.0,
+                    static_cast<unsigned long long>(events),
+                    static_cast<unsigned long long>(result.stats.indications_sent),
+                    static_cast<unsigned long long>(result.moveIndications),
+                    result.stats.indications_sent ? static_cast<double>(events) / result.stats.indications_sent : 0.0,
+                    percentile(result.latencyUs, 0.5) / 1000.0, percentile(result.latencyUs, 0.99) / 1000.0,
+                    result.stats.latency_us_max / 1000.0,
+                    static_cast<unsigned long long>(result.stats.dropped_events),
+                    result.intact ? "" : "  MISMATCH");
+        intact = intact && result.intact;
+    }
+    return intact ? 0 : 1;
+}
@@ -0,0 +1,200 @@
+// Microphone capture-to-send latency benchmark
+//
+// Plays a WAV file (or a generated one) through WavSource into MicCapture in real time,
+// the way aasdk_mic_play_wav() feeds the AV_INPUT channel, with a sender thread that
+// stands in for the channel strand: it pumps every quarter payload and on every ack, as
+// the wrapper does, and a simulated phone that acks each payload after a delay. Runs:
+//   - no flow control (max_unacked 0), checking that every frame arrives in order
+//   - a one-payload window with prompt acks
+//   - a phone that stops acking for a second, which the latency bound has to absorb
+// and reports capture-to-send latency per payload (capture of its first frame to the
+// send call; at least one payload's duration) and the frames dropped.
+//
+// Usage: mic_capture_bench [seconds per run] [16 kHz 16-bit WAV file]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mic_capture.h"
+#include "wav_source.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const AASDKAudioFormat FORMAT = {16000, 1, 16};
+const char* GENERATED = "/tmp/aasdk_mic_bench.wav";
+
+// Two seconds of tone bursts with a ramp, so a misordered payload shows up as a mismatch
+bool writeWav(const char* path) {
+    const uint32_t frames = FORMAT.sample_rate * 2;
+    std::vector<int16_t> samples(frames);
+    for (uint32_t i = 0; i < frames; ++i) {
+        double burst = (i / 4000) % 2 ? 0.0 : 8000.0 * std::sin(2 * 3.14159265358979 * 300.0 * i / FORMAT.sample_rate);
+        samples[i] = static_cast<int16_t>(burst + static_cast<int>(i % 997) - 498);
+    }
+
+    auto put16 = [](std::ofstream& out, uint32_t value) {
+        char bytes[2] = {static_cast<char>(value), static_cast<char>(value >> 8)};
+        out.write(bytes, 2);
+    };
+    auto put32 = [&](std::ofstream& out, uint32_t value) {
+        put16(out, value & 0xFFFF);
+        put16(out, value >> 16);
+    };
+    std::ofstream out(path, std::ios::binary);
+    uint32_t dataBytes = frames * 2;
+    out.write("RIFF", 4);
+    put32(out, 36 + dataBytes);
+    out.write("WAVEfmt ", 8);
+    put32(out, 16);
+    put16(out, 1);
+    put16(out, 1);
+    put32(out, FORMAT.sample_rate);
+    put32(out, FORMAT.sample_rate * 2);
+    put16(out, 2);
+    put16(out, 16);
+    out.write("data", 4);
+    put32(out, dataBytes);
+    out.write(reinterpret_cast<const char*>(samples.data()), dataBytes);
+    return static_cast<bool>(out);
+}
+
+struct Scenario {
+    const char* label;
+    uint32_t window;        // max_unacked granted by the phone
+    uint32_t ackDelayMs;
+    bool stall;             // The phone stops acking for a second in the middle of the run
+};
+
+struct Result {
+    std::vector<uint32_t> latencyUs;
+    std::vector<int16_t> sent;
+    AASDKMicStats stats;
+};
+
+Result run(const Scenario& scenario, WavSource& source, int seconds) {
+    AASDKMicConfig config = {20, 200, 100};
+    Result result;
+    result.latencyUs.reserve(static_cast<size_t>(seconds) * 1000 / config.period_ms + 16);
+
+    // Payloads waiting for the phone's ack, by due time
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Clock::time_point> acks;
+    Clock::time_point stallStart = Clock::now() + std::chrono::seconds(seconds) / 3;
+    Clock::time_point stallEnd = stallStart + std::chrono::seconds(1);
+
+    MicCapture mic(FORMAT, config, [&](uint64_t timestampUs, const int16_t* samples, uint32_t frames) {
+        uint64_t nowUs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count());
+        result.latencyUs.push_back(static_cast<uint32_t>(nowUs - timestampUs));
+        result.sent.insert(result.sent.end(), samples, samples + frames);
+        Clock::time_point due = Clock::now() + std::chrono::milliseconds(scenario.ackDelayMs);
+        if (scenario.stall && due >= stallStart && due < stallEnd) {
+            due = stallEnd;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        acks.push_back(due);
+        return true;
+    });
+
+    mic.open(scenario.window);
+    source.start([&](const int16_t* samples, uint32_t frames, uint64_t captureNs) {
+        mic.write(samples, frames, captureNs);
+    }, FORMAT.sample_rate / 100, true);
+
+    // The channel strand: pump on a quarter-payload timer and whenever an ack comes in
+    Clock::time_point end = Clock::now() + std::chrono::seconds(seconds);
+    Clock::time_point tick = Clock::now();
+    const auto tickPeriod = std::chrono::milliseconds(config.period_ms / 4);
+    while (Clock::now() < end) {
+        uint32_t acked = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            Clock::time_point until = acks.empty() ? tick + tickPeriod : std::min(tick + tickPeriod, acks.front());
+            wake.wait_until(lock, until);
+            while (!acks.empty() && acks.front() <= Clock::now()) {
+                acks.pop_front();
+                ++acked;
+            }
+        }
+        if (acked > 0) {
+            mic.acked(acked);
+        }
+        if (Clock::now() >= tick + tickPeriod) {
+            tick += tickPeriod;
+        }
+        mic.pump();
+    }
+    source.stop();
+    mic.close();
+    mic.stats(&result.stats);
+    return result;
+}
+
+uint32_t percentile(std::vector<uint32_t> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? std::max(2, std::atoi(argv[1])) : 4;
+    const char* path = argc > 2 ? argv[2] : GENERATED;
+    if (argc <= 2 && !writeWav(path)) {
+        std::fprintf(stderr, "Cannot write %s\n", path);
+        return 1;
+    }
+    auto source = WavSource::open(path, FORMAT.sample_rate);
+    if (!source) {
+        return 1;
+    }
+
+    const Scenario scenarios[] = {
+        {"no flow control", 0, 0, false},
+        {"window 1, acks after 5 ms", 1, 5, false},
+        {"window 1, phone stalls 1 s", 1, 5, true},
+    };
+
+    std::printf("Microphone: 20 ms payloads from 10 ms capture chunks, %d s per run, %s\n\n", seconds, path);
+    std::printf("  %-28s %8s %9s %9s %9s %9s %8s\n", "", "payloads", "p50 ms", "p99 ms", "max ms", "dropped", "stalls");
+    bool intact = true;
+    for (const auto& scenario : scenarios) {
+        Result result = run(scenario, *source, seconds);
+        std::printf("  %-28s %8llu %9.1f %9.1f %9.1f %9llu %8llu\n", scenario.label,
+                    static_cast<unsigned long long>(result.stats.payloads_sent),
+                    percentile(result.latencyUs, 0.5) / 1000.0, percentile(result.latencyUs, 0.99) / 1000.0,
+                    result.stats.latency_us_max / 1000.0,
+                    static_cast<unsigned long long>(result.stats.dropped_frames),
+                    static_cast<unsigned long long>(result.stats.window_stalls));
+
+        // Without flow control nothing may be lost or reordered: the sent audio is the
+        // file from the start, looped
+        if (scenario.window == 0) {
+            const std::vector<int16_t>& file = source->samples();
+            for (size_t i = 0; i < result.sent.size(); ++i) {
+                if (result.sent[i] != file[i % file.size()]) {
+                    std::printf("  MISMATCH at frame %zu\n", i);
+                    intact = false;
+                    break;
+                }
+            }
+        }
+    }
+    return intact ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+// Headless session replay benchmark
+//
+// Plays a capture (aasdk_start_capture / OPENAUTO_CAPTURE) through the full wrapper, with
+// no phone or USB device, and consumes video the way the app does: the V2 callback, the
+// video queue and, when the wrapper was built with libavcodec, the native decoder.
+//
+// Reports:
+//   - video frames per second at each consumer, over the span from first to last frame
+//   - per-stage latency percentiles: replay release -> channel handler done, receive ->
+//     callback, receive -> queue pop, receive -> decoded picture
+//   - peak RSS of the process
+//
+// Usage: replay_bench <capture> [speed] [io threads]
+//   speed 0 (default) = as fast as the handlers keep up, 1 = real time, N = N x
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aasdk_c.h"
+
+namespace {
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Latency samples and the first/last arrival of one consumer stage
+struct Stage {
+    std::mutex mutex;
+    std::vector<double> us;
+    uint64_t firstNs = 0;
+    uint64_t lastNs = 0;
+
+    void add(uint64_t receiveNs) {
+        uint64_t now = nowNs();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (receiveNs != 0) {
+            us.push_back((now - receiveNs) / 1000.0);
+        }
+        if (firstNs == 0) {
+            firstNs = now;
+        }
+        lastNs = now;
+    }
+
+    void print(const char* label) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (us.empty()) {
+            std::printf("  %-22s no frames\n", label);
+            return;
+        }
+        std::sort(us.begin(), us.end());
+        auto pct = [this](double p) { return us[static_cast<size_t>(p * (us.size() - 1))]; };
+        double span = (lastNs - firstNs) / 1e9;
+        std::printf("  %-22s n=%-6zu %7.1f fps  p50=%8.1f us  p90=%8.1f us  p99=%8.1f us  max=%8.1f us\n",
+                    label, us.size(), span > 0 ? (us.size() - 1) / span : 0.0, pct(0.50), pct(0.90), pct(0.99),
+                    us.back());
+    }
+};
+
+Stage callbackStage;
+Stage queueStage;
+Stage decodeStage;
+std::atomic<uint64_t> audioPackets{0};
+
+void onVideo(const uint8_t*, uint32_t, uint32_t, uint32_t, const AASDKMediaInfo* info, void*) {
+    callbackStage.add(info->receive_ns);
+}
+
+void onAudio(const int16_t*, uint32_t, uint32_t, uint32_t, const AASDKMediaInfo*, void*) {
+    audioPackets.fetch_add(1, std::memory_order_relaxed);
+}
+
+void onDecoded(const AASDKDecodedFrame* frame, void*) {
+    decodeStage.add(frame->receive_ns);
+}
+
+void printLatency(const char* label, const AASDKLatencyStats& stats) {
+    if (stats.count == 0) {
+        return;
+    }
+    std::printf("  %-22s n=%-6llu             p50=%6u us    p90=%6u us    p99=%6u us    max=%6u us\n", label,
+                static_cast<unsigned long long>(stats.count), stats.p50_us, stats.p90_us, stats.p99_us, stats.max_us);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <capture> [speed] [io threads]\n", argv[0]);
+        return 2;
+    }
+    const char* path = argv[1];
+    double speed = argc > 2 ? std::atof(argv[2]) : 0.0;
+
+    AASDKInitOptions options;
+    aasdk_default_init_options(&options);
+    options.io_threads = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : options.io_threads;
+
+    AASDKHandle handle = aasdk_init_with_options(nullptr, nullptr, nullptr, nullptr, &options);
+    if (!handle) {
+        return 1;
+    }
+    aasdk_set_media_callbacks_v2(handle, onVideo, onAudio, nullptr);
+    bool decoding = aasdk_set_decoded_frame_callback(handle, onDecoded, nullptr);
+
+    if (!aasdk_start_replay(handle, path, speed)) {
+        aasdk_deinit(handle);
+        return 1;
+    }
+
+    std::atomic<bool> replaying{true};
+    std::thread consumer([&]() {
+        while (replaying.load()) {
+            AASDKFrame* frame = aasdk_video_queue_pop(handle, 50);
+            if (frame) {
+                queueStage.add(frame->receive_ns);
+                aasdk_frame_release(frame);
+            }
+        }
+    });
+
+    // The session is set up on an io thread: wait for the replay to start (5 s at most),
+    // then for it to finish
+    AASDKReplayStats replay;
+    bool started = false;
+    for (int polls = 1; ; ++polls) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        aasdk_get_replay_stats(handle, &replay);
+        started = started || replay.running || replay.released > 0;
+        if (started ? !replay.running : polls >= 50) {
+            break;
+        }
+    }
+
+    // Give the decoder a moment to finish the last pictures
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    replaying = false;
+    consumer.join();
+
+    AASDKStats stats;
+    aasdk_get_stats(handle, &stats);
+    aasdk_get_replay_stats(handle, &replay);
+
+    std::printf("Replay of %s at %s\n", path, speed > 0 ? (std::to_string(speed) + "x").c_str() : "full speed");
+    std::printf("  %llu messages in %.3f s (recorded %.3f s), %llu skipped, %llu unclaimed, %llu stalls, %llu sent\n",
+                static_cast<unsigned long long>(replay.released), replay.elapsed_us / 1e6, replay.recorded_us / 1e6,
+                static_cast<unsigned long long>(replay.skipped), static_cast<unsigned long long>(replay.unclaimed),
+                static_cast<unsigned long long>(replay.stalls), static_cast<unsigned long long>(replay.sent));
+    std::printf("Handler stage (release -> next receive):\n");
+    printLatency("control", replay.control);
+    const char* avNames[AASDK_AV_CHANNEL_COUNT] = {"video", "media audio", "speech audio", "system audio"};
+    for (int i = 0; i < AASDK_AV_CHANNEL_COUNT; ++i) {
+        printLatency(avNames[i], replay.handler[i]);
+    }
+    if (speed > 0) {
+        printLatency("schedule slip", replay.schedule_slip);
+    }
+    std::printf("Video consumers (receive -> consumer):\n");
+    callbackStage.print("callback");
+    queueStage.print("queue pop");
+    if (decoding) {
+        decodeStage.print("decoded picture");
+    } else {
+        std::printf("  %-22s wrapper built without libavcodec\n", "decoded picture");
+    }
+    std::printf("  queue drops %llu, resyncs %llu, decode errors %llu, decoder drops %llu, audio packets %llu\n",
+                static_cast<unsigned long long>(stats.video_frames_dropped),
+                static_cast<unsigned long long>(stats.video_resyncs),
+                static_cast<unsigned long long>(stats.decode_errors),
+                static_cast<unsigned long long>(stats.decode_frames_dropped),
+                static_cast<unsigned long long>(audioPackets.load()));
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::printf("Peak RSS: %.1f MB\n", usage.ru_maxrss / 1024.0);
+
+    aasdk_stop(handle);
+    aasdk_deinit(handle);
+    return 0;
+}
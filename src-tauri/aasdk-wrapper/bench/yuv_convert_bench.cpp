@@ -0,0 +1,206 @@
+// YUV to RGB conversion benchmark
+//
+// Checks every kernel set this CPU supports against the scalar reference over all
+// 2^24 Y/U/V combinations, reports the worst deviation from floating-point BT.601,
+// then measures throughput on a 1280x720 projection-sized picture:
+//   - native size I420/NV12 to RGBA/BGRA
+//   - fused bilinear downscale to an 800x480 display
+// Throughput is in output megapixels per second.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "yuv_convert.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Picture {
+    std::vector<uint8_t> planes[3];
+    AASDKDecodedFrame frame;
+};
+
+// Random picture with padded strides, as libavcodec hands them out
+void makePicture(Picture& picture, AASDKPixelFormat format, uint32_t width, uint32_t height, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::memset(&picture.frame, 0, sizeof(picture.frame));
+    picture.frame.format = format;
+    picture.frame.width = width;
+    picture.frame.height = height;
+
+    uint32_t chromaWidth = (width + 1) / 2;
+    uint32_t chromaHeight = (height + 1) / 2;
+    uint32_t strides[3] = {width + 32, chromaWidth + 32, chromaWidth + 32};
+    uint32_t rows[3] = {height, chromaHeight, chromaHeight};
+    int planeCount = 3;
+    if (format == AASDK_PIXEL_FORMAT_NV12) {
+        strides[1] = chromaWidth * 2 + 32;
+        planeCount = 2;
+    }
+
+    for (int plane = 0; plane < planeCount; ++plane) {
+        picture.planes[plane].resize(static_cast<size_t>(strides[plane]) * rows[plane]);
+        for (auto& value : picture.planes[plane]) {
+            value = static_cast<uint8_t>(rng());
+        }
+        picture.frame.planes[plane] = picture.planes[plane].data();
+        picture.frame.strides[plane] = strides[plane];
+    }
+}
+
+// One row per U/V pair with Y sweeping 0-255 across it: every input combination once
+void makeSweep(Picture& picture) {
+    const uint32_t width = 256;
+    const uint32_t height = 2 * 65536;
+    std::memset(&picture.frame, 0, sizeof(picture.frame));
+    picture.frame.format = AASDK_PIXEL_FORMAT_I420;
+    picture.frame.width = width;
+    picture.frame.height = height;
+
+    picture.planes[0].resize(static_cast<size_t>(width) * height);
+    picture.planes[1].resize(static_cast<size_t>(width / 2) * height / 2);
+    picture.planes[2].resize(picture.planes[1].size());
+    for (uint32_t row = 0; row < height; ++row) {
+        for (uint32_t x = 0; x < width; ++x) {
+            picture.planes[0][static_cast<size_t>(row) * width + x] = static_cast<uint8_t>(x);
+        }
+    }
+    for (uint32_t row = 0; row < height / 2; ++row) {
+        std::memset(&picture.planes[1][static_cast<size_t>(row) * width / 2], row >> 8, width / 2);
+        std::memset(&picture.planes[2][static_cast<size_t>(row) * width / 2], row & 0xff, width / 2);
+    }
+    for (int plane = 0; plane < 3; ++plane) {
+        picture.frame.planes[plane] = picture.planes[plane].data();
+        picture.frame.strides[plane] = plane == 0 ? width : width / 2;
+    }
+}
+
+int referencePixel(double value) {
+    return std::min(255, std::max(0, static_cast<int>(std::lround(value))));
+}
+
+// Largest per-channel difference from the floating-point BT.601 limited-range formula
+int maxFloatError(const Picture& sweep, const std::vector<uint8_t>& rgba) {
+    int worst = 0;
+    for (uint32_t row = 0; row < sweep.frame.height; ++row) {
+        uint32_t chroma = row / 2;
+        double u = sweep.planes[1][static_cast<size_t>(chroma) * 128] - 128.0;
+        double v = sweep.planes[2][static_cast<size_t>(chroma) * 128] - 128.0;
+        for (uint32_t x = 0; x < sweep.frame.width; ++x) {
+            double y = 1.164 * (static_cast<int>(x) - 16);
+            int expected[3] = {referencePixel(y + 1.596 * v),
+                               referencePixel(y - 0.391 * u - 0.813 * v),
+                               referencePixel(y + 2.018 * u)};
+            const uint8_t* pixel = &rgba[(static_cast<size_t>(row) * sweep.frame.width + x) * 4];
+            for (int c = 0; c < 3; ++c) {
+                worst = std::max(worst, std::abs(pixel[c] - expected[c]));
+            }
+        }
+    }
+    return worst;
+}
+
+size_t countMismatches(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    size_t mismatches = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        mismatches += a[i] != b[i];
+    }
+    return mismatches;
+}
+
+struct Case {
+    const char* label;
+    AASDKPixelFormat input;
+    AASDKRgbFormat output;
+    uint32_t dstWidth;
+    uint32_t dstHeight;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+    const uint32_t width = 1280;
+    const uint32_t height = 720;
+
+    const YuvConverter::Isa candidates[] = {YuvConverter::Isa::SCALAR, YuvConverter::Isa::SSE2,
+                                            YuvConverter::Isa::AVX2, YuvConverter::Isa::NEON};
+    std::vector<YuvConverter::Isa> isas;
+    for (auto isa : candidates) {
+        YuvConverter converter(isa);
+        if (converter.isa() == isa) {
+            isas.push_back(isa);
+        }
+    }
+    std::printf("Detected kernels: %s\n\n", YuvConverter::isaName(YuvConverter::detectIsa()));
+
+    // Exhaustive correctness sweep
+    Picture sweep;
+    makeSweep(sweep);
+    std::vector<uint8_t> reference(static_cast<size_t>(sweep.frame.width) * sweep.frame.height * 4);
+    {
+        YuvConverter scalar(YuvConverter::Isa::SCALAR);
+        scalar.convert(sweep.frame, reference.data(), sweep.frame.width * 4, sweep.frame.width,
+                       sweep.frame.height, AASDK_RGB_FORMAT_RGBA);
+    }
+    std::printf("All Y/U/V inputs, max error vs float BT.601: %d\n", maxFloatError(sweep, reference));
+
+    bool exact = true;
+    std::vector<uint8_t> output(reference.size());
+    for (auto isa : isas) {
+        YuvConverter converter(isa);
+        converter.convert(sweep.frame, output.data(), sweep.frame.width * 4, sweep.frame.width,
+                          sweep.frame.height, AASDK_RGB_FORMAT_RGBA);
+        size_t mismatches = countMismatches(output, reference);
+        exact = exact && mismatches == 0;
+        std::printf("  %-8s mismatching bytes vs scalar: %zu\n", YuvConverter::isaName(isa), mismatches);
+    }
+    std::printf("\n");
+
+    const Case cases[] = {
+        {"I420 -> RGBA 1280x720", AASDK_PIXEL_FORMAT_I420, AASDK_RGB_FORMAT_RGBA, width, height},
+        {"I420 -> BGRA 1280x720", AASDK_PIXEL_FORMAT_I420, AASDK_RGB_FORMAT_BGRA, width, height},
+        {"NV12 -> RGBA 1280x720", AASDK_PIXEL_FORMAT_NV12, AASDK_RGB_FORMAT_RGBA, width, height},
+        {"I420 -> RGBA 800x480", AASDK_PIXEL_FORMAT_I420, AASDK_RGB_FORMAT_RGBA, 800, 480},
+        {"NV12 -> RGBA 800x480", AASDK_PIXEL_FORMAT_NV12, AASDK_RGB_FORMAT_RGBA, 800, 480},
+    };
+
+    for (const auto& test : cases) {
+        Picture picture;
+        makePicture(picture, test.input, width, height, 1);
+        uint32_t stride = test.dstWidth * 4;
+        std::vector<uint8_t> expected(static_cast<size_t>(stride) * test.dstHeight);
+        {
+            YuvConverter scalar(YuvConverter::Isa::SCALAR);
+            scalar.convert(picture.frame, expected.data(), stride, test.dstWidth, test.dstHeight, test.output);
+        }
+
+        std::printf("%s\n", test.label);
+        for (auto isa : isas) {
+            YuvConverter converter(isa);
+            std::vector<uint8_t> rgb(expected.size());
+            converter.convert(picture.frame, rgb.data(), stride, test.dstWidth, test.dstHeight, test.output);
+            size_t mismatches = countMismatches(rgb, expected);
+            exact = exact && mismatches == 0;
+
+            auto start = Clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                converter.convert(picture.frame, rgb.data(), stride, test.dstWidth, test.dstHeight, test.output);
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            double megapixels = static_cast<double>(test.dstWidth) * test.dstHeight * iterations / 1e6;
+            std::printf("  %-8s %8.1f MP/s  %7.3f ms/frame  %s\n", YuvConverter::isaName(isa),
+                        megapixels / seconds, seconds * 1000.0 / iterations,
+                        mismatches == 0 ? "bit-exact" : "MISMATCH");
+        }
+    }
+
+    return exact ? 0 : 1;
+}
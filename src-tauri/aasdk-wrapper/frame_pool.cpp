@@ -0,0 +1,169 @@
+// Pooled, reference-counted video frame buffers
+// See frame_pool.h
+
+#include "frame_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+constexpr size_t FramePool::TAIL_PADDING;
+
+namespace {
+// Buffers grow in 64 KiB steps so a slowly rising bitrate does not reallocate every frame
+constexpr size_t CAPACITY_STEP = 64 * 1024;
+// Recycled buffers may be this many times the capacity hint before they are trimmed
+constexpr size_t OVERSIZE_FACTOR = 4;
+}
+
+struct FramePool::PooledFrame : public AASDKFrame {
+    std::atomic<uint32_t> refs;
+    std::unique_ptr<uint8_t[]> storage;
+    size_t capacity;
+    std::shared_ptr<State> state;   // Set while checked out, keeps the pool state alive
+    std::shared_ptr<ReleaseListener> listener;
+    uint64_t cookie;
+};
+
+struct FramePool::State {
+    std::mutex mutex;
+    std::vector<PooledFrame*> idle;
+    size_t maxIdle;
+    bool closed;
+    std::atomic<uint32_t> outstanding;
+    std::atomic<uint32_t> allocated;
+    std::atomic<size_t> capacityHint;
+
+    explicit State(size_t maxIdleFrames)
+        : maxIdle(maxIdleFrames), closed(false), outstanding(0), allocated(0), capacityHint(0) {}
+
+    bool oversized(const PooledFrame* frame) const {
+        size_t hint = capacityHint.load(std::memory_order_relaxed);
+        return hint != 0 && frame->capacity > hint * OVERSIZE_FACTOR;
+    }
+
+    ~State() {
+        for (auto* frame : idle) {
+            delete frame;
+        }
+    }
+};
+
+FramePool::FramePool(size_t maxIdle) : state_(std::make_shared<State>(maxIdle)) {
+    state_->idle.reserve(maxIdle);
+}
+
+FramePool::~FramePool() {
+    // Idle buffers go now; frames still held by a consumer are freed on their last release
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->closed = true;
+    for (auto* frame : state_->idle) {
+        delete frame;
+    }
+    state_->idle.clear();
+}
+
+AASDKFrame* FramePool::acquire(size_t size) {
+    PooledFrame* frame = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->idle.empty()) {
+            frame = state_->idle.back();
+            state_->idle.pop_back();
+        }
+    }
+
+    if (!frame) {
+        frame = new (std::nothrow) PooledFrame();
+        if (!frame) {
+            return nullptr;
+        }
+        frame->capacity = 0;
+        state_->allocated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (frame->capacity < size + TAIL_PADDING) {
+        size_t wanted = std::max(size + TAIL_PADDING, state_->capacityHint.load(std::memory_order_relaxed));
+        size_t capacity = (wanted + CAPACITY_STEP - 1) / CAPACITY_STEP * CAPACITY_STEP;
+        frame->storage.reset(new (std::nothrow) uint8_t[capacity]);
+        if (!frame->storage) {
+            std::cerr << "Frame pool: failed to allocate " << capacity << " bytes" << std::endl;
+            delete frame;
+            return nullptr;
+        }
+        frame->capacity = capacity;
+    }
+
+    std::memset(frame->storage.get() + size, 0, TAIL_PADDING);
+    frame->data = frame->storage.get();
+    frame->size = static_cast<uint32_t>(size);
+    frame->width = 0;
+    frame->height = 0;
+    frame->nal_flags = 0;
+    frame->timestamp = 0;
+    frame->sequence = 0;
+    frame->receive_ns = 0;
+    frame->refs.store(1, std::memory_order_relaxed);
+    frame->state = state_;
+    state_->outstanding.fetch_add(1, std::memory_order_relaxed);
+    return frame;
+}
+
+void FramePool::retain(AASDKFrame* frame) {
+    auto* pooled = static_cast<PooledFrame*>(frame);
+    pooled->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FramePool::notifyOnRelease(AASDKFrame* frame, std::shared_ptr<ReleaseListener> listener, uint64_t cookie) {
+    auto* pooled = static_cast<PooledFrame*>(frame);
+    pooled->listener = std::move(listener);
+    pooled->cookie = cookie;
+}
+
+void FramePool::release(AASDKFrame* frame) {
+    auto* pooled = static_cast<PooledFrame*>(frame);
+    if (pooled->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    if (pooled->listener) {
+        std::shared_ptr<ReleaseListener> listener = std::move(pooled->listener);
+        listener->onFrameReleased(pooled->cookie);
+    }
+
+    // Idle frames must not own the state or the pool could never be destroyed
+    std::shared_ptr<State> state = std::move(pooled->state);
+    state->outstanding.fetch_sub(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->closed && state->idle.size() < state->maxIdle && !state->oversized(pooled)) {
+        state->idle.push_back(pooled);
+    } else {
+        delete pooled;
+    }
+}
+
+void FramePool::setCapacityHint(size_t bytes) {
+    state_->capacityHint.store(bytes, std::memory_order_relaxed);
+
+    // Drop idle buffers sized for a previous, larger stream
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    auto& idle = state_->idle;
+    for (auto it = idle.begin(); it != idle.end();) {
+        if (state_->oversized(*it)) {
+            delete *it;
+            it = idle.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+uint32_t FramePool::outstanding() const {
+    return state_->outstanding.load(std::memory_order_relaxed);
+}
+
+uint32_t FramePool::allocated() const {
+    return state_->allocated.load(std::memory_order_relaxed);
+}
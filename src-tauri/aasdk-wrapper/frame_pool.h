@@ -0,0 +1,68 @@
+// Pooled, reference-counted video frame buffers
+// Frames handed across the C ABI are recycled instead of freed, so steady-state
+// video delivery does no heap allocation on the io thread or in the consumer
+
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "aasdk_c.h"
+
+class FramePool {
+public:
+    // Told when the last reference to a frame it was attached to is dropped
+    class ReleaseListener {
+    public:
+        virtual ~ReleaseListener() = default;
+        virtual void onFrameReleased(uint64_t cookie) = 0;
+    };
+
+    // Keeps at most maxIdle released frames around for reuse
+    explicit FramePool(size_t maxIdle);
+    ~FramePool();
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // Zeroed bytes kept after every payload: bitstream readers such as libavcodec
+    // over-read the end of the buffer in their optimized paths
+    static constexpr size_t TAIL_PADDING = 64;
+
+    // Take a frame with room for size bytes and a single reference owned by the caller.
+    // Returns nullptr if the allocation fails.
+    AASDKFrame* acquire(size_t size);
+
+    // Reference counting for frames returned by acquire(). Frames may outlive the pool;
+    // the last release then frees the buffer instead of recycling it.
+    static void retain(AASDKFrame* frame);
+    static void release(AASDKFrame* frame);
+
+    // Call listener->onFrameReleased(cookie) from whichever thread drops the last
+    // reference to frame. One listener per checkout.
+    static void notifyOnRelease(AASDKFrame* frame, std::shared_ptr<ReleaseListener> listener, uint64_t cookie);
+
+    // Typical payload size for the negotiated stream. New buffers start at least this big
+    // so the first keyframes do not grow them step by step, and buffers far larger than
+    // it (left over from a bigger stream) are freed instead of recycled. 0 disables both.
+    void setCapacityHint(size_t bytes);
+
+    // Frames currently checked out (held by the wrapper or a consumer)
+    uint32_t outstanding() const;
+
+    // Buffers ever allocated by this pool
+    uint32_t allocated() const;
+
+private:
+    struct PooledFrame;
+    struct State;
+
+    std::shared_ptr<State> state_;
+};
+
+#endif // FRAME_POOL_H
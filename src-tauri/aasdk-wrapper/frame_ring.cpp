@@ -0,0 +1,364 @@
+// Shared-memory ring of decoded pictures
+// See frame_ring.h
+
+#include "frame_ring.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace {
+constexpr uint32_t ROW_ALIGN = 64;      // Plane rows start on a cache line (and SIMD load) boundary
+constexpr uint32_t PAGE = 4096;         // Slots start on a page so a renderer can import them separately
+constexpr uint32_t MAX_DIMENSION = 4096;
+
+uint32_t alignUp(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Plane layout of a width x height picture inside a slot, offsets from the slot start
+struct PlaneLayout {
+    uint32_t planes;
+    uint32_t offsets[3];
+    uint32_t strides[3];
+    uint32_t rows[3];
+    uint32_t rowBytes[3];
+    uint32_t size;
+};
+
+PlaneLayout layoutFor(int32_t format, uint32_t width, uint32_t height) {
+    PlaneLayout layout = {};
+    uint32_t chromaWidth = (width + 1) / 2;
+    uint32_t chromaHeight = (height + 1) / 2;
+
+    layout.rowBytes[0] = width;
+    layout.rows[0] = height;
+    if (format == AASDK_PIXEL_FORMAT_NV12) {
+        layout.planes = 2;
+        layout.rowBytes[1] = chromaWidth * 2;
+        layout.rows[1] = chromaHeight;
+    } else {
+        layout.planes = 3;
+        layout.rowBytes[1] = layout.rowBytes[2] = chromaWidth;
+        layout.rows[1] = layout.rows[2] = chromaHeight;
+    }
+
+    uint32_t offset = 0;
+    for (uint32_t plane = 0; plane < layout.planes; ++plane) {
+        layout.offsets[plane] = offset;
+        layout.strides[plane] = alignUp(layout.rowBytes[plane], ROW_ALIGN);
+        offset += layout.strides[plane] * layout.rows[plane];
+    }
+    layout.size = offset;
+    return layout;
+}
+
+// The slot state words live in shared memory, where another process may be changing them
+uint32_t loadState(const AASDKFrameRingSlot* slot) {
+    return __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+}
+
+bool swapState(AASDKFrameRingSlot* slot, uint32_t expected, uint32_t desired) {
+    return __atomic_compare_exchange_n(&slot->state, &expected, desired, false, __ATOMIC_ACQ_REL,
+                                       __ATOMIC_RELAXED);
+}
+
+bool claimState(AASDKFrameRingSlot* slot, uint32_t expected) {
+    return swapState(slot, expected, AASDK_RING_SLOT_WRITING);
+}
+}
+
+FrameRing::FrameRing()
+    : memfd_(-1), doorbell_(-1), base_(nullptr), size_(0), header_(nullptr), slots_(nullptr),
+      dataOffset_(0), warnedSize_(false) {}
+
+FrameRing::~FrameRing() {
+    if (base_) {
+        munmap(base_, size_);
+    }
+    if (doorbell_ >= 0) {
+        close(doorbell_);
+    }
+    if (memfd_ >= 0) {
+        close(memfd_);
+    }
+}
+
+std::shared_ptr<FrameRing> FrameRing::create(uint32_t slotCount, uint32_t maxWidth, uint32_t maxHeight) {
+    if (slotCount < AASDK_FRAME_RING_MIN_SLOTS || slotCount > AASDK_FRAME_RING_MAX_SLOTS ||
+        maxWidth == 0 || maxHeight == 0 || maxWidth > MAX_DIMENSION || maxHeight > MAX_DIMENSION) {
+        std::cerr << "Frame ring: invalid geometry " << slotCount << " x " << maxWidth << "x" << maxHeight << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<FrameRing> ring(new FrameRing());
+
+    // I420 needs at least as much room as NV12 at any size
+    uint32_t slotSize = alignUp(layoutFor(AASDK_PIXEL_FORMAT_I420, maxWidth, maxHeight).size, PAGE);
+    uint32_t descriptors = sizeof(AASDKFrameRingHeader) + slotCount * sizeof(AASDKFrameRingSlot);
+    ring->dataOffset_ = alignUp(descriptors, PAGE);
+    ring->size_ = static_cast<size_t>(ring->dataOffset_) + static_cast<size_t>(slotSize) * slotCount;
+
+    ring->memfd_ = memfd_create("aasdk_frame_ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (ring->memfd_ < 0 || ftruncate(ring->memfd_, static_cast<off_t>(ring->size_)) != 0) {
+        std::cerr << "Frame ring: cannot create shared memory: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    // A peer that shrank the file would make our own stores fault
+    if (fcntl(ring->memfd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        std::cerr << "Frame ring: cannot seal shared memory: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    void* base = mmap(nullptr, ring->size_, PROT_READ | PROT_WRITE, MAP_SHARED, ring->memfd_, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "Frame ring: cannot map shared memory: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    ring->base_ = static_cast<uint8_t*>(base);
+
+    ring->doorbell_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (ring->doorbell_ < 0) {
+        std::cerr << "Frame ring: cannot create doorbell: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    // The memfd starts zeroed: every slot is FREE with sequence 0
+    ring->header_ = reinterpret_cast<AASDKFrameRingHeader*>(ring->base_);
+    ring->slots_ = reinterpret_cast<AASDKFrameRingSlot*>(ring->base_ + sizeof(AASDKFrameRingHeader));
+    ring->header_->magic = AASDK_FRAME_RING_MAGIC;
+    ring->header_->version = AASDK_FRAME_RING_VERSION;
+    ring->header_->slot_count = slotCount;
+    ring->header_->slot_size = slotSize;
+    ring->header_->max_width = maxWidth;
+    ring->header_->max_height = maxHeight;
+    return ring;
+}
+
+uint8_t* FrameRing::slotData(const AASDKFrameRingSlot* slot) const {
+    size_t index = static_cast<size_t>(slot - slots_);
+    return base_ + dataOffset_ + index * header_->slot_size;
+}
+
+AASDKFrameRingSlot* FrameRing::claimSlot() {
+    const uint32_t count = header_->slot_count;
+
+    // The reader may grab a READY slot between the scan and the claim; rescan then
+    for (uint32_t attempt = 0; attempt < count; ++attempt) {
+        AASDKFrameRingSlot* free = nullptr;
+        AASDKFrameRingSlot* oldest = nullptr;
+        for (uint32_t i = 0; i < count; ++i) {
+            AASDKFrameRingSlot* slot = &slots_[i];
+            uint32_t state = loadState(slot);
+            if (state == AASDK_RING_SLOT_FREE) {
+                free = slot;
+                break;
+            }
+            if (state == AASDK_RING_SLOT_READY && (!oldest || slot->sequence < oldest->sequence)) {
+                oldest = slot;
+            }
+        }
+
+        if (free && claimState(free, AASDK_RING_SLOT_FREE)) {
+            return free;
+        }
+        if (!free && oldest && claimState(oldest, AASDK_RING_SLOT_READY)) {
+            return oldest;
+        }
+        if (!free && !oldest) {
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+void FrameRing::drop() {
+    __atomic_fetch_add(&header_->dropped, 1, __ATOMIC_RELAXED);
+}
+
+bool FrameRing::publish(const AASDKDecodedFrame& picture) {
+    if (picture.width > header_->max_width || picture.height > header_->max_height) {
+        if (!warnedSize_) {
+            warnedSize_ = true;
+            std::cerr << "Frame ring: " << picture.width << "x" << picture.height << " pictures exceed the "
+                      << header_->max_width << "x" << header_->max_height << " slots, dropping them" << std::endl;
+        }
+        drop();
+        return false;
+    }
+
+    AASDKFrameRingSlot* slot = claimSlot();
+    if (!slot) {
+        drop();
+        return false;
+    }
+
+    PlaneLayout layout = layoutFor(picture.format, picture.width, picture.height);
+    uint8_t* data = slotData(slot);
+    uint32_t slotOffset = static_cast<uint32_t>(data - base_);
+    for (uint32_t plane = 0; plane < 3; ++plane) {
+        if (plane >= layout.planes) {
+            slot->offsets[plane] = 0;
+            slot->strides[plane] = 0;
+            continue;
+        }
+        const uint8_t* src = picture.planes[plane];
+        uint8_t* dst = data + layout.offsets[plane];
+        for (uint32_t row = 0; row < layout.rows[plane]; ++row) {
+            std::memcpy(dst, src, layout.rowBytes[plane]);
+            src += picture.strides[plane];
+            dst += layout.strides[plane];
+        }
+        slot->offsets[plane] = slotOffset + layout.offsets[plane];
+        slot->strides[plane] = layout.strides[plane];
+    }
+
+    uint64_t sequence = header_->published + 1;
+    slot->format = picture.format;
+    slot->width = picture.width;
+    slot->height = picture.height;
+    __atomic_store_n(&slot->sequence, sequence, __ATOMIC_RELAXED);   // Readers scan it unclaimed
+    slot->frame_sequence = picture.sequence;
+    slot->timestamp = picture.timestamp;
+    __atomic_store_n(&slot->state, static_cast<uint32_t>(AASDK_RING_SLOT_READY), __ATOMIC_RELEASE);
+    __atomic_store_n(&header_->published, sequence, __ATOMIC_RELEASE);
+
+    // A full counter (reader gone for 2^64 - 1 pictures) only means the reader is already woken
+    uint64_t one = 1;
+    if (write(doorbell_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        std::cerr << "Frame ring: doorbell write failed: " << std::strerror(errno) << std::endl;
+    }
+    return true;
+}
+
+void FrameRing::info(AASDKFrameRingInfo* info) const {
+    info->memfd = memfd_;
+    info->doorbell_fd = doorbell_;
+    info->size = size_;
+    info->slot_count = header_->slot_count;
+    info->max_width = header_->max_width;
+    info->max_height = header_->max_height;
+}
+
+uint64_t FrameRing::published() const {
+    return __atomic_load_n(&header_->published, __ATOMIC_RELAXED);
+}
+
+uint64_t FrameRing::dropped() const {
+    return __atomic_load_n(&header_->dropped, __ATOMIC_RELAXED);
+}
+
+FrameRingReader::FrameRingReader()
+    : memfd_(-1), doorbell_(-1), base_(nullptr), size_(0), header_(nullptr), slots_(nullptr), lastSequence_(0) {}
+
+FrameRingReader::~FrameRingReader() {
+    if (base_) {
+        munmap(base_, size_);
+    }
+    if (doorbell_ >= 0) {
+        close(doorbell_);
+    }
+    if (memfd_ >= 0) {
+        close(memfd_);
+    }
+}
+
+std::unique_ptr<FrameRingReader> FrameRingReader::open(int memfd, int doorbellFd, uint64_t size) {
+    if (size < sizeof(AASDKFrameRingHeader)) {
+        std::cerr << "Frame ring reader: " << size << " bytes cannot hold a ring" << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<FrameRingReader> reader(new FrameRingReader());
+    reader->memfd_ = fcntl(memfd, F_DUPFD_CLOEXEC, 0);
+    reader->doorbell_ = fcntl(doorbellFd, F_DUPFD_CLOEXEC, 0);
+    if (reader->memfd_ < 0 || reader->doorbell_ < 0) {
+        std::cerr << "Frame ring reader: cannot duplicate descriptors: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    reader->size_ = static_cast<size_t>(size);
+    void* base = mmap(nullptr, reader->size_, PROT_READ | PROT_WRITE, MAP_SHARED, reader->memfd_, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "Frame ring reader: cannot map shared memory: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    reader->base_ = static_cast<uint8_t*>(base);
+    reader->header_ = reinterpret_cast<AASDKFrameRingHeader*>(reader->base_);
+    reader->slots_ = reinterpret_cast<AASDKFrameRingSlot*>(reader->base_ + sizeof(AASDKFrameRingHeader));
+
+    // The writer sealed the size, so a header that fits now keeps fitting
+    const AASDKFrameRingHeader& header = *reader->header_;
+    uint64_t descriptors = sizeof(AASDKFrameRingHeader) + static_cast<uint64_t>(header.slot_count) * sizeof(AASDKFrameRingSlot);
+    if (header.magic != AASDK_FRAME_RING_MAGIC || header.version != AASDK_FRAME_RING_VERSION ||
+        header.slot_count < AASDK_FRAME_RING_MIN_SLOTS || header.slot_count > AASDK_FRAME_RING_MAX_SLOTS ||
+        alignUp(static_cast<uint32_t>(descriptors), PAGE) + static_cast<uint64_t>(header.slot_size) * header.slot_count > size) {
+        std::cerr << "Frame ring reader: not a version " << AASDK_FRAME_RING_VERSION << " frame ring" << std::endl;
+        return nullptr;
+    }
+    return reader;
+}
+
+bool FrameRingReader::wait(int timeoutMs) {
+    pollfd fd = {doorbell_, POLLIN, 0};
+    int ready = poll(&fd, 1, timeoutMs);
+    if (ready < 0 && errno != EINTR) {
+        std::cerr << "Frame ring reader: doorbell poll failed: " << std::strerror(errno) << std::endl;
+    }
+    if (ready <= 0) {
+        return false;
+    }
+    uint64_t count = 0;
+    return read(doorbell_, &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count)) && count > 0;
+}
+
+const AASDKFrameRingSlot* FrameRingReader::acquire() {
+    const uint32_t count = header_->slot_count;
+
+    // The writer may take the chosen READY slot between the scan and the claim; rescan then
+    for (uint32_t attempt = 0; attempt < count; ++attempt) {
+        AASDKFrameRingSlot* newest = nullptr;
+        uint64_t newestSequence = lastSequence_;
+        for (uint32_t i = 0; i < count; ++i) {
+            AASDKFrameRingSlot* slot = &slots_[i];
+            if (loadState(slot) != AASDK_RING_SLOT_READY) {
+                continue;
+            }
+            uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED);
+            if (sequence > newestSequence) {
+                newest = slot;
+                newestSequence = sequence;
+            }
+        }
+        if (!newest) {
+            return nullptr;
+        }
+        // The claim orders the descriptor reads after the writer's READY store. A slot
+        // rewritten between the scan and the claim only holds a newer picture.
+        if (swapState(newest, AASDK_RING_SLOT_READY, AASDK_RING_SLOT_READING)) {
+            lastSequence_ = newest->sequence;
+            return newest;
+        }
+    }
+    return nullptr;
+}
+
+const uint8_t* FrameRingReader::plane(const AASDKFrameRingSlot* slot, uint32_t plane) const {
+    if (plane >= 3 || slot->offsets[plane] == 0 || slot->offsets[plane] >= size_) {
+        return nullptr;
+    }
+    return base_ + slot->offsets[plane];
+}
+
+void FrameRingReader::release(const AASDKFrameRingSlot* slot) {
+    AASDKFrameRingSlot* owned = &slots_[slot - slots_];
+    if (!swapState(owned, AASDK_RING_SLOT_READING, AASDK_RING_SLOT_FREE)) {
+        std::cerr << "Frame ring reader: released a slot it did not hold" << std::endl;
+    }
+}
@@ -0,0 +1,98 @@
+// Shared-memory ring of decoded pictures
+// The decode thread copies each picture into a slot of a memfd-backed ring and rings an
+// eventfd doorbell, so a renderer that maps the same pages (in this process or another
+// one) displays it without further copies. The layout and slot protocol are part of the
+// C ABI: see AASDKFrameRingHeader in aasdk_c.h. FrameRingReader is the renderer's end.
+
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "aasdk_c.h"
+
+class FrameRing {
+public:
+    // Create the memfd, map it and lay out slotCount slots of maxWidth x maxHeight.
+    // Returns nullptr if the arguments are out of range or a syscall fails.
+    static std::shared_ptr<FrameRing> create(uint32_t slotCount, uint32_t maxWidth, uint32_t maxHeight);
+
+    ~FrameRing();
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    // Copy picture into the free slot (or the oldest unread one) and ring the doorbell.
+    // Returns false if the picture was dropped. Single writer: the decode thread only.
+    bool publish(const AASDKDecodedFrame& picture);
+
+    void info(AASDKFrameRingInfo* info) const;
+
+    uint64_t published() const;
+    uint64_t dropped() const;
+
+private:
+    FrameRing();
+
+    // Slot to write next, already switched to WRITING; nullptr if every slot is being read
+    AASDKFrameRingSlot* claimSlot();
+    uint8_t* slotData(const AASDKFrameRingSlot* slot) const;
+    void drop();
+
+    int memfd_;
+    int doorbell_;
+    uint8_t* base_;
+    size_t size_;
+    AASDKFrameRingHeader* header_;
+    AASDKFrameRingSlot* slots_;
+    uint32_t dataOffset_;   // Offset of the first slot's pixels
+    bool warnedSize_;
+};
+
+// Renderer side of a FrameRing: maps the ring from its two descriptors and takes the
+// newest picture with READY -> READING, hands it back with READING -> FREE. One reader
+// per ring, on one thread.
+class FrameRingReader {
+public:
+    // Map the ring behind memfd and doorbellFd (see AASDKFrameRingInfo). Both are dup()ed,
+    // so the reader outlives the wrapper's copies. Returns nullptr if the mapping fails or
+    // the header does not describe a ring of this version that fits in size bytes.
+    static std::unique_ptr<FrameRingReader> open(int memfd, int doorbellFd, uint64_t size);
+
+    ~FrameRingReader();
+
+    FrameRingReader(const FrameRingReader&) = delete;
+    FrameRingReader& operator=(const FrameRingReader&) = delete;
+
+    // Wait up to timeoutMs (-1 = forever) for the doorbell and clear it.
+    // True if a picture was published since the last wait.
+    bool wait(int timeoutMs);
+
+    // Switch the newest unseen READY slot to READING and return it; nullptr if nothing
+    // newer than the last acquired picture is ready. At most one slot is held at a time:
+    // release() it before acquiring the next.
+    const AASDKFrameRingSlot* acquire();
+
+    // Pixels of plane (0..2) of an acquired slot, nullptr if the slot has no such plane
+    const uint8_t* plane(const AASDKFrameRingSlot* slot, uint32_t plane) const;
+
+    // Hand an acquired slot back to the writer
+    void release(const AASDKFrameRingSlot* slot);
+
+    const AASDKFrameRingHeader& header() const { return *header_; }
+
+private:
+    FrameRingReader();
+
+    int memfd_;
+    int doorbell_;
+    uint8_t* base_;
+    size_t size_;
+    AASDKFrameRingHeader* header_;
+    AASDKFrameRingSlot* slots_;
+    uint64_t lastSequence_;     // Newest picture acquired so far
+};
+
+#endif // FRAME_RING_H
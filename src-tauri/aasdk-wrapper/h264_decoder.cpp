@@ -0,0 +1,267 @@
+// Native H.264 decode stage
+// See h264_decoder.h
+
+#include "h264_decoder.h"
+#include "frame_pool.h"
+
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+
+#ifdef AASDK_WITH_LIBAV
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/frame.h>
+}
+#endif
+
+constexpr uint32_t H264Decoder::INPUT_DEPTH;
+constexpr uint32_t H264Decoder::TIMESTAMP_HISTORY;
+
+H264Decoder::H264Decoder(DecodedFrameCallback callback, void* userData)
+    : callback_(callback), userData_(userData), input_(INPUT_DEPTH), running_(false),
+      codec_(nullptr), packet_(nullptr), picture_(nullptr), warnedFormat_(false),
+      decodedFrames_(0), decodeErrors_(0), decodeTimeUs_(0) {
+    for (auto& source : sources_) {
+        source = SourceTiming();
+    }
+}
+
+H264Decoder::~H264Decoder() {
+    stop();
+}
+
+uint32_t H264Decoder::averageDecodeUs() const {
+    uint64_t frames = decodedFrames();
+    return frames == 0 ? 0 : static_cast<uint32_t>(decodeTimeUs_.load(std::memory_order_relaxed) / frames);
+}
+
+void H264Decoder::submit(AASDKFrame* frame, VideoFrameQueue::FrameKind kind) {
+    input_.push(frame, kind);
+}
+
+void H264Decoder::run() {
+    while (running_.load(std::memory_order_relaxed)) {
+        AASDKFrame* frame = input_.pop(100);
+        if (frame) {
+            decode(frame);
+        }
+    }
+}
+
+#ifdef AASDK_WITH_LIBAV
+
+namespace {
+// libavcodec holds the packet buffer as long as it needs it; give the pooled frame back then
+void releasePooledFrame(void* opaque, uint8_t* /*data*/) {
+    FramePool::release(static_cast<AASDKFrame*>(opaque));
+}
+}
+
+bool H264Decoder::available() {
+    return true;
+}
+
+uint32_t H264Decoder::version() {
+    return avcodec_version();
+}
+
+bool H264Decoder::open() {
+    if (codec_) {
+        return true;
+    }
+
+    const AVCodec* codec = avcodec_find_decoder(AV_CODEC_ID_H264);
+    if (!codec) {
+        std::cerr << "H.264 decoder not available in libavcodec" << std::endl;
+        return false;
+    }
+
+    codec_ = avcodec_alloc_context3(codec);
+    packet_ = av_packet_alloc();
+    picture_ = av_frame_alloc();
+    if (!codec_ || !packet_ || !picture_) {
+        std::cerr << "Failed to allocate H.264 decoder state" << std::endl;
+        stop();
+        return false;
+    }
+
+    // Frame threading buffers one picture per thread; the projection stream is a
+    // single slice per frame, so one thread in low-delay mode gives the lowest latency
+    codec_->thread_count = 1;
+    codec_->flags |= AV_CODEC_FLAG_LOW_DELAY;
+    codec_->flags2 |= AV_CODEC_FLAG2_FAST;
+
+    int ret = avcodec_open2(codec_, codec, nullptr);
+    if (ret < 0) {
+        std::cerr << "Failed to open H.264 decoder: " << ret << std::endl;
+        stop();
+        return false;
+    }
+    return true;
+}
+
+bool H264Decoder::start() {
+    if (running_) {
+        return true;
+    }
+    if (!open()) {
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread([this]() { run(); });
+    std::cerr << "Native H.264 decoder started (" << codec_->codec->name << ")" << std::endl;
+    return true;
+}
+
+bool H264Decoder::decodeNow(AASDKFrame* frame) {
+    if (!open()) {
+        FramePool::release(frame);
+        return false;
+    }
+    decode(frame);
+    return true;
+}
+
+void H264Decoder::stop() {
+    running_ = false;
+    input_.close();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    input_.drain();
+
+    if (codec_) {
+        avcodec_free_context(&codec_);
+    }
+    if (packet_) {
+        av_packet_free(&packet_);
+    }
+    if (picture_) {
+        av_frame_free(&picture_);
+    }
+}
+
+void H264Decoder::decode(AASDKFrame* frame) {
+    SourceTiming& source = sources_[frame->sequence % TIMESTAMP_HISTORY];
+    source.timestamp = frame->timestamp;
+    source.receiveNs = frame->receive_ns;
+
+    // Wrap the pooled payload instead of copying it; the pool keeps the padding zeroed
+    AVBufferRef* buffer = av_buffer_create(const_cast<uint8_t*>(frame->data),
+                                           frame->size + FramePool::TAIL_PADDING,
+                                           &releasePooledFrame, frame, AV_BUFFER_FLAG_READONLY);
+    if (!buffer) {
+        FramePool::release(frame);
+        return;
+    }
+
+    packet_->buf = buffer;
+    packet_->data = buffer->data;
+    packet_->size = static_cast<int>(frame->size);
+    packet_->pts = static_cast<int64_t>(frame->sequence);
+    packet_->dts = packet_->pts;
+
+    auto started = std::chrono::steady_clock::now();
+    int ret = avcodec_send_packet(codec_, packet_);
+    av_packet_unref(packet_);
+    if (ret < 0 && ret != AVERROR(EAGAIN)) {
+        // Corrupt or truncated slice; the decoder conceals and recovers at the next IDR
+        decodeErrors_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    while ((ret = avcodec_receive_frame(codec_, picture_)) == 0) {
+        auto decoded = std::chrono::steady_clock::now();
+        decodeTimeUs_.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(decoded - started).count(),
+                                std::memory_order_relaxed);
+        decodedFrames_.fetch_add(1, std::memory_order_relaxed);
+
+        deliver(picture_);
+        av_frame_unref(picture_);
+        started = std::chrono::steady_clock::now();
+    }
+    if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
+        decodeErrors_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void H264Decoder::deliver(const AVFrame* picture) {
+    AASDKDecodedFrame out = {};
+
+    switch (picture->format) {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+        out.format = AASDK_PIXEL_FORMAT_I420;
+        for (int plane = 0; plane < 3; ++plane) {
+            out.planes[plane] = picture->data[plane];
+            out.strides[plane] = static_cast<uint32_t>(picture->linesize[plane]);
+        }
+        break;
+    case AV_PIX_FMT_NV12:
+        out.format = AASDK_PIXEL_FORMAT_NV12;
+        for (int plane = 0; plane < 2; ++plane) {
+            out.planes[plane] = picture->data[plane];
+            out.strides[plane] = static_cast<uint32_t>(picture->linesize[plane]);
+        }
+        break;
+    default:
+        if (!warnedFormat_) {
+            warnedFormat_ = true;
+            std::cerr << "Decoder produced unsupported pixel format " << picture->format
+                      << ", dropping decoded frames" << std::endl;
+        }
+        return;
+    }
+
+    out.width = static_cast<uint32_t>(picture->width);
+    out.height = static_cast<uint32_t>(picture->height);
+    out.sequence = picture->pts == AV_NOPTS_VALUE ? 0 : static_cast<uint64_t>(picture->pts);
+    const SourceTiming& source = sources_[out.sequence % TIMESTAMP_HISTORY];
+    out.timestamp = source.timestamp;
+    out.receive_ns = source.receiveNs;
+
+    if (ring_) {
+        ring_->publish(out);
+    }
+    if (callback_) {
+        callback_(&out, userData_);
+    }
+}
+
+#else // !AASDK_WITH_LIBAV
+
+bool H264Decoder::available() {
+    return false;
+}
+
+uint32_t H264Decoder::version() {
+    return 0;
+}
+
+bool H264Decoder::decodeNow(AASDKFrame* frame) {
+    FramePool::release(frame);
+    return false;
+}
+
+bool H264Decoder::start() {
+    std::cerr << "Native H.264 decoding unavailable: wrapper built without libavcodec" << std::endl;
+    return false;
+}
+
+void H264Decoder::stop() {
+    running_ = false;
+    input_.close();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    input_.drain();
+}
+
+void H264Decoder::decode(AASDKFrame* frame) {
+    FramePool::release(frame);
+}
+
+void H264Decoder::deliver(const AVFrame* /*picture*/) {}
+
+#endif // AASDK_WITH_LIBAV
@@ -0,0 +1,102 @@
+// Native H.264 decode stage
+// Decodes the projection stream with libavcodec on a dedicated thread and hands the
+// decoded YUV planes to a DecodedFrameCallback and/or a shared FrameRing. Only functional
+// when the wrapper is built with AASDK_WITH_LIBAV; otherwise start() reports that
+// decoding is unavailable.
+
+#ifndef H264_DECODER_H
+#define H264_DECODER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "aasdk_c.h"
+#include "frame_ring.h"
+#include "video_queue.h"
+
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
+
+class H264Decoder {
+public:
+    // Frames waiting for the decoder; more only adds latency when decode can't keep up
+    static constexpr uint32_t INPUT_DEPTH = 4;
+
+    H264Decoder(DecodedFrameCallback callback, void* userData);
+    ~H264Decoder();
+
+    H264Decoder(const H264Decoder&) = delete;
+    H264Decoder& operator=(const H264Decoder&) = delete;
+
+    // True if the wrapper was built with libavcodec
+    static bool available();
+
+    // libavcodec version the decoder runs on, 0 without libavcodec
+    static uint32_t version();
+
+    // Also copy every picture into ring (before the callback sees it). Call before start().
+    void setRing(std::shared_ptr<FrameRing> ring) { ring_ = std::move(ring); }
+
+    // Report how long each payload waited before decoding started. Call before start().
+    void setLagController(std::shared_ptr<VideoLagController> lag) { input_.setLagController(std::move(lag)); }
+
+    // Open the codec and start the decode thread
+    bool start();
+
+    // Stop the decode thread and release every pending frame
+    void stop();
+
+    // Queue a payload for decoding, taking over the caller's reference.
+    // Called from the video strand only.
+    void submit(AASDKFrame* frame, VideoFrameQueue::FrameKind kind);
+
+    // Drop queued payloads up to the next IDR. Called from the video strand only.
+    void resync() { input_.resync(); }
+
+    // Decode a payload on the calling thread instead of the decode thread, taking over
+    // the caller's reference; its pictures reach the callback before this returns.
+    // For benchmarking the decode path, never mixed with start().
+    bool decodeNow(AASDKFrame* frame);
+
+    uint64_t decodedFrames() const { return decodedFrames_.load(std::memory_order_relaxed); }
+    uint64_t decodeErrors() const { return decodeErrors_.load(std::memory_order_relaxed); }
+    uint64_t droppedFrames() const { return input_.dropped(); }
+    // Mean wall time spent in libavcodec per decoded picture
+    uint32_t averageDecodeUs() const;
+
+private:
+    // Decoder output is matched back to the source payload's timing through the sequence number
+    static constexpr uint32_t TIMESTAMP_HISTORY = 64;
+
+    struct SourceTiming {
+        uint64_t timestamp;     // Phone media timestamp
+        uint64_t receiveNs;     // Host receive time
+    };
+
+    bool open();
+    void run();
+    void decode(AASDKFrame* frame);
+    void deliver(const AVFrame* picture);
+
+    DecodedFrameCallback callback_;
+    void* userData_;
+    std::shared_ptr<FrameRing> ring_;
+    VideoFrameQueue input_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+
+    AVCodecContext* codec_;
+    AVPacket* packet_;
+    AVFrame* picture_;
+    SourceTiming sources_[TIMESTAMP_HISTORY];   // Decode thread only
+    bool warnedFormat_;
+
+    std::atomic<uint64_t> decodedFrames_;
+    std::atomic<uint64_t> decodeErrors_;
+    std::atomic<uint64_t> decodeTimeUs_;
+};
+
+#endif // H264_DECODER_H
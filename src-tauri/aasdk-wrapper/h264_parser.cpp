@@ -0,0 +1,317 @@
+// H.264 Annex-B parsing for the projection stream
+// See h264_parser.h
+
+#include "h264_parser.h"
+#include "frame_pool.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define H264_PARSER_NEON 1
+#endif
+
+namespace {
+
+// Exp-Golomb bit reader over an RBSP that still contains emulation prevention bytes
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : data_(data), size_(size), position_(0), bit_(0), zeros_(0), failed_(false) {}
+
+    uint32_t bit() {
+        if (position_ >= size_) {
+            failed_ = true;
+            return 0;
+        }
+        uint32_t value = (data_[position_] >> (7 - bit_)) & 1;
+        if (++bit_ == 8) {
+            nextByte();
+        }
+        return value;
+    }
+
+    uint32_t bits(int count) {
+        uint32_t value = 0;
+        for (int i = 0; i < count; ++i) {
+            value = (value << 1) | bit();
+        }
+        return value;
+    }
+
+    uint32_t ue() {
+        int leadingZeros = 0;
+        while (bit() == 0) {
+            if (failed_ || ++leadingZeros > 31) {
+                failed_ = true;
+                return 0;
+            }
+        }
+        return static_cast<uint32_t>((1ull << leadingZeros) - 1 + bits(leadingZeros));
+    }
+
+    int32_t se() {
+        uint32_t value = ue();
+        return (value & 1) ? static_cast<int32_t>((value + 1) / 2) : -static_cast<int32_t>(value / 2);
+    }
+
+    bool failed() const { return failed_; }
+
+private:
+    void nextByte() {
+        zeros_ = data_[position_] == 0 ? zeros_ + 1 : 0;
+        ++position_;
+        bit_ = 0;
+        // 00 00 03 -> the 03 only exists to keep start codes out of the payload
+        if (zeros_ >= 2 && position_ < size_ && data_[position_] == 3) {
+            ++position_;
+            zeros_ = 0;
+        }
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t position_;
+    int bit_;
+    int zeros_;
+    bool failed_;
+};
+
+void skipScalingList(BitReader& reader, int size) {
+    int last = 8;
+    int next = 8;
+    for (int i = 0; i < size && !reader.failed(); ++i) {
+        if (next != 0) {
+            next = (last + reader.se() + 256) % 256;
+        }
+        last = next == 0 ? last : next;
+    }
+}
+
+// Profiles whose SPS carries chroma format, bit depth and scaling matrices
+bool hasChromaInfo(uint32_t profile) {
+    switch (profile) {
+    case 100: case 110: case 122: case 244: case 44: case 83:
+    case 86: case 118: case 128: case 138: case 139: case 134: case 135:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isSlice(uint8_t type) {
+    return type >= H264Parser::NAL_SLICE && type <= H264Parser::NAL_IDR;
+}
+
+uint32_t nalFlag(uint8_t type) {
+    switch (type) {
+    case H264Parser::NAL_SPS: return AASDK_NAL_FLAG_SPS;
+    case H264Parser::NAL_PPS: return AASDK_NAL_FLAG_PPS;
+    case H264Parser::NAL_IDR: return AASDK_NAL_FLAG_IDR;
+    default: return isSlice(type) ? AASDK_NAL_FLAG_NON_IDR : 0;
+    }
+}
+
+const uint8_t START_CODE[4] = {0, 0, 0, 1};
+
+} // namespace
+
+size_t H264Parser::findStartCode(const uint8_t* data, size_t size, size_t from) {
+    size_t i = from;
+
+    // Compare 16 candidate positions at once; each needs bytes i, i+1 and i+2
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    for (; i + 18 <= size; i += 16) {
+        __m128i b0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), zero);
+        __m128i b1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1)), zero);
+        __m128i b2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 2)), one);
+        int mask = _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(b0, b1), b2));
+        if (mask) {
+            return i + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+#elif defined(H264_PARSER_NEON)
+    for (; i + 18 <= size; i += 16) {
+        uint8x16_t b0 = vceqq_u8(vld1q_u8(data + i), vdupq_n_u8(0));
+        uint8x16_t b1 = vceqq_u8(vld1q_u8(data + i + 1), vdupq_n_u8(0));
+        uint8x16_t b2 = vceqq_u8(vld1q_u8(data + i + 2), vdupq_n_u8(1));
+        uint64x2_t match = vreinterpretq_u64_u8(vandq_u8(vandq_u8(b0, b1), b2));
+        if (vgetq_lane_u64(match, 0) | vgetq_lane_u64(match, 1)) {
+            break;  // The scalar loop pins down the exact offset
+        }
+    }
+#endif
+
+    for (; i + 3 <= size; ++i) {
+        if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) {
+            return i;
+        }
+    }
+    return size;
+}
+
+bool H264Parser::parseSps(const uint8_t* nal, size_t size, SpsInfo& info) {
+    if (size < 4 || (nal[0] & 0x1f) != NAL_SPS) {
+        return false;
+    }
+
+    BitReader reader(nal + 1, size - 1);
+    uint32_t profile = reader.bits(8);
+    reader.bits(8);                                 // constraint_set flags
+    uint32_t level = reader.bits(8);
+    reader.ue();                                    // seq_parameter_set_id
+
+    uint32_t chromaFormat = 1;
+    bool separatePlanes = false;
+    if (hasChromaInfo(profile)) {
+        chromaFormat = reader.ue();
+        if (chromaFormat > 3) {
+            return false;
+        }
+        if (chromaFormat == 3) {
+            separatePlanes = reader.bit() != 0;
+        }
+        reader.ue();                                // bit_depth_luma_minus8
+        reader.ue();                                // bit_depth_chroma_minus8
+        reader.bit();                               // qpprime_y_zero_transform_bypass_flag
+        if (reader.bit()) {                         // seq_scaling_matrix_present_flag
+            int lists = chromaFormat != 3 ? 8 : 12;
+            for (int i = 0; i < lists; ++i) {
+                if (reader.bit()) {
+                    skipScalingList(reader, i < 6 ? 16 : 64);
+                }
+            }
+        }
+    }
+
+    reader.ue();                                    // log2_max_frame_num_minus4
+    uint32_t pocType = reader.ue();
+    if (pocType == 0) {
+        reader.ue();                                // log2_max_pic_order_cnt_lsb_minus4
+    } else if (pocType == 1) {
+        reader.bit();                               // delta_pic_order_always_zero_flag
+        reader.se();                                // offset_for_non_ref_pic
+        reader.se();                                // offset_for_top_to_bottom_field
+        uint32_t cycle = reader.ue();
+        if (cycle > 255) {
+            return false;
+        }
+        for (uint32_t i = 0; i < cycle; ++i) {
+            reader.se();
+        }
+    }
+
+    reader.ue();                                    // max_num_ref_frames
+    reader.bit();                                   // gaps_in_frame_num_value_allowed_flag
+    uint32_t widthMbs = reader.ue() + 1;
+    uint32_t heightMapUnits = reader.ue() + 1;
+    uint32_t frameMbsOnly = reader.bit();
+    if (!frameMbsOnly) {
+        reader.bit();                               // mb_adaptive_frame_field_flag
+    }
+    reader.bit();                                   // direct_8x8_inference_flag
+
+    uint32_t cropLeft = 0, cropRight = 0, cropTop = 0, cropBottom = 0;
+    if (reader.bit()) {
+        cropLeft = reader.ue();
+        cropRight = reader.ue();
+        cropTop = reader.ue();
+        cropBottom = reader.ue();
+    }
+    if (reader.failed() || widthMbs > 1024 || heightMapUnits > 1024) {
+        return false;
+    }
+
+    // Cropping is in chroma sample units (times two vertically for field coding)
+    uint32_t arrayType = separatePlanes ? 0 : chromaFormat;
+    uint32_t cropUnitX = (arrayType == 1 || arrayType == 2) ? 2 : 1;
+    uint32_t cropUnitY = (arrayType == 1 ? 2 : 1) * (2 - frameMbsOnly);
+    uint32_t width = widthMbs * 16;
+    uint32_t height = (2 - frameMbsOnly) * heightMapUnits * 16;
+    uint64_t cropX = static_cast<uint64_t>(cropUnitX) * (static_cast<uint64_t>(cropLeft) + cropRight);
+    uint64_t cropY = static_cast<uint64_t>(cropUnitY) * (static_cast<uint64_t>(cropTop) + cropBottom);
+    if (cropX >= width || cropY >= height) {
+        return false;
+    }
+
+    info.width = width - static_cast<uint32_t>(cropX);
+    info.height = height - static_cast<uint32_t>(cropY);
+    info.profile = static_cast<uint8_t>(profile);
+    info.level = static_cast<uint8_t>(level);
+    return true;
+}
+
+H264ParameterCache::H264ParameterCache() : info_(), hasInfo_(false) {}
+
+uint32_t H264ParameterCache::update(const uint8_t* data, size_t size) {
+    // Parameter sets precede the slices, so the walk ends at the first slice header
+    // without scanning the slice data: the cost does not grow with the size of the picture
+    uint32_t flags = 0;
+    H264Parser::forEachNalUntil(data, size, isSlice, [this, &flags](const H264Parser::Nal& nal) {
+        flags |= nalFlag(nal.type);
+        if (nal.type == H264Parser::NAL_SPS) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (sps_.size() != nal.size || std::memcmp(sps_.data(), nal.data, nal.size) != 0) {
+                sps_.assign(nal.data, nal.data + nal.size);
+                hasInfo_ = H264Parser::parseSps(nal.data, nal.size, info_);
+            }
+        } else if (nal.type == H264Parser::NAL_PPS) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pps_.assign(nal.data, nal.data + nal.size);
+        }
+        return true;
+    });
+    return flags;
+}
+
+void H264ParameterCache::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sps_.clear();
+    pps_.clear();
+    hasInfo_ = false;
+}
+
+bool H264ParameterCache::info(H264Parser::SpsInfo& info) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (hasInfo_) {
+        info = info_;
+    }
+    return hasInfo_;
+}
+
+bool H264ParameterCache::hasConfig() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !sps_.empty() && !pps_.empty();
+}
+
+AASDKFrame* H264ParameterCache::configFrame(FramePool& pool) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sps_.empty() || pps_.empty()) {
+        return nullptr;
+    }
+
+    AASDKFrame* frame = pool.acquire(sizeof(START_CODE) * 2 + sps_.size() + pps_.size());
+    if (!frame) {
+        return nullptr;
+    }
+
+    uint8_t* out = const_cast<uint8_t*>(frame->data);
+    std::memcpy(out, START_CODE, sizeof(START_CODE));
+    out += sizeof(START_CODE);
+    std::memcpy(out, sps_.data(), sps_.size());
+    out += sps_.size();
+    std::memcpy(out, START_CODE, sizeof(START_CODE));
+    out += sizeof(START_CODE);
+    std::memcpy(out, pps_.data(), pps_.size());
+
+    frame->nal_flags = AASDK_NAL_FLAG_SPS | AASDK_NAL_FLAG_PPS;
+    if (hasInfo_) {
+        frame->width = info_.width;
+        frame->height = info_.height;
+    }
+    return frame;
+}
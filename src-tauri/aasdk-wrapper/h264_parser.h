@@ -0,0 +1,125 @@
+// H.264 Annex-B parsing for the projection stream
+// Splits payloads into NAL units without copying, tags them with AASDK_NAL_FLAG_*
+// and keeps the latest SPS/PPS so a consumer that attaches (or restarts) mid-stream
+// can be primed without waiting for the phone to send the next IDR.
+
+#ifndef H264_PARSER_H
+#define H264_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "aasdk_c.h"
+
+class FramePool;
+
+class H264Parser {
+public:
+    enum NalType : uint8_t {
+        NAL_SLICE = 1,
+        NAL_IDR = 5,
+        NAL_SEI = 6,
+        NAL_SPS = 7,
+        NAL_PPS = 8,
+        NAL_AUD = 9
+    };
+
+    // One NAL unit inside a payload; data points at the NAL header byte
+    struct Nal {
+        const uint8_t* data;
+        size_t size;
+        uint8_t type;
+    };
+
+    // Fields of a sequence parameter set the wrapper cares about
+    struct SpsInfo {
+        uint32_t width;     // Cropped picture size in pixels
+        uint32_t height;
+        uint8_t profile;
+        uint8_t level;
+    };
+
+    // Offset of the first 00 00 01 start code at or after from, or size if there is none
+    static size_t findStartCode(const uint8_t* data, size_t size, size_t from = 0);
+
+    // Call visit(const Nal&) for each NAL unit until it returns false
+    template <typename Visitor>
+    static void forEachNal(const uint8_t* data, size_t size, Visitor visit);
+
+    // Like forEachNal, but the first NAL unit whose type satisfies last(uint8_t) is
+    // visited without searching for its end (its size runs to the end of data) and ends
+    // the walk, so the bytes behind its header are never scanned
+    template <typename Last, typename Visitor>
+    static void forEachNalUntil(const uint8_t* data, size_t size, Last last, Visitor visit);
+
+    // Decode an SPS NAL unit (header byte included). Returns false if it is truncated
+    // or uses features the projection stream never does.
+    static bool parseSps(const uint8_t* nal, size_t size, SpsInfo& info);
+};
+
+template <typename Visitor>
+void H264Parser::forEachNal(const uint8_t* data, size_t size, Visitor visit) {
+    forEachNalUntil(data, size, [](uint8_t) { return false; }, visit);
+}
+
+template <typename Last, typename Visitor>
+void H264Parser::forEachNalUntil(const uint8_t* data, size_t size, Last last, Visitor visit) {
+    size_t start = findStartCode(data, size);
+    while (start < size) {
+        size_t begin = start + 3;
+        if (begin < size && last(static_cast<uint8_t>(data[begin] & 0x1f))) {
+            Nal nal = {data + begin, size - begin, static_cast<uint8_t>(data[begin] & 0x1f)};
+            visit(nal);
+            return;
+        }
+
+        size_t next = findStartCode(data, size, begin);
+
+        // A 4-byte start code or trailing_zero_bytes leave zeros before the next prefix
+        size_t end = next;
+        while (end > begin && data[end - 1] == 0) {
+            --end;
+        }
+        if (end > begin) {
+            Nal nal = {data + begin, end - begin, static_cast<uint8_t>(data[begin] & 0x1f)};
+            if (!visit(nal)) {
+                return;
+            }
+        }
+        start = next;
+    }
+}
+
+// Latest codec configuration seen on the video channel.
+// Updated from the video strand, read from any thread.
+class H264ParameterCache {
+public:
+    H264ParameterCache();
+
+    // Tag a payload and remember any SPS/PPS it carries. Returns AASDK_NAL_FLAG_*.
+    uint32_t update(const uint8_t* data, size_t size);
+
+    // Forget the configuration, e.g. when a new phone connects
+    void reset();
+
+    // Parsed SPS fields; false until an SPS has been seen
+    bool info(H264Parser::SpsInfo& info) const;
+
+    // True once both an SPS and a PPS have been seen
+    bool hasConfig() const;
+
+    // A pool frame holding the cached SPS and PPS as one Annex-B payload, or nullptr if
+    // either is missing. The caller owns the returned reference.
+    AASDKFrame* configFrame(FramePool& pool) const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<uint8_t> sps_;      // NAL units without start codes
+    std::vector<uint8_t> pps_;
+    H264Parser::SpsInfo info_;
+    bool hasInfo_;
+};
+
+#endif // H264_PARSER_H
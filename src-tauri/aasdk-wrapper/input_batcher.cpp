@@ -0,0 +1,236 @@
+// Touch and button input batching for the input channel
+// See input_batcher.h
+
+#include "input_batcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+InputBatcher::InputBatcher(uint32_t width, uint32_t height)
+    : width_(std::max<uint32_t>(width, 1)), height_(std::max<uint32_t>(height, 1)), cells_(new Cell[CAPACITY]),
+      enqueuePos_(0), dequeuePos_(0), drainPending_(false), downCount_(0), touchEvents_(0), buttonEvents_(0),
+      dropped_(0), coalesced_(0), sent_(0), latencyTotalUs_(0), latencyMaxUs_(0) {
+    for (uint32_t i = 0; i < CAPACITY; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+uint64_t InputBatcher::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool InputBatcher::pushTouch(uint32_t pointerId, int32_t x, int32_t y, int32_t action, uint64_t timeNs) {
+    if (action != AASDK_TOUCH_DOWN && action != AASDK_TOUCH_UP && action != AASDK_TOUCH_MOVE) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    Event event;
+    event.button = false;
+    event.action = action;
+    event.id = pointerId;
+    event.x = static_cast<uint32_t>(std::min<int64_t>(std::max<int32_t>(x, 0), width_ - 1));
+    event.y = static_cast<uint32_t>(std::min<int64_t>(std::max<int32_t>(y, 0), height_ - 1));
+    event.queuedNs = nowNs();
+    event.timeNs = timeNs ? timeNs : event.queuedNs;
+    touchEvents_.fetch_add(1, std::memory_order_relaxed);
+    return push(event);
+}
+
+bool InputBatcher::pushButton(uint32_t code, bool pressed, uint64_t timeNs) {
+    Event event;
+    event.button = true;
+    event.action = pressed ? 1 : 0;
+    event.id = code;
+    event.x = 0;
+    event.y = 0;
+    event.queuedNs = nowNs();
+    event.timeNs = timeNs ? timeNs : event.queuedNs;
+    buttonEvents_.fetch_add(1, std::memory_order_relaxed);
+    return push(event);
+}
+
+bool InputBatcher::push(const Event& event) {
+    uint64_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells_[pos % CAPACITY];
+        int64_t diff = static_cast<int64_t>(cell->sequence.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The consumer has not freed this cell yet: full
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+    cell->event = event;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool InputBatcher::pop(Event* event) {
+    Cell* cell = &cells_[dequeuePos_ % CAPACITY];
+    if (cell->sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+        return false;
+    }
+    *event = cell->event;
+    cell->sequence.store(dequeuePos_ + CAPACITY, std::memory_order_release);
+    ++dequeuePos_;
+    return true;
+}
+
+bool InputBatcher::requestDrain() {
+    return !drainPending_.exchange(true, std::memory_order_acq_rel);
+}
+
+bool InputBatcher::next(Batch* batch) {
+    // Cleared before draining, so an event pushed from here on asks for another drain
+    drainPending_.store(false, std::memory_order_release);
+
+    // Stop taking events while the transport is far behind; the queue then fills and
+    // drops, instead of the outbox growing
+    Event event;
+    while (outbox_.size() < CAPACITY && pop(&event)) {
+        apply(event);
+    }
+    if (outbox_.empty()) {
+        return false;
+    }
+    *batch = outbox_.front();
+    outbox_.pop_front();
+    return true;
+}
+
+void InputBatcher::apply(const Event& event) {
+    Batch batch;
+    batch.button = event.button;
+    batch.action = event.action;
+    batch.actionIndex = 0;
+    batch.pointerCount = 0;
+    batch.code = 0;
+    batch.pressed = false;
+    batch.timeNs = event.timeNs;
+    batch.queuedNs = event.queuedNs;
+    batch.events = 1;
+
+    if (event.button) {
+        batch.code = event.id;
+        batch.pressed = event.action != 0;
+        outbox_.push_back(batch);
+        return;
+    }
+
+    int index = find(event.id);
+    switch (event.action) {
+    case AASDK_TOUCH_MOVE:
+        if (index < 0) {
+            // A move for a pointer that is not down has nothing to move
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        down_[index].x = event.x;
+        down_[index].y = event.y;
+        if (!outbox_.empty() && !outbox_.back().button && outbox_.back().action == AASDK_TOUCH_MOVE) {
+            // Fold into the pending drag: newest positions, oldest queue time
+            Batch& pending = outbox_.back();
+            snapshot(&pending);
+            pending.timeNs = event.timeNs;
+            ++pending.events;
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        snapshot(&batch);
+        batch.actionIndex = static_cast<uint32_t>(index);
+        outbox_.push_back(batch);
+        return;
+
+    case AASDK_TOUCH_DOWN:
+        if (index >= 0) {
+            // Already down: the position is all that is new
+            Event moved = event;
+            moved.action = AASDK_TOUCH_MOVE;
+            apply(moved);
+            return;
+        }
+        if (downCount_ == AASDK_MAX_TOUCH_POINTERS) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        down_[downCount_] = Pointer{event.id, event.x, event.y};
+        batch.actionIndex = downCount_++;
+        batch.action = downCount_ == 1 ? AASDK_TOUCH_DOWN : ACTION_POINTER_DOWN;
+        snapshot(&batch);
+        outbox_.push_back(batch);
+        return;
+
+    case AASDK_TOUCH_UP:
+        if (index < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // The indication still carries the pointer that goes up
+        down_[index].x = event.x;
+        down_[index].y = event.y;
+        batch.action = downCount_ == 1 ? AASDK_TOUCH_UP : ACTION_POINTER_UP;
+        batch.actionIndex = static_cast<uint32_t>(index);
+        snapshot(&batch);
+        outbox_.push_back(batch);
+        std::copy(down_ + index + 1, down_ + downCount_, down_ + index);
+        --downCount_;
+        return;
+    }
+}
+
+void InputBatcher::snapshot(Batch* batch) const {
+    std::copy(down_, down_ + downCount_, batch->pointers);
+    batch->pointerCount = downCount_;
+}
+
+int InputBatcher::find(uint32_t pointerId) const {
+    for (uint32_t i = 0; i < downCount_; ++i) {
+        if (down_[i].id == pointerId) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void InputBatcher::sent(const Batch& batch) {
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t now = nowNs();
+    uint64_t latencyUs = now > batch.queuedNs ? (now - batch.queuedNs) / 1000 : 0;
+    latencyTotalUs_.fetch_add(latencyUs, std::memory_order_relaxed);
+    uint32_t clamped = static_cast<uint32_t>(std::min<uint64_t>(latencyUs, std::numeric_limits<uint32_t>::max()));
+    if (clamped > latencyMaxUs_.load(std::memory_order_relaxed)) {
+        latencyMaxUs_.store(clamped, std::memory_order_relaxed);
+    }
+}
+
+void InputBatcher::reset() {
+    Event event;
+    uint64_t discarded = outbox_.size();
+    while (pop(&event)) {
+        ++discarded;
+    }
+    outbox_.clear();
+    downCount_ = 0;
+    dropped_.fetch_add(discarded, std::memory_order_relaxed);
+    drainPending_.store(false, std::memory_order_release);
+}
+
+void InputBatcher::stats(AASDKInputStats* stats) const {
+    stats->touch_events = touchEvents_.load(std::memory_order_relaxed);
+    stats->button_events = buttonEvents_.load(std::memory_order_relaxed);
+    stats->dropped_events = dropped_.load(std::memory_order_relaxed);
+    stats->coalesced_moves = coalesced_.load(std::memory_order_relaxed);
+    stats->indications_sent = sent_.load(std::memory_order_relaxed);
+    stats->latency_us_avg = stats->indications_sent
+        ? static_cast<uint32_t>(latencyTotalUs_.load(std::memory_order_relaxed) / stats->indications_sent) : 0;
+    stats->latency_us_max = latencyMaxUs_.load(std::memory_order_relaxed);
+}
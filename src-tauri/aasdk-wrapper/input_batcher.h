@@ -0,0 +1,126 @@
+// Touch and button input batching for the input channel
+// The UI thread queues touch points and key presses into a bounded lock-free
+// multi-producer queue and never blocks. The input channel's strand drains it once per
+// send slot (one InputEventIndication in flight at a time) and turns it into
+// indications the way Android's MotionEvents work: every indication carries all the
+// pointers that are down with their latest positions, and the action of one of them.
+// Downs and ups are never merged, so a tap or a second finger is never lost; moves
+// queued since the last slot are merged into one DRAG, so a panel reporting at several
+// hundred hertz costs one message per slot rather than one per point, and a busy
+// transport sends the newest positions instead of falling behind.
+
+#ifndef INPUT_BATCHER_H
+#define INPUT_BATCHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#include "aasdk_c.h"
+
+class InputBatcher {
+public:
+    // Events the queue holds; a full queue drops new events
+    static constexpr uint32_t CAPACITY = 256;
+
+    // TouchAction values for a second or later pointer going down or up, which aasdk's
+    // enum does not name; the phone reads them as Android's ACTION_POINTER_DOWN/UP
+    static constexpr int32_t ACTION_POINTER_DOWN = 5;
+    static constexpr int32_t ACTION_POINTER_UP = 6;
+
+    struct Pointer {
+        uint32_t id;
+        uint32_t x;
+        uint32_t y;
+    };
+
+    // One InputEventIndication
+    struct Batch {
+        bool button;
+        int32_t action;             // Touch: AASDKTouchAction or ACTION_POINTER_DOWN/UP
+        uint32_t actionIndex;       // Index into pointers of the pointer that acted
+        Pointer pointers[AASDK_MAX_TOUCH_POINTERS];
+        uint32_t pointerCount;
+        uint32_t code;              // Button: key code
+        bool pressed;
+        uint64_t timeNs;            // Time of the newest event
+        uint64_t queuedNs;          // When the oldest event was queued
+        uint32_t events;            // Events merged into this batch
+    };
+
+    // Touch coordinates are clamped to width x height
+    InputBatcher(uint32_t width, uint32_t height);
+
+    InputBatcher(const InputBatcher&) = delete;
+    InputBatcher& operator=(const InputBatcher&) = delete;
+
+    // Producer side, any thread; lock-free. timeNs 0 = now. False if the queue is full
+    // or the action is unknown.
+    bool pushTouch(uint32_t pointerId, int32_t x, int32_t y, int32_t action, uint64_t timeNs);
+    bool pushButton(uint32_t code, bool pressed, uint64_t timeNs);
+
+    // Any thread, after a push: true if no drain is pending, so the caller schedules one
+    bool requestDrain();
+
+    // Consumer side (the input strand)
+    // Next indication to send, false if nothing is queued
+    bool next(Batch* batch);
+    // The transport took batch; records its queue-to-send latency
+    void sent(const Batch& batch);
+    // New connection: drop queued events and forget the pointers that were down
+    void reset();
+
+    // Any thread
+    void stats(AASDKInputStats* stats) const;
+
+    static uint64_t nowNs();
+
+private:
+    struct Event {
+        bool button;
+        int32_t action;
+        uint32_t id;                // Pointer id or key code
+        uint32_t x;
+        uint32_t y;
+        uint64_t timeNs;
+        uint64_t queuedNs;
+    };
+
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        Event event;
+    };
+
+    bool push(const Event& event);
+    bool pop(Event* event);
+    // Fold one event into the outbox
+    void apply(const Event& event);
+    void snapshot(Batch* batch) const;
+    int find(uint32_t pointerId) const;
+
+    const uint32_t width_;
+    const uint32_t height_;
+
+    // Bounded MPSC queue: a cell is free for position p when its sequence is p, and
+    // holds the event for p when it is p + 1
+    std::unique_ptr<Cell[]> cells_;
+    std::atomic<uint64_t> enqueuePos_;
+    uint64_t dequeuePos_;
+    std::atomic<bool> drainPending_;
+
+    // Consumer state
+    Pointer down_[AASDK_MAX_TOUCH_POINTERS];
+    uint32_t downCount_;
+    std::deque<Batch> outbox_;      // Unsent, in order; only the last may still take moves
+
+    std::atomic<uint64_t> touchEvents_;
+    std::atomic<uint64_t> buttonEvents_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> coalesced_;
+    std::atomic<uint64_t> sent_;
+    std::atomic<uint64_t> latencyTotalUs_;
+    std::atomic<uint32_t> latencyMaxUs_;
+};
+
+#endif // INPUT_BATCHER_H
@@ -0,0 +1,146 @@
+// Audio jitter buffer
+// See jitter_buffer.h
+
+#include "jitter_buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+constexpr uint32_t AudioJitterBuffer::WINDOW;
+constexpr int64_t AudioJitterBuffer::DISCONTINUITY_US;
+
+AudioJitterBuffer::AudioJitterBuffer(uint32_t capacityFrames, const AASDKAudioFormat& format,
+                                     const AASDKJitterConfig& config)
+    : ring_(capacityFrames, format), minMs_(config.min_ms), maxMs_(config.max_ms), transits_(), transitCount_(0),
+      transitNext_(0), mediaFrames_(0), jitterUs_(0), lastWriteNs_(0), ending_(false), playing_(false), maxRead_(0),
+      windowLow_(std::numeric_limits<uint32_t>::max()), windowFrames_(0), targetFrames_(0), underruns_(0),
+      trimmed_(0) {}
+
+uint64_t AudioJitterBuffer::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint32_t AudioJitterBuffer::write(const int16_t* samples, uint32_t frames, const AASDKMediaInfo& info) {
+    uint32_t written = ring_.write(samples, frames, info);
+
+    if (ending_.load(std::memory_order_relaxed)) {
+        // A new stream: its timeline has nothing to do with the last one's
+        transitCount_ = 0;
+        ending_.store(false, std::memory_order_release);
+    }
+
+    const uint64_t rate = std::max<uint32_t>(format().sample_rate, 1);
+    uint64_t receiveNs = info.receive_ns ? info.receive_ns : nowNs();
+    int64_t mediaUs = (info.flags & AASDK_MEDIA_INFO_HAS_TIMESTAMP) ? static_cast<int64_t>(info.timestamp)
+                                                                    : static_cast<int64_t>(mediaFrames_ * 1000000 / rate);
+    int64_t transit = static_cast<int64_t>(receiveNs / 1000) - mediaUs;
+    if (transitCount_ > 0) {
+        int64_t last = transits_[(transitNext_ + WINDOW - 1) % WINDOW];
+        if (transit - last > DISCONTINUITY_US || last - transit > DISCONTINUITY_US) {
+            transitCount_ = 0;
+        }
+    }
+    transits_[transitNext_] = transit;
+    transitNext_ = (transitNext_ + 1) % WINDOW;
+    transitCount_ = std::min(transitCount_ + 1, WINDOW);
+
+    int64_t low = transit;
+    int64_t high = transit;
+    for (uint32_t i = 1; i < transitCount_; ++i) {
+        int64_t value = transits_[(transitNext_ + WINDOW - 1 - i) % WINDOW];
+        low = std::min(low, value);
+        high = std::max(high, value);
+    }
+    jitterUs_.store(static_cast<uint32_t>(std::min<int64_t>(high - low, std::numeric_limits<uint32_t>::max())),
+                    std::memory_order_relaxed);
+    lastWriteNs_.store(receiveNs, std::memory_order_relaxed);
+    mediaFrames_ += frames;
+    return written;
+}
+
+void AudioJitterBuffer::endOfStream() {
+    ending_.store(true, std::memory_order_release);
+}
+
+uint32_t AudioJitterBuffer::target() const {
+    uint32_t maxMs = maxMs_.load(std::memory_order_relaxed);
+    if (maxMs == 0) {
+        return 0;
+    }
+    const uint64_t rate = format().sample_rate;
+    uint64_t jitter = static_cast<uint64_t>(jitterUs_.load(std::memory_order_relaxed)) * rate / 1000000;
+    uint64_t floor = std::min<uint64_t>(std::max<uint64_t>(minMs_.load(std::memory_order_relaxed) * rate / 1000, maxRead_),
+                                        ring_.capacity());
+    uint64_t ceiling = std::max(std::min<uint64_t>(maxMs * rate / 1000, ring_.capacity() / 2), floor);
+    return static_cast<uint32_t>(std::min(std::max(jitter + jitter / 4, floor), ceiling));
+}
+
+uint32_t AudioJitterBuffer::read(int16_t* out, uint32_t frames, AASDKAudioReadInfo* info) {
+    const uint32_t rate = format().sample_rate;
+    maxRead_ = std::max(maxRead_, frames);
+    uint32_t depth = ring_.buffered();
+    uint32_t goal = target();
+    targetFrames_.store(goal, std::memory_order_relaxed);
+
+    if (!playing_) {
+        // Start once the target is buffered, the phone has ended the stream, or nothing
+        // has arrived for as long as the target would take to play
+        uint64_t now = nowNs();
+        uint64_t last = lastWriteNs_.load(std::memory_order_relaxed);
+        uint64_t quietNs = now > last ? now - last : 0;
+        bool waiting = depth < goal && !ending_.load(std::memory_order_acquire) &&
+                       quietNs < static_cast<uint64_t>(goal) * 1000000000 / std::max<uint32_t>(rate, 1);
+        if (depth == 0 || waiting) {
+            if (info) {
+                *info = AASDKAudioReadInfo();
+                info->available = depth;
+            }
+            return 0;
+        }
+        playing_ = true;
+        windowLow_ = depth;
+        windowFrames_ = 0;
+    }
+
+    // A ring that stayed well above the target for a whole second holds latency the
+    // jitter no longer needs; skip it in one step rather than in a series of small ones
+    if (goal > 0) {
+        windowLow_ = std::min(windowLow_, depth);
+        windowFrames_ += frames;
+        if (windowFrames_ >= rate) {
+            uint32_t slack = std::max(goal / 2, rate / 100);
+            if (windowLow_ > goal + slack) {
+                trimmed_.fetch_add(ring_.discard(windowLow_ - goal), std::memory_order_relaxed);
+            }
+            windowLow_ = std::numeric_limits<uint32_t>::max();
+            windowFrames_ = 0;
+        }
+    }
+
+    uint32_t count = ring_.read(out, frames, info);
+    if (count < frames) {
+        // Ran dry: fill back up to the target before playing again
+        playing_ = false;
+        if (!ending_.load(std::memory_order_acquire)) {
+            underruns_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return count;
+}
+
+void AudioJitterBuffer::configure(const AASDKJitterConfig& config) {
+    minMs_.store(config.min_ms, std::memory_order_relaxed);
+    maxMs_.store(config.max_ms, std::memory_order_relaxed);
+}
+
+void AudioJitterBuffer::stats(AASDKAudioRingStats* stats) const {
+    ring_.stats(stats);
+    stats->underruns = underruns_.load(std::memory_order_relaxed);
+    stats->target_frames = targetFrames_.load(std::memory_order_relaxed);
+    stats->jitter_us = jitterUs_.load(std::memory_order_relaxed);
+    stats->latency_us = static_cast<uint32_t>(static_cast<uint64_t>(stats->buffered_frames) * 1000000 /
+                                              std::max<uint32_t>(format().sample_rate, 1));
+    stats->trimmed_frames = trimmed_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,83 @@
+// Audio jitter buffer for one stream
+// USB delivers Android Auto audio in bursts, so a reader that plays whatever has arrived
+// runs dry between bursts. The producer side measures each payload's transit time, host
+// receive time minus the phone's media timestamp; the spread of transit times over the
+// last WINDOW payloads is the arrival jitter, and the target depth is that jitter plus
+// a quarter, between the configured bounds. The consumer side holds playout back until
+// the ring reaches the target (or the phone goes quiet for as long), fills back up to
+// it after every underrun, and trims a standing backlog: if the ring never dropped to
+// within slack of the target for a whole second, the excess is skipped.
+// Without timestamps, the frames written so far stand in for the media clock.
+
+#ifndef JITTER_BUFFER_H
+#define JITTER_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "aasdk_c.h"
+#include "pcm_ring.h"
+
+class AudioJitterBuffer {
+public:
+    // Payloads the arrival jitter is measured over
+    static constexpr uint32_t WINDOW = 64;
+
+    // A transit time this far from the last one is a new timeline (seek, new session),
+    // not jitter
+    static constexpr int64_t DISCONTINUITY_US = 500000;
+
+    AudioJitterBuffer(uint32_t capacityFrames, const AASDKAudioFormat& format, const AASDKJitterConfig& config);
+
+    AudioJitterBuffer(const AudioJitterBuffer&) = delete;
+    AudioJitterBuffer& operator=(const AudioJitterBuffer&) = delete;
+
+    // Producer side (the stream's channel strand). Append a payload; returns the frames
+    // that fit.
+    uint32_t write(const int16_t* samples, uint32_t frames, const AASDKMediaInfo& info);
+
+    // Producer side. The phone stopped the stream: play out the rest without waiting for
+    // the target and without counting the end as an underrun.
+    void endOfStream();
+
+    // Consumer side. Like PcmRing::read, but returns 0 while filling to the target.
+    uint32_t read(int16_t* out, uint32_t frames, AASDKAudioReadInfo* info);
+
+    // Any thread
+    void configure(const AASDKJitterConfig& config);
+    const AASDKAudioFormat& format() const { return ring_.format(); }
+    uint32_t buffered() const { return ring_.buffered(); }
+    void stats(AASDKAudioRingStats* stats) const;
+
+private:
+    static uint64_t nowNs();
+
+    // Target depth in frames for the current jitter, never below the largest read
+    uint32_t target() const;
+
+    PcmRing ring_;
+    std::atomic<uint32_t> minMs_;
+    std::atomic<uint32_t> maxMs_;
+
+    // Producer only
+    int64_t transits_[WINDOW];      // Receive time minus media time, microseconds
+    uint32_t transitCount_;
+    uint32_t transitNext_;
+    uint64_t mediaFrames_;          // Frames written, the media clock without timestamps
+
+    std::atomic<uint32_t> jitterUs_;
+    std::atomic<uint64_t> lastWriteNs_;
+    std::atomic<bool> ending_;
+
+    // Consumer only
+    bool playing_;
+    uint32_t maxRead_;
+    uint32_t windowLow_;            // Lowest depth seen this trim window
+    uint32_t windowFrames_;         // Frames read this trim window
+
+    std::atomic<uint32_t> targetFrames_;
+    std::atomic<uint64_t> underruns_;
+    std::atomic<uint64_t> trimmed_;
+};
+
+#endif // JITTER_BUFFER_H
@@ -0,0 +1,90 @@
+// Video lag detection and resync
+// See lag_controller.h
+
+#include "lag_controller.h"
+
+#include <chrono>
+
+constexpr uint32_t VideoLagController::KEYFRAME_TIMEOUT_MS;
+
+VideoLagController::VideoLagController(uint32_t thresholdMs)
+    : thresholdNs_(static_cast<uint64_t>(thresholdMs) * 1000000), lagging_(false), ignoreBeforeNs_(0),
+      state_(State::IDLE), awaitingSinceNs_(0), maxLagMs_(0), resyncs_(0), keyframeRequests_(0) {
+    for (auto& bucket : histogram_) {
+        bucket = 0;
+    }
+}
+
+uint64_t VideoLagController::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void VideoLagController::consumed(uint64_t receiveNs) {
+    // Priming frames carry no receive time
+    if (receiveNs == 0) {
+        return;
+    }
+    uint64_t now = nowNs();
+    uint64_t lagNs = now > receiveNs ? now - receiveNs : 0;
+
+    // Bucket i holds lags below 2^i ms, the last bucket everything longer
+    uint64_t lagMs = lagNs / 1000000;
+    uint32_t bucket = 0;
+    while (bucket + 1 < AASDK_LAG_HISTOGRAM_BUCKETS && lagMs >= (1ull << bucket)) {
+        ++bucket;
+    }
+    histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t lagMs32 = lagMs > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(lagMs);
+    uint32_t peak = maxLagMs_.load(std::memory_order_relaxed);
+    while (lagMs32 > peak && !maxLagMs_.compare_exchange_weak(peak, lagMs32, std::memory_order_relaxed)) {
+    }
+
+    if (thresholdNs_ != 0 && lagNs > thresholdNs_ &&
+        receiveNs >= ignoreBeforeNs_.load(std::memory_order_relaxed)) {
+        lagging_.store(true, std::memory_order_relaxed);
+    }
+}
+
+VideoLagController::Action VideoLagController::onPayload(uint32_t nalFlags, uint64_t nowNs) {
+    if (nalFlags & AASDK_NAL_FLAG_IDR) {
+        // The queues drop their backlog in front of an IDR, so the stream is current again
+        state_ = State::IDLE;
+        return Action::NONE;
+    }
+
+    if (state_ == State::IDLE) {
+        if (!lagging_.exchange(false, std::memory_order_relaxed)) {
+            return Action::NONE;
+        }
+        // Consumers are still working through frames that arrived before the flush
+        ignoreBeforeNs_.store(nowNs, std::memory_order_relaxed);
+        state_ = State::AWAITING_IDR;
+        awaitingSinceNs_ = nowNs;
+        resyncs_.fetch_add(1, std::memory_order_relaxed);
+        return Action::FLUSH;
+    }
+
+    if (nowNs - awaitingSinceNs_ < static_cast<uint64_t>(KEYFRAME_TIMEOUT_MS) * 1000000) {
+        return Action::NONE;
+    }
+    // Ask again after another timeout if the focus change got lost
+    awaitingSinceNs_ = nowNs;
+    keyframeRequests_.fetch_add(1, std::memory_order_relaxed);
+    return Action::REQUEST_KEYFRAME;
+}
+
+void VideoLagController::reset() {
+    state_ = State::IDLE;
+    lagging_.store(false, std::memory_order_relaxed);
+}
+
+void VideoLagController::snapshot(AASDKStats* stats) const {
+    for (uint32_t i = 0; i < AASDK_LAG_HISTOGRAM_BUCKETS; ++i) {
+        stats->video_lag_histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+    }
+    stats->video_lag_ms_max = maxLagMs_.load(std::memory_order_relaxed);
+    stats->video_resyncs = resyncs_.load(std::memory_order_relaxed);
+    stats->video_keyframe_requests = keyframeRequests_.load(std::memory_order_relaxed);
+}
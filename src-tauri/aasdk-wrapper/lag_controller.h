@@ -0,0 +1,63 @@
+// Video lag detection and resync
+// Consumers report the host receive time of every frame they take; once a frame is
+// consumed more than the threshold after it arrived, the video strand flushes the queued
+// backlog up to the next IDR. Android Auto phones send IDRs rarely, so if none arrives
+// within KEYFRAME_TIMEOUT_MS the strand forces one by cycling video focus.
+
+#ifndef LAG_CONTROLLER_H
+#define LAG_CONTROLLER_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "aasdk_c.h"
+
+class VideoLagController {
+public:
+    // Time the strand waits for the phone's own IDR after a flush before (re)requesting one
+    static constexpr uint32_t KEYFRAME_TIMEOUT_MS = 250;
+
+    enum class Action {
+        NONE,
+        FLUSH,              // Drop queued frames up to the next IDR
+        REQUEST_KEYFRAME    // Cycle video focus so the phone restarts with an IDR
+    };
+
+    // thresholdMs 0 only records the histogram
+    explicit VideoLagController(uint32_t thresholdMs);
+
+    VideoLagController(const VideoLagController&) = delete;
+    VideoLagController& operator=(const VideoLagController&) = delete;
+
+    // A consumer took the frame received at receiveNs (CLOCK_MONOTONIC). Any thread.
+    void consumed(uint64_t receiveNs);
+
+    // A payload arrived on the video strand; returns what the strand should do about lag
+    Action onPayload(uint32_t nalFlags, uint64_t nowNs);
+
+    // New connection: forget a resync in progress
+    void reset();
+
+    void snapshot(AASDKStats* stats) const;
+
+private:
+    static uint64_t nowNs();
+
+    enum class State {
+        IDLE,
+        AWAITING_IDR    // Flushed, waiting for the stream to restart at an IDR
+    };
+
+    const uint64_t thresholdNs_;
+    std::atomic<bool> lagging_;             // Set by consumers, taken by the strand
+    std::atomic<uint64_t> ignoreBeforeNs_;  // Frames received before the last flush don't count
+    State state_;                           // Video strand only
+    uint64_t awaitingSinceNs_;              // Video strand only
+
+    std::atomic<uint64_t> histogram_[AASDK_LAG_HISTOGRAM_BUCKETS];
+    std::atomic<uint32_t> maxLagMs_;
+    std::atomic<uint64_t> resyncs_;
+    std::atomic<uint64_t> keyframeRequests_;
+};
+
+#endif // LAG_CONTROLLER_H
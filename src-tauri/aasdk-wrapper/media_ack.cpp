@@ -0,0 +1,72 @@
+// Android Auto media flow control
+// See media_ack.h
+
+#include "media_ack.h"
+
+#include <chrono>
+
+MediaAckWindow::MediaAckWindow(uint32_t window, AckSender sender)
+    : window_(window), sender_(std::move(sender)), session_(0),
+      inFlight_(0), inFlightMax_(0), received_(0), acked_(0), ackErrors_(0),
+      ackDelayTotalUs_(0), ackDelayMaxUs_(0) {}
+
+uint64_t MediaAckWindow::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void MediaAckWindow::start(int32_t session) {
+    session_.store(session, std::memory_order_relaxed);
+}
+
+void MediaAckWindow::detach() {
+    std::lock_guard<std::mutex> lock(senderMutex_);
+    sender_ = nullptr;
+}
+
+uint64_t MediaAckWindow::received() {
+    received_.fetch_add(1, std::memory_order_relaxed);
+    uint32_t inFlight = inFlight_.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint32_t peak = inFlightMax_.load(std::memory_order_relaxed);
+    while (inFlight > peak && !inFlightMax_.compare_exchange_weak(peak, inFlight, std::memory_order_relaxed)) {
+    }
+    return nowNs();
+}
+
+void MediaAckWindow::consumed(uint64_t receivedNs) {
+    std::lock_guard<std::mutex> lock(senderMutex_);
+    if (!sender_) {
+        inFlight_.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+    sender_(shared_from_this(), session_.load(std::memory_order_relaxed), receivedNs);
+}
+
+void MediaAckWindow::acked(uint64_t receivedNs) {
+    inFlight_.fetch_sub(1, std::memory_order_relaxed);
+    acked_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t now = nowNs();
+    uint32_t delayUs = static_cast<uint32_t>(now > receivedNs ? (now - receivedNs) / 1000 : 0);
+    ackDelayTotalUs_.fetch_add(delayUs, std::memory_order_relaxed);
+    uint32_t peak = ackDelayMaxUs_.load(std::memory_order_relaxed);
+    while (delayUs > peak && !ackDelayMaxUs_.compare_exchange_weak(peak, delayUs, std::memory_order_relaxed)) {
+    }
+}
+
+void MediaAckWindow::ackFailed() {
+    inFlight_.fetch_sub(1, std::memory_order_relaxed);
+    ackErrors_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MediaAckWindow::snapshot(AASDKMediaAckStats* stats) const {
+    stats->window = window_;
+    stats->in_flight = inFlight_.load(std::memory_order_relaxed);
+    stats->in_flight_max = inFlightMax_.load(std::memory_order_relaxed);
+    stats->received = received_.load(std::memory_order_relaxed);
+    stats->acked = acked_.load(std::memory_order_relaxed);
+    stats->ack_errors = ackErrors_.load(std::memory_order_relaxed);
+    stats->ack_delay_us_avg = stats->acked == 0 ? 0 :
+        static_cast<uint32_t>(ackDelayTotalUs_.load(std::memory_order_relaxed) / stats->acked);
+    stats->ack_delay_us_max = ackDelayMaxUs_.load(std::memory_order_relaxed);
+}
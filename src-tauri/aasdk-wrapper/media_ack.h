@@ -0,0 +1,72 @@
+// Android Auto media flow control
+// The phone keeps at most max_unacked media messages in flight per audio/video channel
+// and waits for AVMediaAckIndication before sending more. MediaAckWindow tracks what has
+// been received and acknowledges each message once it has been consumed, so the window
+// size trades phone-side buffering (throughput) against end-to-end latency.
+
+#ifndef MEDIA_ACK_H
+#define MEDIA_ACK_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "aasdk_c.h"
+#include "frame_pool.h"
+
+class MediaAckWindow : public FramePool::ReleaseListener,
+                       public std::enable_shared_from_this<MediaAckWindow> {
+public:
+    // Writes one ack for session and reports back through acked()/ackFailed() with
+    // receivedNs. Called from whichever thread consumed the message.
+    typedef std::function<void(std::shared_ptr<MediaAckWindow> window, int32_t session, uint64_t receivedNs)> AckSender;
+
+    MediaAckWindow(uint32_t window, AckSender sender);
+
+    MediaAckWindow(const MediaAckWindow&) = delete;
+    MediaAckWindow& operator=(const MediaAckWindow&) = delete;
+
+    // Size to grant in AVChannelSetupResponse::max_unacked
+    uint32_t window() const { return window_; }
+
+    // Session id from AVChannelStartIndication, echoed in every ack
+    void start(int32_t session);
+
+    // Stop sending acks (connection torn down); late releases are ignored
+    void detach();
+
+    // A media message arrived; returns the token to hand to consumed()
+    uint64_t received();
+
+    // The message received at receivedNs has been consumed; sends its ack
+    void consumed(uint64_t receivedNs);
+
+    // Completion of an ack started by the sender
+    void acked(uint64_t receivedNs);
+    void ackFailed();
+
+    // Video frames are consumed when their last reference is released
+    void onFrameReleased(uint64_t cookie) override { consumed(cookie); }
+
+    void snapshot(AASDKMediaAckStats* stats) const;
+
+private:
+    static uint64_t nowNs();
+
+    const uint32_t window_;
+    std::mutex senderMutex_;
+    AckSender sender_;
+    std::atomic<int32_t> session_;
+
+    std::atomic<uint32_t> inFlight_;
+    std::atomic<uint32_t> inFlightMax_;
+    std::atomic<uint64_t> received_;
+    std::atomic<uint64_t> acked_;
+    std::atomic<uint64_t> ackErrors_;
+    std::atomic<uint64_t> ackDelayTotalUs_;
+    std::atomic<uint32_t> ackDelayMaxUs_;
+};
+
+#endif // MEDIA_ACK_H
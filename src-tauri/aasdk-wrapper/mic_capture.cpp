@@ -0,0 +1,117 @@
+// Microphone capture for the AV_INPUT channel
+// See mic_capture.h
+
+#include "mic_capture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+MicCapture::MicCapture(const AASDKAudioFormat& format, const AASDKMicConfig& config, PayloadSender sender)
+    : ring_(format.sample_rate / 1000 * config.ring_ms, format), periodMs_(config.period_ms),
+      periodFrames_(std::max<uint32_t>(format.sample_rate / 1000 * config.period_ms, 1)),
+      maxLatencyFrames_(std::max(format.sample_rate / 1000 * config.max_latency_ms, periodFrames_)),
+      sender_(std::move(sender)), payload_(static_cast<size_t>(periodFrames_) * format.channels),
+      open_(false), window_(0), inFlight_(0), opens_(0), captured_(0), trimmed_(0), sent_(0), acked_(0),
+      stalls_(0), latencyTotalUs_(0), latencyMaxUs_(0) {}
+
+uint64_t MicCapture::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint32_t MicCapture::write(const int16_t* samples, uint32_t frames, uint64_t captureNs) {
+    if (!open_.load(std::memory_order_acquire) || frames == 0) {
+        return 0;
+    }
+    if (captureNs == 0) {
+        uint64_t span = static_cast<uint64_t>(frames) * 1000000000 / std::max<uint32_t>(format().sample_rate, 1);
+        captureNs = nowNs() - span;
+    }
+
+    // The ring keeps the capture time per write and interpolates it for any frame
+    AASDKMediaInfo info = {};
+    info.channel = -1;
+    info.flags = AASDK_MEDIA_INFO_HAS_TIMESTAMP;
+    info.timestamp = captureNs / 1000;
+    info.receive_ns = captureNs;
+    uint32_t written = ring_.write(samples, frames, info);
+    captured_.fetch_add(written, std::memory_order_relaxed);
+    return written;
+}
+
+void MicCapture::open(uint32_t maxUnacked) {
+    // Whatever is left from the last time the phone listened is stale
+    ring_.discard(ring_.buffered());
+    window_.store(maxUnacked, std::memory_order_relaxed);
+    inFlight_.store(0, std::memory_order_relaxed);
+    opens_.fetch_add(1, std::memory_order_relaxed);
+    open_.store(true, std::memory_order_release);
+}
+
+bool MicCapture::close() {
+    return open_.exchange(false, std::memory_order_acq_rel);
+}
+
+uint32_t MicCapture::pump() {
+    uint32_t sent = 0;
+    while (open_.load(std::memory_order_acquire)) {
+        uint32_t depth = ring_.buffered();
+        if (depth > maxLatencyFrames_) {
+            // Behind by more than the bound: keep only the newest audio
+            uint32_t skipped = ring_.discard(depth - maxLatencyFrames_);
+            trimmed_.fetch_add(skipped, std::memory_order_relaxed);
+            depth -= skipped;
+        }
+        if (depth < periodFrames_) {
+            break;
+        }
+        uint32_t window = window_.load(std::memory_order_relaxed);
+        if (window != 0 && inFlight_.load(std::memory_order_relaxed) >= window) {
+            stalls_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+
+        AASDKAudioReadInfo info;
+        ring_.read(payload_.data(), periodFrames_, &info);
+        if (!sender_(info.timestamp, payload_.data(), periodFrames_)) {
+            trimmed_.fetch_add(periodFrames_, std::memory_order_relaxed);
+            break;
+        }
+        inFlight_.fetch_add(1, std::memory_order_relaxed);
+        sent_.fetch_add(1, std::memory_order_relaxed);
+        ++sent;
+
+        uint64_t nowUs = nowNs() / 1000;
+        uint64_t latencyUs = nowUs > info.timestamp ? nowUs - info.timestamp : 0;
+        latencyTotalUs_.fetch_add(latencyUs, std::memory_order_relaxed);
+        uint32_t clamped = static_cast<uint32_t>(std::min<uint64_t>(latencyUs, std::numeric_limits<uint32_t>::max()));
+        if (clamped > latencyMaxUs_.load(std::memory_order_relaxed)) {
+            latencyMaxUs_.store(clamped, std::memory_order_relaxed);
+        }
+    }
+    return sent;
+}
+
+void MicCapture::acked(uint32_t count) {
+    uint32_t inFlight = inFlight_.load(std::memory_order_relaxed);
+    inFlight_.store(inFlight > count ? inFlight - count : 0, std::memory_order_relaxed);
+    acked_.fetch_add(count, std::memory_order_relaxed);
+}
+
+void MicCapture::stats(AASDKMicStats* stats) const {
+    AASDKAudioRingStats ring = {};
+    ring_.stats(&ring);
+
+    stats->open = isOpen();
+    stats->max_unacked = window_.load(std::memory_order_relaxed);
+    stats->opens = opens_.load(std::memory_order_relaxed);
+    stats->captured_frames = captured_.load(std::memory_order_relaxed);
+    stats->dropped_frames = ring.overrun_frames + trimmed_.load(std::memory_order_relaxed);
+    stats->payloads_sent = sent_.load(std::memory_order_relaxed);
+    stats->payloads_acked = acked_.load(std::memory_order_relaxed);
+    stats->window_stalls = stalls_.load(std::memory_order_relaxed);
+    stats->latency_us_avg = stats->payloads_sent
+        ? static_cast<uint32_t>(latencyTotalUs_.load(std::memory_order_relaxed) / stats->payloads_sent) : 0;
+    stats->latency_us_max = latencyMaxUs_.load(std::memory_order_relaxed);
+}
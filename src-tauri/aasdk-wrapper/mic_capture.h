@@ -0,0 +1,78 @@
+// Microphone capture for the AV_INPUT channel
+// The capture device (or a WavSource) writes PCM into a lock-free ring from its own
+// thread; the channel strand pumps it out in fixed payloads, each stamped with the
+// capture time of its first frame. Nothing is accepted while the phone has the
+// microphone closed, so an open starts from fresh audio. The phone grants a window of
+// unacked payloads in AVInputOpenRequest; while it is full the audio waits in the ring,
+// and once more than max_latency_ms is waiting the oldest is dropped, so a stalled phone
+// costs words rather than a growing delay on every later one.
+
+#ifndef MIC_CAPTURE_H
+#define MIC_CAPTURE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "aasdk_c.h"
+#include "pcm_ring.h"
+
+class MicCapture {
+public:
+    // Writes one payload to the channel; timestampUs is the CLOCK_MONOTONIC capture time
+    // of its first frame. Returns false if it could not be queued, which leaves the
+    // window as it was.
+    typedef std::function<bool(uint64_t timestampUs, const int16_t* samples, uint32_t frames)> PayloadSender;
+
+    MicCapture(const AASDKAudioFormat& format, const AASDKMicConfig& config, PayloadSender sender);
+
+    MicCapture(const MicCapture&) = delete;
+    MicCapture& operator=(const MicCapture&) = delete;
+
+    // Producer side (capture thread). captureNs 0 = the frames end now. Returns the
+    // frames accepted.
+    uint32_t write(const int16_t* samples, uint32_t frames, uint64_t captureNs);
+
+    // Sender side (the channel strand)
+    // The phone opened the microphone with this window (0 = no limit); drops stale audio
+    void open(uint32_t maxUnacked);
+    // Returns false if it was not open
+    bool close();
+    // Send every whole payload the window allows; returns the payloads sent
+    uint32_t pump();
+    // The phone acknowledged count payloads
+    void acked(uint32_t count);
+
+    // Any thread
+    const AASDKAudioFormat& format() const { return ring_.format(); }
+    uint32_t periodFrames() const { return periodFrames_; }
+    uint32_t periodMs() const { return periodMs_; }
+    bool isOpen() const { return open_.load(std::memory_order_acquire); }
+    void stats(AASDKMicStats* stats) const;
+
+private:
+    static uint64_t nowNs();
+
+    PcmRing ring_;
+    const uint32_t periodMs_;
+    const uint32_t periodFrames_;
+    const uint32_t maxLatencyFrames_;
+    PayloadSender sender_;
+    std::vector<int16_t> payload_;  // One period, reused for every send
+
+    std::atomic<bool> open_;
+    std::atomic<uint32_t> window_;
+    std::atomic<uint32_t> inFlight_;
+
+    std::atomic<uint64_t> opens_;
+    std::atomic<uint64_t> captured_;
+    std::atomic<uint64_t> trimmed_;     // Dropped for latency; ring overruns are counted by the ring
+    std::atomic<uint64_t> sent_;
+    std::atomic<uint64_t> acked_;
+    std::atomic<uint64_t> stalls_;
+    std::atomic<uint64_t> latencyTotalUs_;
+    std::atomic<uint32_t> latencyMaxUs_;
+};
+
+#endif // MIC_CAPTURE_H
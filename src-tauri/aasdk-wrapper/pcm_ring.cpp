@@ -0,0 +1,139 @@
+// Lock-free PCM ring
+// See pcm_ring.h
+
+#include "pcm_ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+constexpr uint32_t PcmRing::SEGMENTS;
+
+namespace {
+uint32_t roundUpPow2(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value && result < (1u << 31)) {
+        result <<= 1;
+    }
+    return result;
+}
+}
+
+PcmRing::PcmRing(uint32_t capacityFrames, const AASDKAudioFormat& format)
+    : format_(format), capacity_(roundUpPow2(std::max<uint32_t>(capacityFrames, 1))),
+      samples_(new int16_t[static_cast<size_t>(capacity_) * std::max<uint32_t>(format.channels, 1)]()),
+      segments_(new Segment[SEGMENTS]()), writeFrame_(0), readFrame_(0), segmentTail_(0), segmentHead_(0),
+      written_(0), overrunFrames_(0) {}
+
+uint32_t PcmRing::write(const int16_t* samples, uint32_t frames, const AASDKMediaInfo& info) {
+    if (frames == 0) {
+        return 0;
+    }
+    uint64_t write = writeFrame_.load(std::memory_order_relaxed);
+    uint64_t read = readFrame_.load(std::memory_order_acquire);
+    uint64_t tail = segmentTail_.load(std::memory_order_relaxed);
+    uint64_t head = segmentHead_.load(std::memory_order_acquire);
+
+    uint32_t fit = std::min<uint32_t>(frames, capacity_ - static_cast<uint32_t>(write - read));
+    if (fit == 0 || tail - head >= SEGMENTS) {
+        overrunFrames_.fetch_add(frames, std::memory_order_relaxed);
+        return 0;
+    }
+
+    // Copy in at most two pieces around the end of the storage
+    const uint32_t channels = format_.channels;
+    uint32_t offset = static_cast<uint32_t>(write & (capacity_ - 1));
+    uint32_t first = std::min(fit, capacity_ - offset);
+    std::memcpy(&samples_[static_cast<size_t>(offset) * channels], samples,
+                static_cast<size_t>(first) * channels * sizeof(int16_t));
+    if (fit > first) {
+        std::memcpy(&samples_[0], samples + static_cast<size_t>(first) * channels,
+                    static_cast<size_t>(fit - first) * channels * sizeof(int16_t));
+    }
+
+    Segment& segment = segments_[tail % SEGMENTS];
+    segment.startFrame = write;
+    segment.timestamp = info.timestamp;
+    segment.receiveNs = info.receive_ns;
+    segment.flags = info.flags;
+    segmentTail_.store(tail + 1, std::memory_order_release);
+    writeFrame_.store(write + fit, std::memory_order_release);
+
+    written_.fetch_add(fit, std::memory_order_relaxed);
+    if (fit < frames) {
+        overrunFrames_.fetch_add(frames - fit, std::memory_order_relaxed);
+    }
+    return fit;
+}
+
+uint32_t PcmRing::read(int16_t* out, uint32_t frames, AASDKAudioReadInfo* info) {
+    uint64_t read = readFrame_.load(std::memory_order_relaxed);
+    uint64_t write = writeFrame_.load(std::memory_order_acquire);
+    uint64_t tail = segmentTail_.load(std::memory_order_acquire);
+    uint64_t head = segmentHead_.load(std::memory_order_relaxed);
+    uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(frames, write - read));
+
+    // Move to the segment holding the first frame returned
+    head = headFor(read, head, tail);
+    if (info) {
+        *info = AASDKAudioReadInfo();
+        if (count > 0 && head < tail) {
+            const Segment& segment = segments_[head % SEGMENTS];
+            info->flags = segment.flags;
+            info->receive_ns = segment.receiveNs;
+            if (segment.flags & AASDK_MEDIA_INFO_HAS_TIMESTAMP) {
+                uint64_t offset = read - segment.startFrame;
+                info->timestamp = segment.timestamp + offset * 1000000 / std::max<uint32_t>(format_.sample_rate, 1);
+            }
+        }
+    }
+
+    const uint32_t channels = format_.channels;
+    uint32_t offset = static_cast<uint32_t>(read & (capacity_ - 1));
+    uint32_t first = std::min(count, capacity_ - offset);
+    std::memcpy(out, &samples_[static_cast<size_t>(offset) * channels],
+                static_cast<size_t>(first) * channels * sizeof(int16_t));
+    if (count > first) {
+        std::memcpy(out + static_cast<size_t>(first) * channels, &samples_[0],
+                    static_cast<size_t>(count - first) * channels * sizeof(int16_t));
+    }
+
+    read += count;
+    segmentHead_.store(headFor(read, head, tail), std::memory_order_release);
+    readFrame_.store(read, std::memory_order_release);
+    if (info) {
+        info->available = static_cast<uint32_t>(write - read);
+    }
+    return count;
+}
+
+uint32_t PcmRing::discard(uint32_t frames) {
+    uint64_t read = readFrame_.load(std::memory_order_relaxed);
+    uint64_t write = writeFrame_.load(std::memory_order_acquire);
+    uint64_t tail = segmentTail_.load(std::memory_order_acquire);
+    uint64_t head = segmentHead_.load(std::memory_order_relaxed);
+    uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(frames, write - read));
+
+    read += count;
+    segmentHead_.store(headFor(read, head, tail), std::memory_order_release);
+    readFrame_.store(read, std::memory_order_release);
+    return count;
+}
+
+uint64_t PcmRing::headFor(uint64_t frame, uint64_t head, uint64_t tail) const {
+    while (tail - head > 1 && segments_[(head + 1) % SEGMENTS].startFrame <= frame) {
+        ++head;
+    }
+    return head;
+}
+
+uint32_t PcmRing::buffered() const {
+    return static_cast<uint32_t>(writeFrame_.load(std::memory_order_acquire) -
+                                 readFrame_.load(std::memory_order_acquire));
+}
+
+void PcmRing::stats(AASDKAudioRingStats* stats) const {
+    stats->capacity_frames = capacity_;
+    stats->buffered_frames = buffered();
+    stats->written_frames = written_.load(std::memory_order_relaxed);
+    stats->overrun_frames = overrunFrames_.load(std::memory_order_relaxed);
+}
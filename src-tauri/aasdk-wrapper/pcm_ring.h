@@ -0,0 +1,73 @@
+// Lock-free single-producer/single-consumer PCM ring for one audio stream
+// The stream's channel strand writes whole payloads and the audio device callback reads
+// as many frames as it needs, so neither side ever locks or allocates: storage is
+// allocated once, up front. The reader owns the read position, so a full ring drops the
+// incoming frames that do not fit rather than older audio. Each payload's phone
+// timestamp is kept in a small side ring, letting a read report the media time of the
+// first frame it returns.
+
+#ifndef PCM_RING_H
+#define PCM_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "aasdk_c.h"
+
+class PcmRing {
+public:
+    // capacityFrames is rounded up to a power of two
+    PcmRing(uint32_t capacityFrames, const AASDKAudioFormat& format);
+
+    PcmRing(const PcmRing&) = delete;
+    PcmRing& operator=(const PcmRing&) = delete;
+
+    // Producer side. Append frames interleaved frames of the ring's format; returns how
+    // many fit.
+    uint32_t write(const int16_t* samples, uint32_t frames, const AASDKMediaInfo& info);
+
+    // Consumer side. Copy up to frames interleaved frames into out; returns how many were
+    // available. Never blocks. info (optional) describes the first frame returned.
+    uint32_t read(int16_t* out, uint32_t frames, AASDKAudioReadInfo* info);
+
+    // Consumer side. Skip up to frames frames unread; returns how many were skipped.
+    uint32_t discard(uint32_t frames);
+
+    const AASDKAudioFormat& format() const { return format_; }
+    uint32_t capacity() const { return capacity_; }
+    uint32_t buffered() const;
+
+    // Fills the ring's own counters; the jitter buffer above it fills the rest
+    void stats(AASDKAudioRingStats* stats) const;
+
+private:
+    // Where a payload starts in the ring and when the phone said it plays
+    struct Segment {
+        uint64_t startFrame;
+        uint64_t timestamp;
+        uint64_t receiveNs;
+        uint32_t flags;
+    };
+
+    // Payloads that can be buffered at once; more than a full ring of small payloads
+    static constexpr uint32_t SEGMENTS = 256;
+
+    // Consumer: first segment still needed once reading resumes at frame
+    uint64_t headFor(uint64_t frame, uint64_t head, uint64_t tail) const;
+
+    const AASDKAudioFormat format_;
+    const uint32_t capacity_;       // Frames, power of two
+    std::unique_ptr<int16_t[]> samples_;
+    std::unique_ptr<Segment[]> segments_;
+
+    std::atomic<uint64_t> writeFrame_;      // Advanced by the producer
+    std::atomic<uint64_t> readFrame_;       // Advanced by the consumer
+    std::atomic<uint64_t> segmentTail_;     // Next segment to fill, producer
+    std::atomic<uint64_t> segmentHead_;     // Oldest segment still needed, consumer
+
+    std::atomic<uint64_t> written_;
+    std::atomic<uint64_t> overrunFrames_;
+};
+
+#endif // PCM_RING_H
@@ -0,0 +1,339 @@
+// Fixed-ratio polyphase resampler
+// See resampler.h
+
+#include "resampler.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define RESAMPLER_NEON 1
+#endif
+
+namespace {
+
+// Compile-time filter design. std::sin is not constexpr, so the few sines needed to
+// start each recurrence come from a Taylor series; the rest follow from
+// sin((n + 1)d) = 2 cos(d) sin(nd) - sin((n - 1)d), which keeps a bank of ten thousand
+// taps cheap for the compiler.
+
+constexpr double PI = 3.14159265358979323846;
+
+constexpr double sine(double x) {
+    double turns = x / (2 * PI);
+    long long whole = static_cast<long long>(turns < 0 ? turns - 0.5 : turns + 0.5);
+    x -= static_cast<double>(whole) * 2 * PI;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 30; ++n) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cosine(double x) {
+    return sine(x + PI / 2);
+}
+
+constexpr long long roundToInt(double x) {
+    return static_cast<long long>(x < 0 ? x - 0.5 : x + 0.5);
+}
+
+template <uint32_t PHASES, uint32_t TAPS>
+struct FilterBank {
+    int16_t taps[PHASES][TAPS];     // Per phase, oldest input frame's tap first
+    uint32_t shift;                 // Fraction bits
+    bool fits;                      // Taps fit int16 and no dot product can overflow int32
+};
+
+// Windowed-sinc interpolator for upsampling by PHASES, cut off at cutoff times the
+// input Nyquist frequency, split into its polyphase components. The Blackman-Harris
+// window keeps sidelobes below -92 dB. Each phase is scaled to exactly unity DC gain
+// after rounding, the rounding error going to its largest tap.
+template <uint32_t PHASES, uint32_t TAPS>
+constexpr FilterBank<PHASES, TAPS> design(double cutoff, uint32_t shift) {
+    static_assert(TAPS % 8 == 0, "Taps per phase must fill whole SIMD vectors");
+    static_assert((PHASES * TAPS) % 2 == 0, "Even length keeps the sinc's center between taps");
+    constexpr uint32_t N = PHASES * TAPS;
+    double h[N] = {};
+
+    const double center = (N - 1) / 2.0;
+    const double delta = PI * cutoff / PHASES;
+    const double twoCosDelta = 2 * cosine(delta);
+    double sinPrev = sine(-delta * (center + 1));
+    double sinCur = sine(-delta * center);
+    const double phi = 2 * PI / (N - 1);
+    const double twoCosPhi = 2 * cosine(phi);
+    double cosPrev = cosine(phi);
+    double cosCur = 1.0;
+    for (uint32_t n = 0; n < N; ++n) {
+        // sin(pi cutoff t) / (pi t), t in input frames; the overall scale drops out below
+        double t = (n - center) / PHASES;
+        double c = cosCur;
+        double window = 0.35875 - 0.48829 * c + 0.14128 * (2 * c * c - 1) - 0.01168 * (4 * c * c * c - 3 * c);
+        h[n] = sinCur / (PI * t) * window;
+
+        double sinNext = twoCosDelta * sinCur - sinPrev;
+        sinPrev = sinCur;
+        sinCur = sinNext;
+        double cosNext = twoCosPhi * cosCur - cosPrev;
+        cosPrev = cosCur;
+        cosCur = cosNext;
+    }
+
+    FilterBank<PHASES, TAPS> bank = {};
+    bank.shift = shift;
+    bank.fits = true;
+    const long long unity = 1LL << shift;
+    for (uint32_t p = 0; p < PHASES; ++p) {
+        double gain = 0;
+        for (uint32_t k = 0; k < TAPS; ++k) {
+            gain += h[p + k * PHASES];
+        }
+        long long q[TAPS] = {};
+        long long sum = 0;
+        uint32_t peak = 0;
+        for (uint32_t k = 0; k < TAPS; ++k) {
+            // Tap k applies to the input frame k back from the newest
+            q[TAPS - 1 - k] = roundToInt(h[p + k * PHASES] / gain * unity);
+            sum += q[TAPS - 1 - k];
+        }
+        for (uint32_t k = 0; k < TAPS; ++k) {
+            if ((q[k] < 0 ? -q[k] : q[k]) > (q[peak] < 0 ? -q[peak] : q[peak])) {
+                peak = k;
+            }
+        }
+        q[peak] += unity - sum;
+
+        // Full-scale input times the sum of |taps| must stay below 2^31
+        long long l1 = 0;
+        for (uint32_t k = 0; k < TAPS; ++k) {
+            bank.fits = bank.fits && q[k] >= -32767 && q[k] <= 32767;
+            bank.taps[p][k] = static_cast<int16_t>(q[k]);
+            l1 += q[k] < 0 ? -q[k] : q[k];
+        }
+        bank.fits = bank.fits && l1 < 65536;
+    }
+    return bank;
+}
+
+// 16 kHz speech and system audio to 48 kHz: flat to about 6 kHz, images of the 7-8 kHz
+// band fall in the transition
+constexpr FilterBank<3, 48> BANK_16K_48K = design<3, 48>(0.9, 14);
+static_assert(BANK_16K_48K.fits, "16k->48k filter bank overflows its fixed point");
+
+// 44.1 kHz to 48 kHz (x160/147): flat to about 18 kHz
+constexpr FilterBank<160, 64> BANK_44K_48K = design<160, 64>(0.95, 14);
+static_assert(BANK_44K_48K.fits, "44.1k->48k filter bank overflows its fixed point");
+
+struct Conversion {
+    uint32_t inRate;
+    uint32_t outRate;
+    uint32_t phases;
+    uint32_t step;
+    uint32_t taps;
+    uint32_t shift;
+    const int16_t* bank;
+};
+
+const Conversion CONVERSIONS[] = {
+    {16000, 48000, 3, 1, 48, BANK_16K_48K.shift, &BANK_16K_48K.taps[0][0]},
+    {44100, 48000, 160, 147, 64, BANK_44K_48K.shift, &BANK_44K_48K.taps[0][0]},
+};
+
+const Conversion* findConversion(uint32_t inRate, uint32_t outRate) {
+    for (const auto& conversion : CONVERSIONS) {
+        if (conversion.inRate == inRate && conversion.outRate == outRate) {
+            return &conversion;
+        }
+    }
+    return nullptr;
+}
+
+// taps is a multiple of 8 for every kernel. Sums of any subset of products are bounded
+// by the bank's L1 check, so every summation order gives the same result.
+int32_t dotScalar(const int16_t* x, const int16_t* h, uint32_t taps) {
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < taps; ++i) {
+        acc += static_cast<int32_t>(x[i]) * h[i];
+    }
+    return acc;
+}
+
+#if defined(__SSE2__)
+
+int32_t dotSse2(const int16_t* x, const int16_t* h, uint32_t taps) {
+    __m128i acc = _mm_setzero_si128();
+    for (uint32_t i = 0; i < taps; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a, b));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+}
+
+#endif // __SSE2__
+
+#if defined(RESAMPLER_NEON)
+
+int32_t dotNeon(const int16_t* x, const int16_t* h, uint32_t taps) {
+    int32x4_t acc = vdupq_n_s32(0);
+    for (uint32_t i = 0; i < taps; i += 8) {
+        int16x8_t a = vld1q_s16(x + i);
+        int16x8_t b = vld1q_s16(h + i);
+        acc = vmlal_s16(acc, vget_low_s16(a), vget_low_s16(b));
+        acc = vmlal_s16(acc, vget_high_s16(a), vget_high_s16(b));
+    }
+    int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    sum = vpadd_s32(sum, sum);
+    return vget_lane_s32(sum, 0);
+}
+
+#endif // RESAMPLER_NEON
+
+} // namespace
+
+Resampler::Isa Resampler::detectIsa() {
+#if defined(RESAMPLER_NEON)
+    return Isa::NEON;
+#elif defined(__SSE2__)
+    return Isa::SSE2;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+const char* Resampler::isaName(Isa isa) {
+    switch (isa) {
+    case Isa::SCALAR: return "scalar";
+    case Isa::SSE2: return "sse2";
+    case Isa::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+bool Resampler::supports(uint32_t inRate, uint32_t outRate) {
+    return findConversion(inRate, outRate) != nullptr;
+}
+
+Resampler::Resampler()
+    : bank_(nullptr), phases_(1), step_(1), taps_(0), shift_(0), inChannels_(1), outChannels_(1), planes_(1),
+      maxInput_(0), isa_(Isa::SCALAR), dot_(&dotScalar), phase_(0), ahead_(1) {}
+
+std::unique_ptr<Resampler> Resampler::create(uint32_t inRate, uint32_t outRate, uint32_t inChannels,
+                                             uint32_t outChannels, uint32_t maxOutputFrames, Isa isa) {
+    const Conversion* conversion = findConversion(inRate, outRate);
+    if (!conversion || inChannels < 1 || inChannels > 2 || outChannels < 1 || outChannels > 2 ||
+        maxOutputFrames == 0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Resampler> resampler(new Resampler());
+    resampler->bank_ = conversion->bank;
+    resampler->phases_ = conversion->phases;
+    resampler->step_ = conversion->step;
+    resampler->taps_ = conversion->taps;
+    resampler->shift_ = conversion->shift;
+    resampler->inChannels_ = inChannels;
+    resampler->outChannels_ = outChannels;
+    resampler->planes_ = std::min(inChannels, outChannels);
+
+    // The next output frame never needs more than ceil(M/L) new frames, and each
+    // further one advances by M/L
+    const uint32_t phases = conversion->phases;
+    const uint32_t step = conversion->step;
+    resampler->maxInput_ = (step + phases - 1) / phases +
+                           static_cast<uint32_t>((phases - 1 + static_cast<uint64_t>(maxOutputFrames - 1) * step) / phases);
+    for (uint32_t plane = 0; plane < resampler->planes_; ++plane) {
+        resampler->history_[plane].assign(resampler->taps_ + resampler->maxInput_, 0);
+    }
+
+    switch (isa) {
+#if defined(__SSE2__)
+    case Isa::SSE2:
+        resampler->isa_ = isa;
+        resampler->dot_ = &dotSse2;
+        break;
+#endif
+#if defined(RESAMPLER_NEON)
+    case Isa::NEON:
+        resampler->isa_ = isa;
+        resampler->dot_ = &dotNeon;
+        break;
+#endif
+    default:
+        break;
+    }
+    return resampler;
+}
+
+uint32_t Resampler::inputFor(uint32_t outputFrames) const {
+    if (outputFrames == 0) {
+        return 0;
+    }
+    return ahead_ + static_cast<uint32_t>((phase_ + static_cast<uint64_t>(outputFrames - 1) * step_) / phases_);
+}
+
+void Resampler::process(const int16_t* in, int16_t* out, uint32_t outputFrames) {
+    const uint32_t needed = inputFor(outputFrames);
+
+    // Append the new frames after the history, one plane per filtered channel
+    int16_t* first = &history_[0][taps_];
+    if (planes_ == 2) {
+        int16_t* second = &history_[1][taps_];
+        for (uint32_t frame = 0; frame < needed; ++frame) {
+            first[frame] = in[frame * 2];
+            second[frame] = in[frame * 2 + 1];
+        }
+    } else if (inChannels_ == 2) {
+        for (uint32_t frame = 0; frame < needed; ++frame) {
+            first[frame] = static_cast<int16_t>((in[frame * 2] + in[frame * 2 + 1]) >> 1);
+        }
+    } else {
+        std::memcpy(first, in, static_cast<size_t>(needed) * sizeof(int16_t));
+    }
+
+    // Output frame k filters the taps_ frames ending ahead_ + floor((phase_ + kM) / L)
+    // past the history
+    const int32_t round = 1 << (shift_ - 1);
+    uint32_t phase = phase_;
+    uint32_t start = ahead_;
+    for (uint32_t frame = 0; frame < outputFrames; ++frame) {
+        const int16_t* h = bank_ + static_cast<size_t>(phase) * taps_;
+        int16_t* o = out + static_cast<size_t>(frame) * outChannels_;
+        for (uint32_t plane = 0; plane < planes_; ++plane) {
+            int32_t value = (dot_(&history_[plane][start], h, taps_) + round) >> shift_;
+            o[plane] = static_cast<int16_t>(std::min(std::max(value, -32768), 32767));
+        }
+        if (planes_ < outChannels_) {
+            o[1] = o[0];
+        }
+        phase += step_;
+        while (phase >= phases_) {
+            phase -= phases_;
+            ++start;
+        }
+    }
+
+    phase_ = phase;
+    ahead_ = start - needed;
+    for (uint32_t plane = 0; plane < planes_; ++plane) {
+        std::memmove(history_[plane].data(), history_[plane].data() + needed, taps_ * sizeof(int16_t));
+    }
+}
+
+void Resampler::reset() {
+    for (uint32_t plane = 0; plane < planes_; ++plane) {
+        std::fill(history_[plane].begin(), history_[plane].end(), 0);
+    }
+    phase_ = 0;
+    ahead_ = 1;
+}
@@ -0,0 +1,77 @@
+// Fixed-ratio polyphase resampler
+// Converts one interleaved int16 stream to a higher rate by an exact ratio L/M: every
+// output frame is one phase of a windowed-sinc filter (L phases, TAPS each) applied to
+// the last TAPS input frames. The filter banks are designed at compile time, one per
+// supported ratio, with each phase normalized to unity gain so the phases do not beat
+// against each other. The dot product has SSE2 and NEON kernels that are bit-identical
+// to the scalar one. Channel mapping is fused in: mono input is filtered once and
+// written to both output channels, and stereo to mono is downmixed before filtering.
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Resampler {
+public:
+    enum class Isa {
+        SCALAR,
+        SSE2,
+        NEON
+    };
+
+    // Best kernel set supported by this build and CPU
+    static Isa detectIsa();
+    static const char* isaName(Isa isa);
+
+    // True if there is a filter bank for inRate to outRate
+    static bool supports(uint32_t inRate, uint32_t outRate);
+
+    // Resampler for up to maxOutputFrames output frames per process() call. Returns
+    // nullptr if the ratio is not supported or a channel count is not 1 or 2. Falls back
+    // to the scalar kernel if isa is not available.
+    static std::unique_ptr<Resampler> create(uint32_t inRate, uint32_t outRate, uint32_t inChannels,
+                                             uint32_t outChannels, uint32_t maxOutputFrames, Isa isa = detectIsa());
+
+    Resampler(const Resampler&) = delete;
+    Resampler& operator=(const Resampler&) = delete;
+
+    Isa isa() const { return isa_; }
+    uint32_t taps() const { return taps_; }
+    uint32_t maxInput() const { return maxInput_; }
+
+    // Input frames the next process(outputFrames) consumes
+    uint32_t inputFor(uint32_t outputFrames) const;
+
+    // Consume exactly inputFor(outputFrames) interleaved frames from in and write
+    // outputFrames interleaved frames to out. Never allocates.
+    void process(const int16_t* in, int16_t* out, uint32_t outputFrames);
+
+    // Forget the filter history, as if the stream started over
+    void reset();
+
+private:
+    typedef int32_t (*DotKernel)(const int16_t* x, const int16_t* h, uint32_t taps);
+
+    Resampler();
+
+    const int16_t* bank_;           // phases_ x taps_, each phase's taps in input order
+    uint32_t phases_;               // L
+    uint32_t step_;                 // M
+    uint32_t taps_;
+    uint32_t shift_;                // Fixed-point fraction bits of the taps
+    uint32_t inChannels_;
+    uint32_t outChannels_;
+    uint32_t planes_;               // Channels actually filtered
+    uint32_t maxInput_;
+    Isa isa_;
+    DotKernel dot_;
+
+    std::vector<int16_t> history_[2];   // Per plane: taps_ frames of history, then new input
+    uint32_t phase_;                // Filter phase of the next output frame
+    uint32_t ahead_;                // New input frames the next output frame needs
+};
+
+#endif // RESAMPLER_H
@@ -0,0 +1,320 @@
+// Protocol session capture
+// See session_capture.h
+
+#include "session_capture.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+constexpr uint32_t SessionCapture::QUEUE_DEPTH;
+constexpr uint64_t SessionCapture::DEFAULT_CAPACITY;
+
+namespace {
+// The writer naps this long when the queue is empty; producers never wake it, so the
+// io threads do no syscalls, and a few milliseconds of queueing is harmless
+constexpr auto WRITER_IDLE = std::chrono::milliseconds(2);
+}
+
+struct SessionCapture::Entry {
+    std::shared_ptr<const Payload> payload;
+    uint64_t hostNs;
+    size_t mediaTimestampOffset;
+    capture::Direction direction;
+    uint8_t channel;
+    uint8_t flags;
+};
+
+struct SessionCapture::Cell {
+    std::atomic<uint64_t> sequence;
+    Entry entry;
+};
+
+SessionCapture::SessionCapture()
+    : fd_(-1), base_(nullptr), mappedSize_(0), header_(nullptr), cells_(new Cell[QUEUE_DEPTH]),
+      enqueuePos_(0), dequeuePos_(0), running_(false), stopped_(false), full_(false),
+      records_(0), bytes_(0), dropped_(0) {
+    for (uint32_t i = 0; i < QUEUE_DEPTH; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+SessionCapture::~SessionCapture() {
+    stop();
+}
+
+uint64_t SessionCapture::monotonicNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+std::shared_ptr<SessionCapture> SessionCapture::open(const std::string& path, uint64_t capacity) {
+    if (capacity == 0) {
+        capacity = DEFAULT_CAPACITY;
+    }
+
+    std::shared_ptr<SessionCapture> session(new SessionCapture());
+    session->path_ = path;
+    session->mappedSize_ = sizeof(capture::CaptureFileHeader) + capacity;
+
+    session->fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (session->fd_ < 0) {
+        std::cerr << "Capture: cannot create " << path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    // Reserve the blocks now so the writer never hits ENOSPC through a page fault
+    int ret = posix_fallocate(session->fd_, 0, static_cast<off_t>(session->mappedSize_));
+    if (ret == EOPNOTSUPP || ret == EINVAL) {
+        // tmpfs and some FUSE filesystems can't preallocate; a sparse file still works
+        ret = ftruncate(session->fd_, static_cast<off_t>(session->mappedSize_)) == 0 ? 0 : errno;
+    }
+    if (ret != 0) {
+        std::cerr << "Capture: cannot preallocate " << session->mappedSize_ << " bytes for " << path
+                  << ": " << std::strerror(ret) << std::endl;
+        return nullptr;
+    }
+
+    void* base = mmap(nullptr, session->mappedSize_, PROT_READ | PROT_WRITE, MAP_SHARED, session->fd_, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "Capture: cannot map " << path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    session->base_ = static_cast<uint8_t*>(base);
+    madvise(session->base_, session->mappedSize_, MADV_SEQUENTIAL);
+
+    timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    auto* header = reinterpret_cast<capture::CaptureFileHeader*>(session->base_);
+    std::memset(header, 0, sizeof(*header));
+    std::memcpy(header->magic, capture::MAGIC, sizeof(header->magic));
+    header->version = capture::VERSION;
+    header->headerSize = sizeof(capture::CaptureFileHeader);
+    header->capacity = capacity;
+    header->startMonotonicNs = monotonicNs();
+    header->startRealtimeNs = static_cast<uint64_t>(realtime.tv_sec) * 1000000000ull + realtime.tv_nsec;
+    session->header_ = header;
+
+    session->running_ = true;
+    session->writer_ = std::thread(&SessionCapture::run, session.get());
+    std::cerr << "Capture: recording session to " << path << std::endl;
+    return session;
+}
+
+bool SessionCapture::record(capture::Direction direction, uint8_t channel, uint8_t flags,
+                            std::shared_ptr<const Payload> payload, size_t mediaTimestampOffset) {
+    if (stopped_.load(std::memory_order_relaxed) || !payload) {
+        return false;
+    }
+    uint64_t hostNs = monotonicNs();
+
+    uint64_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells_[pos % QUEUE_DEPTH];
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The writer is a full queue behind; losing a record beats stalling the io thread
+            drop();
+            return false;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->entry.payload = std::move(payload);
+    cell->entry.hostNs = hostNs;
+    cell->entry.mediaTimestampOffset = mediaTimestampOffset;
+    cell->entry.direction = direction;
+    cell->entry.channel = channel;
+    cell->entry.flags = flags;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool SessionCapture::pop(Entry& entry) {
+    Cell* cell = &cells_[dequeuePos_ % QUEUE_DEPTH];
+    if (cell->sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+        return false;
+    }
+    entry = std::move(cell->entry);
+    cell->entry.payload.reset();
+    cell->sequence.store(dequeuePos_ + QUEUE_DEPTH, std::memory_order_release);
+    ++dequeuePos_;
+    return true;
+}
+
+void SessionCapture::run() {
+    Entry entry;
+    for (;;) {
+        bool stopping = !running_.load(std::memory_order_acquire);
+        bool wrote = false;
+        while (pop(entry)) {
+            write(entry);
+            entry.payload.reset();
+            wrote = true;
+        }
+        if (stopping) {
+            break;
+        }
+        if (!wrote) {
+            std::this_thread::sleep_for(WRITER_IDLE);
+        }
+    }
+}
+
+void SessionCapture::write(const Entry& entry) {
+    const Payload& payload = *entry.payload;
+    uint32_t payloadSize = static_cast<uint32_t>(payload.size());
+    uint64_t committed = header_->committed;
+    uint64_t span = capture::recordSpan(payloadSize);
+
+    if (full_ || committed + span > header_->capacity) {
+        if (!full_) {
+            full_ = true;
+            std::cerr << "Capture: " << path_ << " is full, dropping further messages" << std::endl;
+        }
+        drop();
+        return;
+    }
+
+    capture::CaptureRecord record = {};
+    record.payloadSize = payloadSize;
+    record.direction = static_cast<uint8_t>(entry.direction);
+    record.channel = entry.channel;
+    record.flags = entry.flags;
+    record.messageId = payloadSize >= 2 ? static_cast<uint16_t>((payload[0] << 8) | payload[1]) : 0xffff;
+    record.hostNs = entry.hostNs;
+    if (entry.mediaTimestampOffset != 0 && payloadSize >= entry.mediaTimestampOffset + 8) {
+        for (size_t i = 0; i < 8; ++i) {
+            record.mediaTimestamp = (record.mediaTimestamp << 8) | payload[entry.mediaTimestampOffset + i];
+        }
+        record.flags |= capture::FLAG_MEDIA_TIMESTAMP;
+    }
+
+    // Padding is already zero: the file was preallocated and is only ever appended to
+    uint8_t* dst = base_ + header_->headerSize + committed;
+    std::memcpy(dst, &record, sizeof(record));
+    if (payloadSize != 0) {
+        std::memcpy(dst + sizeof(record), payload.data(), payloadSize);
+    }
+
+    header_->records += 1;
+    __atomic_store_n(&header_->committed, committed + span, __ATOMIC_RELEASE);
+    records_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(span, std::memory_order_relaxed);
+}
+
+void SessionCapture::drop() {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SessionCapture::stop() {
+    if (stopped_.exchange(true)) {
+        return;
+    }
+    running_.store(false, std::memory_order_release);
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+
+    if (base_) {
+        header_->dropped = dropped();
+        uint64_t fileSize = header_->headerSize + header_->committed;
+        msync(base_, mappedSize_, MS_SYNC);
+        munmap(base_, mappedSize_);
+        base_ = nullptr;
+        header_ = nullptr;
+        // Give back the preallocated tail
+        if (ftruncate(fd_, static_cast<off_t>(fileSize)) != 0) {
+            std::cerr << "Capture: cannot trim " << path_ << ": " << std::strerror(errno) << std::endl;
+        }
+        std::cerr << "Capture: wrote " << records() << " messages (" << fileSize << " bytes) to " << path_
+                  << ", dropped " << dropped() << std::endl;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+CaptureReader::CaptureReader()
+    : fd_(-1), base_(nullptr), size_(0), header_(nullptr), end_(0), offset_(0) {}
+
+CaptureReader::~CaptureReader() {
+    if (base_) {
+        munmap(base_, size_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+std::unique_ptr<CaptureReader> CaptureReader::open(const std::string& path) {
+    std::unique_ptr<CaptureReader> reader(new CaptureReader());
+    reader->fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (reader->fd_ < 0 || fstat(reader->fd_, &st) != 0) {
+        std::cerr << "Capture: cannot open " << path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    reader->size_ = static_cast<size_t>(st.st_size);
+    if (reader->size_ < sizeof(capture::CaptureFileHeader)) {
+        std::cerr << "Capture: " << path << " is too short to be a capture" << std::endl;
+        return nullptr;
+    }
+
+    void* base = mmap(nullptr, reader->size_, PROT_READ, MAP_SHARED, reader->fd_, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "Capture: cannot map " << path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    reader->base_ = static_cast<uint8_t*>(base);
+    madvise(reader->base_, reader->size_, MADV_SEQUENTIAL);
+
+    const auto* header = reinterpret_cast<const capture::CaptureFileHeader*>(reader->base_);
+    if (std::memcmp(header->magic, capture::MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != capture::VERSION || header->headerSize < sizeof(capture::CaptureFileHeader) ||
+        header->headerSize > reader->size_) {
+        std::cerr << "Capture: " << path << " is not a version " << capture::VERSION << " capture" << std::endl;
+        return nullptr;
+    }
+    reader->header_ = header;
+
+    // A file still being written may be followed by preallocated zeroes past committed
+    uint64_t committed = __atomic_load_n(&header->committed, __ATOMIC_ACQUIRE);
+    reader->end_ = std::min<uint64_t>(header->headerSize + committed, reader->size_);
+    reader->offset_ = header->headerSize;
+    return reader;
+}
+
+bool CaptureReader::next(const capture::CaptureRecord*& record, const uint8_t*& payload) {
+    if (offset_ + sizeof(capture::CaptureRecord) > end_) {
+        return false;
+    }
+    const auto* candidate = reinterpret_cast<const capture::CaptureRecord*>(base_ + offset_);
+    uint64_t span = capture::recordSpan(candidate->payloadSize);
+    if (offset_ + span > end_) {
+        return false;
+    }
+    record = candidate;
+    payload = base_ + offset_ + sizeof(capture::CaptureRecord);
+    offset_ += span;
+    return true;
+}
+
+void CaptureReader::rewind() {
+    offset_ = header_->headerSize;
+}
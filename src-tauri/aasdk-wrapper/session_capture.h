@@ -0,0 +1,167 @@
+// Protocol session capture
+// Records every decrypted message that passes the messenger, in both directions, to a
+// preallocated, memory-mapped, append-only file. The io threads only pay for a clock read
+// and a lock-free enqueue of a reference to the payload; a writer thread copies records
+// into the mapping and publishes them by advancing CaptureFileHeader::committed, so a
+// file cut short by a crash still ends on a whole record.
+//
+// File layout (little endian):
+//   CaptureFileHeader
+//   CaptureRecord + payload, padded to 8 bytes, repeated until header.committed
+
+#ifndef SESSION_CAPTURE_H
+#define SESSION_CAPTURE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace capture {
+
+constexpr char MAGIC[8] = {'A', 'A', 'S', 'D', 'K', 'C', 'A', 'P'};
+constexpr uint32_t VERSION = 1;
+
+enum class Direction : uint8_t {
+    INBOUND = 0,    // Phone to head unit, after decryption
+    OUTBOUND = 1    // Head unit to phone, before encryption
+};
+
+// CaptureRecord::flags
+constexpr uint8_t FLAG_ENCRYPTED = 0x01;       // Sent or received encrypted on the wire
+constexpr uint8_t FLAG_CONTROL = 0x02;         // Control-type message on a service channel
+constexpr uint8_t FLAG_MEDIA_TIMESTAMP = 0x04; // mediaTimestamp holds the phone timestamp
+
+struct CaptureFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;        // Offset of the first record
+    uint64_t capacity;          // Preallocated bytes for records
+    uint64_t committed;         // Bytes of complete records, advanced atomically
+    uint64_t records;
+    uint64_t dropped;           // Messages lost to a full queue or a full file
+    uint64_t startMonotonicNs;  // CLOCK_MONOTONIC at the start of the capture
+    uint64_t startRealtimeNs;   // CLOCK_REALTIME at the same instant
+};
+
+struct CaptureRecord {
+    uint32_t payloadSize;       // Bytes following this header, before padding
+    uint8_t direction;          // Direction
+    uint8_t channel;            // Android Auto channel id
+    uint8_t flags;              // FLAG_*
+    uint8_t reserved;
+    uint16_t messageId;         // First two payload bytes (big endian on the wire), 0xffff if missing
+    uint16_t reserved2;
+    uint32_t reserved3;
+    uint64_t hostNs;            // CLOCK_MONOTONIC when the message left or entered the messenger
+    uint64_t mediaTimestamp;    // Phone media timestamp (microseconds) for timestamped media
+};
+
+static_assert(sizeof(CaptureFileHeader) == 64, "capture header layout is part of the file format");
+static_assert(sizeof(CaptureRecord) == 32, "capture record layout is part of the file format");
+
+// Records are padded so every header in the file is 8-byte aligned
+inline uint64_t recordSpan(uint32_t payloadSize) {
+    return sizeof(CaptureRecord) + ((static_cast<uint64_t>(payloadSize) + 7) & ~static_cast<uint64_t>(7));
+}
+
+}  // namespace capture
+
+class SessionCapture {
+public:
+    typedef std::vector<uint8_t> Payload;
+
+    // Messages that can wait for the writer; beyond this they are dropped, never waited for
+    static constexpr uint32_t QUEUE_DEPTH = 1024;
+    static constexpr uint64_t DEFAULT_CAPACITY = 256ull << 20;
+
+    // Create and preallocate path (truncating it) and start the writer thread.
+    // Returns nullptr if the file cannot be created or mapped.
+    static std::shared_ptr<SessionCapture> open(const std::string& path, uint64_t capacity);
+
+    ~SessionCapture();
+
+    SessionCapture(const SessionCapture&) = delete;
+    SessionCapture& operator=(const SessionCapture&) = delete;
+
+    // Queue one message. payload must stay unchanged while referenced (messages are
+    // immutable once handed to the messenger). Lock-free, callable from any thread;
+    // returns false if the message was dropped or the capture is stopped.
+    // mediaTimestampOffset: payload offset of a big-endian phone timestamp, or 0 for none.
+    bool record(capture::Direction direction, uint8_t channel, uint8_t flags,
+                std::shared_ptr<const Payload> payload, size_t mediaTimestampOffset);
+
+    // Write out what is queued, stop the writer and trim the file to the records written.
+    // Later record() calls are ignored.
+    void stop();
+
+    uint64_t records() const { return records_.load(std::memory_order_relaxed); }
+    uint64_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry;
+    struct Cell;
+
+    SessionCapture();
+
+    static uint64_t monotonicNs();
+    bool pop(Entry& entry);
+    void run();
+    void write(const Entry& entry);
+    void drop();
+
+    std::string path_;
+    int fd_;
+    uint8_t* base_;
+    size_t mappedSize_;
+    capture::CaptureFileHeader* header_;
+
+    // Bounded multi-producer queue (Vyukov): each cell's sequence says whose turn it is
+    std::unique_ptr<Cell[]> cells_;
+    std::atomic<uint64_t> enqueuePos_;
+    uint64_t dequeuePos_;               // Writer thread only
+
+    std::thread writer_;
+    std::atomic<bool> running_;
+    std::atomic<bool> stopped_;
+    bool full_;                         // Writer thread only: capacity exhausted
+
+    std::atomic<uint64_t> records_;
+    std::atomic<uint64_t> bytes_;
+    std::atomic<uint64_t> dropped_;
+};
+
+// Read-only view of a capture, including one still being written or cut short by a crash
+class CaptureReader {
+public:
+    // Map path and check its header; returns nullptr if it is not a capture
+    static std::unique_ptr<CaptureReader> open(const std::string& path);
+
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    const capture::CaptureFileHeader& header() const { return *header_; }
+
+    // Next record in file order, payload pointing into the mapping; false after the last
+    // committed record
+    bool next(const capture::CaptureRecord*& record, const uint8_t*& payload);
+    void rewind();
+
+private:
+    CaptureReader();
+
+    int fd_;
+    uint8_t* base_;
+    size_t size_;
+    const capture::CaptureFileHeader* header_;
+    uint64_t end_;          // File offset past the last whole record
+    uint64_t offset_;       // File offset of the next record
+};
+
+#endif // SESSION_CAPTURE_H
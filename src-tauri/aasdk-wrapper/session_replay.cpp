@@ -0,0 +1,264 @@
+// Deterministic session replay
+// See session_replay.h
+
+#include "session_replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+constexpr uint32_t SessionReplay::SETTLE_MS;
+constexpr uint32_t SessionReplay::MAX_CHANNELS;
+
+namespace {
+std::chrono::steady_clock::time_point timePoint(uint64_t ns) {
+    return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(ns));
+}
+
+uint32_t toUs(uint64_t ns) {
+    uint64_t us = ns / 1000;
+    return us > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(us);
+}
+}
+
+SessionReplay::SessionReplay()
+    : channels_(new Channel[MAX_CHANNELS]), running_(false), stopping_(false), released_(0), skipped_(0),
+      stalls_(0), sent_(0), firstReleaseNs_(0), lastActivityNs_(0), recordedNs_(0) {
+    for (uint32_t i = 0; i < MAX_CHANNELS; ++i) {
+        channels_[i].busy = false;
+        channels_[i].busySinceNs = 0;
+    }
+}
+
+SessionReplay::~SessionReplay() {
+    stop();
+}
+
+uint64_t SessionReplay::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+std::unique_ptr<SessionReplay> SessionReplay::open(const std::string& path) {
+    auto reader = CaptureReader::open(path);
+    if (!reader) {
+        return nullptr;
+    }
+    std::unique_ptr<SessionReplay> replay(new SessionReplay());
+    replay->reader_ = std::move(reader);
+    return replay;
+}
+
+void SessionReplay::start(double speed, Filter filter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_ || stopping_) {
+        return;
+    }
+    filter_ = std::move(filter);
+    running_ = true;
+    driver_ = std::thread(&SessionReplay::run, this, speed);
+}
+
+void SessionReplay::run(double speed) {
+    uint64_t startNs = 0;
+    uint64_t firstHostNs = 0;
+    bool first = true;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        const capture::CaptureRecord* record;
+        const uint8_t* payload;
+        if (!reader_->next(record, payload)) {
+            break;
+        }
+        if (record->direction != static_cast<uint8_t>(capture::Direction::INBOUND)) {
+            continue;
+        }
+        if (filter_ && !filter_(*record)) {
+            ++skipped_;
+            continue;
+        }
+
+        if (first) {
+            first = false;
+            firstHostNs = record->hostNs;
+            startNs = nowNs();
+            firstReleaseNs_ = startNs;
+        }
+        uint64_t offsetNs = record->hostNs > firstHostNs ? record->hostNs - firstHostNs : 0;
+        recordedNs_ = offsetNs;
+
+        if (speed > 0) {
+            uint64_t dueNs = startNs + static_cast<uint64_t>(offsetNs / speed);
+            changed_.wait_until(lock, timePoint(dueNs), [this]() { return stopping_; });
+            if (stopping_) {
+                break;
+            }
+            uint64_t now = nowNs();
+            slipUs_.push_back(toUs(now > dueNs ? now - dueNs : 0));
+        } else {
+            waitIdle(lock);
+            if (stopping_) {
+                break;
+            }
+        }
+
+        Message message;
+        message.channel = record->channel;
+        message.flags = record->flags;
+        message.messageId = record->messageId;
+        message.size = record->payloadSize;
+        message.payload = payload;
+        release(lock, message);
+    }
+
+    // Let the handlers finish the tail so elapsed time covers it
+    if (!stopping_) {
+        waitIdle(lock);
+    }
+    running_ = false;
+    std::cerr << "Replay: released " << released_ << " messages, skipped " << skipped_
+              << ", " << stalls_ << " stalled handler(s)" << std::endl;
+}
+
+void SessionReplay::release(std::unique_lock<std::mutex>& lock, const Message& message) {
+    Channel& channel = channels_[message.channel];
+    uint64_t now = nowNs();
+    ++released_;
+    lastActivityNs_ = now;
+
+    if (!channel.receiver || !channel.mailbox.empty()) {
+        channel.mailbox.push_back(message);
+        return;
+    }
+    Receiver receiver = std::move(channel.receiver);
+    channel.receiver = nullptr;
+    channel.busy = true;
+    channel.busySinceNs = now;
+
+    lock.unlock();
+    receiver(message);
+    lock.lock();
+}
+
+void SessionReplay::receive(uint8_t channelId, Receiver receiver) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return;
+    }
+    Channel& channel = channels_[channelId];
+    uint64_t now = nowNs();
+    if (channel.busy) {
+        channel.latencyUs.push_back(toUs(now - channel.busySinceNs));
+        channel.busy = false;
+        lastActivityNs_ = now;
+    }
+
+    if (channel.mailbox.empty()) {
+        channel.receiver = std::move(receiver);
+        changed_.notify_all();
+        return;
+    }
+
+    Message message = channel.mailbox.front();
+    channel.mailbox.pop_front();
+    channel.busy = true;
+    channel.busySinceNs = now;
+    changed_.notify_all();
+
+    lock.unlock();
+    receiver(message);
+}
+
+bool SessionReplay::idle() const {
+    for (uint32_t i = 0; i < MAX_CHANNELS; ++i) {
+        if (channels_[i].busy) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SessionReplay::waitIdle(std::unique_lock<std::mutex>& lock) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SETTLE_MS);
+    if (changed_.wait_until(lock, deadline, [this]() { return stopping_ || idle(); })) {
+        return;
+    }
+    // A handler that never asks for another message would hold the replay forever; its
+    // channel keeps collecting messages in case it does ask later
+    for (uint32_t i = 0; i < MAX_CHANNELS; ++i) {
+        if (channels_[i].busy) {
+            std::cerr << "Replay: channel " << i << " handler did not ask for its next message within "
+                      << SETTLE_MS << " ms" << std::endl;
+            channels_[i].busy = false;
+            ++stalls_;
+        }
+    }
+}
+
+void SessionReplay::sent() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++sent_;
+}
+
+void SessionReplay::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (uint32_t i = 0; i < MAX_CHANNELS; ++i) {
+            channels_[i].receiver = nullptr;
+        }
+    }
+    changed_.notify_all();
+    if (driver_.joinable() && driver_.get_id() != std::this_thread::get_id()) {
+        driver_.join();
+    }
+}
+
+bool SessionReplay::running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void SessionReplay::summarize(std::vector<uint32_t> samples, AASDKLatencyStats* stats) {
+    *stats = AASDKLatencyStats();
+    if (samples.empty()) {
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) { return samples[static_cast<size_t>(p * (samples.size() - 1))]; };
+    stats->count = samples.size();
+    stats->p50_us = percentile(0.50);
+    stats->p90_us = percentile(0.90);
+    stats->p99_us = percentile(0.99);
+    stats->max_us = samples.back();
+}
+
+void SessionReplay::snapshot(AASDKReplayStats* stats) const {
+    std::vector<uint32_t> slip;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats->running = running_;
+        stats->released = released_;
+        stats->skipped = skipped_;
+        stats->stalls = stalls_;
+        stats->sent = sent_;
+        stats->unclaimed = 0;
+        for (uint32_t i = 0; i < MAX_CHANNELS; ++i) {
+            stats->unclaimed += channels_[i].mailbox.size();
+        }
+        stats->recorded_us = recordedNs_ / 1000;
+        stats->elapsed_us = firstReleaseNs_ != 0 ? (lastActivityNs_ - firstReleaseNs_) / 1000 : 0;
+        slip = slipUs_;
+    }
+    summarize(std::move(slip), &stats->schedule_slip);
+}
+
+void SessionReplay::handlerLatency(uint8_t channel, AASDKLatencyStats* stats) const {
+    std::vector<uint32_t> samples;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        samples = channels_[channel].latencyUs;
+    }
+    summarize(std::move(samples), stats);
+}
@@ -0,0 +1,115 @@
+// Deterministic session replay
+// Feeds the inbound messages of a capture (session_capture.h) back to the wrapper without
+// a phone. A driver thread walks the file and releases each message into a per-channel
+// mailbox when its recorded host time comes up, scaled by the replay speed; as fast as
+// possible it waits instead until every channel has handled what it was given, so the
+// same capture always produces the same message order. Channels take messages the way
+// they take them from the messenger: one receive() per message.
+
+#ifndef SESSION_REPLAY_H
+#define SESSION_REPLAY_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aasdk_c.h"
+#include "session_capture.h"
+
+class SessionReplay {
+public:
+    // A released inbound message; payload points into the mapped capture
+    struct Message {
+        uint8_t channel;
+        uint8_t flags;          // capture::FLAG_*
+        uint16_t messageId;
+        uint32_t size;
+        const uint8_t* payload;
+    };
+
+    typedef std::function<void(const Message&)> Receiver;
+    // Return false for records that must not be replayed
+    typedef std::function<bool(const capture::CaptureRecord&)> Filter;
+
+    // As fast as possible: longest wait for a handler to ask for its next message before
+    // the driver gives up on that channel and moves on
+    static constexpr uint32_t SETTLE_MS = 200;
+    static constexpr uint32_t MAX_CHANNELS = 256;
+
+    // Map the capture; returns nullptr if it cannot be read
+    static std::unique_ptr<SessionReplay> open(const std::string& path);
+
+    ~SessionReplay();
+
+    SessionReplay(const SessionReplay&) = delete;
+    SessionReplay& operator=(const SessionReplay&) = delete;
+
+    // Start the driver. speed 1 = real time, N = N times faster, 0 = as fast as possible.
+    void start(double speed, Filter filter);
+
+    // Take the next message on channel: receiver runs here if one is already released,
+    // otherwise on the driver thread when it is. Any thread.
+    void receive(uint8_t channel, Receiver receiver);
+
+    // Outbound message the wrapper sent; replays only count them
+    void sent();
+
+    // Stop the driver; receivers still waiting are dropped
+    void stop();
+
+    bool running() const;
+
+    // Fill everything but the per-channel handler latencies
+    void snapshot(AASDKReplayStats* stats) const;
+
+    // Release-to-next-receive latency of channel
+    void handlerLatency(uint8_t channel, AASDKLatencyStats* stats) const;
+
+private:
+    struct Channel {
+        bool busy;              // Handed a message, next receive() not seen yet
+        uint64_t busySinceNs;
+        Receiver receiver;      // Waiting for the next release
+        std::deque<Message> mailbox;
+        std::vector<uint32_t> latencyUs;
+    };
+
+    SessionReplay();
+
+    static uint64_t nowNs();
+    static void summarize(std::vector<uint32_t> samples, AASDKLatencyStats* stats);
+
+    void run(double speed);
+    // Hand message to its channel's receiver or mailbox; lock is released before the receiver runs
+    void release(std::unique_lock<std::mutex>& lock, const Message& message);
+    // Wait until no channel is in the middle of a message, or give up on the laggards
+    void waitIdle(std::unique_lock<std::mutex>& lock);
+    bool idle() const;
+
+    std::unique_ptr<CaptureReader> reader_;
+    Filter filter_;
+    std::thread driver_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::unique_ptr<Channel[]> channels_;
+    bool running_;
+    bool stopping_;
+
+    uint64_t released_;
+    uint64_t skipped_;
+    uint64_t stalls_;
+    uint64_t sent_;
+    uint64_t firstReleaseNs_;
+    uint64_t lastActivityNs_;
+    uint64_t recordedNs_;
+    std::vector<uint32_t> slipUs_;
+};
+
+#endif // SESSION_REPLAY_H
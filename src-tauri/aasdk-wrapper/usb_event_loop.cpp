@@ -0,0 +1,200 @@
+// libusb <-> boost::asio integration
+// See usb_event_loop.h
+
+#include "usb_event_loop.h"
+
+#include <poll.h>
+#include <iostream>
+
+USBEventLoop::USBEventLoop(boost::asio::io_service& ioService, libusb_context* usbContext)
+    : ioService_(ioService), strand_(ioService), usbContext_(usbContext),
+      timeoutTimer_(ioService), nextWatchId_(0), needsTimer_(false), running_(false) {}
+
+USBEventLoop::~USBEventLoop() {
+    stop();
+}
+
+void USBEventLoop::start() {
+    if (running_ || !usbContext_) {
+        return;
+    }
+
+    const libusb_pollfd** probe = libusb_get_pollfds(usbContext_);
+    if (!probe) {
+        std::cerr << "libusb_get_pollfds not supported on this platform" << std::endl;
+        return;
+    }
+    libusb_free_pollfds(probe);
+
+    running_ = true;
+
+    // On Linux libusb exposes its timeouts through a timerfd, so the pollfds alone are
+    // enough. Older kernels need us to drive libusb_get_next_timeout() ourselves.
+    needsTimer_ = libusb_pollfds_handle_timeouts(usbContext_) == 0;
+
+    // Notifiers can fire from any thread that calls into libusb, so they are funnelled
+    // through the strand. They are installed first and the current set is read on the
+    // strand afterwards: an fd added before the read is in the set (a second add from its
+    // notifier just replaces the watch), one added or removed after it is queued behind it.
+    libusb_set_pollfd_notifiers(usbContext_, &USBEventLoop::onPollfdAdded,
+                                &USBEventLoop::onPollfdRemoved, this);
+
+    strand_.post([this]() {
+        const libusb_pollfd** pollfds = libusb_get_pollfds(usbContext_);
+        if (pollfds) {
+            for (const libusb_pollfd** it = pollfds; *it != nullptr; ++it) {
+                addDescriptor((*it)->fd, (*it)->events);
+            }
+            libusb_free_pollfds(pollfds);
+        }
+        armTimeout();
+    });
+
+    std::cerr << "USB event loop started (timerfd: " << (needsTimer_ ? "no" : "yes") << ")" << std::endl;
+}
+
+// Must be called once the io threads have exited: descriptors are released directly
+void USBEventLoop::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+
+    libusb_set_pollfd_notifiers(usbContext_, nullptr, nullptr, nullptr);
+
+    boost::system::error_code ec;
+    timeoutTimer_.cancel(ec);
+    releaseAll();
+}
+
+void USBEventLoop::onPollfdAdded(int fd, short events, void* userData) {
+    auto* self = static_cast<USBEventLoop*>(userData);
+    self->strand_.post([self, fd, events]() { self->addDescriptor(fd, events); });
+}
+
+void USBEventLoop::onPollfdRemoved(int fd, void* userData) {
+    auto* self = static_cast<USBEventLoop*>(userData);
+    self->strand_.post([self, fd]() { self->removeDescriptor(fd); });
+}
+
+void USBEventLoop::addDescriptor(int fd, short events) {
+    if (!running_) {
+        return;
+    }
+
+    // A re-add for the same fd replaces the old registration
+    removeDescriptor(fd);
+
+    Watch watch;
+    watch.descriptor = std::make_unique<boost::asio::posix::stream_descriptor>(ioService_, fd);
+    watch.id = ++nextWatchId_;
+    watch.events = events;
+    watch.readPending = false;
+    watch.writePending = false;
+    watches_.emplace(fd, std::move(watch));
+
+    armDescriptor(fd);
+}
+
+void USBEventLoop::removeDescriptor(int fd) {
+    auto it = watches_.find(fd);
+    if (it == watches_.end()) {
+        return;
+    }
+
+    // release() deregisters from the reactor and aborts pending waits without closing the fd
+    boost::system::error_code ec;
+    it->second.descriptor->cancel(ec);
+    it->second.descriptor->release();
+    watches_.erase(it);
+}
+
+void USBEventLoop::armDescriptor(int fd) {
+    auto it = watches_.find(fd);
+    if (it == watches_.end() || !running_) {
+        return;
+    }
+
+    Watch& watch = it->second;
+    uint64_t watchId = watch.id;
+
+    // Pending handlers compare the watch id so a recycled fd number never
+    // re-arms a registration that has since been replaced
+    auto onReady = [this, fd, watchId](bool isRead, const boost::system::error_code& ec) {
+        auto current = watches_.find(fd);
+        if (current == watches_.end() || current->second.id != watchId) {
+            return;
+        }
+        if (isRead) {
+            current->second.readPending = false;
+        } else {
+            current->second.writePending = false;
+        }
+        if (ec == boost::asio::error::operation_aborted || !running_) {
+            return;
+        }
+        if (ec) {
+            // libusb closes an fd before its removal notifier reaches the strand, and a
+            // wait on a closed fd fails at once: re-arming it would spin. Drop the watch,
+            // the queued removal then finds nothing left to release.
+            std::cerr << "USB pollfd " << fd << " wait failed: " << ec.message() << std::endl;
+            removeDescriptor(fd);
+            return;
+        }
+        handleEvents();
+        armDescriptor(fd);
+    };
+
+    if ((watch.events & POLLIN) && !watch.readPending) {
+        watch.readPending = true;
+        watch.descriptor->async_wait(boost::asio::posix::stream_descriptor::wait_read,
+            strand_.wrap([onReady](const boost::system::error_code& ec) { onReady(true, ec); }));
+    }
+    if ((watch.events & POLLOUT) && !watch.writePending) {
+        watch.writePending = true;
+        watch.descriptor->async_wait(boost::asio::posix::stream_descriptor::wait_write,
+            strand_.wrap([onReady](const boost::system::error_code& ec) { onReady(false, ec); }));
+    }
+}
+
+void USBEventLoop::handleEvents() {
+    // Zero timeout: the reactor already told us an fd is ready, never block here
+    struct timeval tv = {0, 0};
+    int ret = libusb_handle_events_timeout_completed(usbContext_, &tv, nullptr);
+    if (ret != 0) {
+        std::cerr << "libusb_handle_events failed: " << libusb_error_name(ret) << std::endl;
+    }
+    armTimeout();
+}
+
+void USBEventLoop::armTimeout() {
+    if (!needsTimer_ || !running_) {
+        return;
+    }
+
+    struct timeval tv = {0, 0};
+    boost::posix_time::time_duration wait;
+    if (libusb_get_next_timeout(usbContext_, &tv) == 1) {
+        wait = boost::posix_time::seconds(tv.tv_sec) + boost::posix_time::microseconds(tv.tv_usec);
+    } else {
+        // Without a timerfd libusb cannot tell us when a new transfer adds a timeout,
+        // so fall back to a coarse re-check
+        wait = boost::posix_time::milliseconds(100);
+    }
+
+    timeoutTimer_.expires_from_now(wait);
+    timeoutTimer_.async_wait(strand_.wrap([this](const boost::system::error_code& ec) {
+        if (!ec && running_) {
+            handleEvents();
+        }
+    }));
+}
+
+void USBEventLoop::releaseAll() {
+    for (auto& entry : watches_) {
+        boost::system::error_code ec;
+        entry.second.descriptor->cancel(ec);
+        entry.second.descriptor->release();
+    }
+    watches_.clear();
+}
@@ -0,0 +1,58 @@
+// libusb <-> boost::asio integration
+// Registers libusb's pollfds with the io_service reactor so USB completions are
+// dispatched from ioService.run() alongside every other asio handler
+
+#ifndef USB_EVENT_LOOP_H
+#define USB_EVENT_LOOP_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+#include <libusb-1.0/libusb.h>
+#include <boost/asio.hpp>
+
+class USBEventLoop {
+public:
+    USBEventLoop(boost::asio::io_service& ioService, libusb_context* usbContext);
+    ~USBEventLoop();
+
+    USBEventLoop(const USBEventLoop&) = delete;
+    USBEventLoop& operator=(const USBEventLoop&) = delete;
+
+    // Install the add/remove notifiers, then register the current pollfds
+    void start();
+
+    // Remove notifiers and release all descriptors (fds stay owned by libusb)
+    void stop();
+
+private:
+    struct Watch {
+        std::unique_ptr<boost::asio::posix::stream_descriptor> descriptor;
+        uint64_t id;
+        short events;
+        bool readPending;
+        bool writePending;
+    };
+
+    static void onPollfdAdded(int fd, short events, void* userData);
+    static void onPollfdRemoved(int fd, void* userData);
+
+    void addDescriptor(int fd, short events);
+    void removeDescriptor(int fd);
+    void armDescriptor(int fd);
+    void handleEvents();
+    void armTimeout();
+    void releaseAll();
+
+    boost::asio::io_service& ioService_;
+    boost::asio::io_service::strand strand_;
+    libusb_context* usbContext_;
+    boost::asio::deadline_timer timeoutTimer_;
+    std::map<int, Watch> watches_;
+    uint64_t nextWatchId_;
+    bool needsTimer_;
+    bool running_;
+};
+
+#endif // USB_EVENT_LOOP_H
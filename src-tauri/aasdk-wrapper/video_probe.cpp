@@ -0,0 +1,456 @@
+// Video decode capability probe
+// See video_probe.h
+
+#include "video_probe.h"
+#include "frame_pool.h"
+#include "h264_decoder.h"
+#include "h264_parser.h"
+#include "video_probe_clip.h"
+#include "yuv_convert.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <elf.h>
+#include <link.h>
+#include <sys/stat.h>
+
+constexpr uint32_t VideoCapabilityProbe::BUDGET_PERCENT;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Picture sizes of the advertisable video resolutions (480p, 720p, 1080p)
+const uint32_t PROBE_SIZES[][2] = {{800, 480}, {1280, 720}, {1920, 1080}};
+
+// Keep decoding the clip until this much time has been measured
+const auto DECODE_BUDGET = std::chrono::milliseconds(200);
+const uint32_t MAX_DECODE_LOOPS = 64;
+const auto CONVERT_BUDGET = std::chrono::milliseconds(30);
+const uint32_t MAX_CONVERT_ITERATIONS = 50;
+
+uint32_t macroblocks(uint32_t width, uint32_t height) {
+    return ((width + 15) / 16) * ((height + 15) / 16);
+}
+
+std::vector<uint8_t> decodeBase64(const char* text) {
+    static const std::string ALPHABET =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::vector<uint8_t> out;
+    uint32_t bits = 0;
+    int count = 0;
+    for (const char* c = text; *c && *c != '='; ++c) {
+        size_t value = ALPHABET.find(*c);
+        if (value == std::string::npos) {
+            continue;
+        }
+        bits = (bits << 6) | static_cast<uint32_t>(value);
+        count += 6;
+        if (count >= 8) {
+            count -= 8;
+            out.push_back(static_cast<uint8_t>(bits >> count));
+        }
+    }
+    return out;
+}
+
+// Split an Annex-B stream into the per-picture payloads the phone would send
+std::vector<std::pair<size_t, size_t>> accessUnits(const std::vector<uint8_t>& stream) {
+    std::vector<std::pair<size_t, size_t>> units;
+    size_t begin = 0;
+    H264Parser::forEachNal(stream.data(), stream.size(), [&](const H264Parser::Nal& nal) {
+        if (nal.type == H264Parser::NAL_SLICE || nal.type == H264Parser::NAL_IDR) {
+            size_t end = static_cast<size_t>(nal.data - stream.data()) + nal.size;
+            units.emplace_back(begin, end - begin);
+            begin = end;
+        }
+        return true;
+    });
+    return units;
+}
+
+void countPicture(const AASDKDecodedFrame* /*frame*/, void* userData) {
+    ++*static_cast<uint64_t*>(userData);
+}
+
+// Marker so the build id lookup finds the object this code is linked into
+int probeAnchor;
+
+struct BuildIdSearch {
+    uintptr_t anchor;
+    std::string id;
+};
+
+int findBuildId(struct dl_phdr_info* info, size_t /*size*/, void* data) {
+    auto* search = static_cast<BuildIdSearch*>(data);
+
+    bool contains = false;
+    for (int i = 0; i < info->dlpi_phnum && !contains; ++i) {
+        const auto& phdr = info->dlpi_phdr[i];
+        uintptr_t start = info->dlpi_addr + phdr.p_vaddr;
+        contains = phdr.p_type == PT_LOAD && search->anchor >= start && search->anchor < start + phdr.p_memsz;
+    }
+    if (!contains) {
+        return 0;
+    }
+
+    for (int i = 0; i < info->dlpi_phnum; ++i) {
+        const auto& phdr = info->dlpi_phdr[i];
+        if (phdr.p_type != PT_NOTE) {
+            continue;
+        }
+        const uint8_t* note = reinterpret_cast<const uint8_t*>(info->dlpi_addr + phdr.p_vaddr);
+        const uint8_t* end = note + phdr.p_memsz;
+        while (note + sizeof(ElfW(Nhdr)) <= end) {
+            const auto* header = reinterpret_cast<const ElfW(Nhdr)*>(note);
+            const uint8_t* name = note + sizeof(ElfW(Nhdr));
+            const uint8_t* desc = name + ((header->n_namesz + 3) & ~3u);
+            if (header->n_type == NT_GNU_BUILD_ID && header->n_namesz == 4 &&
+                std::memcmp(name, "GNU", 4) == 0 && desc + header->n_descsz <= end) {
+                char hex[3];
+                for (uint32_t b = 0; b < header->n_descsz; ++b) {
+                    std::snprintf(hex, sizeof(hex), "%02x", desc[b]);
+                    search->id += hex;
+                }
+                return 1;
+            }
+            note = desc + ((header->n_descsz + 3) & ~3u);
+        }
+    }
+    return 1;
+}
+
+// GNU build id of the binary the wrapper is linked into, or its size and mtime
+std::string buildId() {
+    BuildIdSearch search = {reinterpret_cast<uintptr_t>(&probeAnchor), std::string()};
+    dl_iterate_phdr(&findBuildId, &search);
+    if (!search.id.empty()) {
+        return search.id;
+    }
+
+    struct stat info;
+    if (stat("/proc/self/exe", &info) == 0) {
+        return "exe-" + std::to_string(info.st_size) + "-" + std::to_string(info.st_mtime);
+    }
+    return "unknown";
+}
+
+// "model name" on x86, the board name ("Model") or SoC on ARM
+std::string cpuModel() {
+    static const char* const KEYS[] = {"model name", "Model", "Hardware", "CPU part"};
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string found[4];
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+        for (size_t i = 0; i < 4; ++i) {
+            if (key == KEYS[i] && found[i].empty()) {
+                size_t value = line.find_first_not_of(" \t", colon + 1);
+                found[i] = value == std::string::npos ? "" : line.substr(value);
+            }
+        }
+    }
+    for (const auto& model : found) {
+        if (!model.empty()) {
+            return model;
+        }
+    }
+    return "unknown";
+}
+
+bool makeDirectories(const std::string& path) {
+    for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+        std::string dir = path.substr(0, slash);
+        if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+        if (slash == std::string::npos) {
+            return true;
+        }
+    }
+}
+
+} // namespace
+
+VideoCapabilityProbe::VideoCapabilityProbe()
+    : started_(false), finished_(false), valid_(false), result_() {}
+
+VideoCapabilityProbe::~VideoCapabilityProbe() {
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void VideoCapabilityProbe::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (started_) {
+        return;
+    }
+    started_ = true;
+    thread_ = std::thread([this]() { run(); });
+}
+
+VideoCapabilityProbe::Status VideoCapabilityProbe::status() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!finished_) {
+        return Status::PENDING;
+    }
+    return valid_ ? Status::READY : Status::FAILED;
+}
+
+uint32_t VideoCapabilityProbe::frameCostUs(uint32_t width, uint32_t height) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!valid_) {
+        return 0;
+    }
+
+    uint64_t decodeUs = static_cast<uint64_t>(result_.decodeNsPerMb) * macroblocks(width, height) / 1000;
+
+    // Scale the smallest sample at least this big, so cache effects are not underestimated;
+    // past the largest sample, scale that one
+    uint64_t pixels = static_cast<uint64_t>(width) * height;
+    const ConvertSample* sample = nullptr;
+    for (const auto& candidate : result_.convert) {
+        uint64_t candidatePixels = static_cast<uint64_t>(candidate.width) * candidate.height;
+        uint64_t samplePixels = sample ? static_cast<uint64_t>(sample->width) * sample->height : 0;
+        bool fits = candidatePixels >= pixels;
+        bool sampleFits = sample && samplePixels >= pixels;
+        if (!sample || (fits && (!sampleFits || candidatePixels < samplePixels)) ||
+            (!fits && !sampleFits && candidatePixels > samplePixels)) {
+            sample = &candidate;
+        }
+    }
+    uint64_t convertUs = 0;
+    if (sample) {
+        convertUs = static_cast<uint64_t>(sample->us) * pixels /
+                    (static_cast<uint64_t>(sample->width) * sample->height);
+    }
+    return static_cast<uint32_t>(decodeUs + convertUs);
+}
+
+bool VideoCapabilityProbe::sustains(uint32_t width, uint32_t height, uint32_t fps) const {
+    if (fps == 0) {
+        return false;
+    }
+    uint32_t budgetUs = 1000000 / fps * BUDGET_PERCENT / 100;
+    return frameCostUs(width, height) <= budgetUs;
+}
+
+std::string VideoCapabilityProbe::cachePath() {
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    std::string base;
+    if (cacheHome && *cacheHome == '/') {
+        base = cacheHome;
+    } else if (const char* home = std::getenv("HOME")) {
+        base = std::string(home) + "/.cache";
+    } else {
+        return std::string();
+    }
+    return base + "/aasdk_c/video_capability";
+}
+
+std::string VideoCapabilityProbe::cacheKey() {
+    std::ostringstream key;
+    key << cpuModel() << "|" << std::thread::hardware_concurrency()
+        << "|" << YuvConverter::isaName(YuvConverter::detectIsa())
+        << "|" << buildId() << "|avcodec " << H264Decoder::version();
+    return key.str();
+}
+
+bool VideoCapabilityProbe::load(const std::string& path, const std::string& key, Result& result) {
+    std::ifstream in(path);
+    std::string line;
+    if (!std::getline(in, line) || line != "key " + key) {
+        return false;
+    }
+
+    Result loaded = {0, {}};
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        fields >> name;
+        if (name == "decode_ns_per_mb") {
+            fields >> loaded.decodeNsPerMb;
+        } else if (name == "convert_us") {
+            ConvertSample sample = {0, 0, 0};
+            char by = 0;
+            fields >> sample.width >> by >> sample.height >> sample.us;
+            if (fields && by == 'x') {
+                loaded.convert.push_back(sample);
+            }
+        }
+    }
+    if (loaded.decodeNsPerMb == 0) {
+        return false;
+    }
+    result = loaded;
+    return true;
+}
+
+void VideoCapabilityProbe::save(const std::string& path, const std::string& key, const Result& result) {
+    if (!makeDirectories(path.substr(0, path.rfind('/')))) {
+        std::cerr << "Video probe: cannot create cache directory for " << path << std::endl;
+        return;
+    }
+
+    // Write then rename so a crash never leaves a truncated cache behind
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        out << "key " << key << "\n";
+        out << "decode_ns_per_mb " << result.decodeNsPerMb << "\n";
+        for (const auto& sample : result.convert) {
+            out << "convert_us " << sample.width << "x" << sample.height << " " << sample.us << "\n";
+        }
+        if (!out) {
+            std::cerr << "Video probe: failed to write " << temporary << std::endl;
+            return;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Video probe: failed to replace " << path << std::endl;
+    }
+}
+
+bool VideoCapabilityProbe::measureDecode(uint32_t& nsPerMb) {
+    std::vector<uint8_t> clip = decodeBase64(video_probe_clip::BASE64);
+    auto units = accessUnits(clip);
+    if (units.empty()) {
+        return false;
+    }
+
+    FramePool pool(4);
+    uint64_t pictures = 0;
+    H264Decoder decoder(&countPicture, &pictures);
+    uint64_t sequence = 0;
+    auto decodeClip = [&]() {
+        for (const auto& unit : units) {
+            AASDKFrame* frame = pool.acquire(unit.second);
+            if (!frame) {
+                return false;
+            }
+            std::memcpy(const_cast<uint8_t*>(frame->data), clip.data() + unit.first, unit.second);
+            frame->sequence = ++sequence;
+            if (!decoder.decodeNow(frame)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // The first pass opens the codec and warms the caches
+    if (!decodeClip() || pictures == 0) {
+        return false;
+    }
+
+    pictures = 0;
+    auto started = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    for (uint32_t loop = 0; loop < MAX_DECODE_LOOPS && elapsed < DECODE_BUDGET; ++loop) {
+        if (!decodeClip()) {
+            return false;
+        }
+        elapsed = Clock::now() - started;
+    }
+    if (pictures == 0) {
+        return false;
+    }
+
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    nsPerMb = static_cast<uint32_t>(std::max<uint64_t>(1,
+        ns / (pictures * macroblocks(video_probe_clip::WIDTH, video_probe_clip::HEIGHT))));
+    return true;
+}
+
+uint32_t VideoCapabilityProbe::measureConvert(uint32_t width, uint32_t height) {
+    // A decoder-shaped I420 picture; the kernels' cost does not depend on the content
+    uint32_t chromaWidth = (width + 1) / 2;
+    uint32_t chromaHeight = (height + 1) / 2;
+    std::vector<uint8_t> luma(static_cast<size_t>(width) * height);
+    std::vector<uint8_t> chroma(static_cast<size_t>(chromaWidth) * chromaHeight * 2);
+    for (size_t i = 0; i < luma.size(); ++i) {
+        luma[i] = static_cast<uint8_t>(i * 7);
+    }
+    for (size_t i = 0; i < chroma.size(); ++i) {
+        chroma[i] = static_cast<uint8_t>(i * 3);
+    }
+
+    AASDKDecodedFrame picture = {};
+    picture.width = width;
+    picture.height = height;
+    picture.format = AASDK_PIXEL_FORMAT_I420;
+    picture.planes[0] = luma.data();
+    picture.planes[1] = chroma.data();
+    picture.planes[2] = chroma.data() + chroma.size() / 2;
+    picture.strides[0] = width;
+    picture.strides[1] = chromaWidth;
+    picture.strides[2] = chromaWidth;
+
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    YuvConverter converter;
+    converter.convert(picture, rgba.data(), width * 4, width, height, AASDK_RGB_FORMAT_RGBA);
+
+    uint32_t iterations = 0;
+    auto started = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    while (iterations < MAX_CONVERT_ITERATIONS && elapsed < CONVERT_BUDGET) {
+        converter.convert(picture, rgba.data(), width * 4, width, height, AASDK_RGB_FORMAT_RGBA);
+        ++iterations;
+        elapsed = Clock::now() - started;
+    }
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / iterations);
+}
+
+void VideoCapabilityProbe::run() {
+    std::string path = cachePath();
+    std::string key = cacheKey();
+
+    Result result = {0, {}};
+    bool valid = !path.empty() && load(path, key, result);
+    if (valid) {
+        std::cerr << "Video probe: using cached measurements from " << path << std::endl;
+    } else if (H264Decoder::available()) {
+        auto started = Clock::now();
+        valid = measureDecode(result.decodeNsPerMb);
+        if (valid) {
+            for (const auto& size : PROBE_SIZES) {
+                ConvertSample sample = {size[0], size[1], measureConvert(size[0], size[1])};
+                result.convert.push_back(sample);
+            }
+            if (!path.empty()) {
+                save(path, key, result);
+            }
+        } else {
+            std::cerr << "Video probe: reference clip failed to decode" << std::endl;
+        }
+        std::cerr << "Video probe: benchmark took "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started).count()
+                  << " ms" << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result_ = result;
+        valid_ = valid;
+        finished_ = true;
+    }
+
+    if (valid) {
+        for (const auto& size : PROBE_SIZES) {
+            std::cerr << "Video probe: " << size[0] << "x" << size[1] << " costs "
+                      << frameCostUs(size[0], size[1]) << " us per frame" << std::endl;
+        }
+    }
+}
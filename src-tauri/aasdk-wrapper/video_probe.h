@@ -0,0 +1,77 @@
+// Video decode capability probe
+// Times the native decode-plus-convert path on an embedded reference clip so service
+// discovery only advertises video modes this machine sustains in real time. The
+// measurements are cached on disk, keyed by CPU model, wrapper build and libavcodec
+// version, so only the first start of a build on a given board pays for the benchmark.
+
+#ifndef VIDEO_PROBE_H
+#define VIDEO_PROBE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class VideoCapabilityProbe {
+public:
+    // Share of the frame interval decode plus conversion may take; the rest is left for
+    // rendering, audio and the UI
+    static constexpr uint32_t BUDGET_PERCENT = 60;
+
+    VideoCapabilityProbe();
+    ~VideoCapabilityProbe();
+
+    VideoCapabilityProbe(const VideoCapabilityProbe&) = delete;
+    VideoCapabilityProbe& operator=(const VideoCapabilityProbe&) = delete;
+
+    enum class Status {
+        PENDING,    // Not started, or still benchmarking
+        READY,      // Measurements available
+        FAILED,     // No libavcodec, or the clip did not decode
+    };
+
+    // Load the cached measurements, or benchmark on a background thread. Idempotent.
+    void start();
+
+    // Where the measurements stand; never blocks, so io threads may ask
+    Status status() const;
+
+    // Estimated decode plus RGBA conversion time of one picture; needs status() == READY
+    uint32_t frameCostUs(uint32_t width, uint32_t height) const;
+
+    // True if width x height at fps fits in BUDGET_PERCENT of the frame interval
+    bool sustains(uint32_t width, uint32_t height, uint32_t fps) const;
+
+    // $XDG_CACHE_HOME (or ~/.cache) /aasdk_c/video_capability, empty without a home
+    static std::string cachePath();
+
+private:
+    // Conversion time measured at one of the advertised picture sizes
+    struct ConvertSample {
+        uint32_t width;
+        uint32_t height;
+        uint32_t us;
+    };
+
+    struct Result {
+        uint32_t decodeNsPerMb;     // Per 16x16 macroblock, averaged over the clip
+        std::vector<ConvertSample> convert;
+    };
+
+    void run();
+    static std::string cacheKey();
+    static bool load(const std::string& path, const std::string& key, Result& result);
+    static void save(const std::string& path, const std::string& key, const Result& result);
+    static bool measureDecode(uint32_t& nsPerMb);
+    static uint32_t measureConvert(uint32_t width, uint32_t height);
+
+    std::thread thread_;
+    mutable std::mutex mutex_;
+    bool started_;
+    bool finished_;
+    bool valid_;
+    Result result_;
+};
+
+#endif // VIDEO_PROBE_H
@@ -0,0 +1,247 @@
+// Reference clip for the video capability probe (see video_probe.h)
+// 320x192 constrained baseline H.264 at 60 fps, 8 frames (one IDR, seven P frames) of a
+// scrolling map-like scene with text-like detail, Annex-B with SPS/PPS ahead of the IDR.
+// Encoded with libx264 (crf 28, tune zerolatency); stored as base64.
+
+#ifndef VIDEO_PROBE_CLIP_H
+#define VIDEO_PROBE_CLIP_H
+
+namespace video_probe_clip {
+
+constexpr unsigned WIDTH = 320;
+constexpr unsigned HEIGHT = 192;
+constexpr unsigned FRAMES = 8;
+
+constexpr char BASE64[] =
+    "AAAAAWdCwBXZAUGaEAAAAwAQAAAHiPFi5IAAAAABaMuCSyAAAAABZYiEJ+ARVQhh8AMN6JmHq9mQS+ccDuD/tMXesDrA3a3b"
+    "6qwLry3yevd11X7jjmODbbbb+IqIjqoitVQuuL+H+f+OrdvqrAuvLfI9e7/bW+Xn/2oOrdvqrAunlvkevdHCPr9FwAxXI2QH"
+    "q90XIIBhmX9tb5ef/6xHEf/QIdYAG5Zn/MG+kC3/9HS8NRGnwAEzQcRrjV66Cr4UdOOyoQjaq06JO95DZREfLc01mQ+DZ/WA"
+    "JptMXURJ+YPhCK9eEma97v4EogQTou8XmwLv/YgFvrRk+jua7TGttb9aInH///A/VjMvjzkD/4PrTTTXj1JZqDTW01/8aG4q"
+    "rLsBGlAAe2SMjNeiP+02Iu9qUnwX/a0KFOTWdFN//5wHgSZnZiy7n4/7zapk1mC/KDW+ZIziJ5rPIb88sPz1Na5qxKk5P3+C"
+    "I08kNuFQf93aGLfKjtheTcX/7/z63v37//7gwJNN8fkUsQQm//Aw+miBie///5XEIjKsFJVTuLSCKUlagYMGJZoqACrJdNrZ"
+    "TABenXirs5+YDb2XIqi/4CFkzFOdrPfEAARaq7hmh+D4D9VTOzRAIXn1ZA/zuYjUREYJh+9mQ7ondo5u0BRu19f++gAs2Z/J"
+    "XZFP114Dp52+fNik6xYnMPEfyt/fe7vJCZCMer2AHpmfUiRI85xGWI7Ig6v4nmp2wscIT+8PpjLjJjLjPhBdUb8EUwGL6/v/"
+    "8/4pIFf+btXe0K11sREc7TDJ6EbzCIv7FQdQhAMyOQDMggExe0zqNCPMAqFC7TFbTYvAqS9Gb/7FlGox6fr/3/MMgQj3KeGU"
+    "pRHxVer2HPBoaY5ef/uAkHbj1mZ648PUyDK6L7YT6vREIjPUTSyEcAHkVn+7CJe7vkAnpG1blP8AFw4R7n1I56vAabt1Sb2j"
+    "28+D9g7OolkxVX9VQ2zERSE/f39xoxU35uIq5u//5VlM0sOd9dysRHh+MUFIAYrkbID1eIIBhmWi+ANm5aDqAnC1YSm39ciP"
+    "+8MV9EycQVIPG9s17OM/9EYxVcsa/ACZG9lJudL9mixXorrd2DuJbYAjy9te7dYN/mpGk7nq9+sP/8rJqiuf8wAEYqbecr67"
+    "EP1JJJL4ioD1VyUtPg9l6022b4AikwykLWrwVxLbAD/y9svPbtQuEezKuoRgu/9/hTyMZ1yj0AvaEqL+0kf/qAx8mJmIxT/X"
+    "2zPEqJi1Qm/7IC6bZXoo/m2xxEwi3Gnp2kzIDUbV4YIIA+RqsxbdP/ApS8sVG/MgxvsTBLCRW/c/3T8NmZsZdEsf8gEB4UrM"
+    "QeHYqNGN4hIt2ZS9/uEGT/s5TzHf/vFHMxxA6lUiWB2MZbq/YlY3a+I4jLylQjHcfjmZP9YwCLDSH8BGVM0T1eaQWR6Br6ew"
+    "Qcqn7c2Fk+fAKLHT1Lduvn8C6Eok0u5xFVkf38OAKxv6zb2LVsggMIgxND/HbVxsvb7wX1tttv4jiP/oK+sAQiLnYioOqA7B"
+    "vYRvncR//oj7KoDjp4AIdPr6+/7z3F19fj4ggGRlnGm10f3pHrnLf//QC0lCOwq5Rak+ciJ3YroOqg+7EL34nvrq/63t7Nts"
+    "aX8PEVARCqhUFVLwqnaumrrlfqGwC3rnLf//S+FU7V01dfqGwAseuOW//+qwX+BBgEfAQqvjweBcvZMptTce4K3OTtVV7fg/"
+    "OLJW1Vl0C96NblD+/+mSBoRoLXX/NdKY9ILQRLB+uO1tttv/iPgGAIlY9lboKU46t2+qsOSbRtB1fwQDJrXrng9mHFS6UuOg"
+    "Up5bdM9e4AEuSozJ2/97mR74+vhWcJCqYr3VScmoMndu6tyWoy5kL/2BA8mmKqw0ozN866TVdS0u2/te/3laAykqM9RHd/ag"
+    "Sd6Vq1jeP9Dq3bdVYFFPLfIz17v9tb5ef8MBnza5mH3VWlmZJrtVn8Og8f4DuUptHI6M8gAAAwIC32Hefs9uXWYMgQBdB8PM"
+    "QBB3+jwB6FCFKLkA9M2YCUcbkrWmmmvHqOtf/9LSS+RkeMU0GIA57AFm+6uG/IsE7yo4NGYgq4JTTqg637Gv9QZEYxvSpt3g"
+    "ZyxtEtQDiU4cR6VdokPiGAJ/3n/5+ioAxnC5evUdargAeNgbSVpI3f9bWx7+cXLr++5DFOdce+l4XVV0jcwG35dKq/50amMu"
+    "MmMuM/1GogpQUQZLxTnWj30gXDhHs1oK+uYDYcJLyYdydeaxwAnrbmrBjr/aMV/jQzo7n9/+gHNmtx9+i9/BdVXSNzWjjKmt"
+    "tp3zwhfbicev1oBstgk7qbqb99oMX6upuY9D0e+LzLRxg/bV5ICT/atJRxxpAU9HzWu5+b9ibaVt7t/+AAvGq2kmthhwxLiI"
+    "2S7X8CVyec3CXdQ3/0CAN+QrOVxfXEtoJSPSYVf/0gdWhYVEbeflhEOKXqTNcOKtQ9VC39vi0K/fch8ywACRqcARImyM0HUe"
+    "AASOtpaRwKIj7JCxK2mvP/e3/6LFDm6u12u/+gsnZ5LWdn9fzgAJxG4VRPjjSvoRJJkCVsctH7+8syXTNNqYejMMqel5KRb/"
+    "feO1JJJL77CYh/p7GBN784tw0/9WYRlV3KONz5iVdJCqfcPFySRERZY+P3IYDAm8z2GnNeNqQ/rwB6FjFOLlZdariEAp++rT"
+    "GVlraxvy82X724G+8fK/Wm3r33EtsAPfk82Xnt1jAembMBKONzw/JnMuuS4arrgj+Bnqv9aH9/vT8yVACPL3r3bun4q609GX"
+    "jKcmafaAbvf7ESsr/9hwGHat3kqcSDK7IAwjhctQBz4kY6idwBYcRFXi9OTJ//h2tttt/+MMQwBCev4mm2ualyh9DZ54w2/a"
+    "9vjj+AcEK0CpN+zV3f9dXkrRJftZ/hhr4ArNGk0HUfM66wAPEIZxjoyo+AFaAuK6mDRNqAo6JFb33VqSsv/th9GO58ZEKf1f"
+    "HGtttt/Ef24dBOAo33bMS6NBc/8H4IlT39m28Lg9A3VLTGRta/ff+0+Uf6LBGUg0w9erT39yhuqXI79hi93D//8nFfh68vN8"
+    "zbpJyQKePf7qa1OgmC6JCtVjmnh44JAErm729b4FFPLfIz17v57PprWn/8DdRP8zEr3/6Alc9qGvzR/95AQ5iDla0001/X6q"
+    "ZLqhfbf2vf74E20h7unWL/fAYVPLfLP3wEB5/oo0Yi4a4Y6Yy1SG9Mrf/4Irfd7n9HDj7y0WO2JU8V/mV/vd9gHJfopeHHtq"
+    "mFv4MPvtRrfX//6L4L1XVvUax4MkgNQdRkdRkHUZHUZ8KoKAAJkjADHROkAjq1r3AAvUT1mg+Zn4gRHuAKjw9r2XTdpEiLNX"
+    "v/xwAj0jatymHgEZK5lhrKn/oEC3EnLT9Kht3F8lM2lRv9/ZfsDIER7mUAlJZvNzfd1LXAWpV2+B5dfRVx6Ve+sMxa+uPGH/"
+    "/+9aqDKMUUJRpwuql0jcwLvKlUvdgIQEVe8jgn4m///lFKMiWzd+szHfVqlrm7XGNKImJ64qo37S9iumcmkf9iUyRoZ/1e/v"
+    "jHs7LE4nNf/ruxVJRJK/73AOdcJORFyoThlgTpM1FhD3fwAACGQAiVVNZFsHE88JKBEumXlCFqdZQ/++MVxMn9r4j0f8QHn2"
+    "G5Ms64r78Ff9en+6WiWsOm5pxoQLpfRMNFdgNvYrpnJof9/5lXPFbOtG5wUPj3DyvA29iumcmh/1aE1haCKQR8EZojMvLj9/"
+    "utltWJGaACn+/q4wLxIJD0XdrnaGCw25qou7qvvtAPROupG7J7fxBe5O32L6/4H8TetUnP1xMgKpoZcL2V//5yZ1k/fZI4AK"
+    "vWasP467RUBGm2b7f74PTg649e3ri59/eO1JJJLzIoPNisOQll4Cn68czT/wRUxWYACR+iM6bUmoTAYzkl0tGJ+3llR2f/04"
+    "IHgKnM8Cio/+i4UCgvgtZhFARdi0vak//7gDmnabXf+rNApU/JReOEBFVH5Ufy2b1nRbX+v47uJo2FcKe/nuHgPkIZ/ff///"
+    "bhrrZRHjY87/4ACmse6ZC+t//uUNe8WTi9NfnET52aIOqzMBlI/R+gh3+x2tttt/MG/UBWqoX8Ztt5YJq1tDxvbMO4pr3+d9"
+    "AZ/7bcO1//IC/L20927j4iIyhZ4MzwYq602jL9w0AD/J7a927/6/QKOy/4q602jL6mQVC6hmTqC6rcBFRXCgArPSNoOoPTlc"
+    "qqg/+AdmsdAgCd2p1aeADMrRo3q8Fpsy8Es0YIjsmAgnviZa4aT/WwETxH8LrKkT/YILpPPUiI1/cgSj9lTWfXQz/9wDpGSF"
+    "ZsuziB2tttt//CqkriSp/wALRmiX+ZEf/rAW8zIiI26/BhAlxitXPtbG2f7p0Yt/ykDwrUC5YVKcRbd/u4SkF89eu3TwggER"
+    "5Rifhc6pVMz9A7U1gBXnf8HGL1QZwA1ym56PAAKR5CM6YWIBEQAUscW+Uifv2WAAIAkEIK9ijbVTPK/9QJQAhQVgKjWbBosi"
+    "Qn+gtVnSbdQLDJRdupP+vPZE1t8Vk3Y4ZB/JyvB5NlLeHiOzF5O7uhYAAAMCAB/4Bug4LoAh201VrA5x+bCa63FiASkeIZwE"
+    "TCtaaaa8evqMgIXXyQ19rofyPpq0Jw12mIHAvsMxqbTEXIzlG1PqzVyaTcGD0h6N3Jm2gwJhHXwTJpCtt/A2DeOcNdjKJPnq"
+    "qFX3YD2auTU3BVeIodCpvl4OsxmwoyjIceR//4HSvC6xYTf/4fhfr+Lc2j8o1JV3m5vuBkE0FSzm94FoyIKVXQ36+2MB7ILl"
+    "zew96yTZiLMSE87IXhvY7mU/sGXHfhVDdMSYkVxtTDtEiIck3S/uae52QefZX/3kEZrleH0WIAooXAlopfuRMfvvwXtFxhPR"
+    "3/vf8K651sXvggKe1TP9hBAYRAHrcAJXOc3a/ANVeFeuat33/AFgF4dLgk6v0BOS96+KYy4yYy4z/w4cACgSUgAd7JMyEury"
+    "jwTCqTKwD8AwCqFwwXrWAhTIh1qggIXJ3ptCOg//L4DgDi4hQjPAANcGVU73E36IIMzLQnJzBEJ2piu3/92niUpmODHq8AZR"
+    "JFNzKxYIIRMgQikwsAAQDtaqHVcPw1CzJSXP5q7GDs1E1GTX/3/5Pge49tydeDzJSXT+5gNnsVmSSJ/wdqSSSX9fuuDKiXGU"
+    "zrQjvpfqECzQHpFg7NDyPfsEaWqlG//2/JnR9IOrbRVW4RlUzvYsU9JcUEz91X7EEwT3QJoCsIvQrMi4q+f/YGZXiHfXkrff"
+    "h+EKZ55Rbu4vudW8csFGB5D/wDQX6AItNNb44/l//nGNSNGGnd6E9/4CYAmVlaUJsT//rRUQ8zuD7Hx/6AHjNXEaTcww9exh"
+    "QnE6C/IsABJmyahL7eT84Bzfead1n8ASu05k2txHndmQ2pt9+WZI3v+BfEdf7+0K74MCiS+LJsu1WxRtv+2aeLp2Rxv77Xts"
+    "P2lpJffgZ4ftt/Cjfe3sdrbbbfyl/f6C5Z+v/x///7+l9ar9b1QQdMm4aAB/k9te7dBQDn0M7EMCm7XwJXOidXD34F+Xtl52"
+    "6CyyR6sbK/b5QMtm4WZTNL/997asSpOlBuMDJKVI9/VBqd9xUU8AC5uVTB8xj/sE1etN7qxOGyoUmvl/gFgow8N+4j7/f/UY"
+    "673vaV9d38p4F6QPqO7a7N133f//GU5G0+1qcZZHv99///4JmVshlT2X/o21920viuuiHzIyJMMPVUo/0AAXKIQ/HfAlkbJ3"
+    "ZGR/+v8BXcic31aoX9pBHefi9fJvN4P+o41tttv/iv/ox9NkCJMYiKQof/3h8w5LY/z/1rUPFfrJMgLfXOXf//L/ZtX1N+GG"
+    "BMQ6VKRhM55vv+AA980D2VCxO+qc7U5Pq61X9Q3AAuQDeFIrdkGE70aOEKyUKql4QafeuoeFLjf2mOo6RqcavV/+xrg/iM2D"
+    "6SBbhU9QYcAsdXOW//+glztXT6uvPPEWjch1/2vzjpzTV33wNernK+/7gdztTq09X//8O/1juSdla0001+aN4kP0oAHAGfbQ"
+    "ZtZWDf79pgevrIjJlBf6A0OrYnEtUMt782yUkjeQmN//+C/sNVeWx1Xn66v6//8///9/PPr+H5QFBS/gAfcZkNIpBFv99AgU"
+    "b0mz2ncBqTszuR5/330JJYjpzxwte//wCoWiVaXWABMDJL3zcbkG+/+MwK1d3S2kn+Dj+zPlxjVKmii4rH//1Hm5vZwBcmZu"
+    "xtTWFID///0y4/XX4HW917V4Vv/frVYKSr4eOjq3/1SAwq/Lbo//dwQZl/WfXfhLt3/6QGFXltyx++/4ACT9E3TakytMZcZM"
+    "ZcZ+FfrKtVQvzL+s+u/HRbtuqsBReS3q3+xHVKErOjP9vevzbCkH4/+cZf3n1nLsW7bqtAcq8t8m/3u/w1+ilXwNgqU4lQnN"
+    "MLb7v4YnX1/339ahD/9BMnGBRNitR6mFKwYfr//hYgcG9YDqXytidIiaOmhE0dNfkQEDxxDpjuoAFszAkttRUQV/7/AUc8SR"
+    "K6Tx/+DvhocLONL5uER/3rO1dk1Rjp/+6GNF2yjc19df/Ao1yETfZpf/7vCrOUy39ZYKSr4dBIuCl9mC64W8C72Uipf+9d8i"
+    "nOnHvpeF0qXSNzAu9lIqX/vXUPVQrVUfinOuPfS8H5Kl0/uYDb2XIql/z/FOdaPfS5B+SpdP7mBd7KRUv/eqw4+38bA0bJyx"
+    "7GSq11/5FVtwFwh5p/Xqy313OXiT3ntKnf8C4cCSLkUvZh6V+/+/QeTdK8Qhpf7rmR2Rkzbgx2tttt+ZBEF0CQy/+1fTCn4A"
+    "CFSzkg1ov6rhP3w96/wP9LDcbaRcxXsfKXLvYanKeDZmnGH1efWGkRm3/17/8RH/QgoBItZHGLrP6YI3U4eNb1fDww+tV1hA"
+    "AwKA/DeoAER+St6WC/r2mYteVgxvxxrbbbfhNQ/H/a/68MoTg/T8ADD6a1pv/oEyGCXCbSzufX/2MCcZct5xj08Rdus+/i0U"
+    "1eXzATihUsH6sJEo/7oxPAlnqJO51LyAQPh+F+35vRd///GEMzy3NuXn+ABEXyUzaTwMji9WXSZSa9++tV90xA0+AQ+ucq//"
+    "/AVTtXTV14BL3c16/Q6uXRg4r10Enz2qfUSgfAWIl7SW3//hhAdvORP2uOmaMbjBzxla0001/AMAVwXVUcq+4gX1x78gbG++"
+    "hxK0f79Q2PBIKqWwCx65y3//0Eudq6fV1XgCbvD6BNAmaM0gzbqs+XJ/aqQ4JJ6vcgM6locKu38AGFZNsBkXa5BfgOC/0e/b"
+    "aVLB3Wi4zJDbsjUVkVcTovvOHy++vAMA/DDn/BbiKY+m/9FrI5iVU6h5WmMuMmMuM/GMRD4dMnvaYZZAi9rYqv9G6n/r9htc"
+    "EhPRlLPV9V6UkNK33wP+r4DRu2LWlZDG7vqutV/YkKjq3b6qwGFXlvln77+W39r3++B3GX6w2FP/wP3fi5XdgKAW75SV4HP/"
+    "/s1nY3tdiQs/sAIrsRSHNr3x5osBmL+hNzcv64B6iSaGhHABCaa1r3+HkMxZZoB0YgNt0A1Vhm/X+p3wYEp8yB6803387TiZ"
+    "Eg6h4hnASWz8e7X5Ff+mpVNi/1IT/VeAEWFR+NL6SeDEfvCgPhj/UfvvHalEkl/6P+cEb5rYTs8lrOxT9dY7DhA/r+L9/5gD"
+    "ji0jOEhF/O3AmTXujlP3SPevPr7pbHTt/1P+vhgEP0L/Aa9JyYyRRZaOxmkYecpQQNEhhibSwmov/+mn/1qjVkquEfwJpXIj"
+    "9CrAFHR8J7J0vhiDjp86vpRbNDZeic60e+lzYkWUiAcZd2CiKadpXewDVW5Dpdk/quaIjMBiLtAn4yR93HGtttt/1DAIglxV"
+    "HJi7cqet8AIt33V9/2mSH2eciLb/+gwBhtj1mxJet4BuVD/82n8wL8HciuY0HY7jZ9z5/WT1qVQvfVcAwYdQBap4dQGi+Sza"
+    "T/6yG09fI9Q3ap0aU/T6+trZXwo5BXM/33w1zr1d87wbXDsZ1h6vaw5DziZ8TCt/7wDs1cmpufMMAaHUEeAfGq2lNeHolmcO"
+    "d1Y9+unEDUDFEHdtw/iJfpLb/RDfNrbVZl/9YLEh0WW3R//fofETuxVQdVYKCjVQUPCOgAXX19X0jL1pm2YYUXEtt8Ajy9tP"
+    "duFXWTaMv3DWO1tttv+GGqiuqoQXWAB17FPV6e/fwH8r2mTb177iW2+AKvxWr09724D+V7WTb16qUi/0IB+IshHqp2aMUVl2"
+    "BFNzstYKTRD/d7zLkNF++3T88DEvm93t+qv3HM13Ris4hnXEg/U2sTf8e7EfBamM6Ur9X/Rq0JuS2iIzis///57hGS5QXQN8"
+    "EfgAX5NLbkUf/wCUm/OOXi/zT8HnLHm+v/e+Qcd0ritH2/8JEXTON/07j4iLMB98m//4DYk0zImbT/++4CLi/L3ipFN//Fa0"
+    "001+HWf+g0Prz+Iuz/5/6oJBIJBf/zdlEII44CuflHmY/n8wAU9E3OJn7+oCJEsqKcxyiw//+BGKV0nl1P3u41mHXKetS1/1"
+    "huzbMritSXg8jMdM8SFSXpW00HoHr/3WuqoKlADz7Q41jHNv/BLnanJ9XQLT5ef8Ae9XHJ1//8CXO1OT6uhUIgupAP9B1GR1"
+    "GQdRkdRn/4BsMWBMKYACNKc/a1TvL0tbPawCN01stN30ocZSOpu1QMkn/IUR766oBNkL9TP+KQBYoT+I/m93sU9QfkIp/7u8"
+    "/mbdTpf9rBNGbzO3Lf/3n33/+/e/5k9FwYWE3cl/GjGSEaA6XAI3TWyabsKF3udqzn+/q7TjdmcL8w73EE5HnvdsJLv/3DrI"
+    "DmYvzR/+8AZHb5H3jaCXrBu+0LeXzmAH3xZBL+cN5oW3gl7/Vck971jrP6J3U5Md1uC/dDw0z/9w8OCbt5Oqnq13eLMRjY9X"
+    "gWuwIGSE/0/5umtk03QBUeO6qXDc/F9ABgKXBahkX8P77Dfhl5t4hHu+QDYFINWY9VTfYtO/YF0REG3cltU9+gww49soyr06"
+    "qNQVfHCOu37Z1WgveT00X0v+0l4MDX96FMBMZVcQEqYH/f3gJJil3Qer24nfjbnKktf9SSSS/n+ouvT4ERutJ65q/of4OCV4"
+    "e9wGsS3RB1ckdhqruZfBP/1leW+WefUMzO+Mzf1/MNqeu13Gkbb83uzq22sItK7y5lMe/1FQPSw+gvBFA79EXpP/dwg/X1n/"
+    "feoaM6VXPpwj/7/K9ORpqxaNjQfqmOWszxre9rqerytaKS0HUUgqC6kDJQSCQSC8VCS9bbbb/CDFD8KfgKl3iMDT8nv92/wH"
+    "EF3blGXZWbwABh+q+qhhX4aFQvJUufzVA29lyKov+f/RBgBhtGTI9XgNvZci1L/towHwRZIoKoYrShgK0gqjuWdoi//DXO5Y"
+    "+LRwkdHj1Kz/+sCEr3Ni/X+UzrCa0zWrZT97rAHyKsUss5v//7/CvRojTUF0qXSNzYXsuRVF/zm49E52s98AoGijIZusOaAf"
+    "fATkxzOJkyqL/99YQDAAh+N4AYbmTI9XuquC8drbbbf6hFf/Qn7X5Rae66hoIj6QFOAPfk82T3twO3rMkZ6veC56ZQ+SavAS"
+    "zF2XzaRE/3A2yQ4R2dzdrzYXhId5IgqJs0IkXk6n2tVI0TP4Pxr1cVM0lG9jeBuLiazft/vYAAAQDNj2QfVagCqj/63Xkde2"
+    "mGvtwq609GXNxLbcwCPL217twq602jKvgLRwEIpCEsQCUrayJd/AIUbM9ahlK2QGrXd4eiLnYioOoCW5wEea4ZRO/c96FnpS"
+    "NkpMy/9cez6sKbLP/4rWmmmv4BgAQ+gjrQtsPhpwGntzKYl0JaYEKzg21B/ghJESSa/P//b/wBmKZom091XdjwHX/0X40IpU"
+    "NzwsucYvPwoP1quRR8BhwDx1c5P//hVO1dNXX/4AF+WTzy8S+/4ABn8t19LyCOifa94v/qrDB4FB0o3MRD1+fimMuMmMuM/E"
+    "EEEETDIVVPreBbLD+Ic37+5WbiSmYRP2htL0083h9/7dwq6rEi/f/8CXfFh0w2bN3uN90wXX8S52iIgEUeD1eDkFgsOmM2n6"
+    "uYi8+2/sI37/gEvaYOa9RKEDP++ZK//9rvB6ucrr/oJc7U5Pq6tw+Hklz63v97//9w/8/9VDj2a4Q4j/T0Lwce/4AYrbNmer"
+    "xZAZE8f9VhfF/htt//Ukkkv4//kgp+YCAjcr1qgGZcnPIyzABcOEe59SKer3VrwJbaJCr/aiK6oLfQmBQJzJ0OP3+BanltyP"
+    "XunpWyA1a7sNtb5ef//AByGlmUsF0suNU80xP//2f4TL1llvbEXh8QwFVJnQkS4BHwvrdR70bpgA1mhUrkZzdoggDrJ2t7+q"
+    "AUU8t8jPXuAbiF0/S1EF/+5D+Jhm10X6auob2N0NNGBf+23jN7sJum7+wUI75z0W1V/bQM3nkyp7b3V4DgAf/gIykZkR6vE9"
+    "BFKhufxKC6f8+mtrWw547W222/ahS0cA4fyQr2qgA5ccZGR6vf4cHs8AFMf6LoR4Dd9+gBGrZTe7b7/ewmCPGXrneP9+2pTX"
+    "Hpw1YiX1se/UVhegHGtttt///yVAn9YACcRuFUT440rAAsaYmnerh4K/usM6jL1t0uSj/vX2lWX0Ci8+5Ltbu/3/v5CIlV2j"
+    "6nt16/r/wQYF+K252+Pr8662ONkhwbjhl9AdIqHrm/2wBHmflWeqR//5gXHCW55WfXdyQ22npSCtWjjIvKry7+rxjG0b2cKZ"
+    "rjtkO/rEmanugj/vgNhFLMae7C56Fa0001//VQXVUIP1A9+K1elqvbgP0r2tNvXg63D9t8ALvYp6vT37+A/SvZMm3r1UoPTB"
+    "lEn1//64d8ABumTCRcjjlY/5zkj1CVlWBStMZcZMZcZ/lqhNURhTNY7uaXQAF6AvsyjNhe09a9ZROmf+u7CZ3tmZnU/XRbF5"
+    "YPYIibRXfZ9wMCQj5ZNxEbc33/rHpGMnsbe7+gchSSI3f/W2jRpk2Lbuve0gxfiqvr5qYv3gnqtSJVkxEukUA8dXHE//+Eud"
+    "qcn1deYm+g/Lvjgv63Lv/3gVTtXJq68J/6hvrw+q16IMwAseuOW//+glztXT6uv1DfwAM77fve10da5FrEH/9f//GC7AA4oD"
+    "6pRKm2L/f0dJGYDGcBRuY41JJJL/kQCP9F9QM23GRB5nnv/4PEYzbYj3mvBx6OWgh9bgLlQyK5K6jd//4PRiD7sRE/neX7//"
+    "rw//oT5MmZyFflAvQflES/Ik2ew6rBi1jGrgIcOgtkAKBVq3MVz1+WEcXPtmfxUn/7/QX4UjGZXV9d3YccSfj/Q3z5/9DFX6"
+    "svs1N0//+4MwJisivTUr/90C/WKAC1Xw8d4ubzKNmDNfaalrXtNfAUgIKYgbf2vf74pFu3oqsBhU8s+WfvuQ8ca2223/X6qF"
+    "aqhfBie+7/PBq43eeyuAwqeKrYlX33+EJ76/++8CgnN3nv3AYVPFV8Sr77/6/RfHMw0pn9UI9md31DX/B1MgiC6JAyca6qAB"
+    "FSKOCgAGP3c6xq0LiJsS7RghHImQUqXSNzcOBt7Lkql/wa53LHxB4Fy9m1NqbQHhpq96Il0N/0CUO+MMmrbj39sQYn4lccmv"
+    "1vuHa22238ADnVasNUMgO9aLw1Iz/7VkQvfhpp9/3+qx5lS2P/XPvbbb2/YYFNTKJlkJ/wpzrR76QABg+lXcm1+DhmMpdON4"
+    "1e5Y+LjEP/Sxj/tPIcltG0HUH54AE/8+tYBhQfHFCuqgAs8taEvbFN2gMUyB+5kUpvfAaVnhJ0FmLffuGNenYaE5cVXEAAiM"
+    "GrgOy+zc/xApP/+w+DxYCPSv8X+L5KZtL4Qf5qVl2nKb/4A0MZ3FyKp7AlHG5yjzrvY2/+gYqFj1j16Dd3YPGUz6EZmjf4Dl"
+    "xobKy6vcDqsJuTkcj43//6/N+DV/4j/g/VcLakJrYcMrWmmmv/EE+AUb+8Cq0kZ6EuvfB6efQRl5P+IDR0unUW5ROgA2uNDZ"
+    "SOerygAIt2hxuBf1xJdbFoQ09CgcSRId1ADbL+Q2ruD9rEhGydCm4+ygAYAolNk0HUAHbEWtLY5IL/64fEkJfVTu3//qGo/0"
+    "T67gfwFBR5uuJD83v+wREw2LL+m3/8Do39Pcz4j35+0Glg2ai76sq+iIfRQXVUqAMI4XLjKn13Tpmonr/QL5XrTe6gY7soBz"
+    "AI8vbXnbhV1ptGVYNEghWD+vbt1vM9/f9XEIG5F1YH2w6hiy9uGyFLP5wjbFtNDm+/AsDOzMzN43q/X/mHdNm219/ytwwD9h"
+    "H+G7nMhdB1f1phgHu/FdU000///+gYFBxdPqsZSwmEwmF/hT/0EutyRZkZoOrYnaOsAq1/+/mCgoCawxcccQNbjSa7QMp+sK"
+    "oXn8g1Pckcl38+0OLHtTZD9XgRBp1K9RJTd9sRrxb65yULf//rAhthMafJh4XtJKCxP9rP3wf9SSSS/HAIKtQqyegJJ4iONF"
+    "/rY8AAgYAHgGhrs4uVagkety5/7yD05XVVX/zgC3nLP89AXc3P6k/9EMAD/oFJQHpj6jeONz3x6rrAMA/9G66/AAtgxkTmYj"
+    "EkqF36sBCAB2/GkAFEpsjQdQuHiFC5dV+i78CCbMIjS7TgX/8GO1tttv/9vYhoQX7j34ceDSJDPeswGIAvw0K4T1u+BC7/7B"
+    "lrNiyrtf47NkRmg6vAK5p91z1Knlvlv3wff1HgqiKoqpUe+t93ufAA8l+067ojv/PQFJ1fSEId+jf4Grm735XAYVPLfFj99/"
+    "mVvs+/910W0d0y/vh0W7fVWtKeW+Rnr3VhC0IQDAIQIBrm+ExBVNp+7oCgD+FQ3w/Dlc/UAMypmier2uQ49RPDjW222/gxF5"
+    "f0Uv+18LpUukbmX+wjrWPE+wrFOBt7Loql/wAj6a9ab8wJBFJgLAD3mK6YpNEf8DF+p3m8AMrSUlq8eAAYg/JUun9zFiAIj/"
+    "/Vb6ggzA29lyKpf8FOdce+l4IUWHJC2TdvUzFUoOHTdB1iOPwDc/4LkCALoPr8AW5tMkN1BTozx1o27hVWmmmvagHU90fjD+"
+    "CDHx4TiYmfgBTmjF2Vp6uO1ixAWGhhAGS0KeK+6WDxRC0lVN7eCFu59ealabvIyyeMzu40nd+2mMhZWrvKJ3dmB/mG9+wegP"
+    "O+/13vwEzSYHaiqdC/f7SKxLXxaun/6qqLEUKg+8F+Xtr3bgey9abbUHcS2wGhOw/yufTnDfvAKhn3LSOafir/uCVsu89Wso"
+    "P/2iIrNoBk3he/+AXX7YBGX8VQewWSvWymm/u2JaOgiV3ZysFj3/8YY9zN5dcnFq/4M9PKmmmn/f64gDU4Zfr/wAEaU5+1qn"
+    "I69smNfbpfh734AuXNWjaAz/8AFOS6bXT//cJreuaqf/9kpfDepQK79oyNknaY2X73AwdFEGRCGn0AALOMLFggBvfi66w9/c"
+    "ACbRY1ZFXaBDHY5kR08P1e5ZyYt45WRe0HrtUckWlG/20SNGFfxEJit3q9kny3pXgcHrTnHN/vW3Rtg+lV97AM0tWOS6V3/+"
+    "EWGxYkVhNmP/Bhzp/huKPA/kZl5On7r9UyRxh/rZngAB/ADXKbvRYgIjX/4BQHIO1XwAFcl02tqfhQnKVo5siQ//7ekgcLFN"
+    "D3/7qkkkl/wHGY4Ol9GpWD5rzQ97/IEAug7iAFiuxBjam+1mQkI6Y1PX3IEAlZeAIdtNVa3YrXVYoNdKAKakNHrK+euD05XK"
+    "qrDT/gB705e+fyB3O1OrT3CFPzYmu93T5/r+1FXitDMAX4qR0lZ3Km8bbwpqRMWrwAW9c5b//6Cqdq6auuIBo2na2t4dXG1Z"
+    "RvrcQIBdla/wgOAR/iBcJNVE96Iq//B7WcijChAS/n6MQEG0yZHq9BIyFQ3OHHug0T3W222/2L4/0Fy9PdhH3//wQJawAzKR"
+    "mhLq9xV+YmNgEIAmSAEUo4Tsqm7UA0BprL3LSYS76UOM7Kpu0HjOoibiR8e/v//GEarXt+B4f/4gFVYP65S7zkDWu+vR80E/"
+    "/B1GzhuVXXa5gAd4MAiDDzEQvJn4ACNJNP2mkjBa8P9LnbHSbiaT+bprZab4mcGTIVt1//jtNGRsndkZF/6cgzm4l0BSvckL"
+    "MjMg6sBoepYvzOK//0l/JmJHa7sdrbbbf8P3UhhQyvAeNSSrvNyF/7RMzGWeGhETfdJdZendEML/5wBx2cnwGnTEJj6q443P"
+    "2RQkm0jY9Xvww/+gsWPCxmTOWAAIBH1/WH+hJ/15AB0sk2smfav64rUqhDBvEATexXTOTQR/wFFK+4SjP+8LpUukbmEEAlI8"
+    "QzgImA0criYJz7u+51bq1/68dil2YLrj7Pla00018f6qCssk8w/AAglqMtk0bA29lyKov+DXO5Y+LwulS6RuYAUf4nmR5Vqe"
+    "C/OGuK265VVtIbUjLvSXv9CfP6QnO0H38/4/0Ix5DESmezMRWsLX4U//f7/ERzrCwtLJr8Cr6/Vx/6CUggDBEHwLZGsjnCJ/"
+    "+rMc+K+Vd77/v8dixbHeituozH7AgYYceBa8PPcAAgNnSKjNIL34BSy996RHokf/+BAKoFmq3JyHPLCnWsEu0LuKFVMZcZMZ"
+    "cZ/GEVhw6E4I91RgKnKfv6phMexJraAQCPhE5Wh2KienJmgAF2r+sftK9/94GH2H1rqvIVYk+nbFPe5PSP+jnYCdkdZ+4a3I"
+    "wB/5e2ve3Cr2m0ZQALgSmmM+J6KJvloY35jGNhGv/7Zowb9/KY6OcF/9HxLbaJDL+sqVHL3g9wqMFWsRoRDAUrIUQPCUwCSw"
+    "ZFTC61f9mAFmbDyyYuuf//8AI8vbXu3CrrTaMubiW2k35Cq8fP3Ghi39/HJql+Z+8DBtEOqjv034FV+XBbXPf1Yw//4TLAAE"
+    "Cr9V//zrjgDRBNHE0IJo4mv/H/0MCUsQBKYARfbkma11UPa2rA83kFec1W5yACeFkYPR48QzgImckDisXjfgm3A64hq1rV/f"
+    "16ZDVHU+nCbv1ty2oMW63+//oHDbc+XiU679ZjpXvf0pT1e9f1/w/0JGqH8gAzSNMjRiVUWHXrAhqvgsMZg6bUJVST96q0RG"
+    "ZAMIu10QBL2sXno5C6AFhzA9fLf8eAtO1dVdQQwm/9fP4Ka2223/D6rXVUGSgBY6uOW//+ga52p1Hp77cvP4BD1ccXf//IJc"
+    "7U6fV1F/D/0tceIQ6Ez6/9TJOh4A/uYFUGUwAAAAAUGaOBb4IAh///////////////rBCEfwnzeAD533KbqX2EI9Vbbbb8mW"
+    "M5AlD772YFz5RZTQYp58J82Ai6bOqMjW8J3O+EctZCFDLUhnVSofE2/+Uv4T4RE5ojhDcPjDBpTI2GXmYX0BE0X8Pn/LFMnF"
+    "NnG+Uv/+gVhncz5WYqRgWhC/2oHIR4zm8Ld/CnhTwmsEIRFYBJ0UdZvcyAj+9/l/4T/xfCX+YQrik3X3REe7eUuBC6podnk4"
+    "snLHDzC98X4bkp0cGQ/N4I948vKkbIFFWYZebhHpSF7kOFVJqRNZvlghCP6gAAAAAUGaVAS6wQBA9W222/+cWrbbbf//OOVp"
+    "ppr/nq0001/z1aaaa//56pppp/89U000/+eqaaaf//PVJJJL/nqkkkl/z1SSSS//5yq2223//6wQBA9W222/Xnq2223689Wm"
+    "mmviF/ORWmmmvXnqmmmn/z1TTTT/56pppp+vPVJJJL/nqkkkl/z1SSSS8vmzEoATyCmkWP66fqBszhVWy63X684UVpppr/nq"
+    "0001/z1aaaa/yHCurRtFU7f+cKLGnGn/z1TTTT/56pppp+vPVJJJL/nqkkkl/z1SSSS8vkwtQrKcsd+R0G97Y/PyeerTTTX/"
+    "PVpppr/nq0001689U000/iEVfnIqaaafrz1SSSS/56pJJJf89Ukkkvfnq2223682PNCICY+xRP9fBhOFeirFW235POElaaaa"
+    "+JQTN35woqaaaf/OVU000/+cSqaaafk84hUkkkvXnEq22237CESFaq2223/5POElaaaa/5vCPAokwtgEAjH3gQt0bLrDpLWf"
+    "aQZK1joO9kBwreTP/4+eAAU+T2hDAo/89U000/iF/PVNNNP156pJJJf89Ukkkv+eqSSSXl8258q3k/f/85Vbbbb9ecytNNNe"
+    "ieYEAEAOwQ+4obcYA/tzX1AP3P+T+hH+Xz1SSSS/56pJJJf849RaFoWkvXnP0Vbbbf/PUVbbbfp+JOYKcCTlfUvnKrbbbf/P"
+    "Vtttv35yK00018Qi/nq0001685FTTTT/56pppp/85VTTTT9DP35yKkkkl/z1SSSS9ecqtttt+/PVtttv/nq2223689W222/X"
+    "nIrTTTX/PVpppr/nq00015PPVNNNP156pJJJf89Ukkkv+eqSSSXl83DTNgl5GPtL9ecKqKsVYqxV+vOElaaaa/56tNNNf89W"
+    "mmmvfnFqmmmn/ziFTTTT9eeqSSSX/PVJJJL50ERJ63OZW222/+erbbbfrxQ4SfjRNB39tGkE/u5twqE0uz2K978AUV+WXzvn"
+    "Krbbbf/PVtttv/nq2223689WmmmviF/PVppprz+eqSSSX/PVJJJL2M/X4KCaERfYgQj3zvwR8Bnr9In9j4VUFNbbbb/6Farx"
+    "YrAX2v0C6tStYSWp/Tpv8Ls4urRta/+UVgKtqtBE56As+bgI6+SU24em+XhJT47FP/i/DZTWEq1l9PknbnlOFVJqVL0PxfqS"
+    "SSX/FhLgIXrGzRLOjRPL/oeQJqVLbbbfwAAAAAFBmmBnT8EAQ/OJVtsu1/9Dq/EnOvnXnXnX///RK///////OdSbk3/+gUAg"
+    "Q3uwx76oCACD+vQSqEPL4be/XKcJlSXRDrdflCXVpppry+cR0mk0ms32X3/QqpPCengVf4Ai3pJvz9+tQg/sZ4ZQPeDPI+dE"
+    "bf6Dr/VxnpiK/79LgMU9tzyDwAn+xap6d5zhPrbbbfloEAQqwIAKFqT0apfXr82HHqAB7zSk9Lwf/MMK+5gPMMP/DioCL9oO"
+    "o4yaFy4/ngsyZ+niQzonrUIeCDFeKpbu7/z1bbbb8vgihHgXK/5ZPXAgASEL8RAJ9vNLaXvHoniikxxG4nb6/jPF4cvwfKSg"
+    "hOUi3A0HCatttt+XgwXq9GqSwIAKEepfObpdbt+vP62223+4HD+/Qyoz1qQv/qbhhBtw4DgzR+vOVS62XfxPrVj49apJJJeU"
+    "v/ghCIoKSHQQjKDyEktACfHZvJb5B/ubv7q3578J+QsBfflF/g6X/6H8FEg/aoOuE7BXHquRTFQ9BFSpbb/+ghWvUFE686+H"
+    "Isx8vxZIqGAp3I2IpoRu6zf4Xiy5fjgP9HTPl8PpMfxZKOAEPW9Jn7hYFIbSs7/9gvX8o1/tPwQhEslbmT2DQGyCpUof1SSS"
+    "S/4IwlgRa93g9yvkZD7tov0UqfmJgmEyK5OlHwmTjFLbbbfzf/+gSjIAEL2na2v+vadradYAAAABQZqAV1YGAGHf4EEEP5wj"
+    "0UUKKFFCq////5woqaaaf/PVNNNP//rX56pJJJfsCACDv7+9H7v/6AwgxFEgPIQVMg8hBUyDyEFTIBjFNRog9dv7+9+SnyZ1"
+    "9eerTTTXvz+pppp/89U000/d6939/eCPm+u/vXu9e1gMkEICIhHHyEFTIDlSDxUHVDEt0QSdkQuUIKcqBJYg5zf349BMTxW2"
+    "22/XnCitNNNf89WmmmvXKcKlaU0JbaOTXkvQUrvXu/v7wQ1rrv768fdgX6DDZCC15B5CCpkElCCnUAnm1yBB39+dv77sCACC"
+    "cQvf39/etd9+CeYCAVxy6wVl79ArrfLwSezoSxBzkA76ZJAPVd6P1+iVJ612BABBPetSG+Hj+EPVm+UlL3rjfgm9+xW222/3"
+    "ovX5yVLsu/XlyAaHoN5MMP/8GEBAdjI5cXBYMESDq00019Phky1J61+eqSSSX/PVJJJL9/etSGyCYB/oTlzbRvrorv1Xf779"
+    "auwMAKhEASh/w8vrxgRsvyO/2KCJBgTlJhkmquP69SpXrVX99esrNr9VGvj+UegINcdmoGM1VXuz/tz1eAnXtx5W222/1Bgg"
+    "n1+gpXYGAECCvd/f+ccalNNFNVeQJIeLqPS10txlxn9/fdgQAQIR1VAkHEnS22238JoJL/u/3v+/Prl1v9/fJ69XrXf3969+"
+    "CPjSY6k8I4DyEFTIPIQVMDcH+88IDCaDmeqzMXLEFOv361398RfXghqkx+L84nrbbbfvx4odDn2QjB5EBpkAS3PURkH/JhJQ"
+    "BRw/00dA+O3Wa+cvW222/+f1tttvx3gmhumfw3TOpDYxG3w4cqREyZkDL9xgWZM6tttt/L/0ovIBnzj9ceuLtt/FoIjVVfmC"
+    "XACKVbMWVvvi+AR9NetPDKbOBjKb+CiMhMh4COm6lsU9DzdPrGGmnjrL9cv1r83gDKZmifXvi/2ABxmRSTHi8n97OxFdi6Wl"
+    "yghCK1+bwAN51urX9/vgj4Fuqm70/v9/fhwtYAEt6FfOrRcpNk1L/iSI6Z/wzV8TH5Hv+r3TE8EIRwScEvh1uANldYn/u3ep"
+    "wn0Q6Kttv4TQUAC3RGchPn4AIdfX1OVqaPAp19fU6rvTcY79AU6+vqc9ltFpvQAAAAFBmqBnl//8EAQ//6zj+iihRQopr///"
+    "////////nCCpJJJfV+vf9a9+KxQACmKAAWxQAC2AFvHTTAle7ggCEf56pJJJeTxWPmIaWjRGElpYABbFAALf1wnJ5xam1q14"
+    "nzjFSSSS8nisUAAtigAFMB/gAUtAEX96NYAR+P89UkkkvJ4rZAEIylgAFMUAApgE59oEj6p+E/FZ4AHFAAJYoABDBwkpHwmL"
+    "1bbbb8w/OpitNNNfN/xD6BAOA1YJM/8pAHiIyZhpCMTWYs+B3dPzF/BCEfJg8/AjYT1SfpYXgQAQbj9Ne6Z/cEIVIxzByIjJ"
+    "mL8VigAEMUAAhg0LMoCXTUCT07QSnCfS6Ktu1+Ts9RuWrlq5auX6CWblS00015Qlr0xkxkxlxny+cytttt+h85PVtttv5vAf"
+    "/QfCE8AP/CfisUAApgPMQ0tB0xhJaWAAU/XKThI4R6KKFFNNeM85lbbbb9+KGRQACWKAAUxIABLIAlP8gld379ak89WmmmvE"
+    "eeqSSSXk8VngAEsGAkZSwACWKAAS17VYWZwmUEuirt/8FASwAZ9W+sVuuAKdlakbj/4Ai6vr+qrxfhv2AhPOarr9A2CpxeVq"
+    "ffrzCsAasm6lhiTyI8RfN8vEQeN9wK/QPV3tWI7+SwQhEWVhYdtG8HDoctAgCBiYAeJ1ERjD3UCFt3JWZcXm4BHv5P4D+3dz"
+    "un5uCYTIrkDqIz1R8JqJktttt/8E4SigAFMALW58xgw/+YgTtS6JWYL94ATMs0KXpKUpmwACH/67AAAAAUGawGfggCB6tttt"
+    "/89W222//+tYRhEL160001/BAEPzhBWk2jb/1r////89Ukkkv+eqSSSX/6AgThEfRaFoRNHTXyfuBB///5P7/BCETBKtfnq2"
+    "223+wIAIJvWpfPVJJJL/nqkkkl789W222/+erbbbf/PVtttv6+/z1bbbb8Z56pJJJf8/qSSSXv1789W222/fnq2223/z1bbb"
+    "b8/oaVJPOMVJJJL35xak0lpRevOKVtttv14J+r3gCevYWT/Xl+erbbbf/P622234z0Xr85Fbbbb/56tttt+vC+DPq3qxHEps"
+    "mg6ornWJQfq2223//zhPoqxV//OElbbbb8g+EzcYpaaaa+uEQc98dlCQBD7gLb2gihAn1RHQdi9HCfRaFKFKFK8nnCStttt+"
+    "/l89Wmmmvr/XCf9OEDUqQE4GBLXeTxo8Br3ifPVtttv14X6rwBLdMgSf61bbbb//6F9YSiXAAVpppr0EuWtNNNebzhJUkkkv"
+    "fotfnP0uttt/84hW222/+cI9bbbb9ecJK2223689W222/Xnq000179amEak89W222/Xm7v+SoSOE+iihRTTXi6BZOIrSSFr9"
+    "DQgcTKKuKsVf/OElbbbb9ebGmUAvjS30nV7vxHn9TTTT/5/U000/Eeerbbbf/PVtttv/nq2223/wUcB5iWWAf4bVZmPmTlkm"
+    "7uzB/4YBBaXB42WW4rbbbfwwpqf/8AA7mn3Jd/1fiyYSzsjR62GESW8Q5/GZOyndg+Yllvi+DzEssDzEstgkxRaAeYllvi+B"
+    "7jF62CFmT7nbSmRHWofMSy03t5D+EC4r3b6uEZZJutNNNf8FBMYkcsMScssYk5Yh75X4vjEnLA9iWWwC7duQnE//kFbNl1iV"
+    "98XyQmykMw+ZOWweZHLA8yOW+L4j3n4gie8wUKf+WPmJZYHmJZauwQhEXweYvLA9iWWweZOWNGnu+Cjg8xLLG3NYBiLlmU3Q"
+    "+YlluwhKKHVJJJL/goJgHmKPQAZVfkTGd/3bC1usEi6czs318foFp/A0ddJL/iyYDzF5YHmJZbB5iWWB5iWWvwQhEXzFtuB7"
+    "MX9TBky2qCL/EQq/BZ4ey2A8xLLBDXdW8weoMfMJZYHLCeWiwAAAAAFBmuBX0BABB1r3WvdZ9Z9br/ghCK9+varhD//9e//W"
+    "v/17///85crbbbfyev/k1X8E5uAA6fGTvOQEL36THF2WTFM+zloOKaRTfSLrXtL5Dw9lvrORW222/Xn9m1r/69fnqmmmn79a"
+    "r16TzlUut0u/utE7rP6222369ak8+rTTTXr16I89S62Xa/+L8JO1/Ov82ACxk+7pGxgV9xMAnVp7qSPu19a9XrX5yraNrt83"
+    "Icf0DqpYdVLcf/foIdVgSgwcI1IaGZYtHTXqgQBA4rrbbbf6xAiv4NQ7/Ql5ayfrwhghBCKpg+9euXwn4Qb5LfVcIL1+vSBD"
+    "VUkkkvdZ/W222/1gkwxlv3SgjoMtP7wQhEE+AHwyPuHlIby+BCIaddHVQtQxkTkaPR/v69erxUb/bxRg1DiJV/r2PYTC4V6I"
+    "TQhNCE0cmvm8PwAIIEASgA9lo4MltfXZAO3XLVucv+D0mXBN7WQHGRwlM2F5ThPKI6SYotEmL7r60FOv/16vWr8mRSQlyeuB"
+    "ABBCvuKADqXIbZaO+XoJZzzCmOTf9L7Cf78RugJqNojp5ei9fonV6KZKrXLrPVs+t1/8OawAXbJpDIEiN6622Xa/+erZ+3X/"
+    "ziVFW2XT0z7CUSvRCaEJoQmjk186CSxyCa1+gpV4QBacKnSwjGmEsl+es8ENG/lrPdLX8Yo8tfnCStttt/8/pdbv/5/W63f/"
+    "r1+vRXrXWerbbbf6178uU/CDg4fXnq22237Hy1bbbb/56tSmmvMYoeH/Gj1+uuQpjJjJjLjP/QSr9eutCa8EIdQjuteov9YI"
+    "QiJ57jQH7QZ/36mT9e/PytNNNeJ9euuzeH48Yd4AG3UyUBTh77TMAUrabQdR4ATq22238QovfLgo4HCeeDhPPPAG/KZk1DA/"
+    "lxxwn9TvwxwSTH5m1XYHXJiLmlYtxFapgdEVparbbbf/F8ERFjUA6IrS0oMB0RWlgdEVpb4vgIe8jkp4ZRkm12sCmuryHEDK"
+    "qbVeV7hjj0g2lgErwizGm1nB2g1EunZT7Pv/i+GhW6gaFUlsBs16QcKhXS3xZMAY3racr8BRXVtMp7mhGltgXJxUpvpDH6DB"
+    "VAPUs9YPgAFLy7lh76snvQIQj+L4QUtNGkfMdHEVppscAItAcAItJfv7BRMDIOidJYB7QnqQzNYizS5r0/b+vxfBca6bjnb7"
+    "AXXPvEWNv9j0RWlgdEVpaENLqSSSX/F5AaAIXLINJ2wTfuyDZ9/TZhZHo0h6Q0lpvr4/gqqkkkl/wj5fgOkNpYHSG0tg6Q2l"
+    "hLrHGv4KOPRO0sCInqUYOidJYIe62xU2/hjlgBFoDgBFpgOkG0sDonSWUut/39hiGUGJiMN3RuBbiKlTY0JdLDQl0srbbbfw";
+
+} // namespace video_probe_clip
+
+#endif // VIDEO_PROBE_CLIP_H
@@ -0,0 +1,168 @@
+// Bounded single-producer/single-consumer video frame queue
+// See video_queue.h
+
+#include "video_queue.h"
+#include "frame_pool.h"
+
+#include <chrono>
+
+VideoFrameQueue::VideoFrameQueue(uint32_t depth)
+    : depth_(depth), capacity_(depth * 2),
+      slots_(new std::atomic<AASDKFrame*>[depth * 2]), kinds_(new FrameKind[depth * 2]),
+      head_(0), tail_(0), count_(0), awaitingIdr_(false),
+      dropped_(0), highWater_(0), waiting_(false), closed_(false) {
+    for (uint32_t i = 0; i < capacity_; ++i) {
+        slots_[i].store(nullptr, std::memory_order_relaxed);
+        kinds_[i] = FrameKind::DELTA;
+    }
+}
+
+VideoFrameQueue::~VideoFrameQueue() {
+    drain();
+}
+
+void VideoFrameQueue::push(AASDKFrame* frame, FrameKind kind) {
+    if (!enabled() || closed_.load(std::memory_order_relaxed)) {
+        FramePool::release(frame);
+        return;
+    }
+
+    if (kind == FrameKind::IDR) {
+        // Nothing queued before an IDR is needed to decode it; drop the backlog
+        awaitingIdr_ = false;
+        flushDroppable();
+    } else if (kind == FrameKind::DELTA && awaitingIdr_) {
+        // The decoder lost a reference frame, everything until the next IDR is garbage
+        drop(frame);
+        return;
+    }
+
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    auto isFull = [this, tail]() {
+        return count_.load(std::memory_order_acquire) >= depth_ ||
+               tail - head_.load(std::memory_order_acquire) >= capacity_;
+    };
+
+    if (isFull() && kind == FrameKind::CONFIG) {
+        // Parameter sets are tiny and the stream is undecodable without them
+        flushDroppable();
+    }
+    if (isFull()) {
+        drop(frame);
+        awaitingIdr_ = true;
+        return;
+    }
+
+    uint32_t index = static_cast<uint32_t>(tail % capacity_);
+    kinds_[index] = kind;
+    slots_[index].store(frame, std::memory_order_release);
+    uint32_t count = count_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    // Sequentially consistent so it pairs with the consumer's waiting_ store (see pop)
+    tail_.store(tail + 1, std::memory_order_seq_cst);
+
+    if (count > highWater_.load(std::memory_order_relaxed)) {
+        highWater_.store(count, std::memory_order_relaxed);
+    }
+
+    if (waiting_.load(std::memory_order_seq_cst)) {
+        // Taking the mutex orders this notify after the consumer has started waiting
+        { std::lock_guard<std::mutex> lock(waitMutex_); }
+        waitCondition_.notify_one();
+    }
+}
+
+AASDKFrame* VideoFrameQueue::tryPop() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_seq_cst);
+
+    while (head < tail) {
+        // The producer may have flushed this slot already; skip the hole
+        AASDKFrame* frame = slots_[head % capacity_].exchange(nullptr, std::memory_order_acq_rel);
+        ++head;
+        head_.store(head, std::memory_order_release);
+        if (frame) {
+            count_.fetch_sub(1, std::memory_order_acq_rel);
+            return frame;
+        }
+    }
+    return nullptr;
+}
+
+AASDKFrame* VideoFrameQueue::pop(uint32_t timeoutMs) {
+    AASDKFrame* frame = tryPop();
+    if (!frame && timeoutMs != 0 && !closed_.load(std::memory_order_relaxed)) {
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        waiting_.store(true, std::memory_order_seq_cst);
+        waitCondition_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this, &frame]() {
+            frame = tryPop();
+            return frame != nullptr || closed_.load(std::memory_order_relaxed);
+        });
+        waiting_.store(false, std::memory_order_relaxed);
+    }
+
+    if (frame && lag_) {
+        lag_->consumed(frame->receive_ns);
+    }
+    return frame;
+}
+
+void VideoFrameQueue::resync() {
+    if (!enabled()) {
+        return;
+    }
+    awaitingIdr_ = true;
+    flushDroppable();
+}
+
+void VideoFrameQueue::close() {
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        closed_ = true;
+    }
+    waitCondition_.notify_all();
+}
+
+void VideoFrameQueue::drain() {
+    for (uint32_t i = 0; i < capacity_; ++i) {
+        AASDKFrame* frame = slots_[i].exchange(nullptr, std::memory_order_acq_rel);
+        if (frame) {
+            FramePool::release(frame);
+        }
+    }
+    count_ = 0;
+    head_.store(tail_.load());
+}
+
+void VideoFrameQueue::flushDroppable() {
+    // Walk backwards from the newest frame: the consumer pops forwards, so whatever it
+    // wins during the flush is always an unbroken run of frames it can still decode
+    uint64_t head = head_.load(std::memory_order_acquire);
+    for (uint64_t position = tail_.load(std::memory_order_relaxed); position-- > head;) {
+        uint32_t index = static_cast<uint32_t>(position % capacity_);
+        if (kinds_[index] == FrameKind::CONFIG) {
+            continue;
+        }
+        // Exchange races with the consumer's pop; whichever side gets the frame owns it
+        AASDKFrame* frame = slots_[index].exchange(nullptr, std::memory_order_acq_rel);
+        if (frame) {
+            count_.fetch_sub(1, std::memory_order_acq_rel);
+            drop(frame);
+        }
+    }
+}
+
+void VideoFrameQueue::drop(AASDKFrame* frame) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    FramePool::release(frame);
+}
+
+VideoFrameQueue::FrameKind VideoFrameQueue::kindOf(uint32_t nalFlags) {
+    if (nalFlags & AASDK_NAL_FLAG_IDR) {
+        return FrameKind::IDR;
+    }
+    if (nalFlags & AASDK_NAL_FLAG_NON_IDR) {
+        return FrameKind::DELTA;
+    }
+    // Parameter sets alone; anything unrecognised is treated as droppable
+    return (nalFlags & (AASDK_NAL_FLAG_SPS | AASDK_NAL_FLAG_PPS)) ? FrameKind::CONFIG : FrameKind::DELTA;
+}
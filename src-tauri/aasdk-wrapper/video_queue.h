@@ -0,0 +1,91 @@
+// Bounded single-producer/single-consumer video frame queue
+// The video channel strand pushes, one consumer thread pops. When the consumer falls
+// behind, frames are dropped in whole GOPs: H.264 P-frames cannot be skipped
+// individually, so an overflow drops everything up to the next IDR, and an arriving
+// IDR flushes whatever older frames are still queued (latest picture wins).
+
+#ifndef VIDEO_QUEUE_H
+#define VIDEO_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "aasdk_c.h"
+#include "lag_controller.h"
+
+class VideoFrameQueue {
+public:
+    enum class FrameKind {
+        DELTA,      // Depends on earlier frames
+        IDR,        // Decoding can restart here
+        CONFIG      // SPS/PPS only, never dropped
+    };
+
+    // depth: maximum number of queued frames (0 disables the queue)
+    explicit VideoFrameQueue(uint32_t depth);
+    ~VideoFrameQueue();
+
+    VideoFrameQueue(const VideoFrameQueue&) = delete;
+    VideoFrameQueue& operator=(const VideoFrameQueue&) = delete;
+
+    bool enabled() const { return depth_ > 0; }
+
+    // Producer side. Takes over the caller's reference to frame in every case.
+    void push(AASDKFrame* frame, FrameKind kind);
+
+    // Consumer side. Returns a frame reference owned by the caller, or nullptr once
+    // timeoutMs passes without a frame or the queue is closed.
+    AASDKFrame* pop(uint32_t timeoutMs);
+
+    // Report the lag of every popped frame to lag. Call before the first pop().
+    void setLagController(std::shared_ptr<VideoLagController> lag) { lag_ = std::move(lag); }
+
+    // Producer side: drop everything queued (except parameter sets) and every frame
+    // pushed until the next IDR
+    void resync();
+
+    // Wake the consumer and make every later pop() return immediately
+    void close();
+
+    // Release every queued frame; only call once producer and consumer have stopped
+    void drain();
+
+    uint32_t depth() const { return depth_; }
+    uint32_t size() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint32_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+
+    // How the queue treats a payload carrying the given AASDK_NAL_FLAG_* set
+    static FrameKind kindOf(uint32_t nalFlags);
+
+private:
+    AASDKFrame* tryPop();
+    void flushDroppable();
+    void drop(AASDKFrame* frame);
+
+    const uint32_t depth_;
+    // Positions are never reused while a flushed hole is still ahead of the consumer,
+    // so the ring holds twice the logical depth
+    const uint32_t capacity_;
+    std::unique_ptr<std::atomic<AASDKFrame*>[]> slots_;
+    std::unique_ptr<FrameKind[]> kinds_;   // Written and read by the producer only
+
+    std::atomic<uint64_t> head_;    // Next position to pop, advanced by the consumer
+    std::atomic<uint64_t> tail_;    // Next position to push, advanced by the producer
+    std::atomic<uint32_t> count_;   // Frames currently queued
+    bool awaitingIdr_;              // Producer only: a delta was dropped, skip until IDR
+
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint32_t> highWater_;
+    std::shared_ptr<VideoLagController> lag_;
+
+    std::mutex waitMutex_;
+    std::condition_variable waitCondition_;
+    std::atomic<bool> waiting_;
+    std::atomic<bool> closed_;
+};
+
+#endif // VIDEO_QUEUE_H
@@ -0,0 +1,128 @@
+// WAV file stand-in for a microphone
+// See wav_source.h
+
+#include "wav_source.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+uint32_t le16(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8;
+}
+
+uint32_t le32(const uint8_t* p) {
+    return le16(p) | le16(p + 2) << 16;
+}
+
+} // namespace
+
+std::unique_ptr<WavSource> WavSource::open(const std::string& path, uint32_t sampleRate) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return nullptr;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 12 || std::string(bytes.begin(), bytes.begin() + 4) != "RIFF" ||
+        std::string(bytes.begin() + 8, bytes.begin() + 12) != "WAVE") {
+        std::cerr << path << " is not a WAV file" << std::endl;
+        return nullptr;
+    }
+
+    // Walk the chunks for the format and the samples; anything else is skipped
+    uint32_t format = 0;
+    uint32_t channels = 0;
+    uint32_t rate = 0;
+    uint32_t bits = 0;
+    const uint8_t* data = nullptr;
+    size_t dataSize = 0;
+    size_t offset = 12;
+    while (offset + 8 <= bytes.size()) {
+        const uint8_t* chunk = &bytes[offset];
+        size_t size = std::min<size_t>(le32(chunk + 4), bytes.size() - offset - 8);
+        if (std::equal(chunk, chunk + 4, "fmt ") && size >= 16) {
+            format = le16(chunk + 8);
+            channels = le16(chunk + 10);
+            rate = le32(chunk + 12);
+            bits = le16(chunk + 22);
+            if (format == 0xFFFE && size >= 26) {
+                // WAVE_FORMAT_EXTENSIBLE: the real format leads the subformat GUID
+                format = le16(chunk + 32);
+            }
+        } else if (std::equal(chunk, chunk + 4, "data")) {
+            data = chunk + 8;
+            dataSize = size;
+        }
+        offset += 8 + size + (size & 1);
+    }
+
+    if (format != 1 || bits != 16 || (channels != 1 && channels != 2) || rate != sampleRate || !data) {
+        std::cerr << path << " is not 16-bit PCM mono/stereo at " << sampleRate << " Hz (format " << format << ", "
+                  << bits << " bit, " << channels << " ch, " << rate << " Hz)" << std::endl;
+        return nullptr;
+    }
+
+    size_t frames = dataSize / (2 * channels);
+    std::vector<int16_t> samples(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        const uint8_t* frame = data + i * 2 * channels;
+        int32_t sum = static_cast<int16_t>(le16(frame));
+        if (channels == 2) {
+            sum = (sum + static_cast<int16_t>(le16(frame + 2))) / 2;
+        }
+        samples[i] = static_cast<int16_t>(sum);
+    }
+    return std::unique_ptr<WavSource>(new WavSource(sampleRate, std::move(samples)));
+}
+
+WavSource::WavSource(uint32_t sampleRate, std::vector<int16_t> samples)
+    : sampleRate_(sampleRate), samples_(std::move(samples)), running_(false), rewind_(false) {}
+
+WavSource::~WavSource() {
+    stop();
+}
+
+void WavSource::start(Sink sink, uint32_t chunkFrames, bool loop) {
+    stop();
+    running_ = true;
+    rewind_ = false;
+    thread_ = std::thread(&WavSource::run, this, std::move(sink), std::max<uint32_t>(chunkFrames, 1), loop);
+}
+
+void WavSource::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void WavSource::run(Sink sink, uint32_t chunkFrames, bool loop) {
+    std::vector<int16_t> chunk(chunkFrames);
+    size_t position = 0;
+    auto chunkDuration = std::chrono::nanoseconds(static_cast<uint64_t>(chunkFrames) * 1000000000 / sampleRate_);
+    auto captured = std::chrono::steady_clock::now();
+
+    while (running_.load(std::memory_order_acquire)) {
+        if (rewind_.exchange(false, std::memory_order_acq_rel)) {
+            position = 0;
+        }
+        for (uint32_t i = 0; i < chunkFrames; ++i) {
+            if (position >= samples_.size() && loop && !samples_.empty()) {
+                position = 0;
+            }
+            chunk[i] = position < samples_.size() ? samples_[position++] : 0;
+        }
+
+        // A device hands over a chunk once its last frame has been captured
+        std::this_thread::sleep_until(captured + chunkDuration);
+        uint64_t captureNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(captured.time_since_epoch()).count());
+        sink(chunk.data(), chunkFrames, captureNs);
+        captured += chunkDuration;
+    }
+}
@@ -0,0 +1,56 @@
+// WAV file stand-in for a microphone
+// Loads a 16-bit PCM WAV file into memory, downmixing stereo to mono, and plays it into
+// a sink from its own thread in real time, one chunk per chunk duration, the way a
+// capture device callback delivers audio: each chunk arrives once its last frame would
+// have been captured, stamped with the capture time of its first. Past the end of the
+// file it plays silence (or loops), so the pipeline behind it can be driven and timed
+// without hardware.
+
+#ifndef WAV_SOURCE_H
+#define WAV_SOURCE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class WavSource {
+public:
+    // captureNs is the CLOCK_MONOTONIC capture time of the first frame
+    typedef std::function<void(const int16_t* samples, uint32_t frames, uint64_t captureNs)> Sink;
+
+    // Load path; returns nullptr unless it is 16-bit PCM at sampleRate with 1 or 2 channels
+    static std::unique_ptr<WavSource> open(const std::string& path, uint32_t sampleRate);
+
+    ~WavSource();
+
+    WavSource(const WavSource&) = delete;
+    WavSource& operator=(const WavSource&) = delete;
+
+    // Start playing from the beginning in chunks of chunkFrames; loop repeats the file
+    void start(Sink sink, uint32_t chunkFrames, bool loop);
+    void stop();
+
+    // Play from the beginning again at the next chunk; any thread
+    void rewind() { rewind_.store(true, std::memory_order_release); }
+
+    uint32_t sampleRate() const { return sampleRate_; }
+    const std::vector<int16_t>& samples() const { return samples_; }
+
+private:
+    WavSource(uint32_t sampleRate, std::vector<int16_t> samples);
+
+    void run(Sink sink, uint32_t chunkFrames, bool loop);
+
+    const uint32_t sampleRate_;
+    const std::vector<int16_t> samples_;    // Mono
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<bool> rewind_;
+};
+
+#endif // WAV_SOURCE_H
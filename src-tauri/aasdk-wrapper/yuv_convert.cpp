@@ -0,0 +1,498 @@
+// YUV 4:2:0 to 32-bit RGB conversion
+// See yuv_convert.h
+
+#include "yuv_convert.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define YUV_CONVERT_NEON 1
+#endif
+
+// AVX2 kernels are compiled for the target attribute and picked at runtime
+#if defined(__SSE2__) && defined(__x86_64__) && defined(__GNUC__)
+#define YUV_CONVERT_AVX2 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+// BT.601 limited range in 6-bit fixed point, sized so every intermediate fits in a
+// signed 16-bit SIMD lane. Luma is scaled by 74.5 as (Y * 149) >> 1 on unsigned lanes.
+// Blue can exceed int16 for bright yellows; the SIMD kernels saturate there, which only
+// happens when the result clamps to 255 anyway, so the scalar path stays bit-identical.
+constexpr int Y_TO_RGB = 149;
+constexpr int Y_BIAS = 16 * 149 / 2 - 32;   // Black level, less the rounding term
+constexpr int V_TO_R = 102;
+constexpr int U_TO_G = 25;
+constexpr int V_TO_G = 52;
+constexpr int U_TO_B = 129;
+constexpr int SHIFT = 6;
+
+inline uint8_t clampPixel(int value) {
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// Reference kernel; the SIMD kernels finish the tail of each row with it
+template <bool NV12, bool BGRA>
+void rowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst,
+               uint32_t x, uint32_t width) {
+    for (; x < width; ++x) {
+        uint32_t c = NV12 ? (x & ~1u) : (x >> 1);
+        int luma = ((y[x] * Y_TO_RGB) >> 1) - Y_BIAS;
+        int cu = u[c] - 128;
+        int cv = v[c] - 128;
+
+        uint8_t* pixel = dst + x * 4;
+        pixel[BGRA ? 2 : 0] = clampPixel((luma + V_TO_R * cv) >> SHIFT);
+        pixel[1] = clampPixel((luma - U_TO_G * cu - V_TO_G * cv) >> SHIFT);
+        pixel[BGRA ? 0 : 2] = clampPixel((luma + U_TO_B * cu) >> SHIFT);
+        pixel[3] = 255;
+    }
+}
+
+template <bool NV12, bool BGRA>
+void rowKernelScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, uint32_t width) {
+    rowScalar<NV12, BGRA>(y, u, v, dst, 0, width);
+}
+
+#if defined(__SSE2__)
+
+// Interleave 16 pixels of planar channel bytes into 64 bytes of 4-channel output
+inline void storePixelsSse2(__m128i c0, __m128i c1, __m128i c2, uint8_t* dst) {
+    const __m128i alpha = _mm_set1_epi8(-1);
+    __m128i lo01 = _mm_unpacklo_epi8(c0, c1);
+    __m128i hi01 = _mm_unpackhi_epi8(c0, c1);
+    __m128i lo23 = _mm_unpacklo_epi8(c2, alpha);
+    __m128i hi23 = _mm_unpackhi_epi8(c2, alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(lo01, lo23));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi16(lo01, lo23));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), _mm_unpacklo_epi16(hi01, hi23));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), _mm_unpackhi_epi16(hi01, hi23));
+}
+
+template <bool NV12, bool BGRA>
+void rowKernelSse2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, uint32_t width) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i chromaBias = _mm_set1_epi16(128);
+    const __m128i lumaBias = _mm_set1_epi16(Y_BIAS);
+    const __m128i lowBytes = _mm_set1_epi16(0xff);
+
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        // Eight chroma samples as 16-bit lanes
+        __m128i cu, cv;
+        if (NV12) {
+            __m128i uv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x));
+            cu = _mm_and_si128(uv, lowBytes);
+            cv = _mm_srli_epi16(uv, 8);
+        } else {
+            cu = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x / 2)), zero);
+            cv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x / 2)), zero);
+        }
+        cu = _mm_sub_epi16(cu, chromaBias);
+        cv = _mm_sub_epi16(cv, chromaBias);
+        __m128i r = _mm_mullo_epi16(cv, _mm_set1_epi16(V_TO_R));
+        __m128i gu = _mm_mullo_epi16(cu, _mm_set1_epi16(U_TO_G));
+        __m128i gv = _mm_mullo_epi16(cv, _mm_set1_epi16(V_TO_G));
+        __m128i b = _mm_mullo_epi16(cu, _mm_set1_epi16(U_TO_B));
+
+        __m128i luma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+        __m128i y0 = _mm_mullo_epi16(_mm_unpacklo_epi8(luma, zero), _mm_set1_epi16(Y_TO_RGB));
+        __m128i y1 = _mm_mullo_epi16(_mm_unpackhi_epi8(luma, zero), _mm_set1_epi16(Y_TO_RGB));
+        y0 = _mm_sub_epi16(_mm_srli_epi16(y0, 1), lumaBias);
+        y1 = _mm_sub_epi16(_mm_srli_epi16(y1, 1), lumaBias);
+
+        // Each chroma sample covers two pixels
+        __m128i r0 = _mm_srai_epi16(_mm_adds_epi16(y0, _mm_unpacklo_epi16(r, r)), SHIFT);
+        __m128i r1 = _mm_srai_epi16(_mm_adds_epi16(y1, _mm_unpackhi_epi16(r, r)), SHIFT);
+        __m128i g0 = _mm_sub_epi16(_mm_sub_epi16(y0, _mm_unpacklo_epi16(gu, gu)), _mm_unpacklo_epi16(gv, gv));
+        __m128i g1 = _mm_sub_epi16(_mm_sub_epi16(y1, _mm_unpackhi_epi16(gu, gu)), _mm_unpackhi_epi16(gv, gv));
+        g0 = _mm_srai_epi16(g0, SHIFT);
+        g1 = _mm_srai_epi16(g1, SHIFT);
+        __m128i b0 = _mm_srai_epi16(_mm_adds_epi16(y0, _mm_unpacklo_epi16(b, b)), SHIFT);
+        __m128i b1 = _mm_srai_epi16(_mm_adds_epi16(y1, _mm_unpackhi_epi16(b, b)), SHIFT);
+
+        __m128i red = _mm_packus_epi16(r0, r1);
+        __m128i green = _mm_packus_epi16(g0, g1);
+        __m128i blue = _mm_packus_epi16(b0, b1);
+        storePixelsSse2(BGRA ? blue : red, green, BGRA ? red : blue, dst + x * 4);
+    }
+    rowScalar<NV12, BGRA>(y, u, v, dst, x, width);
+}
+
+#endif // __SSE2__
+
+#if defined(YUV_CONVERT_AVX2)
+
+// Spread 16 chroma terms over 32 pixels, in pixel order
+AVX2_TARGET inline void duplicateAvx2(__m256i terms, __m256i& first, __m256i& second) {
+    __m256i lo = _mm256_unpacklo_epi16(terms, terms);   // Pixels 0-7 | 16-23
+    __m256i hi = _mm256_unpackhi_epi16(terms, terms);   // Pixels 8-15 | 24-31
+    first = _mm256_permute2x128_si256(lo, hi, 0x20);
+    second = _mm256_permute2x128_si256(lo, hi, 0x31);
+}
+
+// Pack two halves of 16-bit results into 32 bytes in pixel order
+AVX2_TARGET inline __m256i packAvx2(__m256i first, __m256i second) {
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xd8);
+}
+
+AVX2_TARGET inline void storePixelsAvx2(__m256i c0, __m256i c1, __m256i c2, uint8_t* dst) {
+    const __m256i alpha = _mm256_set1_epi8(-1);
+    __m256i lo01 = _mm256_unpacklo_epi8(c0, c1);        // Pixels 0-7 | 16-23
+    __m256i hi01 = _mm256_unpackhi_epi8(c0, c1);        // Pixels 8-15 | 24-31
+    __m256i lo23 = _mm256_unpacklo_epi8(c2, alpha);
+    __m256i hi23 = _mm256_unpackhi_epi8(c2, alpha);
+    __m256i p0 = _mm256_unpacklo_epi16(lo01, lo23);     // Pixels 0-3 | 16-19
+    __m256i p1 = _mm256_unpackhi_epi16(lo01, lo23);     // Pixels 4-7 | 20-23
+    __m256i p2 = _mm256_unpacklo_epi16(hi01, hi23);     // Pixels 8-11 | 24-27
+    __m256i p3 = _mm256_unpackhi_epi16(hi01, hi23);     // Pixels 12-15 | 28-31
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute2x128_si256(p0, p1, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), _mm256_permute2x128_si256(p2, p3, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 64), _mm256_permute2x128_si256(p0, p1, 0x31));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 96), _mm256_permute2x128_si256(p2, p3, 0x31));
+}
+
+template <bool NV12, bool BGRA>
+AVX2_TARGET void rowKernelAvx2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, uint32_t width) {
+    const __m256i chromaBias = _mm256_set1_epi16(128);
+    const __m256i lumaBias = _mm256_set1_epi16(Y_BIAS);
+    const __m256i lowBytes = _mm256_set1_epi16(0xff);
+
+    uint32_t x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i cu, cv;
+        if (NV12) {
+            __m256i uv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(u + x));
+            cu = _mm256_and_si256(uv, lowBytes);
+            cv = _mm256_srli_epi16(uv, 8);
+        } else {
+            cu = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x / 2)));
+            cv = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(v + x / 2)));
+        }
+        cu = _mm256_sub_epi16(cu, chromaBias);
+        cv = _mm256_sub_epi16(cv, chromaBias);
+
+        __m256i r0, r1, gu0, gu1, gv0, gv1, b0, b1;
+        duplicateAvx2(_mm256_mullo_epi16(cv, _mm256_set1_epi16(V_TO_R)), r0, r1);
+        duplicateAvx2(_mm256_mullo_epi16(cu, _mm256_set1_epi16(U_TO_G)), gu0, gu1);
+        duplicateAvx2(_mm256_mullo_epi16(cv, _mm256_set1_epi16(V_TO_G)), gv0, gv1);
+        duplicateAvx2(_mm256_mullo_epi16(cu, _mm256_set1_epi16(U_TO_B)), b0, b1);
+
+        __m256i luma = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + x));
+        __m256i y0 = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(luma)),
+                                        _mm256_set1_epi16(Y_TO_RGB));
+        __m256i y1 = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(luma, 1)),
+                                        _mm256_set1_epi16(Y_TO_RGB));
+        y0 = _mm256_sub_epi16(_mm256_srli_epi16(y0, 1), lumaBias);
+        y1 = _mm256_sub_epi16(_mm256_srli_epi16(y1, 1), lumaBias);
+
+        __m256i red = packAvx2(_mm256_srai_epi16(_mm256_adds_epi16(y0, r0), SHIFT),
+                               _mm256_srai_epi16(_mm256_adds_epi16(y1, r1), SHIFT));
+        __m256i green = packAvx2(_mm256_srai_epi16(_mm256_sub_epi16(_mm256_sub_epi16(y0, gu0), gv0), SHIFT),
+                                 _mm256_srai_epi16(_mm256_sub_epi16(_mm256_sub_epi16(y1, gu1), gv1), SHIFT));
+        __m256i blue = packAvx2(_mm256_srai_epi16(_mm256_adds_epi16(y0, b0), SHIFT),
+                                _mm256_srai_epi16(_mm256_adds_epi16(y1, b1), SHIFT));
+        storePixelsAvx2(BGRA ? blue : red, green, BGRA ? red : blue, dst + x * 4);
+    }
+    rowScalar<NV12, BGRA>(y, u, v, dst, x, width);
+}
+
+#endif // YUV_CONVERT_AVX2
+
+#if defined(YUV_CONVERT_NEON)
+
+template <bool NV12, bool BGRA>
+void rowKernelNeon(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, uint32_t width) {
+    const int16x8_t chromaBias = vdupq_n_s16(128);
+    const int16x8_t lumaBias = vdupq_n_s16(Y_BIAS);
+
+    uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        int16x8_t cu, cv;
+        if (NV12) {
+            uint8x8x2_t uv = vld2_u8(u + x);
+            cu = vreinterpretq_s16_u16(vmovl_u8(uv.val[0]));
+            cv = vreinterpretq_s16_u16(vmovl_u8(uv.val[1]));
+        } else {
+            cu = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u + x / 2)));
+            cv = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v + x / 2)));
+        }
+        cu = vsubq_s16(cu, chromaBias);
+        cv = vsubq_s16(cv, chromaBias);
+
+        // Each chroma sample covers two pixels
+        int16x8x2_t r = vzipq_s16(vmulq_n_s16(cv, V_TO_R), vmulq_n_s16(cv, V_TO_R));
+        int16x8x2_t gu = vzipq_s16(vmulq_n_s16(cu, U_TO_G), vmulq_n_s16(cu, U_TO_G));
+        int16x8x2_t gv = vzipq_s16(vmulq_n_s16(cv, V_TO_G), vmulq_n_s16(cv, V_TO_G));
+        int16x8x2_t b = vzipq_s16(vmulq_n_s16(cu, U_TO_B), vmulq_n_s16(cu, U_TO_B));
+
+        uint8x16_t luma = vld1q_u8(y + x);
+        uint16x8_t l0 = vshrq_n_u16(vmulq_n_u16(vmovl_u8(vget_low_u8(luma)), Y_TO_RGB), 1);
+        uint16x8_t l1 = vshrq_n_u16(vmulq_n_u16(vmovl_u8(vget_high_u8(luma)), Y_TO_RGB), 1);
+        int16x8_t y0 = vsubq_s16(vreinterpretq_s16_u16(l0), lumaBias);
+        int16x8_t y1 = vsubq_s16(vreinterpretq_s16_u16(l1), lumaBias);
+
+        uint8x16x4_t out;
+        out.val[BGRA ? 2 : 0] = vcombine_u8(vqmovun_s16(vshrq_n_s16(vqaddq_s16(y0, r.val[0]), SHIFT)),
+                                            vqmovun_s16(vshrq_n_s16(vqaddq_s16(y1, r.val[1]), SHIFT)));
+        out.val[1] = vcombine_u8(vqmovun_s16(vshrq_n_s16(vsubq_s16(vsubq_s16(y0, gu.val[0]), gv.val[0]), SHIFT)),
+                                 vqmovun_s16(vshrq_n_s16(vsubq_s16(vsubq_s16(y1, gu.val[1]), gv.val[1]), SHIFT)));
+        out.val[BGRA ? 0 : 2] = vcombine_u8(vqmovun_s16(vshrq_n_s16(vqaddq_s16(y0, b.val[0]), SHIFT)),
+                                            vqmovun_s16(vshrq_n_s16(vqaddq_s16(y1, b.val[1]), SHIFT)));
+        out.val[3] = vdupq_n_u8(255);
+        vst4q_u8(dst + x * 4, out);
+    }
+    rowScalar<NV12, BGRA>(y, u, v, dst, x, width);
+}
+
+#endif // YUV_CONVERT_NEON
+
+// Map dst output positions onto src samples, sampling at pixel centres
+template <typename Tap>
+void buildTaps(uint32_t src, uint32_t dst, std::vector<Tap>& taps) {
+    taps.resize(dst);
+    for (uint32_t i = 0; i < dst; ++i) {
+        // Position in 1/256ths of a source pixel
+        int64_t position = (static_cast<int64_t>(2 * i + 1) * src * 256) / (2 * static_cast<int64_t>(dst)) - 128;
+        if (position < 0) {
+            position = 0;
+        }
+        uint32_t index = static_cast<uint32_t>(position >> 8);
+        uint32_t weight = static_cast<uint32_t>(position & 0xff);
+        if (index >= src - 1) {
+            index = src - 1;
+            weight = 0;
+        }
+        taps[i].index = index;
+        taps[i].next = weight ? index + 1 : index;
+        taps[i].weight = weight;
+    }
+}
+
+inline uint8_t blend(uint8_t a, uint8_t b, uint32_t weight) {
+    return static_cast<uint8_t>((a * (256 - weight) + b * weight + 128) >> 8);
+}
+
+// Vertically filter count bytes of two source rows; returns row0 when no filtering is needed
+const uint8_t* blendRows(const uint8_t* row0, const uint8_t* row1, uint32_t weight, uint32_t count, uint8_t* out) {
+    if (weight == 0) {
+        return row0;
+    }
+
+    uint32_t i = 0;
+#if defined(__SSE2__)
+    // Same arithmetic as blend() in 16-bit lanes; the weighted sum stays below 65536
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weight0 = _mm_set1_epi16(static_cast<int16_t>(256 - weight));
+    const __m128i weight1 = _mm_set1_epi16(static_cast<int16_t>(weight));
+    const __m128i round = _mm_set1_epi16(128);
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), weight0),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), weight1));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), weight0),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), weight1));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(YUV_CONVERT_NEON)
+    const uint8x8_t weight0 = vdup_n_u8(static_cast<uint8_t>(256 - weight));
+    const uint8x8_t weight1 = vdup_n_u8(static_cast<uint8_t>(weight));
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t a = vld1q_u8(row0 + i);
+        uint8x16_t b = vld1q_u8(row1 + i);
+        uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(a), weight0), vget_low_u8(b), weight1);
+        uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(a), weight0), vget_high_u8(b), weight1);
+        vst1q_u8(out + i, vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = blend(row0[i], row1[i], weight);
+    }
+    return out;
+}
+
+// Horizontally filter samples spaced STEP bytes apart
+template <uint32_t STEP, typename Tap>
+void sampleRow(const uint8_t* row, const std::vector<Tap>& taps, uint8_t* out) {
+    // Locals so the byte stores can't force the taps to be reloaded every iteration
+    const Tap* tap = taps.data();
+    const size_t count = taps.size();
+    for (size_t i = 0; i < count; ++i, ++tap) {
+        out[i] = blend(row[tap->index * STEP], row[tap->next * STEP], tap->weight);
+    }
+}
+
+} // namespace
+
+YuvConverter::Isa YuvConverter::detectIsa() {
+#if defined(YUV_CONVERT_NEON)
+    return Isa::NEON;
+#elif defined(__SSE2__)
+#if defined(YUV_CONVERT_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::AVX2;
+    }
+#endif
+    return Isa::SSE2;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+const char* YuvConverter::isaName(Isa isa) {
+    switch (isa) {
+    case Isa::SCALAR: return "scalar";
+    case Isa::SSE2: return "sse2";
+    case Isa::AVX2: return "avx2";
+    case Isa::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+YuvConverter::YuvConverter(Isa isa)
+    : isa_(Isa::SCALAR), tapSrcWidth_(0), tapSrcHeight_(0), tapDstWidth_(0), tapDstHeight_(0) {
+    kernels_[0][0] = &rowKernelScalar<false, false>;
+    kernels_[0][1] = &rowKernelScalar<false, true>;
+    kernels_[1][0] = &rowKernelScalar<true, false>;
+    kernels_[1][1] = &rowKernelScalar<true, true>;
+
+    switch (isa) {
+#if defined(__SSE2__)
+    case Isa::SSE2:
+        isa_ = isa;
+        kernels_[0][0] = &rowKernelSse2<false, false>;
+        kernels_[0][1] = &rowKernelSse2<false, true>;
+        kernels_[1][0] = &rowKernelSse2<true, false>;
+        kernels_[1][1] = &rowKernelSse2<true, true>;
+        break;
+#endif
+#if defined(YUV_CONVERT_AVX2)
+    case Isa::AVX2:
+        if (!__builtin_cpu_supports("avx2")) {
+            break;
+        }
+        isa_ = isa;
+        kernels_[0][0] = &rowKernelAvx2<false, false>;
+        kernels_[0][1] = &rowKernelAvx2<false, true>;
+        kernels_[1][0] = &rowKernelAvx2<true, false>;
+        kernels_[1][1] = &rowKernelAvx2<true, true>;
+        break;
+#endif
+#if defined(YUV_CONVERT_NEON)
+    case Isa::NEON:
+        isa_ = isa;
+        kernels_[0][0] = &rowKernelNeon<false, false>;
+        kernels_[0][1] = &rowKernelNeon<false, true>;
+        kernels_[1][0] = &rowKernelNeon<true, false>;
+        kernels_[1][1] = &rowKernelNeon<true, true>;
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+bool YuvConverter::convert(const AASDKDecodedFrame& picture, uint8_t* dst, uint32_t dstStride,
+                           uint32_t dstWidth, uint32_t dstHeight, AASDKRgbFormat format) {
+    bool nv12 = picture.format == AASDK_PIXEL_FORMAT_NV12;
+    if (!nv12 && picture.format != AASDK_PIXEL_FORMAT_I420) {
+        return false;
+    }
+    if (format != AASDK_RGB_FORMAT_RGBA && format != AASDK_RGB_FORMAT_BGRA) {
+        return false;
+    }
+    if (!picture.planes[0] || !picture.planes[1] || (!nv12 && !picture.planes[2])) {
+        return false;
+    }
+    if (!dst || picture.width == 0 || picture.height == 0 || dstWidth == 0 || dstHeight == 0 ||
+        dstStride < dstWidth * 4) {
+        return false;
+    }
+
+    bool bgra = format == AASDK_RGB_FORMAT_BGRA;
+    if (dstWidth != picture.width || dstHeight != picture.height) {
+        // Scaled rows are gathered into planar scratch buffers
+        convertScaled(picture, dst, dstStride, dstWidth, dstHeight, kernels_[0][bgra]);
+        return true;
+    }
+
+    RowKernel kernel = kernels_[nv12][bgra];
+    for (uint32_t row = 0; row < picture.height; ++row) {
+        const uint8_t* y = picture.planes[0] + static_cast<size_t>(row) * picture.strides[0];
+        const uint8_t* u = picture.planes[1] + static_cast<size_t>(row >> 1) * picture.strides[1];
+        const uint8_t* v = nv12 ? u + 1 : picture.planes[2] + static_cast<size_t>(row >> 1) * picture.strides[2];
+        kernel(y, u, v, dst + static_cast<size_t>(row) * dstStride, picture.width);
+    }
+    return true;
+}
+
+void YuvConverter::updateTaps(const AASDKDecodedFrame& picture, uint32_t dstWidth, uint32_t dstHeight) {
+    if (tapSrcWidth_ == picture.width && tapSrcHeight_ == picture.height &&
+        tapDstWidth_ == dstWidth && tapDstHeight_ == dstHeight) {
+        return;
+    }
+
+    uint32_t chromaWidth = (picture.width + 1) / 2;
+    uint32_t chromaHeight = (picture.height + 1) / 2;
+    buildTaps(picture.width, dstWidth, lumaColumns_);
+    buildTaps(picture.height, dstHeight, lumaRows_);
+    buildTaps(chromaWidth, (dstWidth + 1) / 2, chromaColumns_);
+    buildTaps(chromaHeight, dstHeight, chromaRows_);
+
+    // An interleaved UV row is as wide as the luma row, rounded up to a whole pair
+    blendRow_.resize(std::max(picture.width, chromaWidth * 2));
+    scaledY_.resize(dstWidth);
+    scaledU_.resize(chromaColumns_.size());
+    scaledV_.resize(chromaColumns_.size());
+
+    tapSrcWidth_ = picture.width;
+    tapSrcHeight_ = picture.height;
+    tapDstWidth_ = dstWidth;
+    tapDstHeight_ = dstHeight;
+}
+
+void YuvConverter::convertScaled(const AASDKDecodedFrame& picture, uint8_t* dst, uint32_t dstStride,
+                                 uint32_t dstWidth, uint32_t dstHeight, RowKernel kernel) {
+    updateTaps(picture, dstWidth, dstHeight);
+
+    bool nv12 = picture.format == AASDK_PIXEL_FORMAT_NV12;
+    uint32_t chromaWidth = (picture.width + 1) / 2;
+    auto planeRow = [&picture](int plane, uint32_t row) {
+        return picture.planes[plane] + static_cast<size_t>(row) * picture.strides[plane];
+    };
+
+    for (uint32_t row = 0; row < dstHeight; ++row) {
+        const Tap& lumaTap = lumaRows_[row];
+        const uint8_t* y = blendRows(planeRow(0, lumaTap.index), planeRow(0, lumaTap.next), lumaTap.weight,
+                                     picture.width, blendRow_.data());
+        sampleRow<1>(y, lumaColumns_, scaledY_.data());
+
+        const Tap& chromaTap = chromaRows_[row];
+        if (nv12) {
+            const uint8_t* uv = blendRows(planeRow(1, chromaTap.index), planeRow(1, chromaTap.next),
+                                          chromaTap.weight, chromaWidth * 2, blendRow_.data());
+            sampleRow<2>(uv, chromaColumns_, scaledU_.data());
+            sampleRow<2>(uv + 1, chromaColumns_, scaledV_.data());
+        } else {
+            const uint8_t* u = blendRows(planeRow(1, chromaTap.index), planeRow(1, chromaTap.next),
+                                         chromaTap.weight, chromaWidth, blendRow_.data());
+            sampleRow<1>(u, chromaColumns_, scaledU_.data());
+            const uint8_t* v = blendRows(planeRow(2, chromaTap.index), planeRow(2, chromaTap.next),
+                                         chromaTap.weight, chromaWidth, blendRow_.data());
+            sampleRow<1>(v, chromaColumns_, scaledV_.data());
+        }
+
+        kernel(scaledY_.data(), scaledU_.data(), scaledV_.data(), dst + static_cast<size_t>(row) * dstStride,
+               dstWidth);
+    }
+}
@@ -0,0 +1,76 @@
+// YUV 4:2:0 to 32-bit RGB conversion
+// Converts decoded I420/NV12 pictures to RGBA or BGRA with BT.601 limited-range
+// coefficients, optionally scaling to the display size in the same pass. The SIMD
+// kernels (SSE2, AVX2, NEON) produce output bit-identical to the scalar reference.
+
+#ifndef YUV_CONVERT_H
+#define YUV_CONVERT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "aasdk_c.h"
+
+class YuvConverter {
+public:
+    enum class Isa {
+        SCALAR,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+    // Best kernel set supported by this build and CPU
+    static Isa detectIsa();
+    static const char* isaName(Isa isa);
+
+    // Falls back to the scalar kernels if isa is not available
+    explicit YuvConverter(Isa isa = detectIsa());
+
+    YuvConverter(const YuvConverter&) = delete;
+    YuvConverter& operator=(const YuvConverter&) = delete;
+
+    Isa isa() const { return isa_; }
+
+    // Convert picture into dst (dstStride bytes per row, at least dstWidth * 4).
+    // When the destination size differs from the picture the image is scaled with a
+    // bilinear filter before color conversion. Returns false for unsupported input.
+    bool convert(const AASDKDecodedFrame& picture, uint8_t* dst, uint32_t dstStride,
+                 uint32_t dstWidth, uint32_t dstHeight, AASDKRgbFormat format);
+
+private:
+    // Converts one row: chroma is either two half-width planes or one interleaved plane
+    // (u points at the UV plane, v at u + 1). Writes width pixels of 4 bytes.
+    typedef void (*RowKernel)(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                              uint8_t* dst, uint32_t width);
+
+    // Source samples around one output position and the 8-bit weight of the second
+    struct Tap {
+        uint32_t index;
+        uint32_t next;
+        uint32_t weight;
+    };
+
+    void convertScaled(const AASDKDecodedFrame& picture, uint8_t* dst, uint32_t dstStride,
+                       uint32_t dstWidth, uint32_t dstHeight, RowKernel kernel);
+    void updateTaps(const AASDKDecodedFrame& picture, uint32_t dstWidth, uint32_t dstHeight);
+
+    Isa isa_;
+    RowKernel kernels_[2][2];   // [NV12][BGRA]
+
+    // Scaling state, rebuilt when the source or destination size changes
+    uint32_t tapSrcWidth_;
+    uint32_t tapSrcHeight_;
+    uint32_t tapDstWidth_;
+    uint32_t tapDstHeight_;
+    std::vector<Tap> lumaColumns_;
+    std::vector<Tap> lumaRows_;
+    std::vector<Tap> chromaColumns_;
+    std::vector<Tap> chromaRows_;
+    std::vector<uint8_t> blendRow_;     // Vertically filtered source row
+    std::vector<uint8_t> scaledY_;
+    std::vector<uint8_t> scaledU_;
+    std::vector<uint8_t> scaledV_;
+};
+
+#endif // YUV_CONVERT_H
@@ -21,6 +21,8 @@ fn build_aasdk_wrapper() {
     let aasdk_build_dir = wrapper_dir.join("build");
     let wrapper_source = wrapper_dir.join("aasdk_c.cpp");
     let wrapper_header = wrapper_dir.join("aasdk_c.h");
+    // Internal C++ modules compiled alongside the C wrapper
+    let wrapper_modules = ["usb_event_loop", "frame_pool", "video_queue", "h264_decoder", "yuv_convert", "h264_parser", "media_ack", "video_probe", "frame_ring", "lag_controller", "session_capture", "session_replay", "pcm_ring", "jitter_buffer", "resampler", "audio_mixer", "mic_capture", "wav_source", "audio_focus", "input_batcher"];
 
     // Check if AASDK wrapper files exist
     if !wrapper_source.exists() || !wrapper_header.exists() {
@@ -48,6 +50,7 @@ fn build_aasdk_wrapper() {
     build
         .cpp(true)
         .file(&wrapper_source)
+        .files(wrapper_modules.iter().map(|m| wrapper_dir.join(format!("{}.cpp", m))))
         .include(&wrapper_dir.join("aasdk").join("include"))
         .include(&aasdk_build_dir)
         .std("c++14")
@@ -82,6 +85,29 @@ fn build_aasdk_wrapper() {
         }
     }
     
+    // Native H.264 decode stage is optional: enable it when libavcodec is installed
+    let libav_found = std::process::Command::new("pkg-config")
+        .args(&["--exists", "libavcodec", "libavutil"])
+        .status()
+        .map(|status| status.success())
+        .unwrap_or(false);
+    if libav_found {
+        build.define("AASDK_WITH_LIBAV", None);
+        if let Ok(output) = std::process::Command::new("pkg-config")
+            .args(&["--cflags-only-I", "libavcodec", "libavutil"])
+            .output()
+        {
+            let output_str = String::from_utf8_lossy(&output.stdout);
+            for flag in output_str.split_whitespace() {
+                if let Some(path) = flag.strip_prefix("-I") {
+                    build.include(path);
+                }
+            }
+        }
+    } else {
+        println!("cargo:warning=libavcodec not found, building wrapper without native H.264 decode");
+    }
+    
     build.compile("aasdk_c");
 
     // Tell Cargo where to find the AASDK libraries
@@ -144,9 +170,18 @@ fn build_aasdk_wrapper() {
     println!("cargo:rustc-link-lib=protobuf");
     println!("cargo:rustc-link-lib=crypto");
     println!("cargo:rustc-link-lib=ssl");
+    if libav_found {
+        println!("cargo:rustc-link-lib=avcodec");
+        println!("cargo:rustc-link-lib=avutil");
+    }
 
     // Rebuild if wrapper files change
     println!("cargo:rerun-if-changed={}", wrapper_source_path);
     println!("cargo:rerun-if-changed={}", wrapper_header_path);
+    for module in wrapper_modules.iter() {
+        println!("cargo:rerun-if-changed={}", wrapper_dir.join(format!("{}.cpp", module)).display());
+        println!("cargo:rerun-if-changed={}", wrapper_dir.join(format!("{}.h", module)).display());
+    }
+    println!("cargo:rerun-if-changed={}", wrapper_dir.join("video_probe_clip.h").display());
     println!("cargo:rerun-if-changed={}", aasdk_lib_path_str);
 }
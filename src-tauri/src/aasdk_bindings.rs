@@ -37,6 +37,412 @@ pub type ConnectionStatusCallback = extern "C" fn(
     user_data: *mut c_void,
 );
 
+// H.264 NAL units found in a video payload (AASDKFrame::nal_flags)
+#[allow(dead_code)]
+pub const AASDK_NAL_FLAG_SPS: u32 = 0x01;
+#[allow(dead_code)]
+pub const AASDK_NAL_FLAG_PPS: u32 = 0x02;
+pub const AASDK_NAL_FLAG_IDR: u32 = 0x04;
+#[allow(dead_code)]
+pub const AASDK_NAL_FLAG_NON_IDR: u32 = 0x08;
+
+// Pooled, reference-counted video payload (AASDKFrame)
+#[repr(C)]
+#[derive(Debug)]
+pub struct AASDKFrame {
+    pub data: *const u8,
+    pub size: u32,
+    pub width: u32,
+    pub height: u32,
+    pub nal_flags: u32,
+    pub timestamp: u64,
+    pub sequence: u64,
+    pub receive_ns: u64,
+}
+
+// Receives one reference to the frame, released with aasdk_frame_release
+pub type VideoFrameRefCallback = extern "C" fn(
+    frame: *mut AASDKFrame,
+    user_data: *mut c_void,
+);
+
+// Decoded picture layouts (AASDKPixelFormat)
+pub const AASDK_PIXEL_FORMAT_I420: i32 = 0;
+pub const AASDK_PIXEL_FORMAT_NV12: i32 = 1;
+
+// Decoded video picture (AASDKDecodedFrame), planes valid during the callback only
+#[repr(C)]
+#[derive(Debug)]
+pub struct AASDKDecodedFrame {
+    pub format: i32,
+    pub width: u32,
+    pub height: u32,
+    pub planes: [*const u8; 3],
+    pub strides: [u32; 3],
+    pub timestamp: u64,
+    pub sequence: u64,
+    pub receive_ns: u64,
+}
+
+pub type DecodedFrameCallback = extern "C" fn(
+    frame: *const AASDKDecodedFrame,
+    user_data: *mut c_void,
+);
+
+// AASDKMediaInfo::flags
+pub const AASDK_MEDIA_INFO_HAS_TIMESTAMP: u32 = 0x01;
+
+// Timing of one audio/video payload (AASDKMediaInfo), valid during the callback only
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct AASDKMediaInfo {
+    pub channel: i32,
+    pub flags: u32,
+    pub timestamp: u64,
+    pub receive_ns: u64,
+    pub sequence: u64,
+}
+
+// Version 2 media callbacks, which add the payload's AASDKMediaInfo
+pub type VideoFrameCallbackV2 = extern "C" fn(
+    data: *const u8,
+    size: u32,
+    width: u32,
+    height: u32,
+    info: *const AASDKMediaInfo,
+    user_data: *mut c_void,
+);
+
+pub type AudioDataCallbackV2 = extern "C" fn(
+    samples: *const i16,
+    sample_count: u32,
+    channels: u32,
+    sample_rate: u32,
+    info: *const AASDKMediaInfo,
+    user_data: *mut c_void,
+);
+
+// 32-bit output layouts for aasdk_convert_frame (AASDKRgbFormat)
+pub const AASDK_RGB_FORMAT_RGBA: i32 = 0;
+#[allow(dead_code)]
+pub const AASDK_RGB_FORMAT_BGRA: i32 = 1;
+
+// Negotiated video configuration, refined by the latest SPS (AASDKVideoConfig)
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct AASDKVideoConfig {
+    pub width: u32,
+    pub height: u32,
+    pub profile_idc: u32,
+    pub level_idc: u32,
+    pub fps: u32,
+    pub margin_width: u32,
+    pub margin_height: u32,
+    pub dpi: u32,
+}
+
+// Shared-memory frame ring descriptors (AASDKFrameRingInfo); the slot layout and
+// protocol are documented with AASDKFrameRingHeader in aasdk_c.h
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct AASDKFrameRingInfo {
+    pub memfd: i32,
+    pub doorbell_fd: i32,
+    pub size: u64,
+    pub slot_count: u32,
+    pub max_width: u32,
+    pub max_height: u32,
+}
+
+// Upper bound on io_service worker threads (AASDK_MAX_IO_THREADS)
+pub const AASDK_MAX_IO_THREADS: usize = 8;
+
+// Media flow control windows (AASDK_*_ACK_WINDOW)
+pub const AASDK_DEFAULT_VIDEO_ACK_WINDOW: u32 = 2;
+pub const AASDK_DEFAULT_AUDIO_ACK_WINDOW: u32 = 4;
+#[allow(dead_code)]
+pub const AASDK_MAX_ACK_WINDOW: u32 = 32;
+
+// Receive-to-consume video lag that triggers a resync (AASDK_DEFAULT_VIDEO_LAG_THRESHOLD_MS)
+pub const AASDK_DEFAULT_VIDEO_LAG_THRESHOLD_MS: u32 = 200;
+
+// Video lag histogram buckets: bucket i counts lags below 2^i ms, the last one the rest
+pub const AASDK_LAG_HISTOGRAM_BUCKETS: usize = 12;
+
+// Audio/video channels with media flow control (AASDKAVChannel), indexes AASDKStats::media_ack
+pub const AASDK_AV_CHANNEL_COUNT: usize = 4;
+pub const AASDK_AV_CHANNEL_NAMES: [&str; AASDK_AV_CHANNEL_COUNT] = [
+    "video",
+    "media_audio",
+    "speech_audio",
+    "system_audio",
+];
+
+// Per-channel media ack counters (AASDKMediaAckStats)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, serde::Serialize)]
+pub struct AASDKMediaAckStats {
+    pub window: u32,
+    pub in_flight: u32,
+    pub in_flight_max: u32,
+    pub received: u64,
+    pub acked: u64,
+    pub ack_errors: u64,
+    pub ack_delay_us_avg: u32,
+    pub ack_delay_us_max: u32,
+}
+
+// Upper bound on AASDKInitOptions::audio_ring_ms (AASDK_MAX_AUDIO_RING_MS)
+#[allow(dead_code)]
+pub const AASDK_MAX_AUDIO_RING_MS: u32 = 2000;
+
+// PCM format of an audio stream (AASDKAudioFormat)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct AASDKAudioFormat {
+    pub sample_rate: u32,
+    pub channels: u32,
+    pub bit_depth: u32,
+}
+
+// First frame returned by aasdk_audio_read (AASDKAudioReadInfo)
+#[allow(dead_code)]
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct AASDKAudioReadInfo {
+    pub flags: u32,
+    pub available: u32,
+    pub timestamp: u64,
+    pub receive_ns: u64,
+}
+
+// Per-stream PCM ring counters (AASDKAudioRingStats)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, serde::Serialize)]
+pub struct AASDKAudioRingStats {
+    pub capacity_frames: u32,
+    pub buffered_frames: u32,
+    pub written_frames: u64,
+    pub overrun_frames: u64,
+    pub underruns: u64,
+    pub target_frames: u32,
+    pub jitter_us: u32,
+    pub latency_us: u32,
+    pub trimmed_frames: u64,
+}
+
+// Jitter buffer bounds of one audio stream (AASDKJitterConfig)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+#[allow(dead_code)]
+pub struct AASDKJitterConfig {
+    pub min_ms: u32,
+    pub max_ms: u32,
+}
+
+// Upper bound on AASDKMixerConfig::period_frames (AASDK_MAX_MIXER_PERIOD_FRAMES)
+#[allow(dead_code)]
+pub const AASDK_MAX_MIXER_PERIOD_FRAMES: u32 = 8192;
+
+// Native mixer output (AASDKMixerConfig)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct AASDKMixerConfig {
+    pub sample_rate: u32,
+    pub channels: u32,
+    pub period_frames: u32,
+    pub duck_gain: f32,
+    pub duck_attack_ms: u32,
+    pub duck_release_ms: u32,
+}
+
+// Microphone capture for the AV_INPUT channel (AASDKMicConfig)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct AASDKMicConfig {
+    pub period_ms: u32,
+    pub ring_ms: u32,
+    pub max_latency_ms: u32,
+}
+
+// Phone opened (true) or closed the microphone, on an io thread
+pub type MicStateCallback = extern "C" fn(open: bool, user_data: *mut c_void);
+
+// Microphone capture counters (AASDKMicStats)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, serde::Serialize)]
+pub struct AASDKMicStats {
+    pub open: bool,
+    pub max_unacked: u32,
+    pub opens: u64,
+    pub captured_frames: u64,
+    pub dropped_frames: u64,
+    pub payloads_sent: u64,
+    pub payloads_acked: u64,
+    pub window_stalls: u64,
+    pub latency_us_avg: u32,
+    pub latency_us_max: u32,
+}
+
+// Audio focus arbitration (AASDKAudioFocusInfo); state is an AASDKAudioFocusState
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, serde::Serialize)]
+pub struct AASDKAudioFocusInfo {
+    pub state: i32,
+    pub gain_held: bool,
+    pub media_ducked: bool,
+    pub stream_active: [bool; AASDK_AV_CHANNEL_COUNT],
+    pub requests: u64,
+    pub transitions: u64,
+    pub dropped_frames: [u64; AASDK_AV_CHANNEL_COUNT],
+}
+
+// Touch and key input sent to the phone (AASDKInputStats)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, serde::Serialize)]
+pub struct AASDKInputStats {
+    pub touch_events: u64,
+    pub button_events: u64,
+    pub dropped_events: u64,
+    pub coalesced_moves: u64,
+    pub indications_sent: u64,
+    pub latency_us_avg: u32,
+    pub latency_us_max: u32,
+}
+
+// Focus granted or what plays changed, on an io thread
+pub type AudioFocusCallback = extern "C" fn(focus: *const AASDKAudioFocusInfo, user_data: *mut c_void);
+
+// Initialization options (AASDKInitOptions)
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct AASDKInitOptions {
+    pub io_threads: u32,
+    pub io_thread_cpus: [i32; AASDK_MAX_IO_THREADS],
+    pub video_queue_depth: u32,
+    pub video_ack_window: u32,
+    pub audio_ack_window: u32,
+    pub video_lag_threshold_ms: u32,
+    pub audio_ring_ms: u32,
+}
+
+// Device connection states (AASDKConnectionState)
+pub const AASDK_CONN_STATE_COUNT: usize = 8;
+pub const AASDK_CONN_STATE_NAMES: [&str; AASDK_CONN_STATE_COUNT] = [
+    "idle",
+    "enumerate",
+    "open",
+    "aoap_query",
+    "transport",
+    "handshake",
+    "connected",
+    "failed",
+];
+
+// Connection state snapshot (AASDKConnectionStateInfo)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct AASDKConnectionStateInfo {
+    pub state: i32,
+    pub open_attempts: u32,
+    pub state_time_us: [u64; AASDK_CONN_STATE_COUNT],
+}
+
+// Connection milestone timeline (AASDKConnectTimeline)
+pub const AASDK_TIMELINE_MAX_HANDSHAKE_ROUNDS: usize = 8;
+pub const AASDK_TIMELINE_MAX_CHANNELS: usize = 16;
+
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct AASDKConnectTimeline {
+    pub usb_discovered_ns: u64,
+    pub aoap_switched_ns: u64,
+    pub transport_up_ns: u64,
+    pub version_response_ns: u64,
+    pub handshake_round_count: u32,
+    pub handshake_round_ns: [u64; AASDK_TIMELINE_MAX_HANDSHAKE_ROUNDS],
+    pub auth_complete_ns: u64,
+    pub service_discovery_ns: u64,
+    pub channel_open_ns: [u64; AASDK_TIMELINE_MAX_CHANNELS],
+    pub av_setup_ns: [u64; AASDK_TIMELINE_MAX_CHANNELS],
+    pub first_video_ns: u64,
+    pub first_audio_ns: u64,
+}
+
+// Session replay progress (AASDKReplayStats)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct AASDKLatencyStats {
+    pub count: u64,
+    pub p50_us: u32,
+    pub p90_us: u32,
+    pub p99_us: u32,
+    pub max_us: u32,
+}
+
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct AASDKReplayStats {
+    pub running: bool,
+    pub released: u64,
+    pub skipped: u64,
+    pub unclaimed: u64,
+    pub stalls: u64,
+    pub sent: u64,
+    pub recorded_us: u64,
+    pub elapsed_us: u64,
+    pub control: AASDKLatencyStats,
+    pub handler: [AASDKLatencyStats; AASDK_AV_CHANNEL_COUNT],
+    pub schedule_slip: AASDKLatencyStats,
+}
+
+// Android Auto channel ids, used to index the per-channel timeline arrays
+pub const AASDK_CHANNEL_NAMES: [&str; 9] = [
+    "control",
+    "input",
+    "sensor",
+    "video",
+    "media_audio",
+    "speech_audio",
+    "system_audio",
+    "av_input",
+    "bluetooth",
+];
+
+// Runtime statistics snapshot (AASDKStats)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct AASDKStats {
+    pub io_thread_count: u32,
+    pub io_thread_handlers: [u64; AASDK_MAX_IO_THREADS],
+    pub frame_pool_outstanding: u32,
+    pub frame_pool_allocated: u32,
+    pub video_queue_depth: u32,
+    pub video_queue_size: u32,
+    pub video_queue_high_water: u32,
+    pub video_frames_dropped: u64,
+    pub decoded_frames: u64,
+    pub decode_errors: u64,
+    pub decode_frames_dropped: u64,
+    pub decode_time_us_avg: u32,
+    pub frame_ring_published: u64,
+    pub frame_ring_dropped: u64,
+    pub capture_records: u64,
+    pub capture_bytes: u64,
+    pub capture_dropped: u64,
+    pub video_lag_histogram: [u64; AASDK_LAG_HISTOGRAM_BUCKETS],
+    pub video_lag_ms_max: u32,
+    pub video_resyncs: u64,
+    pub video_keyframe_requests: u64,
+    pub media_ack: [AASDKMediaAckStats; AASDK_AV_CHANNEL_COUNT],
+    pub audio_ring: [AASDKAudioRingStats; AASDK_AV_CHANNEL_COUNT],
+    pub mixer_periods: u64,
+    pub mixer_ducked: bool,
+    pub mic: AASDKMicStats,
+    pub audio_focus: AASDKAudioFocusInfo,
+    pub input: AASDKInputStats,
+}
+
 #[link(name = "aasdk_c", kind = "static")]
 extern "C" {
     pub fn aasdk_init(
@@ -45,6 +451,100 @@ extern "C" {
         conn_cb: ConnectionStatusCallback,
         user_data: *mut c_void,
     ) -> AASDKHandle;
+    pub fn aasdk_default_init_options(options: *mut AASDKInitOptions);
+    pub fn aasdk_init_with_options(
+        video_cb: VideoFrameCallback,
+        audio_cb: AudioDataCallback,
+        conn_cb: ConnectionStatusCallback,
+        user_data: *mut c_void,
+        options: *const AASDKInitOptions,
+    ) -> AASDKHandle;
+    pub fn aasdk_get_connection_state(
+        handle: AASDKHandle,
+        info: *mut AASDKConnectionStateInfo,
+    ) -> bool;
+    pub fn aasdk_get_connect_timeline(
+        handle: AASDKHandle,
+        timeline: *mut AASDKConnectTimeline,
+    ) -> bool;
+    pub fn aasdk_get_stats(handle: AASDKHandle, stats: *mut AASDKStats) -> bool;
+    pub fn aasdk_set_media_callbacks_v2(
+        handle: AASDKHandle,
+        video_cb: Option<VideoFrameCallbackV2>,
+        audio_cb: Option<AudioDataCallbackV2>,
+        user_data: *mut c_void,
+    );
+    pub fn aasdk_set_video_frame_ref_callback(
+        handle: AASDKHandle,
+        callback: Option<VideoFrameRefCallback>,
+        user_data: *mut c_void,
+    );
+    pub fn aasdk_video_queue_pop(handle: AASDKHandle, timeout_ms: u32) -> *mut AASDKFrame;
+    pub fn aasdk_set_decoded_frame_callback(
+        handle: AASDKHandle,
+        callback: Option<DecodedFrameCallback>,
+        user_data: *mut c_void,
+    ) -> bool;
+    #[allow(dead_code)]
+    pub fn aasdk_get_audio_format(handle: AASDKHandle, stream: i32, format: *mut AASDKAudioFormat) -> bool;
+    #[allow(dead_code)]
+    pub fn aasdk_audio_read(
+        handle: AASDKHandle,
+        stream: i32,
+        samples: *mut i16,
+        frames: u32,
+        info: *mut AASDKAudioReadInfo,
+    ) -> u32;
+    #[allow(dead_code)]
+    pub fn aasdk_default_jitter_config(config: *mut AASDKJitterConfig);
+    #[allow(dead_code)]
+    pub fn aasdk_set_jitter_config(handle: AASDKHandle, stream: i32, config: *const AASDKJitterConfig) -> bool;
+    pub fn aasdk_default_mixer_config(config: *mut AASDKMixerConfig);
+    pub fn aasdk_enable_mixer(handle: AASDKHandle, config: *const AASDKMixerConfig) -> bool;
+    pub fn aasdk_audio_mix(handle: AASDKHandle, samples: *mut i16, frames: u32) -> u32;
+    #[allow(dead_code)]
+    pub fn aasdk_set_stream_gain(handle: AASDKHandle, stream: i32, gain: f32);
+    pub fn aasdk_set_audio_focus_callback(
+        handle: AASDKHandle,
+        callback: Option<AudioFocusCallback>,
+        user_data: *mut c_void,
+    );
+    pub fn aasdk_default_mic_config(config: *mut AASDKMicConfig);
+    pub fn aasdk_enable_mic(
+        handle: AASDKHandle,
+        config: *const AASDKMicConfig,
+        state_callback: Option<MicStateCallback>,
+        user_data: *mut c_void,
+    ) -> bool;
+    pub fn aasdk_mic_write(handle: AASDKHandle, samples: *const i16, frames: u32, capture_ns: u64) -> u32;
+    pub fn aasdk_mic_play_wav(handle: AASDKHandle, path: *const c_char, looped: bool) -> bool;
+    pub fn aasdk_get_video_config(handle: AASDKHandle, config: *mut AASDKVideoConfig) -> bool;
+    pub fn aasdk_video_prime(handle: AASDKHandle) -> bool;
+    pub fn aasdk_convert_frame(
+        frame: *const AASDKDecodedFrame,
+        dst: *mut u8,
+        dst_stride: u32,
+        dst_width: u32,
+        dst_height: u32,
+        dst_format: i32,
+    ) -> bool;
+    pub fn aasdk_enable_frame_ring(
+        handle: AASDKHandle,
+        slot_count: u32,
+        max_width: u32,
+        max_height: u32,
+    ) -> bool;
+    pub fn aasdk_get_frame_ring(handle: AASDKHandle, info: *mut AASDKFrameRingInfo) -> bool;
+    #[allow(dead_code)]
+    pub fn aasdk_disable_frame_ring(handle: AASDKHandle);
+    pub fn aasdk_start_capture(handle: AASDKHandle, path: *const c_char, capacity_bytes: u64) -> bool;
+    #[allow(dead_code)]
+    pub fn aasdk_stop_capture(handle: AASDKHandle);
+    pub fn aasdk_start_replay(handle: AASDKHandle, path: *const c_char, speed: f64) -> bool;
+    #[allow(dead_code)]
+    pub fn aasdk_get_replay_stats(handle: AASDKHandle, stats: *mut AASDKReplayStats) -> bool;
+    pub fn aasdk_frame_acquire(frame: *mut AASDKFrame);
+    pub fn aasdk_frame_release(frame: *mut AASDKFrame);
     pub fn aasdk_deinit(handle: AASDKHandle);
     pub fn aasdk_start(handle: AASDKHandle) -> bool;
     pub fn aasdk_stop(handle: AASDKHandle);
@@ -54,6 +554,14 @@ extern "C" {
         y: i32,
         action: i32,
     );
+    pub fn aasdk_send_touch(
+        handle: AASDKHandle,
+        pointer_id: u32,
+        x: i32,
+        y: i32,
+        action: i32,
+        time_ns: u64,
+    ) -> bool;
     pub fn aasdk_send_button_event(
         handle: AASDKHandle,
         button_code: i32,
@@ -0,0 +1,287 @@
+// Android Auto microphone
+// The phone opens the AV_INPUT channel's microphone for voice commands. The wrapper
+// frames captured audio into timestamped payloads and paces them against the phone's
+// acks; this side only feeds it: a cpal input stream, running only while the phone
+// listens, writes each device buffer into the wrapper (aasdk_mic_write) as 16 kHz mono,
+// so the audio thread never locks or allocates.
+
+use std::ffi::CStr;
+use std::sync::{mpsc, Mutex};
+use std::thread::JoinHandle;
+use cpal::traits::{DeviceTrait, HostTrait, StreamTrait};
+use crate::aasdk_bindings::*;
+
+// Rate the phone expects (advertised for AV_INPUT)
+const MIC_RATE: u32 = 16000;
+
+// Device capture period, in milliseconds of audio; half a wrapper payload
+const PERIOD_MS: u32 = 10;
+
+// Largest device callback converted in one pass (100 ms at 16 kHz)
+const MAX_CALLBACK_FRAMES: usize = 1600;
+
+// Anti-alias filter for 48 kHz capture: a Blackman-windowed sinc, flat to 6 kHz and
+// down more than 75 dB from 8 kHz, above which 16 kHz output would alias
+const LOW_PASS_TAPS: usize = 127;
+const LOW_PASS_CUTOFF_HZ: f32 = 6800.0;
+
+// Tells the capture thread when the phone opens or closes the microphone
+static MIC_STATE: Mutex<Option<mpsc::Sender<bool>>> = Mutex::new(None);
+
+extern "C" fn mic_state_callback(open: bool, _user_data: *mut std::ffi::c_void) {
+    if let Some(sender) = MIC_STATE.lock().unwrap().as_ref() {
+        let _ = sender.send(open);
+    }
+}
+
+// Converts device buffers to 16 kHz mono and hands them to the wrapper
+struct Capture {
+    handle: AASDKHandle,
+    channels: usize,
+    decimation: usize,  // Device frames per 16 kHz frame
+    taps: Vec<f32>,     // Low-pass applied before decimating; empty at 16 kHz
+    history: Vec<f32>,  // Last taps.len() mono frames, newest first, stored twice over
+    newest: usize,      // Index of the newest frame in history
+    phase: usize,       // Device frames since the last 16 kHz frame
+    pcm: Vec<i16>,
+    len: usize,
+}
+
+// aasdk_mic_write is safe from one capture thread
+unsafe impl Send for Capture {}
+
+impl Capture {
+    fn new(handle: AASDKHandle, channels: usize, rate: u32) -> Capture {
+        let decimation = (rate / MIC_RATE) as usize;
+        let taps = if decimation > 1 { low_pass(LOW_PASS_TAPS, LOW_PASS_CUTOFF_HZ / rate as f32) } else { Vec::new() };
+        Capture {
+            handle,
+            channels,
+            decimation,
+            history: vec![0.0; taps.len() * 2],
+            taps,
+            newest: 0,
+            phase: 0,
+            pcm: vec![0; MAX_CALLBACK_FRAMES],
+            len: 0,
+        }
+    }
+
+    /// Downmix, low-pass and decimate interleaved samples, already scaled to i16 range
+    fn feed(&mut self, samples: impl Iterator<Item = i32>) {
+        let mut channel = 0;
+        let mut frame = 0;
+        for sample in samples {
+            frame += sample;
+            channel += 1;
+            if channel < self.channels {
+                continue;
+            }
+            self.push((frame / self.channels as i32) as f32);
+            channel = 0;
+            frame = 0;
+        }
+        self.flush();
+    }
+
+    fn push(&mut self, frame: f32) {
+        let n = self.taps.len();
+        if n > 0 {
+            // Each frame goes in twice, so the last n frames are always one contiguous slice
+            self.newest = if self.newest == 0 { n - 1 } else { self.newest - 1 };
+            self.history[self.newest] = frame;
+            self.history[self.newest + n] = frame;
+        }
+        self.phase += 1;
+        if self.phase < self.decimation {
+            return;
+        }
+        self.phase = 0;
+
+        let out = if n > 0 {
+            let window = &self.history[self.newest..self.newest + n];
+            self.taps.iter().zip(window).map(|(tap, sample)| tap * sample).sum()
+        } else {
+            frame
+        };
+        self.pcm[self.len] = out.round().clamp(i16::MIN as f32, i16::MAX as f32) as i16;
+        self.len += 1;
+        if self.len == self.pcm.len() {
+            self.flush();
+        }
+    }
+
+    fn flush(&mut self) {
+        if self.len > 0 {
+            unsafe { aasdk_mic_write(self.handle, self.pcm.as_ptr(), self.len as u32, 0) };
+            self.len = 0;
+        }
+    }
+}
+
+/// Microphone feeding the wrapper; dropping it closes the capture device
+pub struct AudioInput {
+    thread: Option<JoinHandle<()>>,
+}
+
+impl AudioInput {
+    /// Enable the wrapper's microphone and capture from the default input device while
+    /// the phone listens. Returns None if there is no usable input device. Call before
+    /// aasdk_start; the wrapper must outlive the returned value.
+    pub fn start(handle: AASDKHandle) -> Option<AudioInput> {
+        let wrapper = AASDKHandleWrapper(handle);
+        let (state_tx, state_rx) = mpsc::channel::<bool>();
+        let (ready_tx, ready_rx) = mpsc::channel::<bool>();
+
+        // cpal streams are not Send, so one thread owns the stream for its whole life
+        let thread = std::thread::Builder::new()
+            .name("aa-audio-in".into())
+            .spawn(move || {
+                // Move the whole wrapper in, not just its raw pointer field
+                let wrapper = wrapper;
+                let host = cpal::default_host();
+                let Some(device) = host.default_input_device() else {
+                    eprintln!("Warning: No audio input device, Android Auto voice commands disabled");
+                    let _ = ready_tx.send(false);
+                    return;
+                };
+                let Some(stream) = open_stream(&device, wrapper.0) else {
+                    let _ = ready_tx.send(false);
+                    return;
+                };
+                let _ = ready_tx.send(true);
+                // Capture only while the phone listens, until the owner drops the sender
+                while let Ok(open) = state_rx.recv() {
+                    if open {
+                        if let Err(e) = stream.play() {
+                            eprintln!("Warning: Failed to start audio input: {}", e);
+                        }
+                    } else if let Err(e) = stream.pause() {
+                        eprintln!("Warning: Failed to pause audio input: {}", e);
+                    }
+                }
+                drop(stream);
+            })
+            .ok()?;
+
+        if !ready_rx.recv().unwrap_or(false) {
+            let _ = thread.join();
+            return None;
+        }
+        *MIC_STATE.lock().unwrap() = Some(state_tx);
+        if !enable(handle) {
+            MIC_STATE.lock().unwrap().take();
+            let _ = thread.join();
+            return None;
+        }
+        Some(AudioInput { thread: Some(thread) })
+    }
+
+    /// Enable the wrapper's microphone and play path into it, from the start each time
+    /// the phone listens, instead of capturing; for testing voice commands without a mic
+    pub fn start_wav(handle: AASDKHandle, path: &CStr) -> Option<AudioInput> {
+        if !enable(handle) || !unsafe { aasdk_mic_play_wav(handle, path.as_ptr(), false) } {
+            eprintln!("Warning: Cannot play {} into the microphone", path.to_string_lossy());
+            return None;
+        }
+        Some(AudioInput { thread: None })
+    }
+}
+
+impl Drop for AudioInput {
+    fn drop(&mut self) {
+        MIC_STATE.lock().unwrap().take();
+        if let Some(thread) = self.thread.take() {
+            let _ = thread.join();
+        }
+    }
+}
+
+// Windowed-sinc low-pass with unity DC gain; cutoff is a fraction of the sample rate
+fn low_pass(taps: usize, cutoff: f32) -> Vec<f32> {
+    use std::f32::consts::PI;
+    let center = (taps - 1) as f32 / 2.0;
+    let mut filter: Vec<f32> = (0..taps)
+        .map(|i| {
+            let x = i as f32 - center;
+            let sinc = if x == 0.0 { 2.0 * cutoff } else { (2.0 * PI * cutoff * x).sin() / (PI * x) };
+            let phase = 2.0 * PI * i as f32 / (taps - 1) as f32;
+            sinc * (0.42 - 0.5 * phase.cos() + 0.08 * (2.0 * phase).cos())
+        })
+        .collect();
+    let gain: f32 = filter.iter().sum();
+    filter.iter_mut().for_each(|tap| *tap /= gain);
+    filter
+}
+
+fn enable(handle: AASDKHandle) -> bool {
+    let mut config = AASDKMicConfig::default();
+    unsafe {
+        aasdk_default_mic_config(&mut config);
+        aasdk_enable_mic(handle, &config, Some(mic_state_callback), std::ptr::null_mut())
+    }
+}
+
+// Paused capture stream at 16 kHz (or a multiple of it), or None if it cannot be opened
+fn open_stream(device: &cpal::Device, handle: AASDKHandle) -> Option<cpal::Stream> {
+    // Prefer 16 kHz so nothing is decimated, then mono, then i16
+    let mut candidates: Vec<_> = device.supported_input_configs().ok()?
+        .filter(|range| {
+            (1..=2).contains(&range.channels())
+                && matches!(range.sample_format(), cpal::SampleFormat::I16 | cpal::SampleFormat::F32)
+        })
+        .filter_map(|range| {
+            [MIC_RATE, MIC_RATE * 3]
+                .into_iter()
+                .find(|rate| (range.min_sample_rate().0..=range.max_sample_rate().0).contains(rate))
+                .map(|rate| (range, rate))
+        })
+        .collect();
+    candidates.sort_by_key(|(range, rate)| {
+        (*rate != MIC_RATE, range.channels() != 1, range.sample_format() != cpal::SampleFormat::I16)
+    });
+    let Some((range, rate)) = candidates.into_iter().next() else {
+        eprintln!("Warning: Audio input has no 16 or 48 kHz mono/stereo 16-bit/float capture");
+        return None;
+    };
+
+    let sample_format = range.sample_format();
+    let buffer_size = range.buffer_size().clone();
+    let mut config = range.with_sample_rate(cpal::SampleRate(rate)).config();
+    if let cpal::SupportedBufferSize::Range { min, max } = buffer_size {
+        config.buffer_size = cpal::BufferSize::Fixed((rate * PERIOD_MS / 1000).clamp(min, max));
+    }
+
+    let mut capture = Capture::new(handle, config.channels as usize, rate);
+    let on_error = |e: cpal::StreamError| eprintln!("Audio input error: {}", e);
+    let stream = match sample_format {
+        cpal::SampleFormat::I16 => device.build_input_stream(
+            &config,
+            move |data: &[i16], _: &cpal::InputCallbackInfo| {
+                capture.feed(data.iter().map(|&sample| sample as i32));
+            },
+            on_error,
+            None,
+        ),
+        _ => device.build_input_stream(
+            &config,
+            move |data: &[f32], _: &cpal::InputCallbackInfo| {
+                capture.feed(data.iter().map(|&sample| (sample.clamp(-1.0, 1.0) * 32767.0) as i32));
+            },
+            on_error,
+            None,
+        ),
+    };
+
+    let stream = match stream {
+        Ok(stream) => stream,
+        Err(e) => {
+            eprintln!("Warning: Failed to open audio input: {}", e);
+            return None;
+        }
+    };
+    // Runs once the phone opens the microphone
+    let _ = stream.pause();
+    eprintln!("Audio input: {} Hz x{} ({:?}) for voice commands", rate, config.channels, sample_format);
+    Some(stream)
+}
@@ -0,0 +1,176 @@
+// Android Auto audio output
+// The wrapper's native mixer sums the media, speech and system streams, ducking media
+// under guidance, into one stream in the device's format. A single cpal output stream
+// plays it; the device callback pulls each period straight from the mixer
+// (aasdk_audio_mix), so the audio thread never locks or allocates. Audio focus gates the
+// streams inside the wrapper, not the device: system sounds play without the phone asking
+// for focus, so the device runs for the whole session.
+
+use std::sync::mpsc;
+use std::thread::JoinHandle;
+use cpal::traits::{DeviceTrait, HostTrait, StreamTrait};
+use crate::aasdk_bindings::*;
+
+// Device and mixer period, in milliseconds of audio; the rings absorb USB jitter, so a
+// short period only trims output latency
+const PERIOD_MS: u32 = 10;
+
+// Rate to ask the device for; the media stream's own, so only speech and system resample
+const PREFERRED_RATE: u32 = 48000;
+
+// Largest device callback converted to f32 in one pass (200 ms at 48 kHz stereo)
+const MAX_CALLBACK_SAMPLES: usize = 19200;
+
+// Wrapper handle the device callback mixes from; valid until the output is dropped
+#[derive(Clone, Copy)]
+struct Mixer {
+    handle: AASDKHandle,
+    channels: usize,
+}
+
+// aasdk_audio_mix is safe from one audio thread
+unsafe impl Send for Mixer {}
+
+impl Mixer {
+    /// Fill samples with the next mixed frames
+    fn mix(&self, samples: &mut [i16]) {
+        let frames = samples.len() / self.channels;
+        let mixed = unsafe { aasdk_audio_mix(self.handle, samples.as_mut_ptr(), frames as u32) } as usize;
+        samples[mixed * self.channels..].fill(0);
+    }
+}
+
+/// Output stream playing the wrapper's mixed audio; dropping it stops playback
+pub struct AudioOutput {
+    stop: Option<mpsc::Sender<()>>,
+    thread: Option<JoinHandle<()>>,
+}
+
+impl AudioOutput {
+    /// Enable the wrapper's mixer in the default device's format and play it. Returns
+    /// None if there is no usable output device. Call before aasdk_start; the wrapper
+    /// must have been initialized with audio rings and must outlive the returned value.
+    pub fn start(handle: AASDKHandle) -> Option<AudioOutput> {
+        let wrapper = AASDKHandleWrapper(handle);
+
+        // cpal streams are not Send, so one thread owns them for their whole life
+        let (stop_tx, stop_rx) = mpsc::channel::<()>();
+        let (ready_tx, ready_rx) = mpsc::channel::<bool>();
+        let thread = std::thread::Builder::new()
+            .name("aa-audio-out".into())
+            .spawn(move || {
+                // Move the whole wrapper in, not just its raw pointer field
+                let wrapper = wrapper;
+                let host = cpal::default_host();
+                let Some(device) = host.default_output_device() else {
+                    eprintln!("Warning: No audio output device, Android Auto audio disabled");
+                    let _ = ready_tx.send(false);
+                    return;
+                };
+                let Some(stream) = open_stream(&device, wrapper.0) else {
+                    let _ = ready_tx.send(false);
+                    return;
+                };
+                let _ = ready_tx.send(true);
+                // Keep playing until the owner drops the sender
+                let _ = stop_rx.recv();
+                drop(stream);
+            })
+            .ok()?;
+
+        if !ready_rx.recv().unwrap_or(false) {
+            let _ = thread.join();
+            return None;
+        }
+        Some(AudioOutput { stop: Some(stop_tx), thread: Some(thread) })
+    }
+}
+
+impl Drop for AudioOutput {
+    fn drop(&mut self) {
+        self.stop.take();
+        if let Some(thread) = self.thread.take() {
+            let _ = thread.join();
+        }
+    }
+}
+
+// Mixed output stream in the device's preferred format, or None if it cannot be opened
+fn open_stream(device: &cpal::Device, handle: AASDKHandle) -> Option<cpal::Stream> {
+    // Prefer stereo, then i16 so samples are copied straight into the device buffer
+    let mut ranges: Vec<_> = device.supported_output_configs().ok()?
+        .filter(|range| {
+            (1..=2).contains(&range.channels())
+                && matches!(range.sample_format(), cpal::SampleFormat::I16 | cpal::SampleFormat::F32)
+        })
+        .collect();
+    ranges.sort_by_key(|range| (range.channels() != 2, range.sample_format() != cpal::SampleFormat::I16));
+    let Some(range) = ranges.into_iter().next() else {
+        eprintln!("Warning: Audio device has no mono or stereo 16-bit/float output");
+        return None;
+    };
+
+    let sample_format = range.sample_format();
+    let buffer_size = range.buffer_size().clone();
+    let rate = cpal::SampleRate(PREFERRED_RATE).clamp(range.min_sample_rate(), range.max_sample_rate());
+    let mut config = range.with_sample_rate(rate).config();
+    let period = rate.0 * PERIOD_MS / 1000;
+    if let cpal::SupportedBufferSize::Range { min, max } = buffer_size {
+        config.buffer_size = cpal::BufferSize::Fixed(period.clamp(min, max));
+    }
+
+    // Mix straight into the device format
+    let mut mixer_config = AASDKMixerConfig::default();
+    unsafe { aasdk_default_mixer_config(&mut mixer_config) };
+    mixer_config.sample_rate = rate.0;
+    mixer_config.channels = config.channels as u32;
+    mixer_config.period_frames = period.clamp(1, AASDK_MAX_MIXER_PERIOD_FRAMES);
+    if !unsafe { aasdk_enable_mixer(handle, &mixer_config) } {
+        eprintln!("Warning: Audio mixer unavailable, Android Auto audio disabled");
+        return None;
+    }
+
+    let mixer = Mixer { handle, channels: config.channels as usize };
+    let on_error = |e: cpal::StreamError| eprintln!("Audio output error: {}", e);
+    let stream = match sample_format {
+        cpal::SampleFormat::I16 => device.build_output_stream(
+            &config,
+            move |data: &mut [i16], _: &cpal::OutputCallbackInfo| {
+                mixer.mix(data);
+            },
+            on_error,
+            None,
+        ),
+        _ => {
+            let mut scratch = vec![0i16; MAX_CALLBACK_SAMPLES - MAX_CALLBACK_SAMPLES % mixer.channels];
+            device.build_output_stream(
+                &config,
+                move |data: &mut [f32], _: &cpal::OutputCallbackInfo| {
+                    for chunk in data.chunks_mut(scratch.len()) {
+                        let pcm = &mut scratch[..chunk.len()];
+                        mixer.mix(pcm);
+                        for (out, sample) in chunk.iter_mut().zip(pcm.iter()) {
+                            *out = *sample as f32 / 32768.0;
+                        }
+                    }
+                },
+                on_error,
+                None,
+            )
+        }
+    };
+
+    let stream = match stream {
+        Ok(stream) => stream,
+        Err(e) => {
+            eprintln!("Warning: Failed to open audio output: {}", e);
+            return None;
+        }
+    };
+    if let Err(e) = stream.play() {
+        eprintln!("Warning: Failed to start audio output: {}", e);
+        return None;
+    }
+    eprintln!("Audio output: {} Hz x{} ({:?}), mixed natively", rate.0, config.channels, sample_format);
+    Some(stream)
+}
@@ -3,16 +3,19 @@
 
 mod hardware;
 mod audio;
+mod audio_input;
+mod audio_output;
 mod openauto;
 mod aasdk_bindings;
 mod video_decoder;
+mod video_ipc;
 
 use hardware::{HardwareManager, HardwareStatus};
 use audio::AudioManager;
-use openauto::OpenAutoManager;
+use openauto::{ButtonCode, OpenAutoManager, OpenAutoStats, TouchAction};
 use std::sync::{Arc, Mutex};
 use std::sync::atomic::{AtomicBool, Ordering};
-use tauri::Emitter;
+use tauri::ipc::{Channel, InvokeResponseBody};
 
 // Global state for hardware managers
 struct AppState {
@@ -58,61 +61,106 @@ fn is_openauto_connected(state: tauri::State<AppState>) -> Result<bool, String>
     Ok(openauto.is_connected())
 }
 
+#[tauri::command]
+fn get_openauto_stats(state: tauri::State<AppState>) -> Result<Option<OpenAutoStats>, String> {
+    let openauto = state.inner().openauto.lock().map_err(|e| format!("Lock error: {}", e))?;
+    Ok(openauto.stats())
+}
+
+/// One finger of a touch gesture on the projection, in the advertised 1280x720 touch
+/// screen's pixels; action is "down", "move" or "up". False if the wrapper dropped it.
+#[tauri::command]
+fn send_touch(
+    state: tauri::State<AppState>,
+    pointer_id: u32,
+    x: i32,
+    y: i32,
+    action: String,
+) -> Result<bool, String> {
+    let action = TouchAction::parse(&action).ok_or_else(|| format!("Unknown touch action: {}", action))?;
+    let openauto = state.inner().openauto.lock().map_err(|e| format!("Lock error: {}", e))?;
+    Ok(openauto.send_touch(pointer_id, x, y, action))
+}
+
+/// Press or release a key on the phone ("left", "enter", "back", "home", ...)
+#[tauri::command]
+fn send_button(state: tauri::State<AppState>, button: String, pressed: bool) -> Result<(), String> {
+    let button = ButtonCode::parse(&button).ok_or_else(|| format!("Unknown button: {}", button))?;
+    let openauto = state.inner().openauto.lock().map_err(|e| format!("Lock error: {}", e))?;
+    openauto.send_button(button, pressed);
+    Ok(())
+}
+
+/// Stream video to on_frame until stop_video_stream. Natively decoded pictures are sent
+/// as RGBA no larger than max_width x max_height (0 = decoded size); without a native
+/// decoder the H.264 is sent for the webview to decode. Returns the payload format,
+/// "rgba" or "h264".
 #[tauri::command]
 async fn start_video_stream(
     state: tauri::State<'_, AppState>,
-    app: tauri::AppHandle,
-) -> Result<(), String> {
+    on_frame: Channel<InvokeResponseBody>,
+    max_width: u32,
+    max_height: u32,
+) -> Result<String, String> {
     // Check if already streaming
     if state.video_streaming_active.load(Ordering::SeqCst) {
-        return Ok(()); // Already streaming
+        return Err("Video stream already running".to_string());
     }
 
-    let openauto = state.openauto.clone();
+    let (pictures, source) = {
+        let openauto = state.openauto.lock().map_err(|e| format!("Lock error: {}", e))?;
+        match openauto.picture_source(max_width, max_height) {
+            Some(pictures) => (Some(pictures), None),
+            None => {
+                // The webview creates a fresh decoder for every stream; hand it the codec
+                // configuration now instead of leaving it black until the next IDR
+                openauto.prime_video();
+                (None, Some(openauto.video_source()))
+            }
+        }
+    };
+    let format = if pictures.is_some() { "rgba" } else { "h264" };
+
     let streaming_flag = state.video_streaming_active.clone();
 
     // Set streaming flag
     streaming_flag.store(true, Ordering::SeqCst);
 
-    // Spawn background task to emit video frames
-    tauri::async_runtime::spawn(async move {
-        eprintln!("Video streaming task started");
-
-        while streaming_flag.load(Ordering::SeqCst) {
-            // Try to get a frame with a timeout
-            let frame = {
-                let manager = openauto.lock().unwrap();
-                manager.recv_video_frame_timeout(std::time::Duration::from_millis(100))
-            };
-
-            if let Some(frame) = frame {
-                // For now, just pass raw H264 data to frontend
-                // TODO: Decode H264 to RGB in Rust
-                use base64::{Engine as _, engine::general_purpose};
-                let base64_data = general_purpose::STANDARD.encode(&frame.data);
-
-                // Emit H264 frame to frontend
-                if let Err(e) = app.emit(
-                    "video-frame",
-                    VideoFramePayload {
-                        data: base64_data,
-                        width: frame.width,
-                        height: frame.height,
-                        format: "h264".to_string(),
-                    }
-                ) {
-                    eprintln!("Failed to emit video frame: {}", e);
+    // Frames go out as raw ArrayBuffers over the IPC channel (see video_ipc.rs). Waiting
+    // for a picture or on the wrapper's queue blocks, so this runs on its own thread rather
+    // than the async runtime, and on a source rather than the manager, whose lock other
+    // commands need.
+    std::thread::Builder::new()
+        .name("video-ipc".to_string())
+        .spawn(move || {
+            eprintln!("Video streaming task started ({})", format);
+            let timeout = std::time::Duration::from_millis(20);
+
+            while streaming_flag.load(Ordering::SeqCst) {
+                let sent = if let Some(pictures) = &pictures {
+                    pictures.recv_timeout(timeout).map(|picture| {
+                        let sent = video_ipc::send_picture(&on_frame, &picture);
+                        pictures.recycle(picture);
+                        sent
+                    })
+                } else {
+                    source.as_ref().and_then(|source| source.recv_timeout(timeout))
+                        .map(|frame| video_ipc::send(&on_frame, &frame))
+                };
+
+                if let Some(Err(e)) = sent {
+                    eprintln!("Failed to send video frame: {}", e);
                 }
             }
 
-            // Small yield to prevent CPU spinning
-            tokio::time::sleep(tokio::time::Duration::from_millis(1)).await;
-        }
-
-        eprintln!("Video streaming task stopped");
-    });
+            eprintln!("Video streaming task stopped");
+        })
+        .map_err(|e| {
+            state.video_streaming_active.store(false, Ordering::SeqCst);
+            e.to_string()
+        })?;
 
-    Ok(())
+    Ok(format.to_string())
 }
 
 #[tauri::command]
@@ -121,12 +169,23 @@ fn stop_video_stream(state: tauri::State<AppState>) -> Result<(), String> {
     Ok(())
 }
 
-#[derive(Clone, serde::Serialize)]
-struct VideoFramePayload {
-    data: String,  // base64 encoded RGB24 data
-    width: u32,
-    height: u32,
-    format: String,  // "rgb24"
+/// Time per-frame IPC cost at 60 fps for "channel" (raw ArrayBuffer) or "event" (base64 JSON)
+#[tauri::command]
+async fn benchmark_video_ipc(
+    app: tauri::AppHandle,
+    on_frame: Channel<InvokeResponseBody>,
+    transport: String,
+    frames: u32,
+    frame_size: u32,
+) -> Result<video_ipc::BenchmarkReport, String> {
+    let transport = video_ipc::Transport::parse(&transport)
+        .ok_or_else(|| format!("Unknown transport: {}", transport))?;
+    tauri::async_runtime::spawn_blocking(move || {
+        video_ipc::run_benchmark(&app, &on_frame, transport, frames, frame_size)
+    })
+    .await
+    .map_err(|e| e.to_string())?
+    .map_err(|e| e.to_string())
 }
 
 // Note: Path management removed as we're using AASDK directly now
@@ -166,8 +225,12 @@ pub fn run() {
                 stop_openauto,
                 is_openauto_running,
                 is_openauto_connected,
+                get_openauto_stats,
+                send_touch,
+                send_button,
                 start_video_stream,
                 stop_video_stream,
+                benchmark_video_ipc,
             ])
         .run(tauri::generate_context!())
         .expect("error while running tauri application");
@@ -1,36 +1,192 @@
 // OpenAuto integration module using AASDK directly
 // This integrates Android Auto directly into the Tauri app without launching a separate process
-use std::sync::{Arc, Mutex, atomic::{AtomicBool, Ordering}};
-use std::sync::mpsc::{channel, Sender, Receiver};
+use std::sync::{Arc, Mutex, RwLock, atomic::{AtomicBool, Ordering}};
 use anyhow::Result;
 use crate::aasdk_bindings::*;
+use crate::video_decoder::{DecodedPictures, PictureSource};
 
 // Static connection status for callbacks
 static CONNECTION_STATUS: AtomicBool = AtomicBool::new(false);
 
-// Static video frame sender for callbacks
-static VIDEO_SENDER: Mutex<Option<Sender<VideoFrame>>> = Mutex::new(None);
+// Set once the connect timeline for the current connection has been logged
+static TIMELINE_LOGGED: AtomicBool = AtomicBool::new(false);
+
+// io_service worker threads - enough for video, audio and control to run side by
+// side on a Pi 5 without taking every core
+const MAX_IO_THREADS: usize = 4;
+
+// Frames the wrapper buffers for the frontend (~66ms at 60fps) before it starts
+// dropping whole GOPs; more depth only adds latency once the consumer is behind
+const VIDEO_QUEUE_DEPTH: u32 = 4;
+
+// PCM ring per audio stream. The jitter buffer keeps the depth near the measured USB
+// jitter and trims any standing backlog, so the size is headroom, not latency; its
+// target is held to half the ring, so this leaves room for the 200 ms default maximum
+const AUDIO_RING_MS: u32 = 400;
 
 pub struct OpenAutoManager {
     enabled: Arc<Mutex<bool>>,
-    handle: Arc<Mutex<Option<crate::aasdk_bindings::AASDKHandleWrapper>>>,
-    video_rx: Arc<Mutex<Option<Receiver<VideoFrame>>>>,
+    // Read-locked across every call into the wrapper and write-locked to init or deinit
+    // it, so a video pop blocking in the wrapper does not hold up stats or input
+    handle: Arc<RwLock<Option<crate::aasdk_bindings::AASDKHandleWrapper>>>,
+    audio_output: Mutex<Option<crate::audio_output::AudioOutput>>,
+    audio_input: Mutex<Option<crate::audio_input::AudioInput>>,
+    // Pictures from the wrapper's native decoder; the wrapper points at it, so it is never replaced
+    pictures: Arc<DecodedPictures>,
+    // Set while the wrapper decodes natively and the raw H.264 stream has no consumer
+    native_video: AtomicBool,
+}
+
+/// Wrapper runtime statistics exposed to the frontend
+#[derive(Clone, Debug, Default, serde::Serialize)]
+pub struct OpenAutoStats {
+    pub io_thread_count: u32,
+    pub io_thread_handlers: Vec<u64>,
+    /// Video frames currently held by the frontend pipeline
+    pub frame_pool_outstanding: u32,
+    /// Video buffers allocated since start (flat once the pool is warm)
+    pub frame_pool_allocated: u32,
+    pub video_queue_depth: u32,
+    /// Most frames ever waiting for the frontend at once
+    pub video_queue_high_water: u32,
+    /// Frames discarded because the frontend fell behind (whole GOPs)
+    pub video_frames_dropped: u64,
+    /// Native decoder counters (zero when the wrapper is built without libavcodec)
+    pub decoded_frames: u64,
+    pub decode_errors: u64,
+    pub decode_frames_dropped: u64,
+    pub decode_time_us_avg: u32,
+    /// Pictures shared through the memfd frame ring (zero unless OPENAUTO_FRAME_RING is set)
+    pub frame_ring_published: u64,
+    pub frame_ring_dropped: u64,
+    /// Protocol capture counters (zero unless OPENAUTO_CAPTURE is set)
+    pub capture_records: u64,
+    pub capture_bytes: u64,
+    pub capture_dropped: u64,
+    /// Receive-to-consume lag of video frames: bucket i counts lags below 2^i ms
+    pub video_lag_histogram: Vec<u64>,
+    pub video_lag_ms_max: u32,
+    /// Backlogs flushed to the next IDR, and video focus cycles that forced one
+    pub video_resyncs: u64,
+    pub video_keyframe_requests: u64,
+    /// Negotiated video mode, resolution confirmed by the phone's SPS (zero until negotiated)
+    pub video_width: u32,
+    pub video_height: u32,
+    pub video_fps: u32,
+    /// Letterboxing inside the picture, for mapping touches onto the phone UI
+    pub video_margin_width: u32,
+    pub video_margin_height: u32,
+    /// H.264 profile from the SPS (zero until one arrives)
+    pub video_profile: u32,
+    /// Media flow control per audio/video channel, keyed by channel name
+    pub media_ack: Vec<(String, AASDKMediaAckStats)>,
+    /// PCM buffered for the audio output per audio stream, keyed by stream name
+    pub audio_ring: Vec<(String, AASDKAudioRingStats)>,
+    /// Periods rendered by the native mixer, and whether media is ducked under guidance
+    pub mixer_periods: u64,
+    pub mixer_ducked: bool,
+    /// Microphone capture for voice commands: payloads, drops and capture-to-send latency
+    pub mic: AASDKMicStats,
+    /// Audio focus granted to the phone, the streams it lets play and frames dropped while paused
+    pub audio_focus: AASDKAudioFocusInfo,
+    /// Touches and keys sent to the phone, moves merged while the channel was busy, and queue-to-send latency
+    pub input: AASDKInputStats,
+    pub connection_state: String,
+    pub connection_open_attempts: u32,
+    /// Cumulative time spent in each connection state, keyed by state name
+    pub connection_state_time_us: Vec<(String, u64)>,
+}
+
+/// Reference to a pooled wrapper frame; the buffer goes back to the pool on drop
+pub struct FrameRef(std::ptr::NonNull<AASDKFrame>);
+
+// The payload is immutable once delivered and the reference count is atomic
+unsafe impl Send for FrameRef {}
+unsafe impl Sync for FrameRef {}
+
+impl FrameRef {
+    fn frame(&self) -> &AASDKFrame {
+        unsafe { self.0.as_ref() }
+    }
+}
+
+impl std::ops::Deref for FrameRef {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        let frame = self.frame();
+        unsafe { std::slice::from_raw_parts(frame.data, frame.size as usize) }
+    }
 }
 
-#[derive(Clone, serde::Serialize)]
+impl AsRef<[u8]> for FrameRef {
+    fn as_ref(&self) -> &[u8] {
+        self
+    }
+}
+
+impl Clone for FrameRef {
+    fn clone(&self) -> Self {
+        unsafe { aasdk_frame_acquire(self.0.as_ptr()) };
+        FrameRef(self.0)
+    }
+}
+
+impl Drop for FrameRef {
+    fn drop(&mut self) {
+        unsafe { aasdk_frame_release(self.0.as_ptr()) };
+    }
+}
+
+#[derive(Clone)]
 pub struct VideoFrame {
-    pub data: Vec<u8>,
+    pub data: FrameRef,
     pub width: u32,
     pub height: u32,
     pub stride: u32,
+    /// Phone media timestamp in microseconds (0 if not provided)
+    pub timestamp: u64,
+    /// Per-connection frame counter (0 for SPS/PPS re-sent by a prime)
+    pub sequence: u64,
+    /// AASDK_NAL_FLAG_* carried by the payload
+    pub nal_flags: u32,
+    /// CLOCK_MONOTONIC nanoseconds when the payload came off USB (0 for SPS/PPS re-sent by a prime)
+    pub receive_ns: u64,
+}
+
+impl VideoFrame {
+    /// True if decoding can (re)start at this frame
+    #[allow(dead_code)]
+    pub fn is_keyframe(&self) -> bool {
+        self.nal_flags & AASDK_NAL_FLAG_IDR != 0
+    }
+
+    /// Time since the payload was received from the phone
+    #[allow(dead_code)]
+    pub fn age_us(&self) -> u64 {
+        if self.receive_ns == 0 {
+            return 0;
+        }
+        monotonic_ns().saturating_sub(self.receive_ns) / 1000
+    }
+}
+
+/// CLOCK_MONOTONIC in nanoseconds, the clock of the wrapper's receive timestamps
+pub fn monotonic_ns() -> u64 {
+    let mut ts = libc::timespec { tv_sec: 0, tv_nsec: 0 };
+    unsafe { libc::clock_gettime(libc::CLOCK_MONOTONIC, &mut ts) };
+    ts.tv_sec as u64 * 1_000_000_000 + ts.tv_nsec as u64
 }
 
 impl OpenAutoManager {
     pub fn new() -> Self {
         Self {
             enabled: Arc::new(Mutex::new(false)),
-            handle: Arc::new(Mutex::new(None)),
-            video_rx: Arc::new(Mutex::new(None)),
+            handle: Arc::new(RwLock::new(None)),
+            audio_output: Mutex::new(None),
+            audio_input: Mutex::new(None),
+            pictures: Arc::new(DecodedPictures::new()),
+            native_video: AtomicBool::new(false),
         }
     }
 
@@ -42,28 +198,32 @@ impl OpenAutoManager {
 
         eprintln!("Starting Android Auto via AASDK...");
 
-        // Create video frame channel
-        let (tx, rx) = channel::<VideoFrame>();
-
-        // Store the sender in the static mutex for callback access
-        {
-            let mut sender = VIDEO_SENDER.lock().unwrap();
-            *sender = Some(tx);
-        }
-
-        // Store the receiver in the manager
-        {
-            let mut video_rx = self.video_rx.lock().unwrap();
-            *video_rx = Some(rx);
-        }
+        // Size the io_service pool so audio never queues behind video callbacks
+        let io_threads = std::thread::available_parallelism()
+            .map(|n| n.get().min(MAX_IO_THREADS))
+            .unwrap_or(1);
+        let mut options = AASDKInitOptions {
+            io_threads: 1,
+            io_thread_cpus: [-1; AASDK_MAX_IO_THREADS],
+            video_queue_depth: VIDEO_QUEUE_DEPTH,
+            video_ack_window: AASDK_DEFAULT_VIDEO_ACK_WINDOW,
+            audio_ack_window: AASDK_DEFAULT_AUDIO_ACK_WINDOW,
+            video_lag_threshold_ms: AASDK_DEFAULT_VIDEO_LAG_THRESHOLD_MS,
+            audio_ring_ms: 0,
+        };
+        unsafe { aasdk_default_init_options(&mut options) };
+        options.io_threads = io_threads as u32;
+        options.video_queue_depth = VIDEO_QUEUE_DEPTH;
+        options.audio_ring_ms = AUDIO_RING_MS;
 
         // Initialize AASDK with callbacks
         let handle = unsafe {
-            aasdk_init(
+            aasdk_init_with_options(
                 video_frame_callback,
                 audio_data_callback,
                 connection_status_callback,
                 std::ptr::null_mut(), // No user data needed for now
+                &options,
             )
         };
 
@@ -71,23 +231,102 @@ impl OpenAutoManager {
             return Err(anyhow::anyhow!("Failed to initialize AASDK"));
         }
 
+        // Audio arrives with its stream, format, phone timestamp and receive time
+        unsafe {
+            aasdk_set_media_callbacks_v2(handle, None, Some(audio_data_callback_v2), std::ptr::null_mut());
+        }
+
+        // Decode natively when the wrapper has libavcodec, so the webview is sent pictures
+        // ready to draw rather than H.264 to decode in wasm (OPENAUTO_WEBVIEW_DECODE keeps
+        // the wasm decoder). The raw stream then has no consumer: it is released as it
+        // arrives instead of backing up the video queue and tripping its lag resyncs.
+        let native_video = std::env::var_os("OPENAUTO_WEBVIEW_DECODE").is_none() && unsafe {
+            aasdk_set_decoded_frame_callback(
+                handle,
+                Some(crate::video_decoder::decoded_frame_callback),
+                self.pictures.user_data(),
+            )
+        };
+        if native_video {
+            unsafe { aasdk_set_video_frame_ref_callback(handle, Some(release_video_frame), handle) };
+            eprintln!("Native video decode enabled");
+        } else {
+            eprintln!("Native video decode off, the webview decodes H.264");
+        }
+        self.native_video.store(native_video, Ordering::SeqCst);
+
+        // Opt-in shared-memory ring of decoded pictures for an external compositor; the
+        // value is the slot count (empty = wrapper default). Starts the native decoder
+        // for the ring alone when the webview decodes itself.
+        if let Some(slots) = std::env::var_os("OPENAUTO_FRAME_RING") {
+            let slots = slots.to_str().and_then(|s| s.parse::<u32>().ok()).unwrap_or(0);
+            let mut ring = AASDKFrameRingInfo::default();
+            if unsafe { aasdk_enable_frame_ring(handle, slots, 0, 0) && aasdk_get_frame_ring(handle, &mut ring) } {
+                eprintln!(
+                    "Frame ring enabled: {} slots of {}x{}, memfd {} doorbell {}",
+                    ring.slot_count, ring.max_width, ring.max_height, ring.memfd, ring.doorbell_fd
+                );
+            } else {
+                eprintln!("Warning: Frame ring unavailable");
+            }
+        }
+
+        // Opt-in protocol capture of every connection to the given file, for offline replay
+        if let Some(path) = std::env::var_os("OPENAUTO_CAPTURE") {
+            match std::ffi::CString::new(path.to_string_lossy().into_owned()) {
+                Ok(path) if unsafe { aasdk_start_capture(handle, path.as_ptr(), 0) } => {
+                    eprintln!("Capturing sessions to {}", path.to_string_lossy());
+                }
+                _ => eprintln!("Warning: Session capture unavailable"),
+            }
+        }
+
+        // Mix the three audio streams natively and play the result
+        *self.audio_output.lock().unwrap() = crate::audio_output::AudioOutput::start(handle);
+
+        // Microphone for voice commands, or a WAV file in its place when OPENAUTO_MIC_WAV is set
+        let mic_wav = std::env::var_os("OPENAUTO_MIC_WAV")
+            .and_then(|path| std::ffi::CString::new(path.to_string_lossy().into_owned()).ok());
+        *self.audio_input.lock().unwrap() = match &mic_wav {
+            Some(path) => crate::audio_input::AudioInput::start_wav(handle, path),
+            None => crate::audio_input::AudioInput::start(handle),
+        };
+
         // Store handle
         {
-            let mut handle_mutex = self.handle.lock().unwrap();
-            *handle_mutex = Some(crate::aasdk_bindings::AASDKHandleWrapper(handle));
+            let mut handle_lock = self.handle.write().unwrap();
+            *handle_lock = Some(crate::aasdk_bindings::AASDKHandleWrapper(handle));
         }
 
-        // Start AASDK (this will start USB device discovery)
-        let started = unsafe { aasdk_start(handle) };
+        // Start AASDK (this will start USB device discovery), or play back a capture
+        // instead of a phone when OPENAUTO_REPLAY is set
+        let replay = std::env::var_os("OPENAUTO_REPLAY")
+            .and_then(|path| std::ffi::CString::new(path.to_string_lossy().into_owned()).ok());
+        let started = match &replay {
+            Some(path) => {
+                let speed = std::env::var("OPENAUTO_REPLAY_SPEED").ok()
+                    .and_then(|s| s.parse::<f64>().ok())
+                    .unwrap_or(1.0);
+                unsafe { aasdk_start_replay(handle, path.as_ptr(), speed) }
+            }
+            None => unsafe { aasdk_start(handle) },
+        };
         if !started {
+            self.audio_output.lock().unwrap().take();
+            self.audio_input.lock().unwrap().take();
+            // Unpublish before freeing: a reader may already have picked the handle up
+            let mut handle_lock = self.handle.write().unwrap();
+            *handle_lock = None;
             unsafe { aasdk_deinit(handle) };
-            let mut handle_mutex = self.handle.lock().unwrap();
-            *handle_mutex = None;
             return Err(anyhow::anyhow!("Failed to start AASDK"));
         }
 
         *enabled = true;
-        eprintln!("Android Auto started - waiting for USB device connection...");
+        if let Some(path) = replay {
+            eprintln!("Android Auto started - replaying {}", path.to_string_lossy());
+        } else {
+            eprintln!("Android Auto started - waiting for USB device connection...");
+        }
         Ok(())
     }
 
@@ -99,25 +338,20 @@ impl OpenAutoManager {
 
         eprintln!("Stopping Android Auto...");
 
-        // Clear video channel
-        {
-            let mut sender = VIDEO_SENDER.lock().unwrap();
-            *sender = None;
-        }
-        {
-            let mut video_rx = self.video_rx.lock().unwrap();
-            *video_rx = None;
-        }
+        // The device callbacks read from and write to the wrapper, so close them first
+        self.audio_output.lock().unwrap().take();
+        self.audio_input.lock().unwrap().take();
 
-        // Stop and cleanup AASDK
-        let mut handle_mutex = self.handle.lock().unwrap();
-        if let Some(handle_wrapper) = handle_mutex.take() {
+        // Stop and cleanup AASDK once no call is inside it; a video pop returns within its timeout
+        let mut handle_lock = self.handle.write().unwrap();
+        if let Some(handle_wrapper) = handle_lock.take() {
             let handle = handle_wrapper.0;
             unsafe {
                 aasdk_stop(handle);
                 aasdk_deinit(handle);
             }
         }
+        self.native_video.store(false, Ordering::SeqCst);
 
         *enabled = false;
         eprintln!("Android Auto stopped");
@@ -133,71 +367,233 @@ impl OpenAutoManager {
         CONNECTION_STATUS.load(Ordering::SeqCst)
     }
 
+    /// Snapshot of the wrapper's runtime statistics, None when not running
+    pub fn stats(&self) -> Option<OpenAutoStats> {
+        let handle_lock = self.handle.read().unwrap();
+        let handle = handle_lock.as_ref()?.0;
+
+        let mut raw = AASDKStats::default();
+        if !unsafe { aasdk_get_stats(handle, &mut raw) } {
+            return None;
+        }
+
+        let mut conn = AASDKConnectionStateInfo::default();
+        if !unsafe { aasdk_get_connection_state(handle, &mut conn) } {
+            return None;
+        }
+
+        // No negotiated mode yet leaves the video fields zeroed
+        let mut video = AASDKVideoConfig::default();
+        unsafe { aasdk_get_video_config(handle, &mut video) };
+
+        let thread_count = (raw.io_thread_count as usize).min(AASDK_MAX_IO_THREADS);
+        Some(OpenAutoStats {
+            io_thread_count: raw.io_thread_count,
+            io_thread_handlers: raw.io_thread_handlers[..thread_count].to_vec(),
+            frame_pool_outstanding: raw.frame_pool_outstanding,
+            frame_pool_allocated: raw.frame_pool_allocated,
+            video_queue_depth: raw.video_queue_depth,
+            video_queue_high_water: raw.video_queue_high_water,
+            video_frames_dropped: raw.video_frames_dropped,
+            decoded_frames: raw.decoded_frames,
+            decode_errors: raw.decode_errors,
+            decode_frames_dropped: raw.decode_frames_dropped,
+            decode_time_us_avg: raw.decode_time_us_avg,
+            frame_ring_published: raw.frame_ring_published,
+            frame_ring_dropped: raw.frame_ring_dropped,
+            capture_records: raw.capture_records,
+            capture_bytes: raw.capture_bytes,
+            capture_dropped: raw.capture_dropped,
+            video_lag_histogram: raw.video_lag_histogram.to_vec(),
+            video_lag_ms_max: raw.video_lag_ms_max,
+            video_resyncs: raw.video_resyncs,
+            video_keyframe_requests: raw.video_keyframe_requests,
+            video_width: video.width,
+            video_height: video.height,
+            video_fps: video.fps,
+            video_margin_width: video.margin_width,
+            video_margin_height: video.margin_height,
+            video_profile: video.profile_idc,
+            media_ack: AASDK_AV_CHANNEL_NAMES
+                .iter()
+                .zip(raw.media_ack.iter())
+                .map(|(name, ack)| (name.to_string(), *ack))
+                .collect(),
+            audio_ring: AASDK_AV_CHANNEL_NAMES
+                .iter()
+                .zip(raw.audio_ring.iter())
+                .skip(1)
+                .map(|(name, ring)| (name.to_string(), *ring))
+                .collect(),
+            mixer_periods: raw.mixer_periods,
+            mixer_ducked: raw.mixer_ducked,
+            mic: raw.mic,
+            audio_focus: raw.audio_focus,
+            input: raw.input,
+            connection_state: AASDK_CONN_STATE_NAMES
+                .get(conn.state as usize)
+                .unwrap_or(&"unknown")
+                .to_string(),
+            connection_open_attempts: conn.open_attempts,
+            connection_state_time_us: AASDK_CONN_STATE_NAMES
+                .iter()
+                .zip(conn.state_time_us.iter())
+                .map(|(name, us)| (name.to_string(), *us))
+                .collect(),
+        })
+    }
+
+    /// Queue the cached SPS/PPS ahead of the next frame so a freshly (re)started
+    /// decoder can resume without waiting for the phone's next IDR
+    pub fn prime_video(&self) -> bool {
+        let handle_lock = self.handle.read().unwrap();
+        match handle_lock.as_ref() {
+            Some(handle) => unsafe { aasdk_video_prime(handle.0) },
+            None => false,
+        }
+    }
+
     /// Get the latest video frame (for rendering in Tauri window)
     /// This is a non-blocking call that returns immediately
     pub fn get_video_frame(&self) -> Option<VideoFrame> {
-        let video_rx = self.video_rx.lock().unwrap();
-        if let Some(ref rx) = *video_rx {
-            // Try to receive without blocking
-            match rx.try_recv() {
-                Ok(frame) => Some(frame),
-                Err(_) => None, // No frame available or channel disconnected
-            }
-        } else {
-            None
-        }
+        self.video_source().pop(0)
     }
 
     /// Try to receive the next video frame, blocking until one is available
-    /// Returns None if the channel is closed or timeout
+    /// Returns None if the wrapper is stopped or timeout
     pub fn recv_video_frame_timeout(&self, timeout: std::time::Duration) -> Option<VideoFrame> {
-        let video_rx = self.video_rx.lock().unwrap();
-        if let Some(ref rx) = *video_rx {
-            match rx.recv_timeout(timeout) {
-                Ok(frame) => Some(frame),
-                Err(_) => None,
-            }
-        } else {
-            None
+        self.video_source().recv_timeout(timeout)
+    }
+
+    /// The wrapper's video queue, to block on without holding whatever guards the manager
+    pub fn video_source(&self) -> VideoSource {
+        VideoSource { handle: self.handle.clone() }
+    }
+
+    /// Natively decoded pictures, converted to RGBA no larger than max_width x max_height
+    /// (0 = decoded size), while the wrapper decodes natively; None when the webview has
+    /// to decode the H.264 from video_source() itself. Pictures are only converted while
+    /// the returned source is alive.
+    pub fn picture_source(&self, max_width: u32, max_height: u32) -> Option<PictureSource> {
+        if !self.native_video.load(Ordering::SeqCst) {
+            return None;
         }
+        Some(self.pictures.subscribe(max_width, max_height))
     }
 
-    /// Send touch input to Android Auto
-    #[allow(dead_code)]
-    pub fn send_touch(&self, x: i32, y: i32, action: TouchAction) {
-        // TODO: Forward touch event to AASDK
-        eprintln!("Touch: ({}, {}) action: {:?}", x, y, action);
+    /// Send touch input to Android Auto: one finger (pointer_id) of a possibly multi-touch
+    /// gesture, in the advertised 1280x720 touch screen's pixels. Never blocks; moves are
+    /// merged while the channel is busy. False if the wrapper dropped it.
+    pub fn send_touch(&self, pointer_id: u32, x: i32, y: i32, action: TouchAction) -> bool {
+        // The read lock keeps stop() from freeing the handle mid-call; a blocking video
+        // pop only shares it
+        let handle_lock = self.handle.read().unwrap();
+        match handle_lock.as_ref() {
+            Some(handle) => unsafe { aasdk_send_touch(handle.0, pointer_id, x, y, action as i32, 0) },
+            None => false,
+        }
     }
 
     /// Send button press to Android Auto
-    #[allow(dead_code)]
     pub fn send_button(&self, button: ButtonCode, pressed: bool) {
-        // TODO: Forward button event to AASDK
-        eprintln!("Button: {:?} pressed: {}", button, pressed);
+        let handle_lock = self.handle.read().unwrap();
+        if let Some(handle) = handle_lock.as_ref() {
+            unsafe { aasdk_send_button_event(handle.0, button as i32, pressed) };
+        }
+    }
+}
+
+/// Consumer end of the wrapper's video queue. Shares the manager's handle lock, so it
+/// follows start() and stop(): pops return None while nothing runs, and stop() waits at
+/// most one pop timeout for a blocked receiver.
+#[derive(Clone)]
+pub struct VideoSource {
+    handle: Arc<RwLock<Option<crate::aasdk_bindings::AASDKHandleWrapper>>>,
+}
+
+impl VideoSource {
+    /// Receive the next video frame, blocking up to timeout for one.
+    /// Returns None if the wrapper is stopped or on timeout.
+    pub fn recv_timeout(&self, timeout: std::time::Duration) -> Option<VideoFrame> {
+        self.pop(timeout.as_millis().min(u32::MAX as u128) as u32)
+    }
+
+    fn pop(&self, timeout_ms: u32) -> Option<VideoFrame> {
+        let handle_lock = self.handle.read().unwrap();
+        let handle = handle_lock.as_ref()?.0;
+
+        // The wrapper's bounded queue drops whole GOPs if we fall behind
+        let frame = std::ptr::NonNull::new(unsafe { aasdk_video_queue_pop(handle, timeout_ms) })?;
+        let frame_ref = FrameRef(frame);
+
+        // First picture of this connection: the bring-up is complete, log how long it took
+        if !TIMELINE_LOGGED.swap(true, Ordering::SeqCst) {
+            log_connect_timeline(handle);
+        }
+
+        let info = frame_ref.frame();
+        Some(VideoFrame {
+            width: info.width,
+            height: info.height,
+            stride: info.size, // H.264 payload size, not a pixel stride
+            timestamp: info.timestamp,
+            sequence: info.sequence,
+            nal_flags: info.nal_flags,
+            receive_ns: info.receive_ns,
+            data: frame_ref,
+        })
     }
 }
 
 #[derive(Debug, Clone, Copy)]
-#[allow(dead_code)]
 pub enum TouchAction {
     Down = 0,
     Up = 1,
     Move = 2,
 }
 
+impl TouchAction {
+    pub fn parse(name: &str) -> Option<Self> {
+        match name {
+            "down" => Some(TouchAction::Down),
+            "up" => Some(TouchAction::Up),
+            "move" => Some(TouchAction::Move),
+            _ => None,
+        }
+    }
+}
+
+/// Android key codes, as the phone reads them
 #[derive(Debug, Clone, Copy)]
-#[allow(dead_code)]
 pub enum ButtonCode {
-    Left = 0,
-    Right = 1,
-    Up = 2,
-    Down = 3,
-    Enter = 4,
-    Back = 5,
-    Home = 6,
-    Phone = 7,
-    CallEnd = 8,
-    Microphone = 9,
+    Left = 21,
+    Right = 22,
+    Up = 19,
+    Down = 20,
+    Enter = 23,
+    Back = 4,
+    Home = 3,
+    Phone = 5,
+    CallEnd = 6,
+    Microphone = 84,
+}
+
+impl ButtonCode {
+    pub fn parse(name: &str) -> Option<Self> {
+        match name {
+            "left" => Some(ButtonCode::Left),
+            "right" => Some(ButtonCode::Right),
+            "up" => Some(ButtonCode::Up),
+            "down" => Some(ButtonCode::Down),
+            "enter" => Some(ButtonCode::Enter),
+            "back" => Some(ButtonCode::Back),
+            "home" => Some(ButtonCode::Home),
+            "phone" => Some(ButtonCode::Phone),
+            "call_end" => Some(ButtonCode::CallEnd),
+            "microphone" => Some(ButtonCode::Microphone),
+            _ => None,
+        }
+    }
 }
 
 impl Default for OpenAutoManager {
@@ -208,63 +604,50 @@ impl Default for OpenAutoManager {
 
 // Callback implementations (called from C code)
 extern "C" fn video_frame_callback(
-    data: *const u8,
-    width: u32,
-    height: u32,
-    buffer_size: u32,
+    _data: *const u8,
+    _width: u32,
+    _height: u32,
+    _buffer_size: u32,
     _user_data: *mut std::ffi::c_void,
 ) {
-    // This will be called from the C wrapper when a new frame arrives
-    if data.is_null() {
-        return;
-    }
-
-    // For H.264 data, buffer_size is the actual compressed data size
-    // NOT stride (which would be for raw pixel data)
-    let frame_size = buffer_size as usize;
-
-    // Copy the frame data into a Vec
-    let frame_data = unsafe {
-        std::slice::from_raw_parts(data, frame_size).to_vec()
-    };
-
-    // Create the video frame
-    let frame = VideoFrame {
-        data: frame_data,
-        width,
-        height,
-        stride: buffer_size, // Store buffer size in stride field
-    };
+    // Unused: frames are pulled from the wrapper's video queue instead
+}
 
-    // Send frame through the channel
-    if let Ok(sender_guard) = VIDEO_SENDER.lock() {
-        if let Some(ref sender) = *sender_guard {
-            // Use try_send to avoid blocking if the channel is full
-            // This will drop frames if the consumer is too slow
-            match sender.send(frame) {
-                Ok(_) => {
-                    // Frame sent successfully - don't log every frame
-                }
-                Err(_) => {
-                    eprintln!("Warning: Video frame channel full or disconnected");
-                }
-            }
-        }
+// Native decoding takes its own reference to every payload, so the H.264 is not kept.
+// user_data is the handle: the first payload completes the bring-up, as a pop does.
+extern "C" fn release_video_frame(frame: *mut AASDKFrame, user_data: *mut std::ffi::c_void) {
+    unsafe { aasdk_frame_release(frame) };
+    if !TIMELINE_LOGGED.swap(true, Ordering::SeqCst) {
+        log_connect_timeline(user_data);
     }
 }
 
 extern "C" fn audio_data_callback(
+    _samples: *const i16,
+    _sample_count: u32,
+    _channels: u32,
+    _sample_rate: u32,
+    _user_data: *mut std::ffi::c_void,
+) {
+    // Unused: audio_data_callback_v2 is installed instead
+}
+
+extern "C" fn audio_data_callback_v2(
     samples: *const i16,
     sample_count: u32,
     channels: u32,
     sample_rate: u32,
+    info: *const AASDKMediaInfo,
     _user_data: *mut std::ffi::c_void,
 ) {
-    // This will be called from the C wrapper when new audio samples arrive
-    if !samples.is_null() {
-        // TODO: Send audio to AudioManager
-        eprintln!("Received audio: {} samples, {} channels, {} Hz", 
-                 sample_count, channels, sample_rate);
+    // Playback mixes the wrapper's PCM rings (audio_output); this only reports each stream starting
+    if !samples.is_null() && !info.is_null() {
+        let info = unsafe { &*info };
+        if info.sequence == 1 {
+            let channel = AASDK_AV_CHANNEL_NAMES.get(info.channel as usize).unwrap_or(&"unknown");
+            eprintln!("Audio stream {}: {} samples, {} channels, {} Hz",
+                     channel, sample_count, channels, sample_rate);
+        }
     }
 }
 
@@ -274,5 +657,50 @@ extern "C" fn connection_status_callback(
 ) {
     // Update connection status using atomic
     CONNECTION_STATUS.store(connected, Ordering::SeqCst);
+    if connected {
+        TIMELINE_LOGGED.store(false, Ordering::SeqCst);
+    }
     eprintln!("Android Auto connection status changed: {}", connected);
 }
+
+/// Log a per-connection summary of the wrapper's connect timeline,
+/// each milestone relative to the moment the phone was discovered on USB
+fn log_connect_timeline(handle: AASDKHandle) {
+    let mut timeline = AASDKConnectTimeline::default();
+    if !unsafe { aasdk_get_connect_timeline(handle, &mut timeline) } {
+        return;
+    }
+
+    let origin = timeline.usb_discovered_ns;
+    if origin == 0 {
+        return;
+    }
+    let offset = |ns: u64| -> String {
+        if ns == 0 {
+            "-".to_string()
+        } else {
+            format!("+{:.1}ms", ns.saturating_sub(origin) as f64 / 1e6)
+        }
+    };
+
+    eprintln!("Android Auto connect timeline:");
+    eprintln!("  usb discovered     {}", offset(timeline.usb_discovered_ns));
+    eprintln!("  aoap switched      {}", offset(timeline.aoap_switched_ns));
+    eprintln!("  transport up       {}", offset(timeline.transport_up_ns));
+    eprintln!("  version response   {}", offset(timeline.version_response_ns));
+    let rounds = (timeline.handshake_round_count as usize).min(AASDK_TIMELINE_MAX_HANDSHAKE_ROUNDS);
+    for (round, ns) in timeline.handshake_round_ns[..rounds].iter().enumerate() {
+        eprintln!("  handshake round {}  {}", round + 1, offset(*ns));
+    }
+    eprintln!("  auth complete      {}", offset(timeline.auth_complete_ns));
+    eprintln!("  service discovery  {}", offset(timeline.service_discovery_ns));
+    for (id, name) in AASDK_CHANNEL_NAMES.iter().enumerate() {
+        let open = timeline.channel_open_ns[id];
+        let setup = timeline.av_setup_ns[id];
+        if open != 0 || setup != 0 {
+            eprintln!("  {:<18} open {}, av setup {}", name, offset(open), offset(setup));
+        }
+    }
+    eprintln!("  first video        {}", offset(timeline.first_video_ns));
+    eprintln!("  first audio        {}", offset(timeline.first_audio_ns));
+}
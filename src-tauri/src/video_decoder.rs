@@ -1,8 +1,159 @@
-// Video decoder module
-// TODO: Implement H264 decoding using ffmpeg or another library
-// Currently disabled due to Send/threading issues with ffmpeg-next
+// Native video pictures for the webview
+// The wrapper decodes H.264 with libavcodec on its decoder thread, and the callback here
+// converts each picture to RGBA at the size the webview draws it with the wrapper's SIMD
+// converter, on the same thread. The newest picture waits for the video-ipc thread,
+// which sends it as-is, so the webview draws it without decoding anything. A picture
+// not taken before the next one is replaced, never queued.
 
-pub fn init_ffmpeg() -> Result<(), String> {
-    // Placeholder
-    Ok(())
+use std::ffi::c_void;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, Condvar, Mutex};
+use std::time::Duration;
+
+use crate::aasdk_bindings::*;
+
+/// One decoded picture, converted to RGBA
+pub struct Picture {
+    pub data: Vec<u8>,
+    pub width: u32,
+    pub height: u32,
+    /// Phone media timestamp of the source payload
+    pub timestamp: u64,
+    pub sequence: u64,
+}
+
+struct Slot {
+    /// Largest size the consumer draws at; 0 = the decoded size
+    max_width: u32,
+    max_height: u32,
+    latest: Option<Picture>,
+    /// Buffer of a picture already sent, reused for the next conversion
+    spare: Vec<u8>,
+}
+
+/// Hand-off between the decoder thread and one consumer. Lives as long as the
+/// manager, so the wrapper can hold a plain pointer to it across start() and stop().
+pub struct DecodedPictures {
+    slot: Mutex<Slot>,
+    ready: Condvar,
+    /// Nothing is converted while no consumer is subscribed
+    active: AtomicBool,
+}
+
+impl DecodedPictures {
+    pub fn new() -> Self {
+        Self {
+            slot: Mutex::new(Slot { max_width: 0, max_height: 0, latest: None, spare: Vec::new() }),
+            ready: Condvar::new(),
+            active: AtomicBool::new(false),
+        }
+    }
+
+    /// user_data for aasdk_set_decoded_frame_callback()
+    pub fn user_data(self: &Arc<Self>) -> *mut c_void {
+        Arc::as_ptr(self) as *mut c_void
+    }
+
+    /// Start converting pictures for a consumer that draws at most max_width x max_height
+    pub fn subscribe(self: &Arc<Self>, max_width: u32, max_height: u32) -> PictureSource {
+        {
+            let mut slot = self.slot.lock().unwrap();
+            slot.max_width = max_width;
+            slot.max_height = max_height;
+            slot.latest = None;
+        }
+        self.active.store(true, Ordering::SeqCst);
+        PictureSource { pictures: self.clone() }
+    }
+
+    fn convert(&self, frame: &AASDKDecodedFrame) {
+        if !self.active.load(Ordering::SeqCst) {
+            return;
+        }
+
+        let (mut data, width, height) = {
+            let mut slot = self.slot.lock().unwrap();
+            let (width, height) = fit(frame.width, frame.height, slot.max_width, slot.max_height);
+            (std::mem::take(&mut slot.spare), width, height)
+        };
+
+        // Convert outside the lock; the consumer only needs it to take a finished picture
+        data.resize(width as usize * height as usize * 4, 0);
+        let converted = unsafe {
+            aasdk_convert_frame(frame, data.as_mut_ptr(), width * 4, width, height, AASDK_RGB_FORMAT_RGBA)
+        };
+
+        let mut slot = self.slot.lock().unwrap();
+        if !converted {
+            slot.spare = data;
+            return;
+        }
+        let picture = Picture {
+            data,
+            width,
+            height,
+            timestamp: frame.timestamp,
+            sequence: frame.sequence,
+        };
+        if let Some(unsent) = slot.latest.replace(picture) {
+            slot.spare = unsent.data;
+        }
+        self.ready.notify_one();
+    }
+}
+
+impl Default for DecodedPictures {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Consumer end of DecodedPictures; pictures stop being converted when it is dropped
+pub struct PictureSource {
+    pictures: Arc<DecodedPictures>,
+}
+
+impl PictureSource {
+    /// Take the newest picture, waiting up to timeout for one
+    pub fn recv_timeout(&self, timeout: Duration) -> Option<Picture> {
+        let slot = self.pictures.slot.lock().unwrap();
+        let (mut slot, _) = self.pictures.ready
+            .wait_timeout_while(slot, timeout, |slot| slot.latest.is_none())
+            .unwrap();
+        slot.latest.take()
+    }
+
+    /// Give a sent picture's buffer back for the next conversion
+    pub fn recycle(&self, picture: Picture) {
+        let mut slot = self.pictures.slot.lock().unwrap();
+        if slot.spare.capacity() < picture.data.capacity() {
+            slot.spare = picture.data;
+        }
+    }
+}
+
+impl Drop for PictureSource {
+    fn drop(&mut self) {
+        self.pictures.active.store(false, Ordering::SeqCst);
+        self.pictures.slot.lock().unwrap().latest = None;
+    }
+}
+
+/// Largest size within max_width x max_height with the picture's aspect ratio, never
+/// larger than the picture itself
+fn fit(width: u32, height: u32, max_width: u32, max_height: u32) -> (u32, u32) {
+    if max_width == 0 || max_height == 0 || (width <= max_width && height <= max_height) {
+        return (width, height);
+    }
+    let scale = (max_width as f64 / width as f64).min(max_height as f64 / height as f64);
+    (((width as f64 * scale) as u32).max(1), ((height as f64 * scale) as u32).max(1))
+}
+
+/// DecodedFrameCallback; user_data is DecodedPictures::user_data()
+pub extern "C" fn decoded_frame_callback(frame: *const AASDKDecodedFrame, user_data: *mut c_void) {
+    if frame.is_null() || user_data.is_null() {
+        return;
+    }
+    let pictures = unsafe { &*(user_data as *const DecodedPictures) };
+    pictures.convert(unsafe { &*frame });
 }
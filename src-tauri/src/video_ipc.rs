@@ -0,0 +1,171 @@
+// Binary video frame transport to the webview
+// Frames travel over a Tauri IPC channel as raw ArrayBuffers: a fixed little-endian
+// header followed by the payload, copied once out of the wrapper's buffer. The payload
+// is an RGBA picture decoded natively (video_decoder.rs), or H.264 for the webview to
+// decode when the wrapper has no native decoder. src/videoIpc.ts parses the same layout.
+
+use std::time::{Duration, Instant, SystemTime, UNIX_EPOCH};
+use tauri::ipc::{Channel, InvokeResponseBody};
+use tauri::Emitter;
+
+use crate::openauto::VideoFrame;
+use crate::video_decoder::Picture;
+
+/// Bytes before the payload: width u32, height u32, nal_flags u32, payload_len u32,
+/// timestamp u64, sequence u64, format u32, reserved u32
+pub const HEADER_LEN: usize = 40;
+
+/// Payload formats
+pub const FORMAT_H264: u32 = 0;
+/// width x height pixels of 4 bytes, no row padding
+pub const FORMAT_RGBA: u32 = 1;
+
+fn encode(
+    format: u32,
+    width: u32,
+    height: u32,
+    nal_flags: u32,
+    timestamp: u64,
+    sequence: u64,
+    payload: &[u8],
+) -> Vec<u8> {
+    let mut message = Vec::with_capacity(HEADER_LEN + payload.len());
+    message.extend_from_slice(&width.to_le_bytes());
+    message.extend_from_slice(&height.to_le_bytes());
+    message.extend_from_slice(&nal_flags.to_le_bytes());
+    message.extend_from_slice(&(payload.len() as u32).to_le_bytes());
+    message.extend_from_slice(&timestamp.to_le_bytes());
+    message.extend_from_slice(&sequence.to_le_bytes());
+    message.extend_from_slice(&format.to_le_bytes());
+    message.extend_from_slice(&0u32.to_le_bytes());
+    message.extend_from_slice(payload);
+    message
+}
+
+/// Send one H.264 frame to the webview; the pooled buffer is released when frame drops
+pub fn send(channel: &Channel<InvokeResponseBody>, frame: &VideoFrame) -> tauri::Result<()> {
+    let message = encode(
+        FORMAT_H264, frame.width, frame.height, frame.nal_flags, frame.timestamp, frame.sequence, &frame.data,
+    );
+    channel.send(InvokeResponseBody::Raw(message))
+}
+
+/// Send one decoded picture to the webview, which draws it as it arrives
+pub fn send_picture(channel: &Channel<InvokeResponseBody>, picture: &Picture) -> tauri::Result<()> {
+    let message = encode(
+        FORMAT_RGBA, picture.width, picture.height, 0, picture.timestamp, picture.sequence, &picture.data,
+    );
+    channel.send(InvokeResponseBody::Raw(message))
+}
+
+/// Frame transports compared by the IPC benchmark
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub enum Transport {
+    /// Raw ArrayBuffer over an IPC channel (the live path)
+    Channel,
+    /// Base64 inside a JSON event, as frames were delivered before
+    Event,
+}
+
+impl Transport {
+    pub fn parse(name: &str) -> Option<Self> {
+        match name {
+            "channel" => Some(Transport::Channel),
+            "event" => Some(Transport::Event),
+            _ => None,
+        }
+    }
+}
+
+/// Event the benchmark emits for the base64 transport
+pub const BENCHMARK_EVENT: &str = "video-ipc-benchmark";
+
+#[derive(Clone, serde::Serialize)]
+struct EventFramePayload {
+    data: String,
+    width: u32,
+    height: u32,
+    timestamp: u64,
+    sequence: u64,
+}
+
+/// Rust-side cost of a benchmark run; the webview measures arrival latency itself
+#[derive(Clone, Debug, Default, serde::Serialize)]
+pub struct BenchmarkReport {
+    pub transport: String,
+    pub frames: u32,
+    pub frame_size: u32,
+    /// Encoding plus handing the frame to the webview
+    pub send_us_avg: u32,
+    pub send_us_max: u32,
+    /// Frames whose send overran the 60 fps frame interval
+    pub late_frames: u32,
+    pub elapsed_ms: u64,
+}
+
+fn unix_micros() -> u64 {
+    SystemTime::now().duration_since(UNIX_EPOCH).map(|d| d.as_micros() as u64).unwrap_or(0)
+}
+
+/// Push frame_size-byte synthetic frames at 60 fps through transport. Each header
+/// carries the send time in microseconds since the Unix epoch as its timestamp.
+/// Blocks for frames / 60 seconds.
+pub fn run_benchmark<R: tauri::Runtime>(
+    app: &tauri::AppHandle<R>,
+    channel: &Channel<InvokeResponseBody>,
+    transport: Transport,
+    frames: u32,
+    frame_size: u32,
+) -> tauri::Result<BenchmarkReport> {
+    use base64::{engine::general_purpose, Engine as _};
+
+    const INTERVAL: Duration = Duration::from_micros(1_000_000 / 60);
+    // Pseudo-random bytes, so nothing on the way can shortcut a constant buffer
+    let payload: Vec<u8> = (0..frame_size).map(|i| (i.wrapping_mul(2_654_435_761) >> 24) as u8).collect();
+
+    let mut report = BenchmarkReport {
+        transport: format!("{:?}", transport).to_lowercase(),
+        frames,
+        frame_size,
+        ..Default::default()
+    };
+    let mut send_total_us = 0u64;
+    let started = Instant::now();
+    for sequence in 0..frames {
+        let deadline = started + INTERVAL * sequence;
+        if let Some(wait) = deadline.checked_duration_since(Instant::now()) {
+            std::thread::sleep(wait);
+        }
+
+        let send_started = Instant::now();
+        let timestamp = unix_micros();
+        match transport {
+            Transport::Channel => {
+                let message = encode(FORMAT_H264, 1280, 720, 0, timestamp, sequence as u64, &payload);
+                channel.send(InvokeResponseBody::Raw(message))?;
+            }
+            Transport::Event => {
+                app.emit(
+                    BENCHMARK_EVENT,
+                    EventFramePayload {
+                        data: general_purpose::STANDARD.encode(&payload),
+                        width: 1280,
+                        height: 720,
+                        timestamp,
+                        sequence: sequence as u64,
+                    },
+                )?;
+            }
+        }
+        let send_us = send_started.elapsed().as_micros() as u64;
+        send_total_us += send_us;
+        report.send_us_max = report.send_us_max.max(send_us as u32);
+        if send_us > INTERVAL.as_micros() as u64 {
+            report.late_frames += 1;
+        }
+    }
+
+    report.send_us_avg = if frames == 0 { 0 } else { (send_total_us / frames as u64) as u32 };
+    report.elapsed_ms = started.elapsed().as_millis() as u64;
+    Ok(report)
+}
@@ -1,28 +1,42 @@
-import { useEffect, useRef, useState } from "react";
-import { invoke } from "@tauri-apps/api/core";
-import { listen, UnlistenFn } from "@tauri-apps/api/event";
-
-interface VideoFramePayload {
-  data: string; // base64 encoded video data
-  width: number;
-  height: number;
-  format: string; // "h264" or "rgb24"
-}
+import { useEffect, useRef, useState, type PointerEvent as ReactPointerEvent } from "react";
+import { Channel, invoke } from "@tauri-apps/api/core";
+import { parseVideoFrame, VIDEO_FORMAT_RGBA, VIDEO_FRAME_HEADER_LEN } from "./videoIpc";
 
 interface AndroidAutoDisplayProps {
   isConnected: boolean;
 }
 
+// Touch screen the wrapper advertises to the phone (AASDKContext::TOUCH_WIDTH/HEIGHT);
+// pointer positions on the canvas are scaled to it
+const TOUCH_WIDTH = 1280;
+const TOUCH_HEIGHT = 720;
+
+// Keyboard keys forwarded to the phone as Android key presses (openauto.rs ButtonCode)
+const KEY_BUTTONS: Record<string, string> = {
+  ArrowLeft: "left",
+  ArrowRight: "right",
+  ArrowUp: "up",
+  ArrowDown: "down",
+  Enter: "enter",
+  Escape: "back",
+  Backspace: "back",
+  Home: "home",
+};
+
+type TouchAction = "down" | "move" | "up";
+
 export default function AndroidAutoDisplay({ isConnected }: AndroidAutoDisplayProps) {
   const canvasRef = useRef<HTMLCanvasElement>(null);
   const [isStreaming, setIsStreaming] = useState(false);
   const [frameCount, setFrameCount] = useState(0);
   const [fps, setFps] = useState(0);
   const [decoderReady, setDecoderReady] = useState(false);
-  const unlistenRef = useRef<UnlistenFn | null>(null);
+  const [nativeVideo, setNativeVideo] = useState(false);
+  const channelRef = useRef<Channel<ArrayBuffer> | null>(null);
   const lastFrameTimeRef = useRef<number>(Date.now());
   const fpsIntervalRef = useRef<number | null>(null);
   const workerRef = useRef<Worker | null>(null);
+  const pointersRef = useRef<Set<number>>(new Set());
 
   // Initialize H264 decoder worker
   useEffect(() => {
@@ -71,6 +85,33 @@ export default function AndroidAutoDisplay({ isConnected }: AndroidAutoDisplayPr
     }
   }, []);
 
+  // Forward navigation keys while a phone is connected
+  useEffect(() => {
+    if (!isConnected) {
+      return;
+    }
+
+    const onKey = (pressed: boolean) => (e: KeyboardEvent) => {
+      const button = KEY_BUTTONS[e.key];
+      const typing = e.target instanceof HTMLInputElement || e.target instanceof HTMLTextAreaElement;
+      if (!button || typing || (pressed && e.repeat)) {
+        return;
+      }
+      e.preventDefault();
+      invoke("send_button", { button, pressed }).catch((error) => {
+        console.error("Failed to send button:", error);
+      });
+    };
+    const onKeyDown = onKey(true);
+    const onKeyUp = onKey(false);
+    window.addEventListener("keydown", onKeyDown);
+    window.addEventListener("keyup", onKeyUp);
+    return () => {
+      window.removeEventListener("keydown", onKeyDown);
+      window.removeEventListener("keyup", onKeyUp);
+    };
+  }, [isConnected]);
+
   // Start/stop video streaming based on connection status
   useEffect(() => {
     if (isConnected && !isStreaming) {
@@ -90,16 +131,24 @@ export default function AndroidAutoDisplay({ isConnected }: AndroidAutoDisplayPr
     try {
       console.log("Starting video stream...");
 
-      // Start the video streaming task in Rust
-      await invoke("start_video_stream");
-
-      // Listen for video frame events
-      const unlisten = await listen<VideoFramePayload>("video-frame", (event) => {
-        renderFrame(event.payload);
+      // Frames arrive as raw ArrayBuffers over an IPC channel (src-tauri/src/video_ipc.rs)
+      const channel = new Channel<ArrayBuffer>();
+      channel.onmessage = (buffer) => {
+        renderFrame(buffer);
         setFrameCount((prev) => prev + 1);
+      };
+      channelRef.current = channel;
+
+      // Start the video streaming task in Rust. With a native decoder it sends RGBA
+      // pictures scaled to what the canvas can show at most; otherwise H.264
+      const area = canvasRef.current?.parentElement;
+      const ratio = window.devicePixelRatio || 1;
+      const format = await invoke<string>("start_video_stream", {
+        onFrame: channel,
+        maxWidth: Math.round((area?.clientWidth ?? 0) * ratio),
+        maxHeight: Math.round((area?.clientHeight ?? 0) * ratio),
       });
-
-      unlistenRef.current = unlisten;
+      setNativeVideo(format === "rgba");
       setIsStreaming(true);
 
       // Set up FPS counter
@@ -126,10 +175,10 @@ export default function AndroidAutoDisplay({ isConnected }: AndroidAutoDisplayPr
       // Stop the video streaming task in Rust
       await invoke("stop_video_stream");
 
-      // Unlisten from video frame events
-      if (unlistenRef.current) {
-        unlistenRef.current();
-        unlistenRef.current = null;
+      // Ignore frames still in flight
+      if (channelRef.current) {
+        channelRef.current.onmessage = () => {};
+        channelRef.current = null;
       }
 
       // Clear FPS interval
@@ -139,6 +188,7 @@ export default function AndroidAutoDisplay({ isConnected }: AndroidAutoDisplayPr
       }
 
       setIsStreaming(false);
+      setNativeVideo(false);
       setFrameCount(0);
       setFps(0);
 
@@ -157,108 +207,123 @@ export default function AndroidAutoDisplay({ isConnected }: AndroidAutoDisplayPr
     }
   };
 
-  const renderYUVFrame = (yuvData: Uint8Array, width: number, height: number) => {
+  // 2D context of the canvas, resized to the picture if needed
+  const canvasContext = (width: number, height: number) => {
     const canvas = canvasRef.current;
-    if (!canvas) return;
-
-    const ctx = canvas.getContext("2d");
-    if (!ctx) return;
+    if (!canvas) return null;
 
-    // Resize canvas if needed
     if (canvas.width !== width || canvas.height !== height) {
       canvas.width = width;
       canvas.height = height;
       console.log(`Canvas resized to ${width}x${height}`);
     }
+    return canvas.getContext("2d");
+  };
+
+  const renderYUVFrame = (yuvData: Uint8Array, width: number, height: number) => {
+    const ctx = canvasContext(width, height);
+    if (!ctx) return;
 
     // Create ImageData for rendering
     const imageData = ctx.createImageData(width, height);
     const pixels = imageData.data;
 
-    // Convert YUV420 to RGB
+    // Convert I420 to RGBA with the native converter's fixed-point BT.601 math
+    // (aasdk-wrapper/yuv_convert.cpp) so both paths render identical pixels
     const ySize = width * height;
-    const uvSize = ySize / 4;
-
-    for (let i = 0; i < ySize; i++) {
-      const y = yuvData[i];
-      const uvIndex = Math.floor(i / 4);
-      const u = yuvData[ySize + uvIndex] - 128;
-      const v = yuvData[ySize + uvSize + uvIndex] - 128;
-
-      // YUV to RGB conversion
-      const r = y + 1.402 * v;
-      const g = y - 0.344136 * u - 0.714136 * v;
-      const b = y + 1.772 * u;
-
-      const idx = i * 4;
-      pixels[idx] = Math.max(0, Math.min(255, r));
-      pixels[idx + 1] = Math.max(0, Math.min(255, g));
-      pixels[idx + 2] = Math.max(0, Math.min(255, b));
-      pixels[idx + 3] = 255;
+    const chromaWidth = (width + 1) >> 1;
+    const uvSize = chromaWidth * ((height + 1) >> 1);
+    const clamp = (value: number) => (value < 0 ? 0 : value > 255 ? 255 : value);
+
+    let idx = 0;
+    for (let row = 0; row < height; row++) {
+      const yRow = row * width;
+      const uvRow = ySize + (row >> 1) * chromaWidth;
+      for (let col = 0; col < width; col++) {
+        const uvIndex = uvRow + (col >> 1);
+        const luma = ((yuvData[yRow + col] * 149) >> 1) - 1160;
+        const u = yuvData[uvIndex] - 128;
+        const v = yuvData[uvIndex + uvSize] - 128;
+
+        pixels[idx] = clamp((luma + 102 * v) >> 6);
+        pixels[idx + 1] = clamp((luma - 25 * u - 52 * v) >> 6);
+        pixels[idx + 2] = clamp((luma + 129 * u) >> 6);
+        pixels[idx + 3] = 255;
+        idx += 4;
+      }
     }
 
     ctx.putImageData(imageData, 0, 0);
   };
 
-  const renderFrame = (frame: VideoFramePayload) => {
-    if (frame.format === "rgb24") {
-      // Render RGB24 frames
-      const canvas = canvasRef.current;
-      if (!canvas) return;
-
-      const ctx = canvas.getContext("2d");
-      if (!ctx) return;
+  const renderFrame = (buffer: ArrayBuffer) => {
+    const header = parseVideoFrame(buffer);
 
-      try {
-        if (canvas.width !== frame.width || canvas.height !== frame.height) {
-          canvas.width = frame.width;
-          canvas.height = frame.height;
-        }
+    // Decoded and converted natively: draw the pixels straight from the message
+    if (header.format === VIDEO_FORMAT_RGBA) {
+      const ctx = canvasContext(header.width, header.height);
+      if (ctx) {
+        const pixels = new Uint8ClampedArray(buffer, VIDEO_FRAME_HEADER_LEN, header.size);
+        ctx.putImageData(new ImageData(pixels, header.width, header.height), 0, 0);
+      }
+      return;
+    }
 
-        const binaryString = atob(frame.data);
-        const rgbData = new Uint8Array(binaryString.length);
-        for (let i = 0; i < binaryString.length; i++) {
-          rgbData[i] = binaryString.charCodeAt(i);
-        }
+    // Send H264 frame to worker for decoding
+    const worker = workerRef.current;
+    if (!worker || !decoderReady) {
+      console.warn("H264 decoder worker not ready");
+      return;
+    }
 
-        const imageData = ctx.createImageData(frame.width, frame.height);
-        const pixels = imageData.data;
+    try {
+      // Hand the whole buffer over without copying; the payload follows the header
+      worker.postMessage({
+        type: 'decode',
+        data: buffer,
+        offset: VIDEO_FRAME_HEADER_LEN,
+        size: header.size
+      }, [buffer]); // Transfer ownership
+    } catch (error) {
+      console.error("Failed to send H264 frame to worker:", error);
+    }
+  };
 
-        for (let i = 0, j = 0; i < rgbData.length; i += 3, j += 4) {
-          pixels[j] = rgbData[i];
-          pixels[j + 1] = rgbData[i + 1];
-          pixels[j + 2] = rgbData[i + 2];
-          pixels[j + 3] = 255;
-        }
+  // Send one finger of a gesture, scaled from the canvas as displayed to the touch screen
+  const sendTouch = (e: ReactPointerEvent<HTMLCanvasElement>, action: TouchAction) => {
+    const rect = e.currentTarget.getBoundingClientRect();
+    if (rect.width === 0 || rect.height === 0) {
+      return;
+    }
+    const scale = (offset: number, size: number, range: number) =>
+      Math.min(range - 1, Math.max(0, Math.round((offset / size) * range)));
+    const x = scale(e.clientX - rect.left, rect.width, TOUCH_WIDTH);
+    const y = scale(e.clientY - rect.top, rect.height, TOUCH_HEIGHT);
+    invoke<boolean>("send_touch", { pointerId: e.pointerId, x, y, action }).catch((error) => {
+      console.error("Failed to send touch:", error);
+    });
+  };
 
-        ctx.putImageData(imageData, 0, 0);
-      } catch (error) {
-        console.error("Failed to render RGB frame:", error);
-      }
-    } else if (frame.format === "h264") {
-      // Send H264 frame to worker for decoding
-      const worker = workerRef.current;
-      if (!worker || !decoderReady) {
-        console.warn("H264 decoder worker not ready");
-        return;
-      }
+  const onPointerDown = (e: ReactPointerEvent<HTMLCanvasElement>) => {
+    if (!isConnected) {
+      return;
+    }
+    // Keep receiving this finger's moves and up when it leaves the canvas
+    e.currentTarget.setPointerCapture(e.pointerId);
+    pointersRef.current.add(e.pointerId);
+    sendTouch(e, "down");
+  };
 
-      try {
-        // Decode base64 to binary H264 data
-        const binaryString = atob(frame.data);
-        const h264Data = new Uint8Array(binaryString.length);
-        for (let i = 0; i < binaryString.length; i++) {
-          h264Data[i] = binaryString.charCodeAt(i);
-        }
+  const onPointerMove = (e: ReactPointerEvent<HTMLCanvasElement>) => {
+    // A mouse hovering without a button pressed is not a touch
+    if (pointersRef.current.has(e.pointerId)) {
+      sendTouch(e, "move");
+    }
+  };
 
-        // Send to worker for decoding
-        worker.postMessage({
-          type: 'decode',
-          data: h264Data.buffer
-        }, [h264Data.buffer]); // Transfer ownership
-      } catch (error) {
-        console.error("Failed to send H264 frame to worker:", error);
-      }
+  const onPointerUp = (e: ReactPointerEvent<HTMLCanvasElement>) => {
+    if (pointersRef.current.delete(e.pointerId)) {
+      sendTouch(e, "up");
     }
   };
 
@@ -276,10 +341,15 @@ export default function AndroidAutoDisplay({ isConnected }: AndroidAutoDisplayPr
     }}>
       <canvas
         ref={canvasRef}
+        onPointerDown={onPointerDown}
+        onPointerMove={onPointerMove}
+        onPointerUp={onPointerUp}
+        onPointerCancel={onPointerUp}
         style={{
           maxWidth: "100%",
           maxHeight: "100%",
           objectFit: "contain",
+          touchAction: "none",
         }}
       />
 
@@ -306,7 +376,7 @@ export default function AndroidAutoDisplay({ isConnected }: AndroidAutoDisplayPr
         </div>
       )}
 
-      {isConnected && !decoderReady && (
+      {isConnected && !decoderReady && !nativeVideo && (
         <div style={{
           position: "absolute",
           top: "10px",
@@ -1,6 +1,12 @@
 import React from "react";
 import ReactDOM from "react-dom/client";
 import App from "./App";
+import { benchmarkVideoIpc } from "./videoIpc";
+
+// Devtools console helper: benchmarkVideoIpc() times per-frame IPC cost at 60 fps
+if (import.meta.env.DEV) {
+  (window as unknown as { benchmarkVideoIpc: typeof benchmarkVideoIpc }).benchmarkVideoIpc = benchmarkVideoIpc;
+}
 
 ReactDOM.createRoot(document.getElementById("root") as HTMLElement).render(
   <React.StrictMode>
@@ -0,0 +1,111 @@
+import { Channel, invoke } from "@tauri-apps/api/core";
+import { listen } from "@tauri-apps/api/event";
+
+// Binary video frames from src-tauri/src/video_ipc.rs: a little-endian header
+// followed by the payload, delivered as one ArrayBuffer per frame
+export const VIDEO_FRAME_HEADER_LEN = 40;
+
+// Payload formats: H.264 to decode, or a natively decoded picture ready to draw
+export const VIDEO_FORMAT_H264 = 0;
+export const VIDEO_FORMAT_RGBA = 1;   // width x height pixels of 4 bytes, no row padding
+
+export interface VideoFrameHeader {
+  width: number;
+  height: number;
+  nalFlags: number;
+  size: number;       // Payload bytes after the header
+  timestamp: number;  // Phone media timestamp (benchmark: send time, µs since the epoch)
+  sequence: number;
+  format: number;
+}
+
+export function parseVideoFrame(buffer: ArrayBuffer): VideoFrameHeader {
+  const view = new DataView(buffer, 0, VIDEO_FRAME_HEADER_LEN);
+  return {
+    width: view.getUint32(0, true),
+    height: view.getUint32(4, true),
+    nalFlags: view.getUint32(8, true),
+    size: view.getUint32(12, true),
+    timestamp: Number(view.getBigUint64(16, true)),
+    sequence: Number(view.getBigUint64(24, true)),
+    format: view.getUint32(32, true),
+  };
+}
+
+interface BenchmarkReport {
+  transport: string;
+  frames: number;
+  frame_size: number;
+  send_us_avg: number;
+  send_us_max: number;
+  late_frames: number;
+  elapsed_ms: number;
+}
+
+interface BenchmarkEventPayload {
+  data: string;
+  width: number;
+  height: number;
+  timestamp: number;
+  sequence: number;
+}
+
+const nowMicros = () => (performance.timeOrigin + performance.now()) * 1000;
+
+const percentile = (sorted: number[], p: number) =>
+  sorted.length === 0 ? 0 : sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+
+// Per-frame IPC cost at 60 fps: the raw channel against the base64 event path it
+// replaced. Latency is send to usable bytes on the main thread, including the base64
+// decode the event path needs. Run from the devtools console: benchmarkVideoIpc()
+export async function benchmarkVideoIpc(frames = 600, frameSize = 24 * 1024) {
+  const results: Record<string, string | number>[] = [];
+  for (const transport of ["channel", "event"]) {
+    const latencies: number[] = [];
+    let received = 0;
+    const channel = new Channel<ArrayBuffer>();
+    channel.onmessage = (buffer) => {
+      const header = parseVideoFrame(buffer);
+      const payload = new Uint8Array(buffer, VIDEO_FRAME_HEADER_LEN, header.size);
+      if (payload.length === header.size) {
+        received++;
+      }
+      latencies.push(nowMicros() - header.timestamp);
+    };
+    const unlisten = await listen<BenchmarkEventPayload>("video-ipc-benchmark", (event) => {
+      const binary = atob(event.payload.data);
+      const payload = new Uint8Array(binary.length);
+      for (let i = 0; i < binary.length; i++) {
+        payload[i] = binary.charCodeAt(i);
+      }
+      if (payload.length === frameSize) {
+        received++;
+      }
+      latencies.push(nowMicros() - event.payload.timestamp);
+    });
+
+    try {
+      const report = await invoke<BenchmarkReport>("benchmark_video_ipc", {
+        onFrame: channel, transport, frames, frameSize,
+      });
+      // Let the tail of the stream arrive
+      await new Promise((resolve) => setTimeout(resolve, 250));
+      latencies.sort((a, b) => a - b);
+      results.push({
+        transport,
+        frameBytes: frameSize,
+        received: `${received}/${frames}`,
+        sendUsAvg: report.send_us_avg,
+        sendUsMax: report.send_us_max,
+        lateFrames: report.late_frames,
+        latencyUsP50: Math.round(percentile(latencies, 0.5)),
+        latencyUsP99: Math.round(percentile(latencies, 0.99)),
+        latencyUsMax: Math.round(percentile(latencies, 1)),
+      });
+    } finally {
+      unlisten();
+    }
+  }
+  console.table(results);
+  return results;
+}